@@ -0,0 +1,358 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-aoi-stats-calculator.h"
+
+#include "ns3/string.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrAoiStatsCalculator");
+
+NS_OBJECT_ENSURE_REGISTERED(NrAoiStatsCalculator);
+
+NrAoiStatsCalculator::NrAoiStatsCalculator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NrAoiStatsCalculator::~NrAoiStatsCalculator()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_outFile.is_open())
+    {
+        m_outFile.close();
+    }
+}
+
+TypeId
+NrAoiStatsCalculator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrAoiStatsCalculator")
+            .SetParent<Object>()
+            .SetGroupName("nr")
+            .AddConstructor<NrAoiStatsCalculator>()
+            .AddAttribute("StartTime",
+                          "Start time of the first epoch.",
+                          TimeValue(Seconds(0.)),
+                          MakeTimeAccessor(&NrAoiStatsCalculator::SetStartTime,
+                                           &NrAoiStatsCalculator::GetStartTime),
+                          MakeTimeChecker())
+            .AddAttribute("EpochDuration",
+                          "Epoch duration.",
+                          TimeValue(Seconds(0.25)),
+                          MakeTimeAccessor(&NrAoiStatsCalculator::SetEpoch,
+                                           &NrAoiStatsCalculator::GetEpoch),
+                          MakeTimeChecker(NanoSeconds(1)))
+            .AddAttribute("AoiThreshold",
+                          "AoI above which the AoI is counted in the violation probability.",
+                          TimeValue(MilliSeconds(10)),
+                          MakeTimeAccessor(&NrAoiStatsCalculator::m_threshold),
+                          MakeTimeChecker())
+            .AddAttribute("OutputFilename",
+                          "Name of the binary file where the results will be saved.",
+                          StringValue("NrUlAoiStats.bin"),
+                          MakeStringAccessor(&NrAoiStatsCalculator::SetOutputFilename,
+                                             &NrAoiStatsCalculator::GetOutputFilename),
+                          MakeStringChecker());
+    return tid;
+}
+
+void
+NrAoiStatsCalculator::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    FlushResults();
+    Object::DoDispose();
+}
+
+void
+NrAoiStatsCalculator::SetStartTime(Time t)
+{
+    m_startTime = t;
+}
+
+Time
+NrAoiStatsCalculator::GetStartTime() const
+{
+    return m_startTime;
+}
+
+void
+NrAoiStatsCalculator::SetEpoch(Time e)
+{
+    m_epochDuration = e;
+}
+
+Time
+NrAoiStatsCalculator::GetEpoch() const
+{
+    return m_epochDuration;
+}
+
+void
+NrAoiStatsCalculator::SetOutputFilename(std::string outputFilename)
+{
+    m_outputFilename = outputFilename;
+    if (m_outFile.is_open())
+    {
+        m_outFile.close();
+    }
+}
+
+std::string
+NrAoiStatsCalculator::GetOutputFilename() const
+{
+    return m_outputFilename;
+}
+
+void
+NrAoiStatsCalculator::Accumulator::Merge(const Accumulator& other)
+{
+    m_area += other.m_area;
+    m_observed += other.m_observed;
+    m_violation += other.m_violation;
+    m_peakSum += other.m_peakSum;
+    m_peaks += other.m_peaks;
+    m_max = std::max(m_max, other.m_max);
+    m_deliveries += other.m_deliveries;
+}
+
+void
+NrAoiStatsCalculator::Integrate(UeAoi* ue, Time to, Accumulator* acc) const
+{
+    NS_ASSERT(to >= ue->m_lastUpdate);
+    Time from = ue->m_lastUpdate;
+    ue->m_aoi += to - from;
+    ue->m_lastUpdate = to;
+    if (to <= m_startTime)
+    {
+        return;
+    }
+    // the part before the epoch start is not accounted
+    from = std::max(from, m_startTime);
+
+    // the AoI grows linearly from a to b over dt: the trapezoid and the part over the
+    // threshold are computed exactly
+    double dt = (to - from).GetSeconds();
+    double b = ue->m_aoi.GetSeconds();
+    double a = b - dt;
+    acc->m_area += (a + b) * dt / 2.0;
+    acc->m_observed += dt;
+    acc->m_violation += std::clamp(b - m_threshold.GetSeconds(), 0.0, dt);
+    acc->m_max = std::max(acc->m_max, b);
+}
+
+void
+NrAoiStatsCalculator::UlDelivery(uint16_t cellId, uint16_t rnti, Time creationTime)
+{
+    NS_LOG_FUNCTION(this << cellId << rnti << creationTime);
+    ScheduleEndEpoch();
+
+    Time now = Simulator::Now();
+    auto [it, inserted] = m_ueAoi.try_emplace(UeKey(cellId, rnti));
+    UeAoi& ue = it->second;
+    if (inserted)
+    {
+        // the AoI is defined from the first delivery
+        ue.m_lastUpdate = now;
+        ue.m_aoi = now - creationTime;
+        ue.m_newest = creationTime;
+    }
+    else
+    {
+        Integrate(&ue, now, &ue.m_epoch);
+        // a packet older than the newest one delivered does not reset the AoI: no peak
+        if (creationTime > ue.m_newest)
+        {
+            if (now >= m_startTime)
+            {
+                ue.m_epoch.m_peakSum += ue.m_aoi.GetSeconds();
+                ++ue.m_epoch.m_peaks;
+            }
+            ue.m_newest = creationTime;
+            ue.m_aoi = now - creationTime;
+        }
+    }
+    if (now >= m_startTime)
+    {
+        ++ue.m_epoch.m_deliveries;
+    }
+}
+
+void
+NrAoiStatsCalculator::UlAoiDeliveryCallback(Ptr<NrAoiStatsCalculator> aoiStats,
+                                            std::string path,
+                                            uint16_t cellId,
+                                            uint16_t rnti,
+                                            uint64_t creationTime)
+{
+    NS_LOG_FUNCTION(aoiStats << path);
+    aoiStats->UlDelivery(cellId, rnti, MicroSeconds(creationTime));
+}
+
+NrAoiStatsCalculator::Accumulator
+NrAoiStatsCalculator::GetUpToNow(uint16_t cellId, uint16_t rnti) const
+{
+    auto it = m_ueAoi.find(UeKey(cellId, rnti));
+    if (it == m_ueAoi.end())
+    {
+        return Accumulator();
+    }
+    UeAoi ue = it->second;
+    Integrate(&ue, Simulator::Now(), &ue.m_epoch);
+    return ue.m_epoch;
+}
+
+Time
+NrAoiStatsCalculator::GetAoi(uint16_t cellId, uint16_t rnti) const
+{
+    auto it = m_ueAoi.find(UeKey(cellId, rnti));
+    if (it == m_ueAoi.end())
+    {
+        return Time(0);
+    }
+    return it->second.m_aoi + (Simulator::Now() - it->second.m_lastUpdate);
+}
+
+Time
+NrAoiStatsCalculator::GetAverageAoi(uint16_t cellId, uint16_t rnti) const
+{
+    Accumulator acc = GetUpToNow(cellId, rnti);
+    return acc.m_observed > 0 ? Seconds(acc.m_area / acc.m_observed) : Time(0);
+}
+
+Time
+NrAoiStatsCalculator::GetAveragePeakAoi(uint16_t cellId, uint16_t rnti) const
+{
+    auto it = m_ueAoi.find(UeKey(cellId, rnti));
+    if (it == m_ueAoi.end() || it->second.m_epoch.m_peaks == 0)
+    {
+        return Time(0);
+    }
+    return Seconds(it->second.m_epoch.m_peakSum / it->second.m_epoch.m_peaks);
+}
+
+Time
+NrAoiStatsCalculator::GetMaxAoi(uint16_t cellId, uint16_t rnti) const
+{
+    return Seconds(GetUpToNow(cellId, rnti).m_max);
+}
+
+double
+NrAoiStatsCalculator::GetViolationProbability(uint16_t cellId, uint16_t rnti) const
+{
+    Accumulator acc = GetUpToNow(cellId, rnti);
+    return acc.m_observed > 0 ? acc.m_violation / acc.m_observed : 0.0;
+}
+
+void
+NrAoiStatsCalculator::ScheduleEndEpoch()
+{
+    if (!m_flushScheduled)
+    {
+        // write the ongoing epoch at the end of the simulation
+        Simulator::ScheduleDestroy(&NrAoiStatsCalculator::FlushResults,
+                                   Ptr<NrAoiStatsCalculator>(this));
+        m_flushScheduled = true;
+    }
+    if (m_endEpochEvent.IsPending())
+    {
+        return;
+    }
+    Time now = Simulator::Now();
+    while (m_startTime + m_epochDuration <= now)
+    {
+        m_startTime += m_epochDuration;
+    }
+    m_endEpochEvent = Simulator::Schedule(m_startTime + m_epochDuration - now,
+                                          &NrAoiStatsCalculator::EndEpoch,
+                                          this);
+}
+
+void
+NrAoiStatsCalculator::EndEpoch()
+{
+    NS_LOG_FUNCTION(this);
+    WriteResults();
+    for (auto& [key, ue] : m_ueAoi)
+    {
+        ue.m_epoch = Accumulator();
+    }
+    m_startTime += m_epochDuration;
+    m_endEpochEvent =
+        Simulator::Schedule(m_epochDuration, &NrAoiStatsCalculator::EndEpoch, this);
+}
+
+void
+NrAoiStatsCalculator::FlushResults()
+{
+    NS_LOG_FUNCTION(this);
+    m_endEpochEvent.Cancel();
+    if (!m_ueAoi.empty())
+    {
+        WriteResults();
+        m_ueAoi.clear();
+    }
+}
+
+void
+NrAoiStatsCalculator::WriteResults()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_outFile.is_open())
+    {
+        m_outFile.open(m_outputFilename, std::ios::binary);
+        if (!m_outFile.is_open())
+        {
+            NS_LOG_ERROR("Can't open file " << m_outputFilename);
+            return;
+        }
+        m_outFile.write("NrAoi001", 8);
+    }
+
+    Time now = Simulator::Now();
+    std::map<uint16_t, Accumulator> cells;
+    for (auto& [key, ue] : m_ueAoi)
+    {
+        Integrate(&ue, now, &ue.m_epoch);
+        if (ue.m_epoch.m_observed == 0 && ue.m_epoch.m_deliveries == 0)
+        {
+            continue;
+        }
+        WriteRecord(key.first, key.second, ue.m_epoch);
+        cells[key.first].Merge(ue.m_epoch);
+    }
+    for (const auto& [cellId, acc] : cells)
+    {
+        WriteRecord(cellId, 0, acc);
+    }
+    m_outFile.flush();
+}
+
+void
+NrAoiStatsCalculator::WriteRecord(uint16_t cellId, uint16_t rnti, const Accumulator& acc)
+{
+    double start = m_startTime.GetSeconds();
+    double avgAoi = acc.m_observed > 0 ? acc.m_area / acc.m_observed : 0.0;
+    double avgPeakAoi = acc.m_peaks > 0 ? acc.m_peakSum / acc.m_peaks : 0.0;
+    double violation = acc.m_observed > 0 ? acc.m_violation / acc.m_observed : 0.0;
+
+    m_outFile.write(reinterpret_cast<const char*>(&start), sizeof(start));
+    m_outFile.write(reinterpret_cast<const char*>(&cellId), sizeof(cellId));
+    m_outFile.write(reinterpret_cast<const char*>(&rnti), sizeof(rnti));
+    m_outFile.write(reinterpret_cast<const char*>(&acc.m_deliveries), sizeof(acc.m_deliveries));
+    m_outFile.write(reinterpret_cast<const char*>(&avgAoi), sizeof(avgAoi));
+    m_outFile.write(reinterpret_cast<const char*>(&avgPeakAoi), sizeof(avgPeakAoi));
+    m_outFile.write(reinterpret_cast<const char*>(&acc.m_max), sizeof(acc.m_max));
+    m_outFile.write(reinterpret_cast<const char*>(&violation), sizeof(violation));
+}
+
+} // namespace ns3
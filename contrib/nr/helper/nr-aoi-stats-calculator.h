@@ -0,0 +1,264 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_AOI_STATS_CALCULATOR_H_
+#define NR_AOI_STATS_CALCULATOR_H_
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <fstream>
+#include <map>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup nr
+ *
+ * Computes the uplink Age of Information (AoI) of each UE from the
+ * ns3::NrGnbMac::UlAoiDelivery trace source, fired at each successful UL HARQ ACK
+ * with the creation time of the delivered packet.
+ *
+ * The AoI of a UE at time t is t - u(t), where u(t) is the newest creation time
+ * delivered so far: it grows linearly and drops at each delivery of a newer packet.
+ * This sawtooth is integrated exactly, in O(1) per delivery, from the first
+ * delivery of the UE. The statistics are calculated at consecutive epochs of
+ * EpochDuration, starting at StartTime:
+ *
+ *   - Time-average AoI
+ *   - Average peak AoI, i.e., the average of the AoI just before the deliveries that
+ *     reset it (a packet older than the newest one already delivered is not a peak)
+ *   - Maximum AoI
+ *   - Violation probability, i.e., the fraction of time the AoI exceeds AoiThreshold
+ *
+ * for each (cell ID, RNTI) and for each cell, over all its UEs.
+ *
+ * At the end of each epoch, and at the end of the simulation for the ongoing one,
+ * a record is appended to the binary file OutputFilename for each UE and for each
+ * cell that were observed during the epoch. The file starts with the 8 characters
+ * "NrAoi001", followed by records of 48 bytes in host byte order:
+ *
+ *   - double: start of the epoch (s)
+ *   - uint16_t: cell ID
+ *   - uint16_t: RNTI, 0 for the record of the whole cell
+ *   - uint32_t: number of deliveries
+ *   - double: time-average AoI (s)
+ *   - double: average peak AoI (s), 0 if no delivery reset the AoI after the first one
+ *   - double: maximum AoI (s)
+ *   - double: violation probability
+ *
+ * which can be read, e.g., with numpy.fromfile and the dtype
+ * [('start','<f8'),('cellId','<u2'),('rnti','<u2'),('deliveries','<u4'),
+ *  ('avgAoi','<f8'),('avgPeakAoi','<f8'),('maxAoi','<f8'),('violation','<f8')]
+ * after an offset of 8 bytes.
+ */
+class NrAoiStatsCalculator : public Object
+{
+  public:
+    /**
+     * Constructor
+     */
+    NrAoiStatsCalculator();
+
+    /**
+     * Destructor
+     */
+    ~NrAoiStatsCalculator() override;
+
+    // Inherited from ns3::Object
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * Set the start time of the first epoch
+     * \param t the start time
+     */
+    void SetStartTime(Time t);
+
+    /**
+     * \return the start time of the ongoing epoch
+     */
+    Time GetStartTime() const;
+
+    /**
+     * Set the epoch duration
+     * \param e the epoch duration
+     */
+    void SetEpoch(Time e);
+
+    /**
+     * \return the epoch duration
+     */
+    Time GetEpoch() const;
+
+    /**
+     * Set the name of the file where the statistics will be stored.
+     * \param outputFilename string with the name of the file
+     */
+    void SetOutputFilename(std::string outputFilename);
+
+    /**
+     * \return the name of the file where the statistics will be stored
+     */
+    std::string GetOutputFilename() const;
+
+    /**
+     * Notifies the stats calculator that an uplink packet has been delivered.
+     * \param cellId Cell ID of the gNB
+     * \param rnti C-RNTI of the UE who transmitted the packet
+     * \param creationTime creation time of the packet
+     */
+    void UlDelivery(uint16_t cellId, uint16_t rnti, Time creationTime);
+
+    /**
+     * Trace sink for the ns3::NrGnbMac::UlAoiDelivery trace source
+     *
+     * \param aoiStats the AoI stats calculator
+     * \param path the trace source path
+     * \param cellId Cell ID of the gNB
+     * \param rnti C-RNTI of the UE who transmitted the packet
+     * \param creationTime creation time of the packet, in microseconds
+     */
+    static void UlAoiDeliveryCallback(Ptr<NrAoiStatsCalculator> aoiStats,
+                                      std::string path,
+                                      uint16_t cellId,
+                                      uint16_t rnti,
+                                      uint64_t creationTime);
+
+    /**
+     * \param cellId Cell ID of the gNB
+     * \param rnti C-RNTI of the UE
+     * \return the AoI of the UE now, or 0 before its first delivery
+     */
+    Time GetAoi(uint16_t cellId, uint16_t rnti) const;
+
+    /**
+     * \param cellId Cell ID of the gNB
+     * \param rnti C-RNTI of the UE
+     * \return the time-average AoI of the UE in the ongoing epoch, up to now
+     */
+    Time GetAverageAoi(uint16_t cellId, uint16_t rnti) const;
+
+    /**
+     * \param cellId Cell ID of the gNB
+     * \param rnti C-RNTI of the UE
+     * \return the average peak AoI of the UE in the ongoing epoch
+     */
+    Time GetAveragePeakAoi(uint16_t cellId, uint16_t rnti) const;
+
+    /**
+     * \param cellId Cell ID of the gNB
+     * \param rnti C-RNTI of the UE
+     * \return the maximum AoI of the UE in the ongoing epoch, up to now
+     */
+    Time GetMaxAoi(uint16_t cellId, uint16_t rnti) const;
+
+    /**
+     * \param cellId Cell ID of the gNB
+     * \param rnti C-RNTI of the UE
+     * \return the fraction of the ongoing epoch, up to now, in which the AoI of the
+     * UE exceeded the threshold
+     */
+    double GetViolationProbability(uint16_t cellId, uint16_t rnti) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief AoI statistics of a UE, or of a cell, in the ongoing epoch
+     */
+    struct Accumulator
+    {
+        double m_area{0.0};       //!< Integral of the AoI (s^2)
+        double m_observed{0.0};   //!< Time the AoI was defined (s)
+        double m_violation{0.0};  //!< Time the AoI exceeded the threshold (s)
+        double m_peakSum{0.0};    //!< Sum of the peak AoIs (s)
+        double m_max{0.0};        //!< Maximum AoI (s)
+        uint32_t m_peaks{0};      //!< Number of peak AoIs
+        uint32_t m_deliveries{0}; //!< Number of deliveries
+
+        /**
+         * \brief Add the statistics of another accumulator
+         * \param other the other accumulator
+         */
+        void Merge(const Accumulator& other);
+    };
+
+    /**
+     * \brief AoI sawtooth of a UE
+     */
+    struct UeAoi
+    {
+        Time m_lastUpdate;   //!< Time up to which the AoI was integrated
+        Time m_aoi;          //!< AoI at m_lastUpdate
+        Time m_newest;       //!< Newest creation time delivered
+        Accumulator m_epoch; //!< Statistics of the ongoing epoch
+    };
+
+    using UeKey = std::pair<uint16_t, uint16_t>; //!< (cell ID, RNTI)
+
+    /**
+     * \brief Integrate the AoI of a UE up to a time
+     * \param ue the UE
+     * \param to the end of the integration, not before ue.m_lastUpdate
+     * \param acc the accumulator of the statistics
+     */
+    void Integrate(UeAoi* ue, Time to, Accumulator* acc) const;
+
+    /**
+     * \brief Statistics of a UE in the ongoing epoch, integrated up to now
+     * \param cellId Cell ID of the gNB
+     * \param rnti C-RNTI of the UE
+     * \return the statistics, empty if the UE was never delivered a packet
+     */
+    Accumulator GetUpToNow(uint16_t cellId, uint16_t rnti) const;
+
+    /**
+     * \brief Schedule the end of the ongoing epoch, if not done yet
+     */
+    void ScheduleEndEpoch();
+
+    /**
+     * \brief Write the statistics of the ongoing epoch and start a new one
+     */
+    void EndEpoch();
+
+    /**
+     * \brief Write the statistics of the ongoing epoch, integrated up to now
+     */
+    void WriteResults();
+
+    /**
+     * \brief Write the statistics of the ongoing epoch, if any, and stop the statistics
+     */
+    void FlushResults();
+
+    /**
+     * \brief Write a record in the output file
+     * \param cellId Cell ID of the gNB
+     * \param rnti C-RNTI of the UE, 0 for the cell
+     * \param acc the statistics
+     */
+    void WriteRecord(uint16_t cellId, uint16_t rnti, const Accumulator& acc);
+
+    Time m_startTime;               //!< Start time of the ongoing epoch
+    Time m_epochDuration;           //!< Epoch duration
+    Time m_threshold;               //!< AoI threshold for the violation probability
+    std::string m_outputFilename;   //!< Name of the output file
+    std::ofstream m_outFile;        //!< Output file stream, opened at the first write
+    EventId m_endEpochEvent;        //!< Event of the end of the ongoing epoch
+    std::map<UeKey, UeAoi> m_ueAoi; //!< AoI of each UE
+    bool m_flushScheduled{false};   //!< FlushResults scheduled at the simulation end
+};
+
+} // namespace ns3
+
+#endif /* NR_AOI_STATS_CALCULATOR_H_ */
@@ -2011,6 +2011,25 @@ NrHelper::EnableUlMacSchedTraces()
         MakeBoundCallback(&NrMacSchedulingStats::UlSchedulingCallback, m_macSchedStats));
 }
 
+void
+NrHelper::EnableUlAoiTraces()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_aoiStats)
+    {
+        m_aoiStats = CreateObject<NrAoiStatsCalculator>();
+    }
+    Config::Connect(
+        "/NodeList/*/DeviceList/*/BandwidthPartMap/*/NrGnbMac/UlAoiDelivery",
+        MakeBoundCallback(&NrAoiStatsCalculator::UlAoiDeliveryCallback, m_aoiStats));
+}
+
+Ptr<NrAoiStatsCalculator>
+NrHelper::GetAoiStatsCalculator()
+{
+    return m_aoiStats;
+}
+
 void
 NrHelper::EnablePathlossTraces()
 {
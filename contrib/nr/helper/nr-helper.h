@@ -7,6 +7,7 @@
 
 #include "cc-bwp-helper.h"
 #include "ideal-beamforming-helper.h"
+#include "nr-aoi-stats-calculator.h"
 #include "nr-bearer-stats-connector.h"
 #include "nr-mac-scheduling-stats.h"
 
@@ -840,6 +841,20 @@ class NrHelper : public Object
      */
     void EnableUlMacSchedTraces();
 
+    /**
+     * Enable the UL Age of Information statistics (see NrAoiStatsCalculator).
+     *
+     * It is not part of EnableTraces(): the statistics file is created only when this is called.
+     */
+    void EnableUlAoiTraces();
+
+    /**
+     * \brief Get the UL Age of Information stats calculator
+     *
+     * \return the NrAoiStatsCalculator object, nullptr if EnableUlAoiTraces was not called
+     */
+    Ptr<NrAoiStatsCalculator> GetAoiStatsCalculator();
+
     /**
      * \brief Enable trace sinks for DL and UL pathloss
      */
@@ -1060,6 +1075,7 @@ class NrHelper : public Object
     //!< has assigned streams in order to avoid double
     //!< assignments
     Ptr<NrMacSchedulingStats> m_macSchedStats; //!<< Pointer to NrMacStatsCalculator
+    Ptr<NrAoiStatsCalculator> m_aoiStats;      //!<< Pointer to NrAoiStatsCalculator
     bool m_useIdealRrc;
     std::vector<OperationBandInfo> m_bands;
 };
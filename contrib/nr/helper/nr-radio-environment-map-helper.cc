@@ -12,6 +12,7 @@
 #include <ns3/config.h>
 #include <ns3/double.h>
 #include <ns3/enum.h>
+#include <ns3/integer.h>
 #include <ns3/log.h>
 #include <ns3/mobility-model.h>
 #include <ns3/node.h>
@@ -22,10 +23,14 @@
 #include <ns3/simulator.h>
 #include <ns3/spectrum-converter.h>
 #include <ns3/string.h>
+#include <ns3/thread-pool.h>
+#include <ns3/three-gpp-channel-model.h>
 #include <ns3/uinteger.h>
 
+#include <algorithm>
 #include <fstream>
 #include <limits>
+#include <map>
 
 namespace ns3
 {
@@ -151,7 +156,33 @@ NrRadioEnvironmentMapHelper::GetTypeId()
                 "depends on RRC message timing.",
                 TimeValue(MilliSeconds(100)),
                 MakeTimeAccessor(&NrRadioEnvironmentMapHelper::SetInstallationDelay),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("NumThreads",
+                          "Number of threads computing the REM points. With 0 or 1, they "
+                          "are computed in the simulation thread. The map does not depend "
+                          "on the number of threads. When there are buildings, a single "
+                          "thread is used.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&NrRadioEnvironmentMapHelper::SetNumThreads,
+                                               &NrRadioEnvironmentMapHelper::GetNumThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TileSize",
+                          "Number of consecutive REM points (along the y axis, then the x "
+                          "axis) of a tile, the unit of work of a thread. The random "
+                          "variables are assigned new streams at the beginning of each tile, "
+                          "so that the map depends on the size of the tiles.",
+                          UintegerValue(1000),
+                          MakeUintegerAccessor(&NrRadioEnvironmentMapHelper::SetTileSize,
+                                               &NrRadioEnvironmentMapHelper::GetTileSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("FirstStream",
+                          "First stream number of the random variables of the REM points. "
+                          "The tiles use consecutive blocks of streams from it, which should "
+                          "not overlap the streams assigned to the simulation.",
+                          IntegerValue(1000000),
+                          MakeIntegerAccessor(&NrRadioEnvironmentMapHelper::SetFirstStream,
+                                              &NrRadioEnvironmentMapHelper::GetFirstStream),
+                          MakeIntegerChecker<int64_t>(0));
     return tid;
 }
 
@@ -221,6 +252,24 @@ NrRadioEnvironmentMapHelper::SetInstallationDelay(const Time& installationDelay)
     m_installationDelay = installationDelay;
 }
 
+void
+NrRadioEnvironmentMapHelper::SetNumThreads(uint32_t numThreads)
+{
+    m_numThreads = numThreads;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetTileSize(uint32_t tileSize)
+{
+    m_tileSize = tileSize;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetFirstStream(int64_t stream)
+{
+    m_firstStream = stream;
+}
+
 NrRadioEnvironmentMapHelper::RemMode
 NrRadioEnvironmentMapHelper::GetRemMode() const
 {
@@ -269,6 +318,24 @@ NrRadioEnvironmentMapHelper::GetZ() const
     return m_z;
 }
 
+uint32_t
+NrRadioEnvironmentMapHelper::GetNumThreads() const
+{
+    return m_numThreads;
+}
+
+uint32_t
+NrRadioEnvironmentMapHelper::GetTileSize() const
+{
+    return m_tileSize;
+}
+
+int64_t
+NrRadioEnvironmentMapHelper::GetFirstStream() const
+{
+    return m_firstStream;
+}
+
 double
 NrRadioEnvironmentMapHelper::DbmToW(double dBm) const
 {
@@ -612,7 +679,8 @@ NrRadioEnvironmentMapHelper::DelayedInstall(const NetDeviceContainer& rtdNetDev,
     {
         NS_FATAL_ERROR("Unknown REM mode");
     }
-    PrintRemToFile();
+    CreateCustomGnuplotFile();
+    Finalize();
 
     std::ostringstream ossGnbs;
     ossGnbs << "nr-rem-" << m_simTag.c_str() << "-gnbs.txt";
@@ -680,18 +748,25 @@ NrRadioEnvironmentMapHelper::ConfigureQuasiOmniBfv(RemDevice& device)
 }
 
 void
-NrRadioEnvironmentMapHelper::ConfigureDirectPathBfv(RemDevice& device,
-                                                    const RemDevice& otherDevice,
-                                                    const Ptr<const UniformPlanarArray>& antenna)
+NrRadioEnvironmentMapHelper::ConfigureDirectPathBfv(
+    RemDevice& device,
+    const RemDevice& otherDevice,
+    const Ptr<const UniformPlanarArray>& antenna) const
 {
     NS_LOG_FUNCTION(this);
     device.antenna->SetBeamformingVector(CreateDirectPathBfv(device.mob, otherDevice.mob, antenna));
 }
 
 Ptr<SpectrumValue>
-NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherDevice) const
+NrRadioEnvironmentMapHelper::CalcRxPsdValue(const PropagationModels& propagationModels,
+                                            RemDevice& device,
+                                            RemDevice& otherDevice) const
 {
-    PropagationModels tempPropModels = CreateTemporalPropagationModels();
+    // forget the channels of the device, so that a new realization is generated
+    uint32_t nodeId = device.node->GetId();
+    propagationModels.remChannelConditionModelCopy->RemoveNode(nodeId);
+    propagationModels.remPropagationLossModelCopy->RemoveNode(nodeId);
+    propagationModels.remSpectrumLossModelCopy->RemoveNode(nodeId);
 
     std::vector<int> activeRbs;
     for (size_t rbId = 0; rbId < device.spectrumModel->GetNumBands(); rbId++)
@@ -728,7 +803,7 @@ NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherD
     Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
     rxParams->psd = convertedTxPsd->Copy();
     double pathLossDb =
-        tempPropModels.remPropagationLossModelCopy->CalcRxPower(0, device.mob, otherDevice.mob);
+        propagationModels.remPropagationLossModelCopy->CalcRxPower(0, device.mob, otherDevice.mob);
     double pathGainLinear = DbToRatio(pathLossDb);
 
     NS_LOG_DEBUG("Tx power in dBm:" << WToDbm(Integral(*convertedTxPsd)));
@@ -740,12 +815,12 @@ NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherD
     NS_LOG_DEBUG("RX power in dBm after pathloss:" << WToDbm(Integral(*(rxParams->psd))));
 
     // Now we call spectrum model, which in this keys add a beamforming gain
-    rxParams =
-        tempPropModels.remSpectrumLossModelCopy->DoCalcRxPowerSpectralDensity(rxParams,
-                                                                              device.mob,
-                                                                              otherDevice.mob,
-                                                                              device.antenna,
-                                                                              otherDevice.antenna);
+    rxParams = propagationModels.remSpectrumLossModelCopy->DoCalcRxPowerSpectralDensity(
+        rxParams,
+        device.mob,
+        otherDevice.mob,
+        device.antenna,
+        otherDevice.antenna);
 
     NS_LOG_DEBUG("RX power in dBm after fading: " << WToDbm(Integral(*(rxParams->psd))));
 
@@ -758,8 +833,7 @@ NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<Ptr<SpectrumValue>>& va
     // TODO add this abort, if necessary add include for abort.h
     NS_ABORT_MSG_IF(values.empty(), "Must provide a list of values.");
 
-    Ptr<SpectrumValue> maxValue = Create<SpectrumValue>(m_rrd.spectrumModel);
-    *maxValue = **(values.begin());
+    Ptr<SpectrumValue> maxValue = (*values.begin())->Copy();
 
     for (const auto& value : values)
     {
@@ -772,18 +846,19 @@ NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<Ptr<SpectrumValue>>& va
 }
 
 double
-NrRadioEnvironmentMapHelper::CalculateMaxSnr(
-    const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
+NrRadioEnvironmentMapHelper::CalculateMaxSnr(const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+                                             const Ptr<const SpectrumValue>& noisePsd) const
 {
     Ptr<SpectrumValue> maxSnr = GetMaxValue(receivedPowerList);
-    SpectrumValue snr = (*maxSnr) / (*m_noisePsd);
+    SpectrumValue snr = (*maxSnr) / (*noisePsd);
     return RatioToDb(Sum(snr) / snr.GetSpectrumModel()->GetNumBands());
 }
 
 double
-NrRadioEnvironmentMapHelper::CalculateSnr(const Ptr<SpectrumValue>& usefulSignal) const
+NrRadioEnvironmentMapHelper::CalculateSnr(const Ptr<SpectrumValue>& usefulSignal,
+                                          const Ptr<const SpectrumValue>& noisePsd) const
 {
-    SpectrumValue snr = (*usefulSignal) / (*m_noisePsd);
+    SpectrumValue snr = (*usefulSignal) / (*noisePsd);
 
     return RatioToDb(Sum(snr) / snr.GetSpectrumModel()->GetNumBands());
 }
@@ -791,17 +866,18 @@ NrRadioEnvironmentMapHelper::CalculateSnr(const Ptr<SpectrumValue>& usefulSignal
 double
 NrRadioEnvironmentMapHelper::CalculateSinr(
     const Ptr<SpectrumValue>& usefulSignal,
-    const std::list<Ptr<SpectrumValue>>& interferenceSignals) const
+    const std::list<Ptr<SpectrumValue>>& interferenceSignals,
+    const Ptr<const SpectrumValue>& noisePsd) const
 {
     Ptr<SpectrumValue> interferencePsd = nullptr;
 
     if (interferenceSignals.empty())
     {
-        return CalculateSnr(usefulSignal);
+        return CalculateSnr(usefulSignal, noisePsd);
     }
     else
     {
-        interferencePsd = Create<SpectrumValue>(m_rrd.spectrumModel);
+        interferencePsd = Create<SpectrumValue>(noisePsd->GetSpectrumModel());
     }
 
     // sum all interfering signals
@@ -811,7 +887,7 @@ NrRadioEnvironmentMapHelper::CalculateSinr(
     }
     // calculate sinr
 
-    SpectrumValue sinr = (*usefulSignal) / (*interferencePsd + *m_noisePsd);
+    SpectrumValue sinr = (*usefulSignal) / (*interferencePsd + *noisePsd);
 
     // calculate average sinr over RBs, convert it from linear to dB units, and return it
     return RatioToDb(Sum(sinr) / sinr.GetSpectrumModel()->GetNumBands());
@@ -832,7 +908,7 @@ NrRadioEnvironmentMapHelper::CalculateSir(
     }
     else
     {
-        interferencePsd = Create<SpectrumValue>(m_rrd.spectrumModel);
+        interferencePsd = Create<SpectrumValue>(usefulSignal->GetSpectrumModel());
     }
 
     // sum all interfering signals
@@ -850,7 +926,8 @@ NrRadioEnvironmentMapHelper::CalculateSir(
 
 double
 NrRadioEnvironmentMapHelper::CalculateMaxSinr(
-    const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
+    const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+    const Ptr<const SpectrumValue>& noisePsd) const
 {
     // we calculate sinr considering for each RTD as if it would be TX device, and the rest of RTDs
     // interferers
@@ -871,7 +948,7 @@ NrRadioEnvironmentMapHelper::CalculateMaxSinr(
 
         interferenceSignals.insert(interferenceSignals.end(), ++tempit, receivedPowerList.end());
         NS_ASSERT(interferenceSignals.size() == receivedPowerList.size() - 1);
-        sinrList.push_back(CalculateSinr(*it, interferenceSignals));
+        sinrList.push_back(CalculateSinr(*it, interferenceSignals, noisePsd));
     }
     return GetMaxValue(sinrList);
 }
@@ -908,72 +985,59 @@ void
 NrRadioEnvironmentMapHelper::CalcBeamShapeRemMap()
 {
     NS_LOG_FUNCTION(this);
+    CalcRemMap(&NrRadioEnvironmentMapHelper::CalcBeamShapeRemPoint);
+}
 
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
-
-    for (std::list<RemPoint>::iterator itRemPoint = m_rem.begin(); itRemPoint != m_rem.end();
-         ++itRemPoint)
+void
+NrRadioEnvironmentMapHelper::CalcBeamShapeRemPoint(RemWorker& worker, RemPoint& remPoint) const
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    double sumSir = 0.0;
+    std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
+                                       // each Iteration (linear)
+    worker.rrd.mob->SetPosition(remPoint.pos);
+
+    Ptr<MobilityBuildingInfo> buildingInfo = worker.rrd.mob->GetObject<MobilityBuildingInfo>();
+    buildingInfo->MakeConsistent(worker.rrd.mob);
+    NS_ASSERT_MSG(buildingInfo, "buildingInfo is null");
+
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        double sumSir = 0.0;
-        std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
-                                           // each Iteration (linear)
-        m_rrd.mob->SetPosition(itRemPoint->pos);
-
-        Ptr<MobilityBuildingInfo> buildingInfo = m_rrd.mob->GetObject<MobilityBuildingInfo>();
-        buildingInfo->MakeConsistent(m_rrd.mob);
-        NS_ASSERT_MSG(buildingInfo, "buildingInfo is null");
-
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
-        {
-            std::list<Ptr<SpectrumValue>>
-                receivedPowerList; // RTD node id, rxPsd of the signal coming from that node
+        std::list<Ptr<SpectrumValue>>
+            receivedPowerList; // RTD node id, rxPsd of the signal coming from that node
 
-            for (auto& itRtd : m_remDev)
-            {
-                // calculate received power from the current RTD device
-                receivedPowerList.push_back(CalcRxPsdValue(itRtd, m_rrd));
-            } // end for std::list<RemDev>::iterator  (RTDs)
-
-            sumSnr += CalculateMaxSnr(receivedPowerList);
-            sumSinr += CalculateMaxSinr(receivedPowerList);
-            sumSir += CalculateMaxSir(receivedPowerList);
-
-            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
-            // Iteration (linear)
-            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(receivedPowerList));
-
-            receivedPowerList.clear();
-        } // end for m_numOfIterationsToAverage  (Average)
-
-        // Sum the rxPower for all the Iterations (linear)
-        double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
-
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
-        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
-        itRemPoint->avRxPowerDbm =
-            WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
-
-        NS_LOG_INFO("Avg snr value saved:" << itRemPoint->avgSnrDb);
-        NS_LOG_INFO("Avg sinr value saved:" << itRemPoint->avgSinrDb);
-        NS_LOG_INFO("Avg ipsd value saved (dBm):" << itRemPoint->avRxPowerDbm);
-
-        if (++remPointCounter == remSizeNextReport)
+        for (auto& itRtd : worker.rtds)
         {
-            PrintProgressReport(&remSizeNextReport);
-        }
-
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
-
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+            // calculate received power from the current RTD device
+            receivedPowerList.push_back(
+                CalcRxPsdValue(worker.propagationModels, itRtd, worker.rrd));
+        } // end for std::list<RemDev>::iterator  (RTDs)
+
+        sumSnr += CalculateMaxSnr(receivedPowerList, worker.noisePsd);
+        sumSinr += CalculateMaxSinr(receivedPowerList, worker.noisePsd);
+        sumSir += CalculateMaxSir(receivedPowerList);
+
+        // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
+        // Iteration (linear)
+        rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(receivedPowerList));
+
+        receivedPowerList.clear();
+    } // end for m_numOfIterationsToAverage  (Average)
+
+    // Sum the rxPower for all the Iterations (linear)
+    double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
+    // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
+    remPoint.avRxPowerDbm = WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+
+    NS_LOG_INFO("Avg snr value saved:" << remPoint.avgSnrDb);
+    NS_LOG_INFO("Avg sinr value saved:" << remPoint.avgSinrDb);
+    NS_LOG_INFO("Avg ipsd value saved (dBm):" << remPoint.avRxPowerDbm);
 }
 
 double
@@ -997,10 +1061,14 @@ NrRadioEnvironmentMapHelper::GetMaxValue(const std::list<double>& listOfValues)
 
 double
 NrRadioEnvironmentMapHelper::CalculateAggregatedIpsd(
-    const std::list<Ptr<SpectrumValue>>& receivedSignals)
+    const std::list<Ptr<SpectrumValue>>& receivedSignals) const
 {
+    NS_ABORT_MSG_IF(receivedSignals.empty(),
+                    "CalculateAggregatedIpsd should not be called "
+                    "with an empty list.");
+
     Ptr<SpectrumValue> sumRxPowers = nullptr;
-    sumRxPowers = Create<SpectrumValue>(m_rrd.spectrumModel);
+    sumRxPowers = Create<SpectrumValue>((*receivedSignals.begin())->GetSpectrumModel());
 
     // sum the received power of all the rtds
     for (auto rxPowersIt : receivedSignals)
@@ -1014,7 +1082,7 @@ NrRadioEnvironmentMapHelper::CalculateAggregatedIpsd(
 }
 
 double
-NrRadioEnvironmentMapHelper::SumListElements(const std::list<double>& listOfValues)
+NrRadioEnvironmentMapHelper::SumListElements(const std::list<double>& listOfValues) const
 {
     NS_ABORT_MSG_IF(listOfValues.empty(),
                     "SumListElements should not be called "
@@ -1033,233 +1101,278 @@ void
 NrRadioEnvironmentMapHelper::CalcCoverageAreaRemMap()
 {
     NS_LOG_FUNCTION(this);
-    uint16_t calcRxPsdCounter = 0;
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
+    CalcRemMap(&NrRadioEnvironmentMapHelper::CalcCoverageAreaRemPoint);
+}
 
-    for (std::list<RemPoint>::iterator itRemPoint = m_rem.begin(); itRemPoint != m_rem.end();
-         ++itRemPoint)
+void
+NrRadioEnvironmentMapHelper::CalcCoverageAreaRemPoint(RemWorker& worker, RemPoint& remPoint) const
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    worker.rrd.mob->SetPosition(remPoint.pos);
+
+    // all RTDs should point toward that RemPoint with DirectPah beam, this is definition of
+    // worst-case scenario
+    for (auto& itRtd : worker.rtds)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        m_rrd.mob->SetPosition(itRemPoint->pos);
-
-        // all RTDs should point toward that RemPoint with DirectPah beam, this is definition of
-        // worst-case scenario
-        for (auto& itRtd : m_remDev)
-        {
-            ConfigureDirectPathBfv(itRtd, m_rrd, itRtd.antenna);
-        }
+        ConfigureDirectPathBfv(itRtd, worker.rrd, itRtd.antenna);
+    }
 
-        std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
-                                           // each Iteration (linear)
+    std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
+                                       // each Iteration (linear)
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
-        {
-            std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
-            std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
+        std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
 
-            std::list<Ptr<SpectrumValue>> rxPsdsList; // vector in which we will save the sum of
-                                                      // rxPowers per remPoint (linear)
+        std::list<Ptr<SpectrumValue>> rxPsdsList; // vector in which we will save the sum of
+                                                  // rxPowers per remPoint (linear)
 
-            // For each beam configuration at RemPoint/RRD we should calculate SINR, there are as
-            // many beam configurations at RemPoint as many RTDs
-            for (std::list<RemDevice>::iterator itRtdBeam = m_remDev.begin();
-                 itRtdBeam != m_remDev.end();
-                 ++itRtdBeam)
+        // For each beam configuration at RemPoint/RRD we should calculate SINR, there are as
+        // many beam configurations at RemPoint as many RTDs
+        for (std::list<RemDevice>::iterator itRtdBeam = worker.rtds.begin();
+             itRtdBeam != worker.rtds.end();
+             ++itRtdBeam)
+        {
+            // configure RRD beam toward RTD
+            ConfigureDirectPathBfv(worker.rrd, *itRtdBeam, worker.rrd.antenna);
+
+            // Calculate the received power from this RTD for this RemPoint
+            Ptr<SpectrumValue> receivedPowerFromRtd =
+                CalcRxPsdValue(worker.propagationModels, *itRtdBeam, worker.rrd);
+            // and put it to the list of the received powers for this RemPoint (to sum all
+            // later)
+            rxPsdsList.push_back(receivedPowerFromRtd);
+
+            NS_LOG_DEBUG("beam node: " << itRtdBeam->node->GetId()
+                                       << " is Rxed in RemPoint with Rx Power in W: "
+                                       << (Integral(*receivedPowerFromRtd)));
+            NS_LOG_DEBUG("RxPower in dBm: " << WToDbm(Integral(*receivedPowerFromRtd)));
+
+            std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
+            Ptr<SpectrumValue> usefulSignalRxPsd;
+
+            // For this configuration of beam at RRD, we need to calculate RX PSD,
+            // and in order to be able to calculate SINR for that beam,
+            // we need to calculate received PSD for each RTD using this beam at RRD
+            for (auto& itRtdCalc : worker.rtds)
             {
-                // configure RRD beam toward RTD
-                ConfigureDirectPathBfv(m_rrd, *itRtdBeam, m_rrd.antenna);
-
-                // Calculate the received power from this RTD for this RemPoint
-                Ptr<SpectrumValue> receivedPowerFromRtd = CalcRxPsdValue(*itRtdBeam, m_rrd);
-                // and put it to the list of the received powers for this RemPoint (to sum all
-                // later)
-                rxPsdsList.push_back(receivedPowerFromRtd);
-
-                NS_LOG_DEBUG("beam node: " << itRtdBeam->dev->GetNode()->GetId()
-                                           << " is Rxed in RemPoint with Rx Power in W: "
-                                           << (Integral(*receivedPowerFromRtd)));
-                NS_LOG_DEBUG("RxPower in dBm: " << WToDbm(Integral(*receivedPowerFromRtd)));
-
-                std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
-                Ptr<SpectrumValue> usefulSignalRxPsd;
-
-                // For this configuration of beam at RRD, we need to calculate RX PSD,
-                // and in order to be able to calculate SINR for that beam,
-                // we need to calculate received PSD for each RTD using this beam at RRD
-                for (auto& itRtdCalc : m_remDev)
-                {
-                    // increase counter de calcRXPsd calls
-                    calcRxPsdCounter++;
-                    // calculate received power from the current RTD device
-                    Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(itRtdCalc, m_rrd);
+                // calculate received power from the current RTD device
+                Ptr<SpectrumValue> receivedPower =
+                    CalcRxPsdValue(worker.propagationModels, itRtdCalc, worker.rrd);
 
-                    // is this received power useful signal (from RTD for which I configured my
-                    // beam) or is interference signal
+                // is this received power useful signal (from RTD for which I configured my
+                // beam) or is interference signal
 
-                    if (itRtdBeam->dev->GetNode()->GetId() == itRtdCalc.dev->GetNode()->GetId())
-                    {
-                        if (usefulSignalRxPsd != nullptr)
-                        {
-                            NS_FATAL_ERROR("Already assigned usefulSignal!");
-                        }
-                        usefulSignalRxPsd = receivedPower;
-                    }
-                    else
+                if (itRtdBeam->node->GetId() == itRtdCalc.node->GetId())
+                {
+                    if (usefulSignalRxPsd != nullptr)
                     {
-                        interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                        NS_FATAL_ERROR("Already assigned usefulSignal!");
                     }
+                    usefulSignalRxPsd = receivedPower;
+                }
+                else
+                {
+                    interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                }
 
-                } // end for std::list<RemDev>::iterator itRtdCalc (RTDs)
-
-                sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
-                snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
-
-                NS_LOG_INFO("Done:" << (double)calcRxPsdCounter /
-                                           (m_rem.size() * m_numOfIterationsToAverage *
-                                            m_remDev.size() * m_remDev.size()) *
-                                           100
-                                    << " %."); // how many times will be called CalcRxPsdValues
-
-            } // end for std::list<RemDev>::iterator itRtdBeam (RTDs)
-
-            sumSnr += GetMaxValue(snrsPerBeam);
-            sumSinr += GetMaxValue(sinrsPerBeam);
+            } // end for std::list<RemDev>::iterator itRtdCalc (RTDs)
 
-            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
-            // Iteration (linear)
-            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(rxPsdsList));
+            sinrsPerBeam.push_back(
+                CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds, worker.noisePsd));
+            snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd, worker.noisePsd));
 
-        } // end for m_numOfIterationsToAverage  (Average)
+        } // end for std::list<RemDev>::iterator itRtdBeam (RTDs)
 
-        // Sum the rxPower for all the Iterations (linear)
-        double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+        sumSnr += GetMaxValue(snrsPerBeam);
+        sumSinr += GetMaxValue(sinrsPerBeam);
 
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
-        itRemPoint->avRxPowerDbm =
-            WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+        // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
+        // Iteration (linear)
+        rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(rxPsdsList));
 
-        if (++remPointCounter == remSizeNextReport)
-        {
-            PrintProgressReport(&remSizeNextReport);
-        }
+    } // end for m_numOfIterationsToAverage  (Average)
 
-        NS_LOG_DEBUG("itRemPoint->avRxPowerDb  in dB: " << itRemPoint->avRxPowerDbm);
+    // Sum the rxPower for all the Iterations (linear)
+    double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
+    remPoint.avRxPowerDbm = WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
 
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+    NS_LOG_DEBUG("remPoint.avRxPowerDb  in dB: " << remPoint.avRxPowerDbm);
 }
 
 void
-NrRadioEnvironmentMapHelper::PrintProgressReport(uint32_t* remSizeNextReport)
+NrRadioEnvironmentMapHelper::PrintProgressReport(size_t firstTile,
+                                                 size_t lastTile,
+                                                 size_t numTiles,
+                                                 size_t remPointsDone) const
 {
     auto remTimeUpToNow = std::chrono::system_clock::now();
     std::chrono::duration<double> remElapsedSecondsUpToNow = remTimeUpToNow - m_remStartTime;
     double minutesUpToNow = ((double)remElapsedSecondsUpToNow.count()) / 60;
     double minutesLeftEstimated =
-        ((double)(minutesUpToNow) / *remSizeNextReport) * ((m_rem.size() - *remSizeNextReport));
-    std::cout << "\n REM done:" << ceil(((double)*remSizeNextReport / m_rem.size()) * 100) << " %."
+        ((double)(minutesUpToNow) / remPointsDone) * ((m_rem.size() - remPointsDone));
+    std::cout << "\n REM tiles " << firstTile + 1 << "-" << lastTile << " of " << numTiles
+              << " done:" << ceil(((double)remPointsDone / m_rem.size()) * 100) << " %."
               << " Minutes up to now: " << minutesUpToNow
-              << ". Minutes left estimated:" << minutesLeftEstimated
-              << "."; // how many times will be called CalcRxPsdValues
-    // we want progress report for 1%, 10%, 20%, 30%, and so on
-    if (*remSizeNextReport < m_rem.size() / 10)
-    {
-        *remSizeNextReport = m_rem.size() / 10;
-    }
-    else
-    {
-        *remSizeNextReport += m_rem.size() / 10;
-    }
+              << ". Minutes left estimated:" << minutesLeftEstimated << ".";
 }
 
 void
 NrRadioEnvironmentMapHelper::CalcUeCoverageRemMap()
 {
     NS_LOG_FUNCTION(this);
+    CalcRemMap(&NrRadioEnvironmentMapHelper::CalcUeCoverageRemPoint);
+}
 
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
+void
+NrRadioEnvironmentMapHelper::CalcUeCoverageRemPoint(RemWorker& worker, RemPoint& remPoint) const
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    worker.rrd.mob->SetPosition(remPoint.pos);
 
-    for (auto& itRemPoint : m_rem)
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        m_rrd.mob->SetPosition(itRemPoint.pos);
+        std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
+        std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+        //"Associate" UE (RemPoint) with this RTD
+        for (auto& itRtdAssociated : worker.rtds)
         {
-            std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
-            std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+            // configure RRD (RemPoint) beam toward RTD (itRtdAssociated)
+            ConfigureDirectPathBfv(worker.rrd, itRtdAssociated, worker.rrd.antenna);
+            // configure RTD (itRtdAssociated) beam toward RRD (RemPoint)
+            ConfigureDirectPathBfv(itRtdAssociated, worker.rrd, itRtdAssociated.antenna);
+
+            std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
+            Ptr<SpectrumValue> usefulSignalRxPsd;
 
-            //"Associate" UE (RemPoint) with this RTD
-            for (auto& itRtdAssociated : m_remDev)
+            for (auto& itRtdInterferer : worker.rtds)
             {
-                // configure RRD (RemPoint) beam toward RTD (itRtdAssociated)
-                ConfigureDirectPathBfv(m_rrd, itRtdAssociated, m_rrd.antenna);
-                // configure RTD (itRtdAssociated) beam toward RRD (RemPoint)
-                ConfigureDirectPathBfv(itRtdAssociated, m_rrd, itRtdAssociated.antenna);
+                if (itRtdAssociated.node->GetId() != itRtdInterferer.node->GetId())
+                {
+                    // configure RTD (itRtdInterferer) beam toward RTD (itRtdAssociated)
+                    ConfigureDirectPathBfv(itRtdInterferer,
+                                           itRtdAssociated,
+                                           itRtdInterferer.antenna);
 
-                std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
-                Ptr<SpectrumValue> usefulSignalRxPsd;
+                    // calculate received power (interference) from the current RTD device
+                    Ptr<SpectrumValue> receivedPower =
+                        CalcRxPsdValue(worker.propagationModels, itRtdInterferer, itRtdAssociated);
 
-                for (auto& itRtdInterferer : m_remDev)
+                    interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                }
+                else
                 {
-                    if (itRtdAssociated.dev->GetNode()->GetId() !=
-                        itRtdInterferer.dev->GetNode()->GetId())
+                    // calculate received power (useful Signal) from the current RRD device
+                    Ptr<SpectrumValue> receivedPower =
+                        CalcRxPsdValue(worker.propagationModels, worker.rrd, itRtdAssociated);
+                    if (usefulSignalRxPsd != nullptr)
                     {
-                        // configure RTD (itRtdInterferer) beam toward RTD (itRtdAssociated)
-                        ConfigureDirectPathBfv(itRtdInterferer,
-                                               itRtdAssociated,
-                                               itRtdInterferer.antenna);
+                        NS_FATAL_ERROR("Already assigned usefulSignal!");
+                    }
+                    usefulSignalRxPsd = receivedPower;
+                }
 
-                        // calculate received power (interference) from the current RTD device
-                        Ptr<SpectrumValue> receivedPower =
-                            CalcRxPsdValue(itRtdInterferer, itRtdAssociated);
+            } // end for std::list<RemDev>::iterator itRtdInterferer (RTD)
 
-                        interferenceSignalsRxPsds.push_back(receivedPower); // interference
-                    }
-                    else
-                    {
-                        // calculate received power (useful Signal) from the current RRD device
-                        Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(m_rrd, itRtdAssociated);
-                        if (usefulSignalRxPsd != nullptr)
-                        {
-                            NS_FATAL_ERROR("Already assigned usefulSignal!");
-                        }
-                        usefulSignalRxPsd = receivedPower;
-                    }
+            sinrsPerBeam.push_back(
+                CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds, worker.noisePsd));
+            snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd, worker.noisePsd));
+
+        } // end for std::list<RemDev>::iterator itRtdAssociated (RTD)
+
+        sumSnr += GetMaxValue(snrsPerBeam);
+        sumSinr += GetMaxValue(sinrsPerBeam);
+
+    } // end for m_numOfIterationsToAverage  (Average)
+
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+}
+
+void
+NrRadioEnvironmentMapHelper::CalcRemMap(CalcRemPointFunction calcRemPoint)
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t numThreads = std::max<uint32_t>(m_numThreads, 1);
+    if (numThreads > 1 && BuildingList::GetNBuildings() > 0)
+    {
+        // the building information of the mobility models refers to the shared buildings
+        NS_LOG_WARN("There are buildings: the REM points are computed by a single thread.");
+        numThreads = 1;
+    }
+    Ptr<ThreadPool> threadPool = numThreads > 1 ? Create<ThreadPool>(numThreads) : nullptr;
 
-                } // end for std::list<RemDev>::iterator itRtdInterferer (RTD)
+    // the copies are created here, since creating objects is not thread-safe
+    std::vector<RemWorker> workers;
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        workers.push_back(CreateRemWorker());
+    }
+    int64_t streamsPerTile = AssignStreams(workers.front().propagationModels, m_firstStream);
 
-                sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
-                snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
+    std::ostringstream oss;
+    oss << "nr-rem-" << m_simTag.c_str() << ".out";
 
-            } // end for std::list<RemDev>::iterator itRtdAssociated (RTD)
+    std::ofstream outFile;
+    std::string outputFile = oss.str();
+    outFile.open(outputFile.c_str());
 
-            sumSnr += GetMaxValue(snrsPerBeam);
-            sumSinr += GetMaxValue(sinrsPerBeam);
+    if (!outFile.is_open())
+    {
+        NS_FATAL_ERROR("Can't open file " << (outputFile));
+        return;
+    }
 
-        } // end for m_numOfIterationsToAverage  (Average)
+    size_t tileSize = std::max<uint32_t>(m_tileSize, 1);
+    size_t numTiles = (m_rem.size() + tileSize - 1) / tileSize;
+    for (size_t firstTile = 0; firstTile < numTiles; firstTile += numThreads)
+    {
+        size_t lastTile = std::min<size_t>(firstTile + numThreads, numTiles);
 
-        itRemPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+        // the random variables of a tile do not depend on the thread computing it
+        for (size_t tile = firstTile; tile < lastTile; ++tile)
+        {
+            AssignStreams(workers[tile - firstTile].propagationModels,
+                          m_firstStream + static_cast<int64_t>(tile) * streamsPerTile);
+        }
 
-        if (++remPointCounter == remSizeNextReport)
+        auto calcTile = [this, calcRemPoint, &workers, firstTile, tileSize](size_t i) {
+            size_t first = (firstTile + i) * tileSize;
+            size_t last = std::min(first + tileSize, m_rem.size());
+            for (size_t point = first; point < last; ++point)
+            {
+                (this->*calcRemPoint)(workers[i], m_rem[point]);
+            }
+        };
+        if (threadPool)
+        {
+            threadPool->ParallelFor(lastTile - firstTile, calcTile);
+        }
+        else
         {
-            PrintProgressReport(&remSizeNextReport);
+            for (size_t i = 0; i < lastTile - firstTile; ++i)
+            {
+                calcTile(i);
+            }
         }
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+        size_t remPointsDone = std::min(lastTile * tileSize, m_rem.size());
+        PrintRemToFile(outFile, firstTile * tileSize, remPointsDone);
+        PrintProgressReport(firstTile, lastTile, numTiles, remPointsDone);
+    }
+
+    outFile.close();
 
     auto remEndTime = std::chrono::system_clock::now();
     std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
@@ -1267,6 +1380,68 @@ NrRadioEnvironmentMapHelper::CalcUeCoverageRemMap()
                 << remElapsedSeconds.count() / 60 << " minutes.");
 }
 
+NrRadioEnvironmentMapHelper::RemWorker
+NrRadioEnvironmentMapHelper::CreateRemWorker() const
+{
+    NS_LOG_FUNCTION(this);
+
+    // copies of the spectrum models, shared by the copies of the devices
+    std::map<uint32_t, Ptr<const SpectrumModel>> spectrumModels;
+    auto copySpectrumModel = [&spectrumModels](const Ptr<const SpectrumModel>& model) {
+        auto it = spectrumModels.find(model->GetUid());
+        if (it == spectrumModels.end())
+        {
+            Bands bands(model->Begin(), model->End());
+            it = spectrumModels.emplace(model->GetUid(), Create<SpectrumModel>(bands)).first;
+        }
+        return it->second;
+    };
+
+    auto copyDevice = [&copySpectrumModel](const RemDevice& device, RemDevice& copy) {
+        copy.mob->SetPosition(device.mob->GetPosition());
+        Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo>();
+        copy.mob->AggregateObject(buildingInfo);
+        copy.antenna = Copy(device.antenna);
+        copy.txPower = device.txPower;
+        copy.bandwidth = device.bandwidth;
+        copy.frequency = device.frequency;
+        copy.numerology = device.numerology;
+        copy.spectrumModel = copySpectrumModel(device.spectrumModel);
+    };
+
+    RemWorker worker;
+    copyDevice(m_rrd, worker.rrd);
+    for (const auto& rtd : m_remDev)
+    {
+        worker.rtds.emplace_back();
+        copyDevice(rtd, worker.rtds.back());
+    }
+    worker.noisePsd = NrSpectrumValueHelper::CreateNoisePowerSpectralDensity(
+        m_rrdPhy->GetNoiseFigure(),
+        worker.rrd.spectrumModel);
+    worker.propagationModels = CreateTemporalPropagationModels();
+    return worker;
+}
+
+int64_t
+NrRadioEnvironmentMapHelper::AssignStreams(const PropagationModels& propagationModels,
+                                           int64_t stream) const
+{
+    int64_t currentStream = stream;
+    currentStream += propagationModels.remChannelConditionModelCopy->AssignStreams(currentStream);
+    currentStream += propagationModels.remPropagationLossModelCopy->AssignStreams(currentStream);
+    if (propagationModels.remSpectrumLossModelCopy)
+    {
+        Ptr<ThreeGppChannelModel> channelModel = DynamicCast<ThreeGppChannelModel>(
+            propagationModels.remSpectrumLossModelCopy->GetChannelModel());
+        if (channelModel)
+        {
+            currentStream += channelModel->AssignStreams(currentStream);
+        }
+    }
+    return currentStream - stream;
+}
+
 NrRadioEnvironmentMapHelper::PropagationModels
 NrRadioEnvironmentMapHelper::CreateTemporalPropagationModels() const
 {
@@ -1276,6 +1451,7 @@ NrRadioEnvironmentMapHelper::CreateTemporalPropagationModels() const
     // create rem copy of channel condition
     Ptr<ChannelConditionModel> condModelCopy =
         m_channelConditionModelFactory.Create<ChannelConditionModel>();
+    propModels.remChannelConditionModelCopy = condModelCopy;
 
     // create rem copy of propagation model
     ObjectFactory propLossModelFactory = ConfigureObjectFactory(m_propagationLossModel);
@@ -1373,34 +1549,17 @@ NrRadioEnvironmentMapHelper::PrintGnuplottableBuildingListToFile(const std::stri
 }
 
 void
-NrRadioEnvironmentMapHelper::PrintRemToFile()
+NrRadioEnvironmentMapHelper::PrintRemToFile(std::ofstream& outFile, size_t first, size_t last) const
 {
     NS_LOG_FUNCTION(this);
 
-    std::ostringstream oss;
-    oss << "nr-rem-" << m_simTag.c_str() << ".out";
-
-    std::ofstream outFile;
-    std::string outputFile = oss.str();
-    outFile.open(outputFile.c_str());
-
-    if (!outFile.is_open())
-    {
-        NS_FATAL_ERROR("Can't open file " << (outputFile));
-        return;
-    }
-
-    for (auto& it : m_rem)
+    for (size_t i = first; i < last; ++i)
     {
+        const auto& it = m_rem[i];
         outFile << it.pos.x << "\t" << it.pos.y << "\t" << it.pos.z << "\t" << it.avgSnrDb << "\t"
                 << it.avgSinrDb << "\t" << it.avRxPowerDbm << "\t" << it.avgSirDb << "\t"
                 << std::endl;
     }
-
-    outFile.close();
-
-    CreateCustomGnuplotFile();
-    Finalize();
 }
 
 void
@@ -16,6 +16,7 @@
 
 #include <chrono>
 #include <fstream>
+#include <vector>
 
 namespace ns3
 {
@@ -59,6 +60,18 @@ class UniformPlanarArray;
  * N iterations (specified by the user) in order to consider the randomness of
  * the channel
  *
+ * The REM points are independent: they are computed by tiles of TileSize
+ * consecutive points (along the y axis, then the x axis), on NumThreads threads.
+ * Each thread uses its own copies of the devices and of the propagation models,
+ * created before the computation, and the random variables of the models are
+ * assigned the same streams for a tile whatever the thread computing it, so that
+ * the map does not depend on the number of threads. The streams of the tiles are
+ * consecutive blocks from the FirstStream attribute, which should be set past the
+ * streams assigned to the simulation. The rows of the REM file are written, and
+ * the progress reported, as the tiles are completed. The buildings are shared by
+ * all the REM points: when there are buildings, the map is computed by a single
+ * thread.
+ *
  * For the CoverageArea REM generation the user can include the following code
  * in the desired example script:
  *
@@ -89,6 +102,8 @@ nr-rem-SimTag-plot-rem.gnuplot \endcode
 
 class NrRadioEnvironmentMapHelper : public Object
 {
+    friend class NrRemThreadsTestCase;
+
   public:
     enum RemMode
     {
@@ -183,6 +198,26 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void SetInstallationDelay(const Time& installationDelay);
 
+    /**
+     * \brief Sets the number of threads computing the REM points
+     * \param numThreads the number of threads, 0 or 1 to compute them in the
+     * simulation thread
+     */
+    void SetNumThreads(uint32_t numThreads);
+
+    /**
+     * \brief Sets the number of consecutive REM points of a tile
+     * \param tileSize the number of REM points of a tile
+     */
+    void SetTileSize(uint32_t tileSize);
+
+    /**
+     * \brief Sets the first stream number of the random variables of the REM points
+     * \param stream the first stream number, the tiles use consecutive blocks of
+     * streams from it
+     */
+    void SetFirstStream(int64_t stream);
+
     /**
      * \brief Get the type of REM Map to be generated
      * \return The type of the map (BeamShape/CoverageArea/UeCoverage)
@@ -226,6 +261,21 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     double GetZ() const;
 
+    /**
+     * \return Gets the number of threads computing the REM points
+     */
+    uint32_t GetNumThreads() const;
+
+    /**
+     * \return Gets the number of consecutive REM points of a tile
+     */
+    uint32_t GetTileSize() const;
+
+    /**
+     * \return Gets the first stream number of the random variables of the REM points
+     */
+    int64_t GetFirstStream() const;
+
     /**
      * \brief Convert from Watts to dBm.
      * \param w the power in Watts
@@ -318,10 +368,31 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     struct PropagationModels
     {
+        Ptr<ChannelConditionModel> remChannelConditionModelCopy;
         Ptr<ThreeGppPropagationLossModel> remPropagationLossModelCopy;
         Ptr<ThreeGppSpectrumPropagationLossModel> remSpectrumLossModelCopy;
     };
 
+    /**
+     * \brief This struct includes the copies of the devices and of the
+     * propagation models used by a thread to compute its REM points. The
+     * objects of the REM are reference counted without synchronization,
+     * hence each thread only uses its own copies.
+     */
+    struct RemWorker
+    {
+        RemDevice rrd;                       //!< Copy of the RRD
+        std::list<RemDevice> rtds;           //!< Copies of the RTDs, in the order of m_remDev
+        Ptr<const SpectrumValue> noisePsd;   //!< Noise PSD, in the spectrum model of rrd
+        PropagationModels propagationModels; //!< Propagation models of the thread
+    };
+
+    /**
+     * \brief Function computing the SNR/SINR/IPSD values of a REM point
+     */
+    typedef void (NrRadioEnvironmentMapHelper::*CalcRemPointFunction)(RemWorker&,
+                                                                      RemPoint&) const;
+
     /**
      * \brief This method creates the list of Rem Points (coordinates) based on
      * the min/max coprdinates and the resolution defined by the user
@@ -364,6 +435,13 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void CalcBeamShapeRemMap();
 
+    /**
+     * \brief Calculates the SNR/SINR/IPSD values of a REM point of a BeamShape map
+     * \param worker the copies of the devices and propagation models to use
+     * \param remPoint the REM point
+     */
+    void CalcBeamShapeRemPoint(RemWorker& worker, RemPoint& remPoint) const;
+
     /**
      * \brief This function generates a CoverageArea map. In this case, all the
      * antennas of the rtds are set to point towards the rem point and the antenna
@@ -371,6 +449,13 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void CalcCoverageAreaRemMap();
 
+    /**
+     * \brief Calculates the SNR/SINR/IPSD values of a REM point of a CoverageArea map
+     * \param worker the copies of the devices and propagation models to use
+     * \param remPoint the REM point
+     */
+    void CalcCoverageAreaRemPoint(RemWorker& worker, RemPoint& remPoint) const;
+
     /**
      * \brief This function generates a Ue Coverage map that depicts the SNR of
      * this UE with respect to its UL transmission towards the gNB form various
@@ -381,17 +466,54 @@ class NrRadioEnvironmentMapHelper : public Object
     void CalcUeCoverageRemMap();
 
     /**
-     * \brief This method calculates the PSD
+     * \brief Calculates the SNR/SINR values of a REM point of a UeCoverage map
+     * \param worker the copies of the devices and propagation models to use
+     * \param remPoint the REM point
+     */
+    void CalcUeCoverageRemPoint(RemWorker& worker, RemPoint& remPoint) const;
+
+    /**
+     * \brief Calculates the values of all the REM points, by tiles computed in
+     * parallel, and prints them to the REM file as the tiles are completed
+     * \param calcRemPoint the function calculating the values of a REM point
+     */
+    void CalcRemMap(CalcRemPointFunction calcRemPoint);
+
+    /**
+     * \brief Creates the copies of the devices and of the propagation models
+     * used by a thread
+     * \return the copies
+     */
+    RemWorker CreateRemWorker() const;
+
+    /**
+     * \brief Assigns the streams of the random variables of propagation models
+     * \param propagationModels the propagation models
+     * \param stream the first stream number
+     * \return the number of streams assigned
+     */
+    int64_t AssignStreams(const PropagationModels& propagationModels, int64_t stream) const;
+
+    /**
+     * \brief This method calculates the PSD. The channel is generated anew, as
+     * an independent realization, at each call.
+     * \param propagationModels the propagation models to use
+     * \param device the transmitting device
+     * \param otherDevice the receiving device
      * \return The PSD (spectrumValue)
      */
-    Ptr<SpectrumValue> CalcRxPsdValue(RemDevice& device, RemDevice& otherDevice) const;
+    Ptr<SpectrumValue> CalcRxPsdValue(const PropagationModels& propagationModels,
+                                      RemDevice& device,
+                                      RemDevice& otherDevice) const;
 
     /**
      * \brief This function calculates the SNR.
      * \param usefulSignal The useful Signal
+     * \param noisePsd The noise PSD
      * \return The snr
      */
-    double CalculateSnr(const Ptr<SpectrumValue>& usefulSignal) const;
+    double CalculateSnr(const Ptr<SpectrumValue>& usefulSignal,
+                        const Ptr<const SpectrumValue>& noisePsd) const;
 
     /**
      * \brief This function finds the max value in a space of frequency-dependent
@@ -405,17 +527,21 @@ class NrRadioEnvironmentMapHelper : public Object
      * \brief This function finds the max value in a space of frequency-dependent
      * values (such as PSD).
      * \param values The list of spectrumValues for which we want to find the max
+     * \param noisePsd The noise PSD
      * \return The max value (snr)
      */
-    double CalculateMaxSnr(const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
+    double CalculateMaxSnr(const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+                           const Ptr<const SpectrumValue>& noisePsd) const;
 
     /**
      * \brief This function finds the max value in a space of frequency-dependent
      * values (such as PSD).
      * \param values The list of spectrumValues for which we want to find the max
+     * \param noisePsd The noise PSD
      * \return The max value (sinr)
      */
-    double CalculateMaxSinr(const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
+    double CalculateMaxSinr(const std::list<Ptr<SpectrumValue>>& receivedPowerList,
+                            const Ptr<const SpectrumValue>& noisePsd) const;
 
     /**
      * \brief This function finds the max value in a space of frequency-dependent
@@ -430,10 +556,12 @@ class NrRadioEnvironmentMapHelper : public Object
      * values (such as PSD).
      * \param usefulSignal The spectrumValue considered as useful signal
      * \param interferenceSignals The list of spectrumValues considered as interference
+     * \param noisePsd The noise PSD
      * \return The max value (sinr)
      */
     double CalculateSinr(const Ptr<SpectrumValue>& usefulSignal,
-                         const std::list<Ptr<SpectrumValue>>& interferenceSignals) const;
+                         const std::list<Ptr<SpectrumValue>>& interferenceSignals,
+                         const Ptr<const SpectrumValue>& noisePsd) const;
 
     /**
      * \brief This function calculates the SIR for a given space of frequency-dependent
@@ -457,13 +585,14 @@ class NrRadioEnvironmentMapHelper : public Object
      * list of SpectrumValues
      * \return The integral of the sum of the elements of the list
      */
-    double CalculateAggregatedIpsd(const std::list<Ptr<SpectrumValue>>& interferenceSignals);
+    double CalculateAggregatedIpsd(
+        const std::list<Ptr<SpectrumValue>>& interferenceSignals) const;
 
     /**
      * \brief This function returns the sum of the elements of a list of double values
      * \return The sum of the elements of the list
      */
-    double SumListElements(const std::list<double>& listOfValues);
+    double SumListElements(const std::list<double>& listOfValues) const;
 
     /**
      * \brief Configures propagation loss model factories
@@ -480,14 +609,21 @@ class NrRadioEnvironmentMapHelper : public Object
     /**
      * \brief This method creates the temporal Propagation Models
      * \return The struct with the temporal propagation models (created for each
-     * rem point)
+     * thread of the rem)
      */
     PropagationModels CreateTemporalPropagationModels() const;
 
     /**
-     * \brief Prints REM generation progress report
+     * \brief Prints REM generation progress report, when tiles are completed
+     * \param firstTile the index of the first completed tile
+     * \param lastTile the index following the one of the last completed tile
+     * \param numTiles the number of tiles
+     * \param remPointsDone the number of REM points computed up to now
      */
-    void PrintProgressReport(uint32_t* remSizeNextReport);
+    void PrintProgressReport(size_t firstTile,
+                             size_t lastTile,
+                             size_t numTiles,
+                             size_t remPointsDone) const;
 
     /**
      * \brief Prints the position of the RTDs.
@@ -505,10 +641,13 @@ class NrRadioEnvironmentMapHelper : public Object
     void PrintGnuplottableBuildingListToFile(const std::string& filename);
 
     /**
-     * \brief this method goes through every Rem Point and prints the
+     * \brief this method goes through a range of Rem Points and prints the
      * calculated SNR/SINR/IPSD values.
+     * \param outFile the REM file
+     * \param first the index of the first Rem Point of the range
+     * \param last the index following the one of the last Rem Point of the range
      */
-    void PrintRemToFile();
+    void PrintRemToFile(std::ofstream& outFile, size_t first, size_t last) const;
 
     /*
      * Creates rem_plot${SimTag}.gnuplot file
@@ -534,10 +673,10 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void ConfigureDirectPathBfv(RemDevice& device,
                                 const RemDevice& otherDevice,
-                                const Ptr<const UniformPlanarArray>& antenna);
+                                const Ptr<const UniformPlanarArray>& antenna) const;
 
     std::list<RemDevice> m_remDev; ///< List of REM Transmitting Devices (RTDs).
-    std::list<RemPoint> m_rem;     ///< List of REM points.
+    std::vector<RemPoint> m_rem;   ///< List of REM points.
 
     std::chrono::system_clock::time_point
         m_remStartTime; //!< Time at which REM generation has started
@@ -557,6 +696,9 @@ class NrRadioEnvironmentMapHelper : public Object
 
     uint16_t m_numOfIterationsToAverage{1};
     Time m_installationDelay{Seconds(0)};
+    uint32_t m_numThreads{0}; ///< The `NumThreads` attribute.
+    uint32_t m_tileSize{0};   ///< The `TileSize` attribute.
+    int64_t m_firstStream{0}; ///< The `FirstStream` attribute.
 
     RemDevice m_rrd;
 
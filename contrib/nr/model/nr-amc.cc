@@ -8,14 +8,19 @@
 #include "nr-error-model.h"
 #include "nr-lte-mi-error-model.h"
 
+#include <ns3/boolean.h>
 #include <ns3/double.h>
 #include <ns3/enum.h>
+#include <ns3/hash.h>
 #include <ns3/log.h>
 #include <ns3/math.h>
 #include <ns3/nr-spectrum-value-helper.h>
 #include <ns3/object-factory.h>
 #include <ns3/uinteger.h>
 
+#include <cmath>
+#include <limits>
+
 namespace ns3
 {
 
@@ -36,6 +41,7 @@ NrAmc::SetDlMode()
 {
     NS_LOG_FUNCTION(this);
     m_emMode = NrErrorModel::DL;
+    ClearMcsCache();
 }
 
 void
@@ -43,6 +49,7 @@ NrAmc::SetUlMode()
 {
     NS_LOG_FUNCTION(this);
     m_emMode = NrErrorModel::UL;
+    ClearMcsCache();
 }
 
 TypeId
@@ -71,6 +78,39 @@ NrAmc::GetTypeId()
                           TypeIdValue(NrLteMiErrorModel::GetTypeId()),
                           MakeTypeIdAccessor(&NrAmc::SetErrorModelType, &NrAmc::GetErrorModelType),
                           MakeTypeIdChecker())
+            .AddAttribute("McsCacheSize",
+                          "Maximum number of SINR signatures whose MCS is memoized when "
+                          "AmcModel is set to ErrorModel, 0 to disable the cache",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&NrAmc::SetMcsCacheSize, &NrAmc::GetMcsCacheSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("McsCacheSinrQuantum",
+                          "Quantization step (dB) of the SINR values in the signatures of the "
+                          "MCS cache. With 0, the signatures are the exact SINR values, and the "
+                          "MCS is the same as without the cache",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&NrAmc::SetMcsCacheSinrQuantum,
+                                             &NrAmc::GetMcsCacheSinrQuantum),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("BinaryMcsSearch",
+                          "Search the maximum MCS with a binary search instead of a linear one. "
+                          "The result is the same only if the TBLER does not decrease with "
+                          "the MCS",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrAmc::m_binaryMcsSearch),
+                          MakeBooleanChecker())
+            .AddAttribute("McsCacheHits",
+                          "Number of MCS searches answered by the MCS cache",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&NrAmc::GetMcsCacheHits),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("McsCacheMisses",
+                          "Number of MCS searches not answered by the MCS cache",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&NrAmc::GetMcsCacheMisses),
+                          MakeUintegerChecker<uint64_t>())
             .AddConstructor<NrAmc>();
     return tid;
 }
@@ -113,6 +153,7 @@ NrAmc::SetNumRefScPerRb(uint8_t nref)
 {
     NS_LOG_FUNCTION(this);
     m_numRefScPerRb = nref;
+    ClearMcsCache();
 }
 
 uint32_t
@@ -218,57 +259,42 @@ NrAmc::CreateCqiFeedbackWbTdma(const SpectrumValue& sinr, uint8_t& mcs) const
     }
     else if (m_amcModel == ErrorModel)
     {
-        std::vector<int> rbMap;
-        int rbId = 0;
-        for (it = sinr.ConstValuesBegin(); it != sinr.ConstValuesEnd(); it++)
+        auto key = MakeMcsCacheKey(0, sinr.GetValues().data(), sinr.GetValuesN());
+        auto cached = GetCachedMcs(key);
+        if (cached.has_value())
         {
-            if (*it != 0.0)
-            {
-                rbMap.push_back(rbId);
-            }
-            rbId += 1;
+            mcs = cached.value();
         }
-
-        mcs = 0;
-        Ptr<NrErrorModelOutput> output;
-        while (mcs <= m_errorModel->GetMaxMcs())
+        else
         {
-            uint8_t rank = 1; // This function is SISO only
-            auto tbSize = CalculateTbSize(mcs, rank, rbMap.size());
-            output = m_errorModel->GetTbDecodificationStats(sinr,
-                                                            rbMap,
-                                                            tbSize,
-                                                            mcs,
-                                                            NrErrorModel::NrErrorModelHistory());
-            if (output->m_tbler > 0.1)
+            std::vector<int> rbMap;
+            int rbId = 0;
+            for (it = sinr.ConstValuesBegin(); it != sinr.ConstValuesEnd(); it++)
             {
-                break;
+                if (*it != 0.0)
+                {
+                    rbMap.push_back(rbId);
+                }
+                rbId += 1;
             }
-            mcs++;
-        }
 
-        if (mcs > 0)
-        {
-            mcs--;
+            mcs = SearchMaxMcs([&](uint8_t candidate) {
+                uint8_t rank = 1; // This function is SISO only
+                auto tbSize = CalculateTbSize(candidate, rank, rbMap.size());
+                return m_errorModel
+                    ->GetTbDecodificationStats(sinr,
+                                               rbMap,
+                                               tbSize,
+                                               candidate,
+                                               NrErrorModel::NrErrorModelHistory())
+                    ->m_tbler;
+            });
+            CacheMcs(std::move(key), mcs);
         }
 
-        if ((output->m_tbler > 0.1) && (mcs == 0))
-        {
-            cqi = 0;
-        }
-        else if (mcs == m_errorModel->GetMaxMcs())
-        {
-            cqi = 15; // all MCSs can guarantee the 10 % of BER
-        }
-        else
-        {
-            double s = m_errorModel->GetSpectralEfficiencyForMcs(mcs);
-            cqi = 0;
-            while ((cqi < 15) && (m_errorModel->GetSpectralEfficiencyForCqi(cqi + 1) <= s))
-            {
-                ++cqi;
-            }
-        }
+        // MCS 0 is reported with CQI 0 whether its TBLER is low enough or not, and
+        // CQI 15 means that all MCSs can guarantee the 10 % of BER
+        cqi = GetWbCqiFromMcs(mcs);
         NS_LOG_DEBUG(this << "\t MCS " << (uint16_t)mcs << "-> CQI " << cqi);
     }
     return cqi;
@@ -334,6 +360,7 @@ NrAmc::SetErrorModelType(const TypeId& type)
     factory.SetTypeId(m_errorModelType);
     m_errorModel = DynamicCast<NrErrorModel>(factory.Create());
     NS_ASSERT(m_errorModel != nullptr);
+    ClearMcsCache();
 }
 
 TypeId
@@ -389,27 +416,187 @@ NrAmc::GetMaxMcsParams(const NrSinrMatrix& sinrMat, size_t subbandSize) const
 uint8_t
 NrAmc::GetMaxMcsForErrorModel(const NrSinrMatrix& sinrMat) const
 {
+    const auto& values = sinrMat.GetValues();
+    auto key = MakeMcsCacheKey(sinrMat.GetRank(), std::begin(values), values.size());
+    auto cached = GetCachedMcs(key);
+    if (cached.has_value())
+    {
+        return cached.value();
+    }
+
+    auto mcs = SearchMaxMcs(
+        [&](uint8_t candidate) { return CalcTblerForMimoMatrix(candidate, sinrMat); });
+    CacheMcs(std::move(key), mcs);
+    return mcs;
+}
+
+uint8_t
+NrAmc::SearchMaxMcs(const std::function<double(uint8_t)>& tbler) const
+{
+    // TODO: Change target TBLER from default 0.1 when using MCS table 3
+    auto maxMcs = static_cast<uint8_t>(m_errorModel->GetMaxMcs());
     auto mcs = uint8_t{0};
-    while (mcs <= m_errorModel->GetMaxMcs())
+    if (m_binaryMcsSearch)
     {
-        auto tbler = CalcTblerForMimoMatrix(mcs, sinrMat);
-        // TODO: Change target TBLER from default 0.1 when using MCS table 3
-        if (tbler > 0.1)
+        // Find the first MCS with a high TBLER in [0, maxMcs + 1), where maxMcs + 1 stands
+        // for "none", assuming that the TBLER does not decrease with the MCS
+        auto hi = static_cast<uint8_t>(maxMcs + 1);
+        while (mcs < hi)
         {
-            break;
+            auto mid = static_cast<uint8_t>((mcs + hi) / 2);
+            if (tbler(mid) > 0.1)
+            {
+                hi = mid;
+            }
+            else
+            {
+                mcs = mid + 1;
+            }
+        }
+    }
+    else
+    {
+        while (mcs <= maxMcs)
+        {
+            if (tbler(mcs) > 0.1)
+            {
+                break;
+            }
+            // The current configuration produces a sufficiently low TBLER, try next value
+            mcs++;
         }
-        // The current configuration produces a sufficiently low TBLER, try next value
-        mcs++;
     }
     if (mcs > 0)
     {
-        // The loop exited because the MCS exceeded max MCS or because of high TBLER. Reduce MCS
+        // The search stopped at the first MCS with high TBLER, or after the max MCS. Reduce MCS
         mcs--;
     }
-
     return mcs;
 }
 
+void
+NrAmc::SetMcsCacheSize(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    m_mcsCacheSize = size;
+    while (m_mcsCache.size() > m_mcsCacheSize)
+    {
+        m_mcsCacheIndex.erase(m_mcsCache.back().m_key.m_hash);
+        m_mcsCache.pop_back();
+    }
+}
+
+uint32_t
+NrAmc::GetMcsCacheSize() const
+{
+    return m_mcsCacheSize;
+}
+
+void
+NrAmc::SetMcsCacheSinrQuantum(double quantum)
+{
+    NS_LOG_FUNCTION(this << quantum);
+    m_mcsCacheQuantum = quantum;
+    ClearMcsCache();
+}
+
+double
+NrAmc::GetMcsCacheSinrQuantum() const
+{
+    return m_mcsCacheQuantum;
+}
+
+uint64_t
+NrAmc::GetMcsCacheHits() const
+{
+    return m_mcsCacheHits;
+}
+
+uint64_t
+NrAmc::GetMcsCacheMisses() const
+{
+    return m_mcsCacheMisses;
+}
+
+NrAmc::McsCacheKey
+NrAmc::MakeMcsCacheKey(double tag, const double* sinr, size_t n) const
+{
+    McsCacheKey key;
+    if (m_mcsCacheSize == 0)
+    {
+        return key;
+    }
+    key.m_values.reserve(n + 1);
+    key.m_values.push_back(tag);
+    if (m_mcsCacheQuantum > 0)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            // RBs without signal (SINR == 0) keep their own value, as they are not decoded
+            key.m_values.push_back(
+                sinr[i] > 0 ? std::round(10 * std::log10(sinr[i]) / m_mcsCacheQuantum)
+                            : -std::numeric_limits<double>::infinity());
+        }
+    }
+    else
+    {
+        key.m_values.insert(key.m_values.end(), sinr, sinr + n);
+    }
+    key.m_hash = Hash64(reinterpret_cast<const char*>(key.m_values.data()),
+                        key.m_values.size() * sizeof(double));
+    return key;
+}
+
+std::optional<uint8_t>
+NrAmc::GetCachedMcs(const McsCacheKey& key) const
+{
+    if (m_mcsCacheSize == 0)
+    {
+        return std::nullopt;
+    }
+    auto it = m_mcsCacheIndex.find(key.m_hash);
+    if (it == m_mcsCacheIndex.end() || it->second->m_key.m_values != key.m_values)
+    {
+        ++m_mcsCacheMisses;
+        return std::nullopt;
+    }
+    ++m_mcsCacheHits;
+    m_mcsCache.splice(m_mcsCache.begin(), m_mcsCache, it->second);
+    NS_LOG_LOGIC("MCS cache hit, MCS " << +it->second->m_mcs);
+    return it->second->m_mcs;
+}
+
+void
+NrAmc::CacheMcs(McsCacheKey&& key, uint8_t mcs) const
+{
+    if (m_mcsCacheSize == 0)
+    {
+        return;
+    }
+    auto it = m_mcsCacheIndex.find(key.m_hash);
+    if (it != m_mcsCacheIndex.end())
+    {
+        // Hash collision with another signature: the newest one replaces it
+        m_mcsCache.erase(it->second);
+        m_mcsCacheIndex.erase(it);
+    }
+    else if (m_mcsCache.size() >= m_mcsCacheSize)
+    {
+        m_mcsCacheIndex.erase(m_mcsCache.back().m_key.m_hash);
+        m_mcsCache.pop_back();
+    }
+    auto hash = key.m_hash;
+    m_mcsCache.push_front(McsCacheEntry{std::move(key), mcs});
+    m_mcsCacheIndex[hash] = m_mcsCache.begin();
+}
+
+void
+NrAmc::ClearMcsCache()
+{
+    m_mcsCache.clear();
+    m_mcsCacheIndex.clear();
+}
+
 uint8_t
 NrAmc::GetWbCqiFromMcs(uint8_t mcs) const
 {
@@ -8,6 +8,11 @@
 #include "nr-error-model.h"
 #include "nr-phy-mac-common.h"
 
+#include <functional>
+#include <list>
+#include <optional>
+#include <unordered_map>
+
 namespace ns3
 {
 
@@ -23,6 +28,24 @@ namespace ns3
  * configure the ErrorModel type, which must be the same as the one set in the
  * NrSpectrumPhy class.
  *
+ * \section nr_amc_cache MCS cache
+ *
+ * With the ErrorModel model, the maximum MCS of a SINR vector (or MIMO SINR matrix)
+ * is searched by calling the error model for each candidate MCS. Static UEs report the
+ * same SINR slot after slot, so the result of the search can be memoized in a LRU cache of
+ * McsCacheSize entries (0, i.e., disabled, by default), keyed on the SINR signature: the
+ * SINR values, exact by default, or quantized with a step of McsCacheSinrQuantum dB, so
+ * that close SINR values share the MCS of the first one that was searched. With exact
+ * signatures, the cache only hits when the SINR does not change at all, e.g., for static
+ * UEs without fading; with a quantum, it also hits when the channel varies, at the price
+ * of an approximate MCS. The hits and misses of the cache are exposed by the McsCacheHits
+ * and McsCacheMisses attributes. Setting BinaryMcsSearch replaces the linear search over
+ * the MCSs with a binary search, which assumes that the TBLER does not decrease with the
+ * MCS.
+ *
+ * The cache is updated by the const methods that compute the MCS, so an NrAmc instance,
+ * which is shared by a GNB and its UEs, must only be used from the simulation thread.
+ *
  * \section nr_amc_conf Configuration
  *
  * The attributes of this class can be configured through the helper methods
@@ -204,6 +227,38 @@ class NrAmc : public Object
     /// \return a struct with the optimal MCS and corresponding CQI and TB size
     McsParams GetMaxMcsParams(const NrSinrMatrix& sinrMat, size_t subbandSize) const;
 
+    /**
+     * \brief Set the maximum number of SINR signatures whose MCS is memoized
+     * \param size the size of the cache, 0 to disable it
+     */
+    void SetMcsCacheSize(uint32_t size);
+
+    /**
+     * \return the maximum number of SINR signatures whose MCS is memoized
+     */
+    uint32_t GetMcsCacheSize() const;
+
+    /**
+     * \brief Set the quantization step of the SINR signatures of the MCS cache
+     * \param quantum the step (dB), 0 for exact SINR values
+     */
+    void SetMcsCacheSinrQuantum(double quantum);
+
+    /**
+     * \return the quantization step (dB) of the SINR signatures of the MCS cache
+     */
+    double GetMcsCacheSinrQuantum() const;
+
+    /**
+     * \return the number of MCS searches answered by the cache
+     */
+    uint64_t GetMcsCacheHits() const;
+
+    /**
+     * \return the number of MCS searches not answered by the cache
+     */
+    uint64_t GetMcsCacheMisses() const;
+
   private:
     /// \brief Find maximum MCS supported for this channel, using the Shannon model
     /// \param sinrMat the MIMO SINR matrix (rank * nRbs)
@@ -238,6 +293,53 @@ class NrAmc : public Object
      */
     double GetBer() const;
 
+    /**
+     * \brief Find the maximum MCS whose TBLER does not exceed 0.1
+     *
+     * The search is linear from MCS 0, or binary if BinaryMcsSearch is set.
+     *
+     * \param tbler the function computing the TBLER of an MCS
+     * \return the maximum MCS, or 0 if no MCS has a low enough TBLER
+     */
+    uint8_t SearchMaxMcs(const std::function<double(uint8_t)>& tbler) const;
+
+    /**
+     * \brief Signature of a SINR vector or matrix in the MCS cache
+     */
+    struct McsCacheKey
+    {
+        std::vector<double> m_values; //!< Tag, then the (quantized) SINR values
+        uint64_t m_hash{0};           //!< Hash of m_values
+    };
+
+    /**
+     * \brief Compute the signature of SINR values
+     * \param tag what the values are: 0 for a SISO vector, the rank for a MIMO matrix
+     * \param sinr the SINR values (linear)
+     * \param n the number of values
+     * \return the signature
+     */
+    McsCacheKey MakeMcsCacheKey(double tag, const double* sinr, size_t n) const;
+
+    /**
+     * \brief Look up the MCS of a signature, counting the hit or the miss
+     * \param key the signature
+     * \return the memoized MCS, if any
+     */
+    std::optional<uint8_t> GetCachedMcs(const McsCacheKey& key) const;
+
+    /**
+     * \brief Memoize the MCS of a signature, evicting the least recently used one if full
+     * \param key the signature
+     * \param mcs the MCS
+     */
+    void CacheMcs(McsCacheKey&& key, uint8_t mcs) const;
+
+    /**
+     * \brief Forget all the memoized MCSs, e.g., when the error model changes
+     */
+    void ClearMcsCache();
+
   private:
     AmcModel m_amcModel;                           //!< Type of the CQI feedback model
     Ptr<NrErrorModel> m_errorModel;                //!< Pointer to an instance of ErrorModel
@@ -245,6 +347,26 @@ class NrAmc : public Object
     uint8_t m_numRefScPerRb{1};                    //!< number of reference subcarriers per RB
     NrErrorModel::Mode m_emMode{NrErrorModel::DL}; //!< Error model mode
     static const unsigned int m_crcLen = 24 / 8;   //!< CRC length (in bytes)
+
+    bool m_binaryMcsSearch{false}; //!< Search the MCS with a binary search
+    uint32_t m_mcsCacheSize{0};    //!< Maximum number of memoized signatures
+    double m_mcsCacheQuantum{0.0}; //!< Quantization step (dB) of the signatures
+
+    /**
+     * \brief Entry of the MCS cache
+     */
+    struct McsCacheEntry
+    {
+        McsCacheKey m_key; //!< Signature
+        uint8_t m_mcs{0};  //!< Maximum MCS
+    };
+
+    // The cache is updated by const methods: simulation thread only, see the class doc
+    mutable std::list<McsCacheEntry> m_mcsCache; //!< Memoized MCSs, most recently used first
+    mutable std::unordered_map<uint64_t, std::list<McsCacheEntry>::iterator>
+        m_mcsCacheIndex;                //!< Entry of each signature hash
+    mutable uint64_t m_mcsCacheHits{0};   //!< MCS searches answered by the cache
+    mutable uint64_t m_mcsCacheMisses{0}; //!< MCS searches not answered by the cache
 };
 
 } // end namespace ns3
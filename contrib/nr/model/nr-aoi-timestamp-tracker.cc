@@ -0,0 +1,156 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-aoi-timestamp-tracker.h"
+
+#include <ns3/log.h>
+#include <ns3/uinteger.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrAoiTimestampTracker");
+NS_OBJECT_ENSURE_REGISTERED(NrAoiTimestampTracker);
+
+TypeId
+NrAoiTimestampTracker::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrAoiTimestampTracker")
+            .SetParent<Object>()
+            .AddConstructor<NrAoiTimestampTracker>()
+            .SetGroupName("Nr")
+            .AddAttribute("Capacity",
+                          "Maximum number of packet creation times stored for each RNTI",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&NrAoiTimestampTracker::SetCapacity,
+                                               &NrAoiTimestampTracker::GetCapacity),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+void
+NrAoiTimestampTracker::SetCapacity(uint32_t capacity)
+{
+    NS_LOG_FUNCTION(this << capacity);
+    m_capacity = capacity;
+}
+
+uint32_t
+NrAoiTimestampTracker::GetCapacity() const
+{
+    return m_capacity;
+}
+
+bool
+NrAoiTimestampTracker::Push(uint16_t rnti, uint64_t creationTime)
+{
+    NS_LOG_FUNCTION(this << rnti << creationTime);
+    Ring& ring = m_rings[rnti];
+    if (ring.times.empty())
+    {
+        ring.times.resize(m_capacity);
+    }
+    NS_ASSERT_MSG(creationTime >= ring.newest, "Creation times must be pushed in order");
+    ring.newest = creationTime;
+    if (ring.size == ring.times.size())
+    {
+        NS_LOG_WARN("Creation times of RNTI " << rnti << " full, " << creationTime
+                                              << " dropped");
+        ++m_dropped;
+        return false;
+    }
+    ring.times[ring.Index(ring.size)] = creationTime;
+    ++ring.size;
+    ++ring.stored;
+    return true;
+}
+
+void
+NrAoiTimestampTracker::Pop(uint16_t rnti)
+{
+    NS_LOG_FUNCTION(this << rnti);
+    auto it = m_rings.find(rnti);
+    if (it == m_rings.end() || it->second.size == 0)
+    {
+        return;
+    }
+    Ring& ring = it->second;
+    ring.head = ring.Index(1);
+    --ring.size;
+}
+
+bool
+NrAoiTimestampTracker::IsEmpty(uint16_t rnti) const
+{
+    return GetSize(rnti) == 0;
+}
+
+uint32_t
+NrAoiTimestampTracker::GetSize(uint16_t rnti) const
+{
+    auto it = m_rings.find(rnti);
+    return it == m_rings.end() ? 0 : it->second.size;
+}
+
+uint64_t
+NrAoiTimestampTracker::GetOldest(uint16_t rnti) const
+{
+    auto it = m_rings.find(rnti);
+    NS_ASSERT_MSG(it != m_rings.end() && it->second.size > 0,
+                  "No creation time stored for RNTI " << rnti);
+    return it->second.times[it->second.head];
+}
+
+uint64_t
+NrAoiTimestampTracker::GetNewest(uint16_t rnti) const
+{
+    auto it = m_rings.find(rnti);
+    return it == m_rings.end() ? 0 : it->second.newest;
+}
+
+uint64_t
+NrAoiTimestampTracker::GetAge(uint16_t rnti, uint64_t now) const
+{
+    auto it = m_rings.find(rnti);
+    if (it == m_rings.end() || it->second.size == 0)
+    {
+        return 0;
+    }
+    return now - it->second.times[it->second.head];
+}
+
+uint64_t
+NrAoiTimestampTracker::GetStoredCount(uint16_t rnti) const
+{
+    auto it = m_rings.find(rnti);
+    return it == m_rings.end() ? 0 : it->second.stored;
+}
+
+void
+NrAoiTimestampTracker::GetNewestStored(uint16_t rnti,
+                                       uint64_t count,
+                                       std::vector<uint64_t>* creationTimes) const
+{
+    auto it = m_rings.find(rnti);
+    if (it == m_rings.end())
+    {
+        return;
+    }
+    const Ring& ring = it->second;
+    uint32_t first = count < ring.size ? ring.size - static_cast<uint32_t>(count) : 0;
+    for (uint32_t i = first; i < ring.size; ++i)
+    {
+        creationTimes->push_back(ring.times[ring.Index(i)]);
+    }
+}
+
+void
+NrAoiTimestampTracker::RemoveUe(uint16_t rnti)
+{
+    NS_LOG_FUNCTION(this << rnti);
+    m_rings.erase(rnti);
+}
+
+} // namespace ns3
@@ -0,0 +1,161 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#pragma once
+
+#include <ns3/object.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief Creation times of the UL packets of each UE, for the Age of Information
+ *
+ * The creation times (in microseconds) of the packets waiting in a UE are kept in a
+ * fixed-capacity ring buffer per RNTI, oldest first: Push(), Pop() and GetOldest() are
+ * O(1) and do not allocate once the buffer of the RNTI exists. The AoI of a UE is the
+ * time elapsed since its oldest creation time.
+ *
+ * The gNB MAC owns one instance, fed by the SR messages and popped by the UL HARQ ACKs,
+ * and the scheduler reads it through NrMacSchedSapUser::GetAoiTimestampTracker(), so
+ * that the creation times are not copied from the MAC to the scheduler. The UE MAC uses
+ * another instance for the packets it did not transmit yet.
+ *
+ * When the buffer of an RNTI is full, new creation times are dropped: the oldest ones,
+ * which give the AoI, are kept.
+ */
+class NrAoiTimestampTracker : public Object
+{
+  public:
+    /**
+     * \brief GetTypeId
+     * \return The TypeId of the class
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Set the capacity of the buffer of each RNTI
+     * \param capacity the maximum number of creation times of an RNTI
+     *
+     * It applies to the buffers created afterwards.
+     */
+    void SetCapacity(uint32_t capacity);
+
+    /**
+     * \brief Get the capacity of the buffer of each RNTI
+     * \return the maximum number of creation times of an RNTI
+     */
+    uint32_t GetCapacity() const;
+
+    /**
+     * \brief Add the creation time of a new packet
+     * \param rnti the RNTI of the UE
+     * \param creationTime the creation time, not older than the ones already pushed
+     * \return false if the buffer of the RNTI is full and the creation time was dropped
+     */
+    bool Push(uint16_t rnti, uint64_t creationTime);
+
+    /**
+     * \brief Remove the oldest creation time of an RNTI, if any
+     * \param rnti the RNTI of the UE
+     */
+    void Pop(uint16_t rnti);
+
+    /**
+     * \param rnti the RNTI of the UE
+     * \return true if no creation time is stored for the RNTI
+     */
+    bool IsEmpty(uint16_t rnti) const;
+
+    /**
+     * \param rnti the RNTI of the UE
+     * \return the number of creation times stored for the RNTI
+     */
+    uint32_t GetSize(uint16_t rnti) const;
+
+    /**
+     * \param rnti the RNTI of the UE, which must not be empty
+     * \return the oldest creation time stored for the RNTI
+     */
+    uint64_t GetOldest(uint16_t rnti) const;
+
+    /**
+     * \param rnti the RNTI of the UE
+     * \return the newest creation time ever pushed for the RNTI (0 if none), even if it was
+     * popped or dropped since
+     */
+    uint64_t GetNewest(uint16_t rnti) const;
+
+    /**
+     * \brief Get the Age of Information of an RNTI
+     * \param rnti the RNTI of the UE
+     * \param now the current time, in microseconds
+     * \return now minus the oldest creation time, or 0 if no creation time is stored
+     */
+    uint64_t GetAge(uint16_t rnti, uint64_t now) const;
+
+    /**
+     * \param rnti the RNTI of the UE
+     * \return the number of creation times stored for the RNTI since its buffer was created,
+     * including the ones popped since but not the dropped ones
+     */
+    uint64_t GetStoredCount(uint16_t rnti) const;
+
+    /**
+     * \brief Append the newest stored creation times
+     * \param rnti the RNTI of the UE
+     * \param count the number of creation times, limited to the ones still stored
+     * \param creationTimes the vector to which the creation times are appended, oldest first
+     */
+    void GetNewestStored(uint16_t rnti,
+                         uint64_t count,
+                         std::vector<uint64_t>* creationTimes) const;
+
+    /**
+     * \brief Forget all the creation times of an RNTI
+     * \param rnti the RNTI of the UE
+     */
+    void RemoveUe(uint16_t rnti);
+
+    /**
+     * \return the number of creation times dropped because a buffer was full
+     */
+    uint64_t GetDropped() const
+    {
+        return m_dropped;
+    }
+
+  private:
+    /**
+     * \brief Ring buffer of the creation times of an RNTI
+     */
+    struct Ring
+    {
+        std::vector<uint64_t> times; //!< Storage, of the capacity size
+        uint32_t head{0};            //!< Index of the oldest creation time
+        uint32_t size{0};            //!< Number of creation times stored
+        uint64_t newest{0};          //!< Newest creation time ever pushed
+        uint64_t stored{0};          //!< Number of creation times ever stored
+
+        /**
+         * \param i the position from the oldest, in [0, size)
+         * \return the index of the creation time in times
+         */
+        uint32_t Index(uint32_t i) const
+        {
+            uint32_t index = head + i;
+            return index >= times.size() ? index - times.size() : index;
+        }
+    };
+
+    uint32_t m_capacity{1024};                  //!< Capacity of the new ring buffers
+    uint64_t m_dropped{0};                      //!< Creation times dropped
+    std::unordered_map<uint16_t, Ring> m_rings; //!< Ring buffer of each RNTI
+};
+
+} // namespace ns3
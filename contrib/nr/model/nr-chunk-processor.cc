@@ -49,7 +49,15 @@ NrChunkProcessor::EvaluateChunk(const SpectrumValue& sinr, Time duration)
     {
         m_sumValues = Create<SpectrumValue>(sinr.GetSpectrumModel());
     }
-    (*m_sumValues) += sinr * duration.GetSeconds();
+    // (*m_sumValues) += sinr * duration, without the temporary SpectrumValue
+    NS_ASSERT(m_sumValues->GetSpectrumModelUid() == sinr.GetSpectrumModelUid());
+    double d = duration.GetSeconds();
+    auto sinrIt = sinr.ConstValuesBegin();
+    for (auto sumIt = m_sumValues->ValuesBegin(); sumIt != m_sumValues->ValuesEnd();
+         ++sumIt, ++sinrIt)
+    {
+        *sumIt += (*sinrIt) * d;
+    }
     m_totDuration += duration;
 }
 
@@ -10,6 +10,8 @@
 
 #include <ns3/simple-ref-count.h>
 
+#include <vector>
+
 namespace ns3
 {
 
@@ -129,17 +131,28 @@ class NrSRMessage : public NrControlMessage
      */
 
     uint16_t GetRNTI() const;
-    void SetPacketCreationTimes(const std::queue<uint64_t>& times)
+
+    /**
+     * \brief Set the creation times of the packets reported by this SR
+     * \param times creation times in microseconds, oldest first
+     */
+    void SetPacketCreationTimes(std::vector<uint64_t> times)
     {
-      m_packet_creation_time_queue=times;
+        m_packetCreationTimes = std::move(times);
     }
-    std::queue<uint64_t> GetPacketCreationTimes() const
+
+    /**
+     * \brief Get the creation times of the packets reported by this SR
+     * \return creation times in microseconds, oldest first
+     */
+    const std::vector<uint64_t>& GetPacketCreationTimes() const
     {
-      return m_packet_creation_time_queue;  
+        return m_packetCreationTimes;
     }
+
   private:
-    uint16_t m_rnti{0}; //!< RNTI
-    std::queue<uint64_t> m_packet_creation_time_queue;  // 패킷 생성 시간 큐
+    uint16_t m_rnti{0};                         //!< RNTI
+    std::vector<uint64_t> m_packetCreationTimes; //!< Creation times of the reported packets
 };
 
 /**
@@ -12,7 +12,9 @@
 #include "ns3/log.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <mutex>
 
 namespace ns3
 {
@@ -60,12 +62,17 @@ NrEesmErrorModel::SinrEff(const SpectrumValue& sinr,
                           uint8_t mcs,
                           double a,
                           double b) const
+{
+    return SinrEffFromExp(SinrExp(sinr, map, mcs), mcs, a, b);
+}
+
+double
+NrEesmErrorModel::SinrEffFromExp(double sinrExpSum, uint8_t mcs, double a, double b) const
 {
     // it follows: SINReff = - beta * ln [1/b * (sum (exp (-sinr/beta)) + a)]
     // for HARQ-IR: b = sum (map.size()), a = sum_j(sum_n (exp (-sinr/beta))) (for previous retx,
     // till j=q-1) for HARQ-CC: b = map.size(), a = 0.0 (SINRs are already combined in sinr input)
 
-    double sinrExpSum = SinrExp(sinr, map, mcs);
     double beta = GetBetaTable()->at(mcs);
     double SINR = -beta * log((a + sinrExpSum) / b);
     SINR = std::max(SINR, 0.0);
@@ -83,32 +90,77 @@ NrEesmErrorModel::SinrExp(const SpectrumValue& sinr, const std::vector<int>& map
     NS_ABORT_MSG_IF(map.empty(),
                     " Error: number of allocated RBs cannot be 0 - EESM method - SinrEff function");
 
-    double SINRexp = 0.0;
+    // the exponentials of a block of RBs are computed at once, and then summed in the
+    // order of the map
+    std::array<double, 64> block;
+    const Values& values = sinr.GetValues();
     double SINRsum = 0.0;
     double beta = GetBetaTable()->at(mcs);
-    for (int i : map)
+    for (size_t start = 0; start < map.size(); start += block.size())
     {
-        double sinrLin = sinr[i];
-        SINRexp = exp21d(-sinrLin / beta);
-        SINRsum += SINRexp;
+        size_t n = std::min(block.size(), map.size() - start);
+        for (size_t k = 0; k < n; ++k)
+        {
+            double sinrLin = values.at(map[start + k]);
+            block[k] = -sinrLin / beta;
+        }
+        exp21dBlock(block.data(), n);
+        for (size_t k = 0; k < n; ++k)
+        {
+            SINRsum += block[k];
+        }
     }
     return SINRsum;
 }
 
-const std::vector<double>&
-NrEesmErrorModel::GetSinrDbVectorFromSimulatedValues(NrEesmErrorModel::GraphType graphType,
-                                                     uint8_t mcs,
-                                                     uint32_t cbSizeIndex) const
+const NrEesmErrorModel::FlatBlerTable&
+NrEesmErrorModel::GetFlatBlerTable(const SimulatedBlerFromSINR* table)
 {
-    return std::get<0>(GetSimulatedBlerFromSINR()->at(graphType).at(mcs).at(cbSizeIndex));
-}
+    static std::map<const SimulatedBlerFromSINR*, FlatBlerTable> flatTables;
+    // Error models used by several threads may flatten the tables concurrently. The
+    // map nodes are stable, so the returned references stay valid after the unlock
+    static std::mutex flatTablesMutex;
+    std::lock_guard<std::mutex> lock(flatTablesMutex);
+
+    auto [it, inserted] = flatTables.try_emplace(table);
+    FlatBlerTable& flat = it->second;
+    if (!inserted)
+    {
+        return flat;
+    }
 
-const std::vector<double>&
-NrEesmErrorModel::GetBLERVectorFromSimulatedValues(NrEesmErrorModel::GraphType graphType,
-                                                   uint8_t mcs,
-                                                   uint32_t cbSizeIndex) const
-{
-    return std::get<1>(GetSimulatedBlerFromSINR()->at(graphType).at(mcs).at(cbSizeIndex));
+    NS_LOG_FUNCTION(table);
+    for (const auto& bgCurves : *table)
+    {
+        flat.m_numMcs = std::max(flat.m_numMcs, static_cast<uint32_t>(bgCurves.size()));
+    }
+    for (const auto& bgCurves : *table)
+    {
+        for (uint32_t mcs = 0; mcs < flat.m_numMcs; ++mcs)
+        {
+            flat.m_first.push_back(flat.m_curves.size());
+            if (mcs >= bgCurves.size())
+            {
+                continue;
+            }
+            // the map is sorted by CB size
+            for (const auto& [cbSize, curve] : bgCurves[mcs])
+            {
+                const auto& sinrDb = std::get<0>(curve);
+                const auto& bler = std::get<1>(curve);
+                NS_ASSERT_MSG(!sinrDb.empty() && sinrDb.size() == bler.size(),
+                              "Inconsistent BLER-SINR curve for MCS " << mcs << " and CB size "
+                                                                      << cbSize);
+                flat.m_curves.push_back({cbSize,
+                                         static_cast<uint32_t>(flat.m_sinrDb.size()),
+                                         static_cast<uint32_t>(sinrDb.size())});
+                flat.m_sinrDb.insert(flat.m_sinrDb.end(), sinrDb.begin(), sinrDb.end());
+                flat.m_bler.insert(flat.m_bler.end(), bler.begin(), bler.end());
+            }
+        }
+    }
+    flat.m_first.push_back(flat.m_curves.size());
+    return flat;
 }
 
 double
@@ -118,6 +170,11 @@ NrEesmErrorModel::MappingSinrBler(double sinr, uint8_t mcs, uint32_t cbSizeBit)
     NS_ABORT_MSG_IF(mcs > GetMaxMcs(),
                     "MCS out of range [0..27/28]: " << static_cast<uint8_t>(mcs));
 
+    if (m_flatBler == nullptr)
+    {
+        m_flatBler = &GetFlatBlerTable(GetSimulatedBlerFromSINR());
+    }
+
     // use cbSize to obtain the index of CBSIZE in the map, jointly with mcs and sinr. take the
     // lowest CBSIZE simulated including this CB for removing CB size quatization
     // errors. sinr is also lower-bounded.
@@ -125,42 +182,47 @@ NrEesmErrorModel::MappingSinrBler(double sinr, uint8_t mcs, uint32_t cbSizeBit)
     double sinr_db = 10 * log10(sinr);
     GraphType bg_type = GetBaseGraphType(cbSizeBit, mcs);
 
-    // Get the index of CBSIZE in the map
+    // Get the curve of CBSIZE among the ones of the base graph and MCS
     NS_LOG_INFO("For sinr " << sinr << " and mcs " << +mcs << " CbSizebit " << cbSizeBit
                             << " we got bg type " << m_bgTypeName[bg_type]);
-    const auto& cbMap = GetSimulatedBlerFromSINR()->at(bg_type).at(mcs);
-    auto cbIt = cbMap.upper_bound(cbSizeBit);
-
-    if (cbIt != cbMap.begin())
+    NS_ABORT_MSG_IF(mcs >= m_flatBler->m_numMcs, "No BLER-SINR curve for MCS " << +mcs);
+    uint32_t index = bg_type * m_flatBler->m_numMcs + mcs;
+    auto cbBegin = m_flatBler->m_curves.begin() + m_flatBler->m_first[index];
+    auto cbEnd = m_flatBler->m_curves.begin() + m_flatBler->m_first[index + 1];
+    NS_ABORT_MSG_IF(cbBegin == cbEnd, "No BLER-SINR curve for MCS " << +mcs);
+    auto cbIt = std::upper_bound(cbBegin,
+                                 cbEnd,
+                                 cbSizeBit,
+                                 [](uint32_t size, const FlatBlerTable::Curve& curve) {
+                                     return size < curve.m_cbSize;
+                                 });
+
+    if (cbIt != cbBegin)
     {
         cbIt--;
     }
 
-    if (sinr_db < GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).front())
+    const double* sinrBegin = m_flatBler->m_sinrDb.data() + cbIt->m_offset;
+    const double* sinrEnd = sinrBegin + cbIt->m_size;
+    if (sinr_db < *sinrBegin)
     {
         bler = 1.0;
     }
-    else if (sinr_db > GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).back())
+    else if (sinr_db > *(sinrEnd - 1))
     {
         bler = 0.0;
     }
     else
     {
-        // Get the index of SINR in the vector
-        auto sinrIt =
-            std::upper_bound(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                             GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).end(),
-                             sinr_db);
+        // Get the index of SINR in the curve
+        const double* sinrIt = std::upper_bound(sinrBegin, sinrEnd, sinr_db);
 
-        if (sinrIt != GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin())
+        if (sinrIt != sinrBegin)
         {
             sinrIt--;
         }
 
-        auto sinr_index =
-            std::distance(GetSinrDbVectorFromSimulatedValues(bg_type, mcs, cbIt->first).begin(),
-                          sinrIt);
-        bler = GetBLERVectorFromSimulatedValues(bg_type, mcs, cbIt->first).at(sinr_index);
+        bler = m_flatBler->m_bler[cbIt->m_offset + (sinrIt - sinrBegin)];
     }
 
     NS_LOG_LOGIC("SINR effective: " << sinr << " BLER:" << bler);
@@ -289,9 +351,9 @@ NrEesmErrorModel::GetTbBitDecodificationStats(const SpectrumValue& sinr,
     NS_LOG_FUNCTION(this);
     NS_ABORT_IF(mcs > GetMaxMcs());
 
-    double tbSinr = SinrEff(sinr, map, mcs, 0, map.size()); // effective SINR for this tx
-    double SINR = tbSinr;
     double sinrExpSum = SinrExp(sinr, map, mcs); // exponential sum of SINRs for this tx
+    double tbSinr = SinrEffFromExp(sinrExpSum, mcs, 0, map.size()); // effective SINR for this tx
+    double SINR = tbSinr;
 
     NS_LOG_DEBUG(" mcs " << +mcs << " TBSize in bit " << sizeBit << " history elements: "
                          << sinrHistory.size() << " SINR of the tx: " << tbSinr << std::endl
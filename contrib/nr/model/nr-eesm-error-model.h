@@ -328,25 +328,56 @@ class NrEesmErrorModel : public NrErrorModel
     std::pair<uint32_t, uint32_t> CodeBlockSegmentation(uint32_t B, GraphType bg_type) const;
 
     /**
-     * \brief Get SinrDb Vector From Simulated Values
-     * \param graphType
-     * \param mcs
-     * \param cbSizeIndex
-     * \return
+     * \brief The BLER-SINR curves of a SimulatedBlerFromSINR table, flattened
+     *
+     * The curves of each (base graph, MCS) are consecutive and sorted by CB size, and
+     * the SINR (in dB) and BLER points of all the curves are stored in two contiguous
+     * arrays: a lookup indexes the (base graph, MCS), searches a few adjacent CB sizes
+     * and then a few adjacent SINR points, instead of walking nested maps.
      */
-    const std::vector<double>& GetSinrDbVectorFromSimulatedValues(GraphType graphType,
-                                                                  uint8_t mcs,
-                                                                  uint32_t cbSizeIndex) const;
+    struct FlatBlerTable
+    {
+        /**
+         * \brief A BLER-SINR curve
+         */
+        struct Curve
+        {
+            uint32_t m_cbSize; //!< CB size (bits)
+            uint32_t m_offset; //!< Index of the first point in m_sinrDb and m_bler
+            uint32_t m_size;   //!< Number of points
+        };
+
+        uint32_t m_numMcs{0};          //!< Number of MCSs of each base graph
+        std::vector<uint32_t> m_first; //!< First curve of bg * m_numMcs + mcs, and the end
+        std::vector<Curve> m_curves;   //!< The curves
+        std::vector<double> m_sinrDb;  //!< SINR points (dB) of all the curves
+        std::vector<double> m_bler;    //!< BLER points of all the curves
+    };
+
     /**
-     * \brief Get BLER Vector From Simulated Values
-     * \param graphType
-     * \param mcs
-     * \param cbSizeIndex
-     * \return
+     * \brief Get the flattened version of a BLER-SINR table
+     *
+     * The tables are static, so each one is flattened once, at its first use, and
+     * shared by all the instances of the error models that use it. The flattening is
+     * guarded by a mutex, so this can be called from any thread.
+     *
+     * \param table the BLER-SINR table
+     * \return the flattened table
      */
-    const std::vector<double>& GetBLERVectorFromSimulatedValues(GraphType graphType,
-                                                                uint8_t mcs,
-                                                                uint32_t cbSizeIndex) const;
+    static const FlatBlerTable& GetFlatBlerTable(const SimulatedBlerFromSINR* table);
+
+    /**
+     * \brief Compute the effective SINR from the sum of exponential SINRs
+     * \param sinrExpSum the sum of exponential SINRs, as returned by SinrExp()
+     * \param mcs the MCS of the TB
+     * \param a the sum term to the exponential SINR
+     * \param b the denominator for the exponentials sum
+     * \return the effective SINR
+     * \see SinrEff
+     */
+    double SinrEffFromExp(double sinrExpSum, uint8_t mcs, double a, double b) const;
+
+    const FlatBlerTable* m_flatBler{nullptr}; //!< GetSimulatedBlerFromSINR(), flattened
 };
 
 } // namespace ns3
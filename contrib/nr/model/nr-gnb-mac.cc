@@ -253,6 +253,7 @@ class NrMacMemberMacSchedSapUser : public NrMacSchedSapUser
     uint32_t GetSymbolsPerSlot() const override;
     Time GetSlotPeriod() const override;
     void BuildRarList(SlotAllocInfo& slotAllocInfo) override;
+    Ptr<NrAoiTimestampTracker> GetAoiTimestampTracker() const override;
 
   private:
     NrGnbMac* m_mac;
@@ -320,6 +321,12 @@ NrMacMemberMacSchedSapUser::BuildRarList(ns3::SlotAllocInfo& slotAllocInfo)
     m_mac->DoBuildRarList(slotAllocInfo);
 }
 
+Ptr<NrAoiTimestampTracker>
+NrMacMemberMacSchedSapUser::GetAoiTimestampTracker() const
+{
+    return m_mac->GetAoiTimestampTracker();
+}
+
 class NrMacMemberMacCschedSapUser : public NrMacCschedSapUser
 {
   public:
@@ -436,6 +443,10 @@ NrGnbMac::GetTypeId()
                             "Harq feedback.",
                             MakeTraceSourceAccessor(&NrGnbMac::m_dlHarqFeedback),
                             "ns3::NrGnbMac::DlHarqFeedbackTracedCallback")
+            .AddTraceSource("UlAoiDelivery",
+                            "Creation time of the UL packets acknowledged by the UL HARQ.",
+                            MakeTraceSourceAccessor(&NrGnbMac::m_ulAoiDelivery),
+                            "ns3::NrGnbMac::UlAoiDeliveryTracedCallback")
             .AddAttribute("NumberOfRaPreambles",
                           "How many random access preambles are available for the contention based "
                           "RACH process",
@@ -472,6 +483,7 @@ NrGnbMac::NrGnbMac()
     m_macSchedSapUser = new NrMacMemberMacSchedSapUser(this);
     m_macCschedSapUser = new NrMacMemberMacCschedSapUser(this);
     m_ccmMacSapProvider = new MemberNrCcmMacSapProvider<NrGnbMac>(this);
+    m_aoiTracker = CreateObject<NrAoiTimestampTracker>();
 }
 
 NrGnbMac::~NrGnbMac()
@@ -491,6 +503,7 @@ NrGnbMac::DoDispose()
     delete m_macCschedSapUser;
     delete m_phySapUser;
     delete m_ccmMacSapProvider;
+    m_aoiTracker = nullptr;
 }
 
 void
@@ -758,13 +771,6 @@ NrGnbMac::DoSlotUlIndication(const SfnSf& sfnSf, LteNrTddSlotType type)
         params.m_srList.insert(params.m_srList.begin(), m_srRntiList.begin(), m_srRntiList.end());
         m_srRntiList.clear();
 
-        // rnti 별로 SR메시지와 함께 패킷 생성 큐를 보낸다.
-        for(const auto &rnti : params.m_srList)
-        {
-            params.sched_packet_ctime_queue_map[rnti] = gnb_mac_Ctime_queue_map[rnti];
-            // std::cout<<"[nr-gnb-mac] : rnti "<<rnti<<"의 DoSlotUlIndication 직전 oldest queue "<<gnb_mac_Ctime_queue_map[rnti].front()<<std::endl;
-        }
-        
         m_macSchedSapProvider->SchedUlSrInfoReq(params);
 
         for (const auto& v : params.m_srList)
@@ -898,7 +904,7 @@ NrGnbMac::DoReportSrToScheduler(uint16_t rnti)
 
 /**
  * ue-mac에서 SHORT_BSR 패킷에서 보낸 패킷 생성 시간 큐 Tag를
- * DoReceivePhyPdu 메서드에서 떼고 gnb_mac_Ctime_queue_map에 저장
+ * DoReceivePhyPdu 메서드에서 떼고 NrAoiTimestampTracker에 저장
  * 태그는 잠깐 나가있어.
  */
 void
@@ -1055,32 +1061,16 @@ NrGnbMac::DoReceiveControlMessage(Ptr<NrControlMessage> msg)
         NS_LOG_INFO("Received SR from RNTI "<<sr_rnti);
         m_ccmMacSapUser->UlReceiveSr(sr->GetRNTI(), GetBwpId());
         
-        // ue-mac으로부터 패킷 큐 이어받기
-        std::queue<uint64_t> newPackets = sr->GetPacketCreationTimes(); // 복사본 생성
-        while (!newPackets.empty()) 
+        // ue-mac으로부터 패킷 생성 시간 이어받기: the SR carries the creation times not
+        // reported yet, which can share the time of the newest one already stored
+        uint64_t newest = m_aoiTracker->GetNewest(sr_rnti);
+        for (uint64_t creationTime : sr->GetPacketCreationTimes())
         {
-            gnb_mac_Ctime_queue_map[sr_rnti].push(newPackets.front()); // 새로운 패킷 추가
-            newPackets.pop();
+            if (creationTime >= newest)
+            {
+                m_aoiTracker->Push(sr_rnti, creationTime);
+            }
         }
-        // [Output 3] : UE->gNB 큐 정확하게 왔는지 확인
-        // 큐 테스트
-        // std::cout<<"Rnti "<<sr->GetRNTI()<<"의 큐 정보\n사이즈 : "<<gnb_mac_Ctime_queue_map[sr_rnti].size()<<"\n";
-        // std::cout<<"큐 elements : \n";
-        // std::queue<uint64_t> temp = gnb_mac_Ctime_queue_map[sr_rnti];
-        // for(int i=0;i<gnb_mac_Ctime_queue_map.size();i++)
-        // {
-        //     if(!temp.empty())
-        //     {
-        //         std::cout<<temp.front();
-        //     }
-        //     else
-        //     {
-        //         break;
-        //     }
-        //     temp.pop();
-        //     std::cout<<std::endl;
-        // }
-        // NS_LOG_INFO("Queue Size : "<<gnb_mac_Ctime_queue_map.size());
 
         break;
     }
@@ -1111,10 +1101,10 @@ NrGnbMac::DoUlHarqFeedback(const UlHarqInfo& params)
     uint16_t rnti = params.m_rnti;
     if(params.IsReceivedOk())
     {
-        if(!gnb_mac_Ctime_queue_map[rnti].empty())
+        if (!m_aoiTracker->IsEmpty(rnti))
         {
-            // std::cout<<"pop\n";
-            gnb_mac_Ctime_queue_map[rnti].pop();
+            m_ulAoiDelivery(GetCellId(), rnti, m_aoiTracker->GetOldest(rnti));
+            m_aoiTracker->Pop(rnti);
         }
     }
     else
@@ -1528,6 +1518,12 @@ NrGnbMac::GetUlCtrlDci() const
                                                 rbgBitmask);
 }
 
+Ptr<NrAoiTimestampTracker>
+NrGnbMac::GetAoiTimestampTracker() const
+{
+    return m_aoiTracker;
+}
+
 void
 NrGnbMac::DoAddUe(uint16_t rnti)
 {
@@ -1567,6 +1563,7 @@ NrGnbMac::DoRemoveUe(uint16_t rnti)
     m_macCschedSapProvider->CschedUeReleaseReq(params);
     m_miDlHarqProcessesPackets.erase(rnti);
     m_rlcAttached.erase(rnti);
+    m_aoiTracker->RemoveUe(rnti);
 
     // remove unprocessed preamble received for RACH during handover
     auto jt = m_allocatedNcRaPreambleMap.begin();
@@ -15,6 +15,7 @@
 #ifndef NR_GNB_MAC_H
 #define NR_GNB_MAC_H
 
+#include "nr-aoi-timestamp-tracker.h"
 #include "nr-ccm-mac-sap.h"
 #include "nr-gnb-cmac-sap.h"
 #include "nr-mac-pdu-info.h"
@@ -23,7 +24,6 @@
 #include "nr-mac-scheduler.h"
 #include "nr-phy-mac-common.h"
 #include "nr-phy-sap.h"
-#include <queue>
 
 #include <ns3/traced-callback.h>
 
@@ -36,19 +36,6 @@ class NrControlMessage;
 class NrRarMessage;
 class BeamId;
 
-/*
- * 평균 AoI 계산 및 출력을 위한 gNB에서 UE 정보를 관리하는 구조체 선언
- */
-struct UeInfo
-{
-    uint64_t info_lastPacketCreationTime; // SR 메시지에 포함되어 있는 패킷 생성 시간을 저장하는 변수
-    uint64_t info_before_scheduling_time; // 스케줄러에게 파라미터를 보내는 시점이 저장되는 변수
-    uint64_t info_current_aoi;  // 스케줄러가 파라미터로 사용할 AoI를 저장하는 변수
-    uint32_t info_wma=1;  // 데이터 전송 성공에 대한 카운트 수치 (gNB용)
-    bool info_last_transmission_successful; // 이전 데이터 전송 성공 여부를 판단하기 위한 변수
-};
-
-
 /**
  * TODO
  * My Environment Gateway callback function
@@ -119,13 +106,6 @@ class NrGnbMac : public Object
     friend class MemberNrCcmMacSapProvider<NrGnbMac>;
 
   public:
-    /**
-     * UE별 패킷 생성 시간 큐를 map으로 구성함.
-     * BSR을 받을 때, Queue도 함께 받음
-     * 따라서 <rnti, packetCreationTimeQueue> map을 저장할 멤버 변수 선언
-     */
-    std::unordered_map<uint16_t, std::queue<uint64_t>> gnb_mac_Ctime_queue_map;
-
     /**
      * \brief Get the TypeId
      * \return the TypeId
@@ -313,6 +293,17 @@ class NrGnbMac : public Object
                                                      const uint8_t bwpId,
                                                      Ptr<NrControlMessage>);
 
+    /**
+     *  TracedCallback signature for the UL packets delivered, for the AoI.
+     *
+     * \param [in] cellId
+     * \param [in] rnti
+     * \param [in] creation time of the delivered packet, in microseconds
+     */
+    typedef void (*UlAoiDeliveryTracedCallback)(const uint16_t cellId,
+                                                const uint16_t rnti,
+                                                const uint64_t creationTime);
+
   protected:
     /**
      * \brief DoDispose method inherited from Object
@@ -342,6 +333,12 @@ class NrGnbMac : public Object
      */
     std::shared_ptr<DciInfoElementTdma> GetUlCtrlDci() const;
 
+    /**
+     * \brief Get the creation times of the UL packets of the UEs, for the AoI
+     * \return the tracker fed by the SR messages and popped by the UL HARQ ACKs
+     */
+    Ptr<NrAoiTimestampTracker> GetAoiTimestampTracker() const;
+
   private:
     void ReceiveRachPreamble(uint32_t raId);
     void DoReceiveRachPreamble(uint32_t raId);
@@ -478,6 +475,8 @@ class NrGnbMac : public Object
 
     std::list<uint16_t> m_srRntiList; //!< List of RNTI that requested a SR
 
+    Ptr<NrAoiTimestampTracker> m_aoiTracker; //!< Creation times of the UL packets of the UEs
+
     std::unordered_map<uint8_t, uint32_t> m_rapIdRntiMap; //!< RAPID RNTI map
 
     TracedCallback<uint8_t, uint16_t> m_srCallback; //!< Callback invoked when a UE requested a SR
@@ -507,6 +506,11 @@ class NrGnbMac : public Object
      */
     TracedCallback<const DlHarqInfo&> m_dlHarqFeedback;
 
+    /**
+     * Trace the creation time of the UL packets acknowledged by the UL HARQ, for the AoI.
+     */
+    TracedCallback<uint16_t, uint16_t, uint64_t> m_ulAoiDelivery;
+
     void ProcessRaPreambles(const SfnSf& sfnSf);
     void SetNumberOfRaPreambles(uint8_t numberOfRaPreambles);
     void SetPreambleTransMax(uint8_t preambleTransMax);
@@ -11,6 +11,9 @@
 #include <ns3/log.h>
 #include <ns3/simulator.h>
 
+#include <algorithm>
+#include <numeric>
+
 namespace ns3
 {
 
@@ -39,6 +42,8 @@ NrInterferenceBase::DoDispose()
     m_rxSignal = nullptr;
     m_allSignals = nullptr;
     m_noise = nullptr;
+    m_interfScratch = nullptr;
+    m_sinrScratch = nullptr;
     Object::DoDispose();
 }
 
@@ -56,7 +61,8 @@ NrInterferenceBase::StartRx(Ptr<const SpectrumValue> rxPsd)
     if (!m_receiving)
     {
         NS_LOG_LOGIC("first signal");
-        m_rxSignal = rxPsd->Copy();
+        PrepareScratch(m_rxSignal, *rxPsd);
+        std::copy(rxPsd->ConstValuesBegin(), rxPsd->ConstValuesEnd(), m_rxSignal->ValuesBegin());
         m_lastChangeTime = Now();
         m_receiving = true;
         for (auto it = m_rsPowerChunkProcessorList.begin(); it != m_rsPowerChunkProcessorList.end();
@@ -80,7 +86,10 @@ NrInterferenceBase::StartRx(Ptr<const SpectrumValue> rxPsd)
         // receiving multiple simultaneous signals, make sure they are synchronized
         NS_ASSERT(m_lastChangeTime == Now());
         // make sure they use orthogonal resource blocks
-        NS_ASSERT(Sum((*rxPsd) * (*m_rxSignal)) == 0.0);
+        NS_ASSERT(std::inner_product(rxPsd->ConstValuesBegin(),
+                                     rxPsd->ConstValuesEnd(),
+                                     m_rxSignal->ConstValuesBegin(),
+                                     0.0) == 0.0);
         (*m_rxSignal) += (*rxPsd);
     }
 }
@@ -170,18 +179,17 @@ NrInterferenceBase::ConditionallyEvaluateChunk()
         NS_LOG_LOGIC(this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals
                           << " noise = " << *m_noise);
 
-        SpectrumValue interf = (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+        ComputeInterfAndSinr();
 
-        SpectrumValue sinr = (*m_rxSignal) / interf;
         Time duration = Now() - m_lastChangeTime;
         for (auto it = m_sinrChunkProcessorList.begin(); it != m_sinrChunkProcessorList.end(); ++it)
         {
-            (*it)->EvaluateChunk(sinr, duration);
+            (*it)->EvaluateChunk(*m_sinrScratch, duration);
         }
         for (auto it = m_interfChunkProcessorList.begin(); it != m_interfChunkProcessorList.end();
              ++it)
         {
-            (*it)->EvaluateChunk(interf, duration);
+            (*it)->EvaluateChunk(*m_interfScratch, duration);
         }
         for (auto it = m_rsPowerChunkProcessorList.begin(); it != m_rsPowerChunkProcessorList.end();
              ++it)
@@ -192,6 +200,49 @@ NrInterferenceBase::ConditionallyEvaluateChunk()
     }
 }
 
+void
+NrInterferenceBase::PrepareScratch(Ptr<SpectrumValue>& buffer, const SpectrumValue& ref)
+{
+    if (!buffer || buffer->GetSpectrumModelUid() != ref.GetSpectrumModelUid())
+    {
+        buffer = Create<SpectrumValue>(ref.GetSpectrumModel());
+    }
+}
+
+double
+NrInterferenceBase::ComputeInterfAndSinr(double rssiBandwidth)
+{
+    NS_LOG_FUNCTION(this);
+    PrepareScratch(m_interfScratch, *m_rxSignal);
+    PrepareScratch(m_sinrScratch, *m_rxSignal);
+    NS_ASSERT(m_allSignals->GetSpectrumModelUid() == m_rxSignal->GetSpectrumModelUid());
+    NS_ASSERT(m_noise->GetSpectrumModelUid() == m_rxSignal->GetSpectrumModelUid());
+
+    // plain loops over contiguous arrays, which the compiler vectorizes
+    const size_t numBands = m_rxSignal->GetValuesN();
+    const double* all = &(*m_allSignals->ConstValuesBegin());
+    const double* rx = &(*m_rxSignal->ConstValuesBegin());
+    const double* noise = &(*m_noise->ConstValuesBegin());
+    double* interf = &(*m_interfScratch->ValuesBegin());
+    double* sinr = &(*m_sinrScratch->ValuesBegin());
+    for (size_t i = 0; i < numBands; ++i)
+    {
+        interf[i] = all[i] - rx[i] + noise[i];
+        sinr[i] = rx[i] / interf[i];
+    }
+
+    // accumulated in band order, as Sum() does
+    double rssi = 0.0;
+    if (rssiBandwidth != 0.0)
+    {
+        for (size_t i = 0; i < numBands; ++i)
+        {
+            rssi += (noise[i] + all[i]) * rssiBandwidth;
+        }
+    }
+    return rssi;
+}
+
 void
 NrInterferenceBase::SetNoisePowerSpectralDensity(Ptr<const SpectrumValue> noisePsd)
 {
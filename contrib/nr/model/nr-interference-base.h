@@ -114,6 +114,32 @@ class NrInterferenceBase : public Object
      */
     virtual void DoSubtractSignal(Ptr<const SpectrumValue> spd, uint32_t signalId);
 
+    /**
+     * \brief Make sure that a scratch buffer has the spectrum model of a reference value
+     *
+     * The buffer is (re)allocated only when it does not exist yet or when the spectrum
+     * model changed, so that it can be reused by every chunk of every RX.
+     *
+     * @param buffer the scratch buffer
+     * @param ref the value whose spectrum model is used
+     */
+    static void PrepareScratch(Ptr<SpectrumValue>& buffer, const SpectrumValue& ref);
+
+    /**
+     * \brief Compute the interference plus noise and the SINR of the signal being received
+     *
+     * The results are written in m_interfScratch and m_sinrScratch in a single pass over
+     * the bands, without temporary SpectrumValue. The per-band operations are the ones of
+     * (*m_allSignals) - (*m_rxSignal) + (*m_noise) and (*m_rxSignal) / interf, so the
+     * results are the same.
+     *
+     * @param rssiBandwidth if not zero, the bandwidth of a band (Hz) used to compute the
+     * total received power
+     * @return the total received power plus noise (W), i.e., the sum over the bands of
+     * (noise + all signals) * rssiBandwidth, or 0 if rssiBandwidth is zero
+     */
+    double ComputeInterfAndSinr(double rssiBandwidth = 0.0);
+
     bool m_receiving{false}; ///< are we receiving?
 
     Ptr<SpectrumValue> m_rxSignal{nullptr}; /**< stores the power spectral density of
@@ -129,6 +155,9 @@ class NrInterferenceBase : public Object
 
     Ptr<const SpectrumValue> m_noise{nullptr}; ///< the noise value
 
+    Ptr<SpectrumValue> m_interfScratch{nullptr}; ///< interference plus noise of the last chunk
+    Ptr<SpectrumValue> m_sinrScratch{nullptr};   ///< SINR of the last chunk
+
     Time m_lastChangeTime{Seconds(0)}; /**< the time of the last change in
                                         * m_TotalPower
                                         */
@@ -37,6 +37,9 @@ NrInterference::DoDispose()
     m_mimoChunkProcessors.clear();
     m_rxSignalsMimo.clear();
     m_allSignalsMimo.clear();
+    m_allSignalsCov = NrCovMat{};
+    m_noiseRise = nullptr;
+    m_numNoiseRiseSignals = 0;
 
     NrInterferenceBase::DoDispose();
 }
@@ -79,6 +82,32 @@ NrInterference::AddSignal(Ptr<const SpectrumValue> spd, Time duration)
     AppendEvent(Simulator::Now(), Simulator::Now() + duration, rxPowerW);
 
     NrInterferenceBase::AddSignal(spd, duration);
+
+    // The chunk was evaluated by NrInterferenceBase before the signal is added, so that the
+    // noise rise of the MIMO interference can be updated now
+    if (!m_noiseRise)
+    {
+        m_noiseRise = Create<SpectrumValue>(spd->GetSpectrumModel());
+    }
+    (*m_noiseRise) += (*spd);
+    m_numNoiseRiseSignals++;
+    Simulator::Schedule(duration, &NrInterference::DoSubtractNoiseRise, this, spd);
+}
+
+void
+NrInterference::DoSubtractNoiseRise(Ptr<const SpectrumValue> spd)
+{
+    NS_LOG_FUNCTION(this << *spd);
+    ConditionallyEvaluateChunk();
+    NS_ASSERT_MSG(m_noiseRise && m_numNoiseRiseSignals > 0, "No noise rise to subtract");
+    if (--m_numNoiseRiseSignals == 0)
+    {
+        m_noiseRise = nullptr;
+    }
+    else
+    {
+        (*m_noiseRise) -= (*spd);
+    }
 }
 
 void
@@ -91,8 +120,15 @@ NrInterference::EndRx()
     }
     else
     {
-        SpectrumValue snr = (*m_rxSignal) / (*m_noise);
-        double avgSnr = Sum(snr) / (snr.GetSpectrumModel()->GetNumBands());
+        // Sum((*m_rxSignal) / (*m_noise)), without the temporary SpectrumValue
+        double sumSnr = 0.0;
+        auto noiseIt = m_noise->ConstValuesBegin();
+        for (auto rxIt = m_rxSignal->ConstValuesBegin(); rxIt != m_rxSignal->ConstValuesEnd();
+             ++rxIt, ++noiseIt)
+        {
+            sumSnr += (*rxIt) / (*noiseIt);
+        }
+        double avgSnr = sumSnr / (m_rxSignal->GetSpectrumModel()->GetNumBands());
         m_snrPerProcessedChunk(avgSnr);
 
         NrInterference::ConditionallyEvaluateChunk();
@@ -131,11 +167,10 @@ NrInterference::ConditionallyEvaluateChunk()
     {
         NS_LOG_LOGIC(this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals
                           << " noise = " << *m_noise);
-        SpectrumValue interf = (*m_allSignals) - (*m_rxSignal) + (*m_noise);
-        SpectrumValue sinr = (*m_rxSignal) / interf;
         double rbWidth = (*m_rxSignal).GetSpectrumModel()->Begin()->fh -
                          (*m_rxSignal).GetSpectrumModel()->Begin()->fl;
-        double rssidBm = 10 * log10(Sum((*m_noise + *m_allSignals) * rbWidth) * 1000);
+        // interference, SINR and RSSI in a single pass, in the scratch buffers
+        double rssidBm = 10 * log10(ComputeInterfAndSinr(rbWidth) * 1000);
         m_rssiPerProcessedChunk(rssidBm);
 
         NS_LOG_DEBUG("All signals: " << (*m_allSignals)[0] << ", rxSignal:" << (*m_rxSignal)[0]
@@ -148,30 +183,45 @@ NrInterference::ConditionallyEvaluateChunk()
         }
         for (auto& it : m_sinrChunkProcessorList)
         {
-            it->EvaluateChunk(sinr, duration);
+            it->EvaluateChunk(*m_sinrScratch, duration);
         }
 
-        for (auto& cp : m_mimoChunkProcessors)
+        if (!m_mimoChunkProcessors.empty())
         {
-            // Covariance matrix of noise plus out-of-cell interference
-            auto outOfCellInterfCov = CalcOutOfCellInterfCov();
+            // Covariance matrices of noise plus all the signals, and plus out-of-cell
+            // interference, from the covariance matrix of the signals updated as they start and
+            // end, so that the cost is linear in the number of received signals
+            auto allSignalsNoiseCov = CalcAllSignalsNoiseCov();
+            auto outOfCellInterfCov = CalcOutOfCellInterfCov(allSignalsNoiseCov);
 
             // Compute the MIMO SINR separately for each received signal.
+            std::vector<NrSinrMatrix> sinrMatrices;
+            sinrMatrices.reserve(m_rxSignalsMimo.size());
             for (auto& rxSignal : m_rxSignalsMimo)
             {
-                // Use the UE's RNTI to distinguish multiple received signals
-                auto nrRxSignal = DynamicCast<const NrSpectrumSignalParametersDataFrame>(rxSignal);
-                uint16_t rnti = nrRxSignal ? nrRxSignal->rnti : 0;
-
-                // MimoSinrChunk is used to store SINR and compute TBLER of the data transmission
-                auto sinrMatrix = ComputeSinr(outOfCellInterfCov, rxSignal);
-                MimoSinrChunk mimoSinr{sinrMatrix, rnti, duration};
-                cp->EvaluateChunk(mimoSinr);
-
-                // MimoSignalChunk is used to compute PMI feedback.
-                auto& chanSpct = *(rxSignal->spectrumChannelMatrix);
-                MimoSignalChunk mimoSignal{chanSpct, outOfCellInterfCov, rnti, duration};
-                cp->EvaluateChunk(mimoSignal);
+                sinrMatrices.push_back(ComputeSinr(allSignalsNoiseCov, rxSignal));
+            }
+
+            for (auto& cp : m_mimoChunkProcessors)
+            {
+                for (size_t i = 0; i < m_rxSignalsMimo.size(); i++)
+                {
+                    // Use the UE's RNTI to distinguish multiple received signals
+                    const auto& rxSignal = m_rxSignalsMimo[i];
+                    auto nrRxSignal =
+                        DynamicCast<const NrSpectrumSignalParametersDataFrame>(rxSignal);
+                    uint16_t rnti = nrRxSignal ? nrRxSignal->rnti : 0;
+
+                    // MimoSinrChunk is used to store SINR and compute TBLER of the data
+                    // transmission
+                    MimoSinrChunk mimoSinr{sinrMatrices[i], rnti, duration};
+                    cp->EvaluateChunk(mimoSinr);
+
+                    // MimoSignalChunk is used to compute PMI feedback.
+                    auto& chanSpct = *(rxSignal->spectrumChannelMatrix);
+                    MimoSignalChunk mimoSignal{chanSpct, outOfCellInterfCov, rnti, duration};
+                    cp->EvaluateChunk(mimoSignal);
+                }
             }
         }
         m_lastChangeTime = Now();
@@ -333,6 +383,10 @@ NrInterference::AddSignalMimo(Ptr<const SpectrumSignalParameters> params, const
     NS_LOG_FUNCTION(this << *params->psd << duration);
     NrInterferenceBase::DoAddSignal(params->psd);
     m_allSignalsMimo.push_back(params);
+    if (!m_mimoChunkProcessors.empty())
+    {
+        AddToAllSignalsCov(params);
+    }
     // Update signal ID to match signal ID in NrInterferenceBase
     if (++m_lastSignalId == m_lastSignalIdBeforeReset)
     {
@@ -385,17 +439,38 @@ NrInterference::DoSubtractSignalMimo(Ptr<const SpectrumSignalParameters> params,
     }
     NS_ASSERT_MSG(m_allSignalsMimo.size() == (numSignals - 1),
                   "MIMO signal was not found for removal");
+    if (m_mimoChunkProcessors.empty())
+    {
+        return;
+    }
+    if (m_allSignalsMimo.empty())
+    {
+        m_allSignalsCov = NrCovMat{};
+    }
+    else if (params->spectrumChannelMatrix)
+    {
+        SubtractInterference(m_allSignalsCov, params);
+    }
 }
 
 void
 NrInterference::AddMimoChunkProcessor(Ptr<NrMimoChunkProcessor> cp)
 {
     NS_LOG_FUNCTION(this << cp);
+    if (m_mimoChunkProcessors.empty())
+    {
+        // The covariance matrix of the signals is only maintained with MIMO chunk processors
+        m_allSignalsCov = NrCovMat{};
+        for (const auto& signal : m_allSignalsMimo)
+        {
+            AddToAllSignalsCov(signal);
+        }
+    }
     m_mimoChunkProcessors.push_back(cp);
 }
 
 NrCovMat
-NrInterference::CalcOutOfCellInterfCov() const
+NrInterference::CalcAllSignalsNoiseCov() const
 {
     // Extract dimensions from first receive signal. Interference signals have equal dimensions
     NS_ASSERT_MSG(!(m_rxSignalsMimo.empty()), "At least one receive signal is required");
@@ -403,56 +478,58 @@ NrInterference::CalcOutOfCellInterfCov() const
     NS_ASSERT_MSG(firstSignal->spectrumChannelMatrix, "signal must have a channel matrix");
     auto nRbs = firstSignal->spectrumChannelMatrix->GetNumPages();
     auto nRxPorts = firstSignal->spectrumChannelMatrix->GetNumRows();
+    NS_ASSERT_MSG((m_allSignalsCov.GetNumRows() == nRxPorts) &&
+                      (m_allSignalsCov.GetNumPages() == nRbs),
+                  "The receive signals must be part of the covariance matrix of all signals");
 
-    // Create white noise covariance matrix
-    auto allSignalsNoiseCov = NrCovMat{ComplexMatrixArray(nRxPorts, nRxPorts, nRbs)};
+    // Add the white noise, and the noise rise of the signals without channel matrix, to the
+    // covariance matrix of all the signals
+    auto allSignalsNoiseCov = m_allSignalsCov;
     for (size_t iRb = 0; iRb < nRbs; iRb++)
     {
-        for (size_t iRxPort = 0; iRxPort < nRxPorts; iRxPort++)
+        auto noise = m_noise->ValuesAt(iRb);
+        if (m_noiseRise)
         {
-            allSignalsNoiseCov(iRxPort, iRxPort, iRb) = m_noise->ValuesAt(iRb);
+            noise += m_noiseRise->ValuesAt(iRb);
         }
-    }
-
-    // Add all external interference signals to the covariance matrix
-    for (const auto& intfSignal : m_allSignalsMimo)
-    {
-        if (std::find(m_rxSignalsMimo.begin(), m_rxSignalsMimo.end(), intfSignal) !=
-            m_rxSignalsMimo.end())
+        for (size_t iRxPort = 0; iRxPort < nRxPorts; iRxPort++)
         {
-            // This is one of the signals in the current cell
-            continue;
+            allSignalsNoiseCov(iRxPort, iRxPort, iRb) += noise;
         }
-
-        AddInterference(allSignalsNoiseCov, intfSignal);
     }
     return allSignalsNoiseCov;
 }
 
 NrCovMat
-NrInterference::CalcCurrInterfCov(Ptr<const SpectrumSignalParameters> rxSignal,
-                                  const NrCovMat& outOfCellInterfCov) const
+NrInterference::CalcOutOfCellInterfCov(const NrCovMat& allSignalsNoiseCov) const
 {
-    // Add also the potential interfering signals intended for this device but belonging to other
-    // transmissions. This is required for a gNB receiving MU-MIMO UL signals from multiple UEs
-    auto interfNoiseCov = outOfCellInterfCov;
-    for (auto& otherSignal : m_rxSignalsMimo)
+    // Remove the signals of the current cell from the covariance matrix of all the signals
+    auto outOfCellInterfCov = allSignalsNoiseCov;
+    for (const auto& rxSignal : m_rxSignalsMimo)
     {
-        if (otherSignal == rxSignal)
-        {
-            continue; // this is the current receive signal of interest, do not add to interference
-        }
-        NS_ASSERT_MSG((std::find(m_allSignalsMimo.begin(), m_allSignalsMimo.end(), otherSignal) !=
+        NS_ASSERT_MSG((std::find(m_allSignalsMimo.begin(), m_allSignalsMimo.end(), rxSignal) !=
                        m_allSignalsMimo.end()),
                       "RX signal already deleted from m_allSignalsMimo");
-
-        AddInterference(interfNoiseCov, otherSignal);
+        SubtractInterference(outOfCellInterfCov, rxSignal);
     }
+    return outOfCellInterfCov;
+}
+
+NrCovMat
+NrInterference::CalcCurrInterfCov(Ptr<const SpectrumSignalParameters> rxSignal,
+                                  const NrCovMat& allSignalsNoiseCov) const
+{
+    // The potential interfering signals intended for this device but belonging to other
+    // transmissions are kept. This is required for a gNB receiving MU-MIMO UL signals from
+    // multiple UEs. The current receive signal of interest is removed: a rank update of the
+    // covariance matrix of all the signals.
+    auto interfNoiseCov = allSignalsNoiseCov;
+    SubtractInterference(interfNoiseCov, rxSignal);
     return interfNoiseCov;
 }
 
-void
-NrInterference::AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParameters> signal) const
+ComplexMatrixArray
+NrInterference::GetPrecodedChannel(Ptr<const SpectrumSignalParameters> signal)
 {
     const auto& chanSpct = *(signal->spectrumChannelMatrix);
     if (signal->precodingMatrix)
@@ -463,21 +540,47 @@ NrInterference::AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParame
         NS_ASSERT_MSG(precMats.GetNumPages() == chanSpct.GetNumPages(),
                       "dim mismatch " << precMats.GetNumPages() << " vs "
                                       << chanSpct.GetNumPages());
-        covMat.AddInterferenceSignal(chanSpct * precMats);
+        return chanSpct * precMats;
     }
-    else
+    return chanSpct;
+}
+
+void
+NrInterference::AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParameters> signal) const
+{
+    covMat.AddInterferenceSignal(GetPrecodedChannel(signal));
+}
+
+void
+NrInterference::SubtractInterference(NrCovMat& covMat,
+                                     Ptr<const SpectrumSignalParameters> signal) const
+{
+    covMat.SubtractInterferenceSignal(GetPrecodedChannel(signal));
+}
+
+void
+NrInterference::AddToAllSignalsCov(Ptr<const SpectrumSignalParameters> signal)
+{
+    if (!signal->spectrumChannelMatrix)
+    {
+        return;
+    }
+    if (m_allSignalsCov.GetSize() == 0)
     {
-        covMat.AddInterferenceSignal(chanSpct);
+        const auto& chanSpct = *(signal->spectrumChannelMatrix);
+        auto nRxPorts = chanSpct.GetNumRows();
+        m_allSignalsCov = NrCovMat{ComplexMatrixArray{nRxPorts, nRxPorts, chanSpct.GetNumPages()}};
     }
+    AddInterference(m_allSignalsCov, signal);
 }
 
 NrSinrMatrix
-NrInterference::ComputeSinr(NrCovMat& outOfCellInterfCov,
+NrInterference::ComputeSinr(const NrCovMat& allSignalsNoiseCov,
                             Ptr<const SpectrumSignalParameters> rxSignal) const
 {
     // Calculate the interference+noise (I+N) covariance matrix for this signal,
     // including interference from other RX signals
-    auto interfNoiseCov = CalcCurrInterfCov(rxSignal, outOfCellInterfCov);
+    auto interfNoiseCov = CalcCurrInterfCov(rxSignal, allSignalsNoiseCov);
 
     // Interference whitening: normalize the signal such that interference + noise covariance matrix
     // is the identity matrix
@@ -7,6 +7,7 @@
 
 #include "nr-chunk-processor.h"
 #include "nr-interference-base.h"
+#include "nr-mimo-matrices.h"
 
 #include <ns3/nstime.h>
 #include <ns3/object.h>
@@ -21,8 +22,6 @@ namespace ns3
 // Signal ID increment used in LteInterference
 static constexpr uint32_t NR_LTE_SIGNALID_INCR = 0x10000000;
 
-class NrCovMat;
-class NrSinrMatrix;
 class NrErrorModel;
 class NrMimoChunkProcessor;
 
@@ -53,6 +52,13 @@ class NrInterference : public NrInterferenceBase
      */
     static TypeId GetTypeId();
 
+    /**
+     * \brief Add a signal without channel matrix, e.g., a negligible interference of another
+     * cell. In the MIMO interference, it is a spatially white noise rise, added to the noise of
+     * all the receive ports while the signal lasts.
+     * \param spd the power spectral density of the signal
+     * \param duration the duration of the signal
+     */
     void AddSignal(Ptr<const SpectrumValue> spd, Time duration) override;
 
     /**
@@ -121,31 +127,57 @@ class NrInterference : public NrInterferenceBase
     virtual void AddMimoChunkProcessor(Ptr<NrMimoChunkProcessor> cp);
 
   private:
+    /// \brief Subtract the noise rise of a signal added by AddSignal, when it ends
+    /// \param spd the power spectral density of the signal
+    void DoSubtractNoiseRise(Ptr<const SpectrumValue> spd);
+
+    /// \brief Calculate the covariance matrix of all the incoming signals, plus noise
+    /// \return the interference+noise covariance matrix of all the signals
+    NrCovMat CalcAllSignalsNoiseCov() const;
+
     /// \brief Calculate interference-plus-noise covariance matrix for signals not in m_rxSignals
-    /// This function computes the interference signals from all out-of-cell interferers. The
-    /// intra-cell interference signals that are part of m_rxSignals are skipped.
+    /// The intra-cell signals that are part of m_rxSignals are subtracted from the covariance of
+    /// all the signals.
+    /// \param allSignalsNoiseCov the covariance matrix of all the signals, plus noise
     /// \return the interference+noise covariance matrix for out-of-cell interference
-    NrCovMat CalcOutOfCellInterfCov() const;
+    NrCovMat CalcOutOfCellInterfCov(const NrCovMat& allSignalsNoiseCov) const;
 
-    /// \brief Add the remaining interference to the interference-and-noise covariance matrix
-    /// This function is required for MU-MIMO UL, where the signal from a different UE within the
-    /// same cell can act as interference towards the current signal.
+    /// \brief Calculate the interference-and-noise covariance matrix of a received signal
+    /// The received signal is subtracted from the covariance of all the signals, so that the
+    /// other signals intended for this device are kept as interference. This is required for
+    /// MU-MIMO UL, where the signal from a different UE within the same cell can act as
+    /// interference towards the current signal.
     /// \param rxSignal the parameters of the received signal-of-interest
-    /// \param outOfCellInterfCov the covariance matrix of out-of-cell signals, plus noise
+    /// \param allSignalsNoiseCov the covariance matrix of all the signals, plus noise
     /// \return the interference+noise covariance matrix for the current signal
     NrCovMat CalcCurrInterfCov(Ptr<const SpectrumSignalParameters> rxSignal,
-                               const NrCovMat& outOfCellInterfCov) const;
+                               const NrCovMat& allSignalsNoiseCov) const;
 
     /// \brief Add the covariance of the signal to an existing covariance matrix
     /// \param covMat the existing interference-and-noise covariance matrix
     /// \param signal the signal to be added
     void AddInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParameters> signal) const;
 
+    /// \brief Subtract the covariance of the signal from an existing covariance matrix
+    /// \param covMat the existing interference-and-noise covariance matrix
+    /// \param signal the signal to be subtracted
+    void SubtractInterference(NrCovMat& covMat, Ptr<const SpectrumSignalParameters> signal) const;
+
+    /// \brief Get the channel matrix of a signal, including its precoding if any
+    /// \param signal the signal
+    /// \return the full channel matrix of the signal
+    static ComplexMatrixArray GetPrecodedChannel(Ptr<const SpectrumSignalParameters> signal);
+
+    /// \brief Add a signal to the covariance matrix of all the incoming signals, if it has a
+    /// channel matrix
+    /// \param signal the signal to be added
+    void AddToAllSignalsCov(Ptr<const SpectrumSignalParameters> signal);
+
     /// \brief Compute the SINR of the current receive signal
-    /// \param outOfCellInterfCov the covariance matrix of out-of-cell signals, plus noise
+    /// \param allSignalsNoiseCov the covariance matrix of all the signals, plus noise
     /// \param rxSignal the receive signal
     /// \return the SINR of the receive signal
-    NrSinrMatrix ComputeSinr(NrCovMat& outOfCellInterfCov,
+    NrSinrMatrix ComputeSinr(const NrCovMat& allSignalsNoiseCov,
                              Ptr<const SpectrumSignalParameters> rxSignal) const;
 
     /// Stores the params of all incoming signals, including the interference signals
@@ -154,6 +186,20 @@ class NrInterference : public NrInterferenceBase
     /// Stores the params of all incoming signals intended for this receiver
     std::vector<Ptr<const SpectrumSignalParameters>> m_rxSignalsMimo;
 
+    /// Covariance matrix of the signals of m_allSignalsMimo that have a channel matrix, without
+    /// noise. It is only maintained with MIMO chunk processors: the signals are added when they
+    /// start and subtracted when they end, and the matrix is cleared when no signal is left, so
+    /// that the rounding errors do not accumulate.
+    NrCovMat m_allSignalsCov;
+
+    /// Sum of the power spectral densities of the signals added by AddSignal, i.e., without
+    /// channel matrix, that are part of the noise of the MIMO interference. Null when no such
+    /// signal is left, so that the rounding errors do not accumulate.
+    Ptr<SpectrumValue> m_noiseRise;
+
+    /// Number of the signals of m_noiseRise
+    size_t m_numNoiseRiseSignals{0};
+
     /// The processor instances that are notified whenever a new interference chunk is calculated
     std::list<Ptr<NrMimoChunkProcessor>> m_mimoChunkProcessors;
 
@@ -7,11 +7,11 @@
 
 #include "nr-control-messages.h"
 #include "nr-phy-mac-common.h"
-#include <queue>
 
 namespace ns3
 {
 
+class NrAoiTimestampTracker;
 class SpectrumModel;
 
 /**
@@ -82,14 +82,12 @@ class NrMacSchedSapProvider
 
     /**
      * \brief UL HARQ information to be used when scheduling UL data.
-     * Rnti 별 패킷 생성 시간 큐 map 변수 추가
      */
     struct SchedUlTriggerReqParameters
     {
         SfnSf m_snfSf;                                   //!< SfnSf
         std::vector<struct UlHarqInfo> m_ulHarqInfoList; //!< UL HARQ info list
         LteNrTddSlotType m_slotType{F};                  //!< Indicate the type of slot requested
-        std::unordered_map<uint16_t, std::queue<uint64_t>> sched_packetCreationTimes;   // UE 별 패킷 생성 시간 큐
     };
 
     /**
@@ -113,7 +111,6 @@ class NrMacSchedSapProvider
     {
         SfnSf m_snfSf;                  //!< SnfSf in which the sr where received
         std::vector<uint16_t> m_srList; //!< List of RNTI which asked for a SR
-        std::unordered_map<uint16_t, std::queue<uint64_t>> sched_packet_ctime_queue_map;    // rnti 별 패킷 생성시간 큐 맵 변수
     };
 
     /**
@@ -263,6 +260,13 @@ class NrMacSchedSapUser
      * @param slotAllocInfo Allocations
      */
     virtual void BuildRarList(SlotAllocInfo& slotAllocInfo) = 0;
+
+    /**
+     * \brief Get the creation times of the UL packets of the UEs, kept by the MAC
+     * \return the tracker shared by the MAC and the scheduler, or nullptr if the MAC
+     * does not track them
+     */
+    virtual Ptr<NrAoiTimestampTracker> GetAoiTimestampTracker() const = 0;
 };
 
 inline std::ostream&
@@ -40,7 +40,17 @@ NrMacSchedulerAiNs3GymEnv::GetTypeId()
 {
     static TypeId tid = TypeId("NrMacSchedulerAiNs3GymEnv")
                             .SetParent<OpenGymEnv>()
-                            .AddConstructor<NrMacSchedulerAiNs3GymEnv>();
+                            .AddConstructor<NrMacSchedulerAiNs3GymEnv>()
+                            .AddAttribute("MaxFlows",
+                                          "Rows of the fixed-shape observation [MaxFlows, 7] "
+                                          "(6 columns and a validity mask), stably indexed by "
+                                          "flow. 0 uses the variable-shape observation "
+                                          "[numFlows, 6].",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(
+                                              &NrMacSchedulerAiNs3GymEnv::SetMaxFlows,
+                                              &NrMacSchedulerAiNs3GymEnv::GetMaxFlows),
+                                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
@@ -69,7 +79,7 @@ NrMacSchedulerAiNs3GymEnv::GetObservationSpace()
     float high = 100.0;
     std::vector<uint32_t> shape = {
         m_numFlows,
-        6,
+        m_maxFlows > 0 ? 7U : 6U,
     };
     std::string dtype = TypeNameGet<uint16_t>();
     return Create<OpenGymBoxSpace>(low, high, shape, dtype);
@@ -86,6 +96,23 @@ Ptr<OpenGymDataContainer>
 NrMacSchedulerAiNs3GymEnv::GetObservation()
 {
     NS_LOG_FUNCTION(this);
+    if (m_maxFlows > 0)
+    {
+        // only the rows observed in this step can receive a weight
+        m_spareRowFlows.resize(m_maxFlows);
+        for (uint32_t row = 0; row < m_maxFlows; ++row)
+        {
+            m_spareRowFlows[row] =
+                m_rowLastSeen[row] == m_currentStep ? m_rowFlow[row] : NO_FLOW;
+        }
+        m_pendingSteps.push_back({m_openGymInterface->GetCurrentStepId(),
+                                  {},
+                                  m_updateAllUeWeightsFn,
+                                  std::move(m_spareRowFlows)});
+        m_spareRowFlows.clear();
+        return m_fixedObservation;
+    }
+
     std::vector<uint32_t> shape = {
         m_numFlows,
         6,
@@ -102,6 +129,8 @@ NrMacSchedulerAiNs3GymEnv::GetObservation()
         observation->AddValue(obs.cqi);
         // observation->AddValue(obs.sinr);
     }
+    m_pendingSteps.push_back(
+        {m_openGymInterface->GetCurrentStepId(), m_observation, m_updateAllUeWeightsFn, {}});
     return observation;
 }
 
@@ -127,21 +156,56 @@ bool
 NrMacSchedulerAiNs3GymEnv::ExecuteActions(Ptr<OpenGymDataContainer> action)
 {
     NS_LOG_FUNCTION(this);
+    // Observations older than the answered one will never be answered (the agent skipped them)
+    uint64_t stepId = m_openGymInterface->GetActionStepId();
+    while (!m_pendingSteps.empty() && m_pendingSteps.front().stepId < stepId)
+    {
+        m_pendingSteps.pop_front();
+    }
+    if (m_pendingSteps.empty() || m_pendingSteps.front().stepId != stepId)
+    {
+        NS_LOG_WARN("No observation found for the action of step " << stepId);
+        return false;
+    }
+    PendingStep step = std::move(m_pendingSteps.front());
+    m_pendingSteps.pop_front();
+
     Ptr<OpenGymBoxContainer<float>> actionBox = DynamicCast<OpenGymBoxContainer<float>>(action);
-    std::vector<float> actionData = actionBox->GetData();
-    NrMacSchedulerUeInfoAi::UeWeightsMap ueWeightsMap;
-    for (uint32_t i = 0; i < m_numFlows; i++)
+    NS_ABORT_MSG_IF(!actionBox, "The action must be a Box of float");
+    if (!step.rowFlows.empty())
     {
-        if (ueWeightsMap.end() == ueWeightsMap.find(m_observation[i].rnti))
+        const std::vector<float>& weights = actionBox->GetDataRef();
+        NS_ABORT_MSG_IF(weights.size() < step.rowFlows.size(),
+                        "Received " << weights.size() << " weights for " << step.rowFlows.size()
+                                    << " rows");
+        NrMacSchedulerUeInfoAi::UeWeightsMap ueWeightsMap;
+        for (uint32_t row = 0; row < step.rowFlows.size(); ++row)
         {
-            ueWeightsMap[m_observation[i].rnti] = NrMacSchedulerUeInfoAi::Weights();
-            NS_LOG_UNCOND("[gym-env] <ExecuteActions> : Rnti "
-                          << m_observation[i].rnti << " received weight " << actionData[i]
-                          << " from agent");
+            uint32_t flow = step.rowFlows[row];
+            if (flow != NO_FLOW)
+            {
+                ueWeightsMap[flow >> 8][flow & 0xff] = weights[row];
+            }
         }
-        ueWeightsMap[m_observation[i].rnti][m_observation[i].lcId] = actionData[i];
+        step.updateAllUeWeightsFn(ueWeightsMap);
+        // keep the storage for the next observation
+        m_spareRowFlows = std::move(step.rowFlows);
+        return true;
     }
-    m_updateAllUeWeightsFn(ueWeightsMap);
+
+    const std::vector<float>& actionData = actionBox->GetDataRef();
+    NS_ABORT_MSG_IF(actionData.size() < step.observation.size(),
+                    "Received " << actionData.size() << " weights for "
+                                << step.observation.size() << " flows");
+    NrMacSchedulerUeInfoAi::UeWeightsMap ueWeightsMap;
+    for (uint32_t i = 0; i < step.observation.size(); i++)
+    {
+        const auto& obs = step.observation[i];
+        NS_LOG_DEBUG("Rnti " << obs.rnti << " LC " << +obs.lcId << " received weight "
+                             << actionData[i] << " from agent");
+        ueWeightsMap[obs.rnti][obs.lcId] = actionData[i];
+    }
+    step.updateAllUeWeightsFn(ueWeightsMap);
     return true;
 }
 
@@ -154,16 +218,23 @@ NrMacSchedulerAiNs3GymEnv::NotifyCurrentIteration(
     const NrMacSchedulerUeInfoAi::UpdateAllUeWeightsFn& updateAllUeWeightsFn)
 {
     NS_LOG_FUNCTION(this);
-    if (m_numFlows != observations.size())
+    m_currentStep++;
+    if (m_maxFlows > 0)
+    {
+        FillFixedObservation(observations);
+    }
+    else
     {
-        m_numFlows = observations.size();
+        if (m_numFlows != observations.size())
+        {
+            m_numFlows = observations.size();
+        }
+        m_observation = observations;
     }
-    m_observation = observations;
     m_gameOver = isGameOver;
     m_reward = reward;
     m_extraInfo = extraInfo;
     m_updateAllUeWeightsFn = updateAllUeWeightsFn;
-    m_currentStep++;
     // if (m_currentStep >= m_maxSteps)
     // {
     //     m_gameOver = true;
@@ -171,6 +242,97 @@ NrMacSchedulerAiNs3GymEnv::NotifyCurrentIteration(
     Notify();
 }
 
+void
+NrMacSchedulerAiNs3GymEnv::SetMaxFlows(uint32_t maxFlows)
+{
+    NS_LOG_FUNCTION(this << maxFlows);
+    m_maxFlows = maxFlows;
+    m_rowFlow.assign(maxFlows, NO_FLOW);
+    m_rowLastSeen.assign(maxFlows, 0);
+    m_flowRow.clear();
+    m_flowRow.reserve(maxFlows);
+    m_fixedObservation = nullptr;
+    if (maxFlows > 0)
+    {
+        m_numFlows = maxFlows;
+        m_fixedObservation =
+            CreateObject<OpenGymBoxContainer<uint16_t>>(std::vector<uint32_t>{maxFlows, 7});
+        m_fixedObservation->SetData(std::vector<uint16_t>(maxFlows * 7, 0));
+    }
+}
+
+uint32_t
+NrMacSchedulerAiNs3GymEnv::GetMaxFlows() const
+{
+    return m_maxFlows;
+}
+
+void
+NrMacSchedulerAiNs3GymEnv::FillFixedObservation(
+    const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations)
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<uint16_t>& data = m_fixedObservation->GetDataRef();
+    for (const auto& obs : observations)
+    {
+        uint32_t flow = (static_cast<uint32_t>(obs.rnti) << 8) | obs.lcId;
+        uint32_t row = NO_FLOW;
+        auto it = m_flowRow.find(flow);
+        if (it != m_flowRow.end())
+        {
+            row = it->second;
+        }
+        else
+        {
+            // a row never used, otherwise the one unseen for the longest time
+            uint64_t oldest = m_currentStep;
+            for (uint32_t r = 0; r < m_maxFlows; ++r)
+            {
+                if (m_rowFlow[r] == NO_FLOW)
+                {
+                    row = r;
+                    break;
+                }
+                if (m_rowLastSeen[r] < oldest)
+                {
+                    oldest = m_rowLastSeen[r];
+                    row = r;
+                }
+            }
+            if (row == NO_FLOW)
+            {
+                NS_LOG_WARN("More than " << m_maxFlows << " flows, RNTI " << obs.rnti << " LC "
+                                         << +obs.lcId << " is not observed");
+                continue;
+            }
+            if (m_rowFlow[row] != NO_FLOW)
+            {
+                m_flowRow.erase(m_rowFlow[row]);
+            }
+            m_rowFlow[row] = flow;
+            m_flowRow[flow] = row;
+        }
+        m_rowLastSeen[row] = m_currentStep;
+
+        auto value = data.begin() + row * 7;
+        *value++ = obs.rnti;
+        *value++ = obs.lcId;
+        *value++ = obs.priority;
+        *value++ = obs.holDelay;
+        *value++ = obs.aoi;
+        *value++ = obs.cqi;
+        *value = 1;
+    }
+    // rows of the flows not observed in this step are empty
+    for (uint32_t row = 0; row < m_maxFlows; ++row)
+    {
+        if (m_rowLastSeen[row] != m_currentStep)
+        {
+            std::fill_n(data.begin() + row * 7, 7, 0);
+        }
+    }
+}
+
 } // namespace ns3
 
 #endif // HAVE_OPENGYM
@@ -15,6 +15,9 @@
 #include "ns3/nr-module.h"
 #include "ns3/opengym-module.h"
 
+#include <deque>
+#include <unordered_map>
+
 namespace ns3
 {
 /**
@@ -91,7 +94,9 @@ class NrMacSchedulerAiNs3GymEnv : public OpenGymEnv
      * environment, the observation space is also defined as a continuous space where each
      * observation is a set of parameters describing the flows (e.g., RNTI, LCID, HOL delay,
      * priority). The observation values are bounded between `low` (0.0) and `high` (100.0) and the
-     * space has a shape of `[m_numFlows, 4]`, meaning each flow has four observable properties.
+     * space has a shape of `[m_numFlows, 6]` (RNTI, LC ID, priority, HOL delay, AoI and CQI), or
+     * `[MaxFlows, 7]` with the validity mask (see SetMaxFlows). Both the ZMQ and the shared memory
+     * transports deliver the observation to the agent with this shape.
      */
     Ptr<OpenGymSpace> GetObservationSpace() override;
 
@@ -141,6 +146,10 @@ class NrMacSchedulerAiNs3GymEnv : public OpenGymEnv
      * weight for a specific flow. The method updates the internal scheduler state by adjusting the
      * weights of the flows based on the RL model's decisions. After applying the actions, the
      * scheduler's behavior is updated accordingly.
+     *
+     * The action is matched to the observation it answers through the step id tagged by the
+     * OpenGymInterface, so that in the pipelined mode an action that arrives some slots later is
+     * still mapped to the flows (and UEs) of its own observation.
      */
     bool ExecuteActions(Ptr<OpenGymDataContainer> action) override;
 
@@ -168,12 +177,52 @@ class NrMacSchedulerAiNs3GymEnv : public OpenGymEnv
     // 상태와 보상 업데이트를 위한 메서드
     void UpdateState(const std::vector<double>& observations, float reward);
 
+    /**
+     * @brief Set the maximum number of flows of the fixed-shape observation
+     * @param maxFlows the number of rows of the observation, 0 for the variable-shape one
+     *
+     * With a non-zero MaxFlows the observation has the fixed shape [MaxFlows, 7]: the six
+     * columns of the variable-shape observation plus a validity mask (1 for a row that holds a
+     * flow observed in the current step, 0 for an empty row, whose other columns are 0). The
+     * action has the shape [MaxFlows] and the weights of the empty rows are ignored. Each flow
+     * (RNTI, LC ID) keeps its row as long as possible: a new flow takes a row never used before
+     * if any, otherwise the row of the flow unseen for the longest time. Flows that find no row
+     * (more than MaxFlows flows in the same step) are not observed.
+     */
+    void SetMaxFlows(uint32_t maxFlows);
+
+    /**
+     * @brief Get the maximum number of flows of the fixed-shape observation
+     * @return the number of rows of the observation, 0 for the variable-shape one
+     */
+    uint32_t GetMaxFlows() const;
+
     void SetScheduler(Ptr<NrMacSchedulerNs3> scheduler)
     {
         m_scheduler = scheduler;
     }
 
   private:
+    /**
+     * @brief An observation sent to the RL model and not answered yet
+     */
+    struct PendingStep
+    {
+        uint64_t stepId; //!< Step id assigned by the OpenGymInterface
+        std::vector<NrMacSchedulerUeInfoAi::LcObservation> observation; //!< Observed flows
+        NrMacSchedulerUeInfoAi::UpdateAllUeWeightsFn updateAllUeWeightsFn; //!< Weights update
+        std::vector<uint32_t> rowFlows; //!< Flow of each row, with a fixed-shape observation
+    };
+
+    /**
+     * @brief Write the observations in the rows of the fixed-shape observation
+     * @param observations the observed flows
+     */
+    void FillFixedObservation(
+        const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations);
+
+    static constexpr uint32_t NO_FLOW = UINT32_MAX; //!< Key of an empty row
+
     uint32_t m_numFlows; //!< The number of flows in the environment
     bool m_gameOver;     //!< Whether the current game/episode is over
     std::vector<NrMacSchedulerUeInfoAi::LcObservation> m_observation; //!< Current observation data
@@ -184,6 +233,14 @@ class NrMacSchedulerAiNs3GymEnv : public OpenGymEnv
     uint32_t m_maxSteps = 10000;
     uint32_t m_currentStep = 0;
     Ptr<NrMacSchedulerNs3> m_scheduler;
+    std::deque<PendingStep> m_pendingSteps; //!< Observations waiting for their action
+
+    uint32_t m_maxFlows{0}; //!< Rows of the fixed-shape observation, 0 if variable
+    Ptr<OpenGymBoxContainer<uint16_t>> m_fixedObservation; //!< Reused fixed-shape observation
+    std::vector<uint32_t> m_rowFlow;      //!< Flow key (RNTI << 8 | LC ID) of each row
+    std::vector<uint64_t> m_rowLastSeen;  //!< Last step in which the flow of each row was seen
+    std::unordered_map<uint32_t, uint32_t> m_flowRow; //!< Row of each flow key
+    std::vector<uint32_t> m_spareRowFlows; //!< Storage of an answered step, reused
 };
 } // namespace ns3
 #endif
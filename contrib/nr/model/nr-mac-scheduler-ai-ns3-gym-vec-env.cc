@@ -0,0 +1,283 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-mac-scheduler-ai-ns3-gym-vec-env.h"
+
+#include "ns3/log.h"
+
+#ifdef HAVE_OPENGYM
+
+#include <algorithm>
+#include <sstream>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("NrMacSchedulerAiNs3GymVecEnv");
+NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerAiNs3GymVecEnv);
+
+NrMacSchedulerAiNs3GymVecEnv::NrMacSchedulerAiNs3GymVecEnv()
+{
+    NS_LOG_FUNCTION(this);
+    SetNumEnvs(1);
+}
+
+NrMacSchedulerAiNs3GymVecEnv::NrMacSchedulerAiNs3GymVecEnv(uint32_t numEnvs)
+{
+    NS_LOG_FUNCTION(this << numEnvs);
+    SetNumEnvs(numEnvs);
+}
+
+NrMacSchedulerAiNs3GymVecEnv::~NrMacSchedulerAiNs3GymVecEnv()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+NrMacSchedulerAiNs3GymVecEnv::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("NrMacSchedulerAiNs3GymVecEnv")
+            .SetParent<OpenGymEnv>()
+            .AddConstructor<NrMacSchedulerAiNs3GymVecEnv>()
+            // not set at construction, so that the number of cells given to the
+            // constructor is kept
+            .AddAttribute("NumEnvs",
+                          "The number of cells stepped together",
+                          TypeId::ATTR_GET | TypeId::ATTR_SET,
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&NrMacSchedulerAiNs3GymVecEnv::SetNumEnvs,
+                                               &NrMacSchedulerAiNs3GymVecEnv::GetNumEnvs),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MaxFlows",
+                          "Rows of each cell in the fixed-shape observation [K, MaxFlows, 7] "
+                          "(6 columns and a validity mask). The flows of a cell beyond MaxFlows "
+                          "are not observed.",
+                          UintegerValue(32),
+                          MakeUintegerAccessor(&NrMacSchedulerAiNs3GymVecEnv::m_maxFlows),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+void
+NrMacSchedulerAiNs3GymVecEnv::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_stepEvent.Cancel();
+    m_cells.clear();
+    m_pendingSteps.clear();
+}
+
+void
+NrMacSchedulerAiNs3GymVecEnv::SetNumEnvs(uint32_t numEnvs)
+{
+    NS_LOG_FUNCTION(this << numEnvs);
+    m_cells.resize(numEnvs);
+}
+
+uint32_t
+NrMacSchedulerAiNs3GymVecEnv::GetNumEnvs() const
+{
+    return m_cells.size();
+}
+
+NrMacSchedulerUeInfoAi::NotifyCb
+NrMacSchedulerAiNs3GymVecEnv::GetNotifyCb(uint32_t envId)
+{
+    NS_LOG_FUNCTION(this << envId);
+    NS_ABORT_MSG_IF(envId >= m_cells.size(),
+                    "Cell " << envId << " out of " << m_cells.size() << " cells");
+    return MakeCallback(&NrMacSchedulerAiNs3GymVecEnv::NotifyCurrentIteration, this).Bind(envId);
+}
+
+Ptr<OpenGymSpace>
+NrMacSchedulerAiNs3GymVecEnv::GetActionSpace()
+{
+    NS_LOG_FUNCTION(this);
+    float low = 0.0;
+    float high = 1.0;
+    std::vector<uint32_t> shape = {GetNumEnvs(), m_maxFlows};
+    std::string dtype = TypeNameGet<float>();
+    return Create<OpenGymBoxSpace>(low, high, shape, dtype);
+}
+
+Ptr<OpenGymSpace>
+NrMacSchedulerAiNs3GymVecEnv::GetObservationSpace()
+{
+    NS_LOG_FUNCTION(this);
+    float low = 0.0;
+    float high = 100.0;
+    std::vector<uint32_t> shape = {GetNumEnvs(), m_maxFlows, COLUMNS};
+    std::string dtype = TypeNameGet<uint16_t>();
+    return Create<OpenGymBoxSpace>(low, high, shape, dtype);
+}
+
+bool
+NrMacSchedulerAiNs3GymVecEnv::GetGameOver()
+{
+    NS_LOG_FUNCTION(this);
+    for (const auto& cell : m_cells)
+    {
+        if (cell.reported && cell.gameOver)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+Ptr<OpenGymDataContainer>
+NrMacSchedulerAiNs3GymVecEnv::GetObservation()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<uint32_t> shape = {GetNumEnvs(), m_maxFlows, COLUMNS};
+    std::vector<uint16_t> data(GetNumEnvs() * m_maxFlows * COLUMNS, 0);
+    for (uint32_t k = 0; k < m_cells.size(); ++k)
+    {
+        if (!m_cells[k].reported)
+        {
+            continue;
+        }
+        const auto& observation = m_cells[k].observation;
+        if (observation.size() > m_maxFlows)
+        {
+            NS_LOG_WARN("Cell " << k << " reported " << observation.size() << " flows, only "
+                                << m_maxFlows << " are observed");
+        }
+        auto row = data.begin() + k * m_maxFlows * COLUMNS;
+        for (uint32_t i = 0; i < std::min<size_t>(observation.size(), m_maxFlows); ++i)
+        {
+            const auto& obs = observation[i];
+            *row++ = obs.rnti;
+            *row++ = obs.lcId;
+            *row++ = obs.priority;
+            *row++ = obs.holDelay;
+            *row++ = obs.aoi;
+            *row++ = obs.cqi;
+            *row++ = 1;
+        }
+    }
+    Ptr<OpenGymBoxContainer<uint16_t>> observation =
+        CreateObject<OpenGymBoxContainer<uint16_t>>(shape);
+    observation->SetData(std::move(data));
+
+    m_pendingSteps.push_back({m_openGymInterface->GetCurrentStepId(), m_maxFlows, m_cells});
+    return observation;
+}
+
+float
+NrMacSchedulerAiNs3GymVecEnv::GetReward()
+{
+    NS_LOG_FUNCTION(this);
+    float reward = 0.0;
+    uint32_t reported = 0;
+    for (const auto& cell : m_cells)
+    {
+        if (cell.reported)
+        {
+            reward += cell.reward;
+            ++reported;
+        }
+    }
+    return reported > 0 ? reward / reported : 0.0F;
+}
+
+std::string
+NrMacSchedulerAiNs3GymVecEnv::GetExtraInfo()
+{
+    NS_LOG_FUNCTION(this);
+    std::ostringstream info;
+    for (uint32_t k = 0; k < m_cells.size(); ++k)
+    {
+        info << (k > 0 ? "," : "") << (m_cells[k].reported ? m_cells[k].reward : 0.0F);
+    }
+    return info.str();
+}
+
+bool
+NrMacSchedulerAiNs3GymVecEnv::ExecuteActions(Ptr<OpenGymDataContainer> action)
+{
+    NS_LOG_FUNCTION(this);
+    // Steps older than the answered one will never be answered (the agent skipped them)
+    uint64_t stepId = m_openGymInterface->GetActionStepId();
+    while (!m_pendingSteps.empty() && m_pendingSteps.front().stepId < stepId)
+    {
+        m_pendingSteps.pop_front();
+    }
+    if (m_pendingSteps.empty() || m_pendingSteps.front().stepId != stepId)
+    {
+        NS_LOG_WARN("No observation found for the action of step " << stepId);
+        return false;
+    }
+    PendingStep step = std::move(m_pendingSteps.front());
+    m_pendingSteps.pop_front();
+
+    Ptr<OpenGymBoxContainer<float>> actionBox = DynamicCast<OpenGymBoxContainer<float>>(action);
+    NS_ABORT_MSG_IF(!actionBox, "The action must be a Box of float");
+    const std::vector<float>& actionData = actionBox->GetDataRef();
+    NS_ABORT_MSG_IF(actionData.size() < step.cells.size() * step.maxFlows,
+                    "Received " << actionData.size() << " weights for " << step.cells.size()
+                                << " cells of " << step.maxFlows << " flows");
+
+    for (uint32_t k = 0; k < step.cells.size(); ++k)
+    {
+        const CellState& cell = step.cells[k];
+        if (!cell.reported)
+        {
+            continue;
+        }
+        NrMacSchedulerUeInfoAi::UeWeightsMap ueWeightsMap;
+        // the weights of the empty rows are ignored
+        for (uint32_t i = 0; i < std::min<size_t>(cell.observation.size(), step.maxFlows); i++)
+        {
+            const auto& obs = cell.observation[i];
+            ueWeightsMap[obs.rnti][obs.lcId] = actionData[k * step.maxFlows + i];
+        }
+        cell.updateAllUeWeightsFn(ueWeightsMap);
+    }
+    return true;
+}
+
+void
+NrMacSchedulerAiNs3GymVecEnv::NotifyCurrentIteration(
+    uint32_t envId,
+    const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+    bool isGameOver,
+    float reward,
+    const std::string& extraInfo,
+    const NrMacSchedulerUeInfoAi::UpdateAllUeWeightsFn& updateAllUeWeightsFn)
+{
+    NS_LOG_FUNCTION(this << envId);
+    NS_ABORT_MSG_IF(envId >= m_cells.size(),
+                    "Cell " << envId << " out of " << m_cells.size() << " cells");
+    CellState& cell = m_cells[envId];
+    // a cell that decides several times at the same time (e.g. per RBG) keeps the last report
+    cell.reported = true;
+    cell.observation = observations;
+    cell.gameOver = isGameOver;
+    cell.reward = reward;
+    cell.updateAllUeWeightsFn = updateAllUeWeightsFn;
+
+    if (!m_stepEvent.IsPending())
+    {
+        // the other cells schedule at the same time: step once all of them reported. The
+        // current decision of the cell is already taken, the weights apply to the next one
+        m_stepEvent = Simulator::ScheduleNow(&NrMacSchedulerAiNs3GymVecEnv::Step, this);
+    }
+}
+
+void
+NrMacSchedulerAiNs3GymVecEnv::Step()
+{
+    NS_LOG_FUNCTION(this);
+    Notify();
+    for (auto& cell : m_cells)
+    {
+        cell.reported = false;
+    }
+}
+
+} // namespace ns3
+
+#endif // HAVE_OPENGYM
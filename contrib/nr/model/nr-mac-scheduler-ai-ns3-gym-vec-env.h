@@ -0,0 +1,201 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#pragma once
+
+#if __has_include("ns3/opengym-module.h")
+#define HAVE_OPENGYM
+
+#include "nr-mac-scheduler-ue-info-ai.h"
+
+#include "ns3/core-module.h"
+#include "ns3/opengym-module.h"
+
+#include <deque>
+
+namespace ns3
+{
+/**
+ * @brief Vectorized Gym environment: K cells stepped in lockstep by one agent
+ *
+ * Each of the K cells (a gNB with its own NrMacSchedulerOfdmaAi) is bound to the callback
+ * returned by GetNotifyCb. The observations that the cells report at the same simulation time
+ * are gathered into one step, whose observation is a [K, MaxFlows, 7] tensor and whose action
+ * is a [K, MaxFlows] tensor of weights scattered back to the cells. One round trip with the
+ * agent thus serves K cells, and the agent can evaluate its policy on the whole batch.
+ *
+ * The shapes do not change from a step to another. The flows of each cell fill its first rows,
+ * in the order of its report, with the six columns of NrMacSchedulerAiNs3GymEnv followed by a
+ * validity mask set to 1; the remaining rows are zero, mask included, and their weights are
+ * ignored. A cell that did not report in a step has only empty rows, and the flows of a cell
+ * beyond MaxFlows are not observed.
+ *
+ * The step is sent by an event scheduled with Simulator::ScheduleNow, when all the cells have
+ * scheduled at the current time. The decisions that produced the observations are therefore
+ * already taken: the weights chosen by the agent apply only from the next scheduling decision
+ * of each cell.
+ *
+ * The reward of the step is the average reward of the cells that reported; the reward of each
+ * cell is in the extra info, as a comma separated list of K values.
+ *
+ * \code{.cc}
+ * Ptr<NrMacSchedulerAiNs3GymVecEnv> env = CreateObject<NrMacSchedulerAiNs3GymVecEnv>(gnbNum);
+ * env->SetOpenGymInterface(openGymInterface);
+ * for (uint32_t k = 0; k < gnbNum; ++k)
+ * {
+ *     NrHelper::GetScheduler(gnbDevs.Get(k), 0)
+ *         ->SetAttribute("NotifyCbUl", CallbackValue(env->GetNotifyCb(k)));
+ * }
+ * \endcode
+ */
+class NrMacSchedulerAiNs3GymVecEnv : public OpenGymEnv
+{
+  public:
+    /**
+     * @brief Constructor for NrMacSchedulerAiNs3GymVecEnv
+     */
+    NrMacSchedulerAiNs3GymVecEnv();
+
+    /**
+     * @brief Constructor with number of cells
+     * @param numEnvs The number of cells (K)
+     */
+    NrMacSchedulerAiNs3GymVecEnv(uint32_t numEnvs);
+
+    /**
+     * @brief Destructor for NrMacSchedulerAiNs3GymVecEnv
+     */
+    ~NrMacSchedulerAiNs3GymVecEnv() override;
+
+    /**
+     * @brief GetTypeId
+     * @return The TypeId of the class
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Dispose of the object
+     */
+    void DoDispose() override;
+
+    /**
+     * @brief Set the number of cells
+     * @param numEnvs The number of cells (K)
+     */
+    void SetNumEnvs(uint32_t numEnvs);
+
+    /**
+     * @brief Get the number of cells
+     * @return The number of cells (K)
+     */
+    uint32_t GetNumEnvs() const;
+
+    /**
+     * @brief Get the callback to bind to the scheduler of a cell
+     * @param envId The index of the cell, in [0, K)
+     * @return a callback that can be set as NotifyCbUl or NotifyCbDl of NrMacSchedulerOfdmaAi
+     */
+    NrMacSchedulerUeInfoAi::NotifyCb GetNotifyCb(uint32_t envId);
+
+    /**
+     * @brief Get the action space of the environment
+     * @return a Box space of shape [K, MaxFlows] with weights in [0, 1]
+     */
+    Ptr<OpenGymSpace> GetActionSpace() override;
+
+    /**
+     * @brief Get the observation space of the environment
+     * @return a Box space of shape [K, MaxFlows, 7]
+     */
+    Ptr<OpenGymSpace> GetObservationSpace() override;
+
+    /**
+     * @brief Check if the game is over
+     * @return true if the game is over for any of the cells
+     */
+    bool GetGameOver() override;
+
+    /**
+     * @brief Get the observation of the current step
+     * @return the [K, MaxFlows, 7] observation, with the validity mask in the last column
+     */
+    Ptr<OpenGymDataContainer> GetObservation() override;
+
+    /**
+     * @brief Get the reward of the current step
+     * @return the average reward of the cells that reported in the step
+     */
+    float GetReward() override;
+
+    /**
+     * @brief Get extra information from the environment
+     * @return the reward of each cell, comma separated
+     */
+    std::string GetExtraInfo() override;
+
+    /**
+     * @brief Scatter the [K, MaxFlows] weights to the cells
+     * @param action The action received from the RL model
+     * @return true if the action matched a step
+     */
+    bool ExecuteActions(Ptr<OpenGymDataContainer> action) override;
+
+    /**
+     * @brief Notify the environment about the current iteration of a cell
+     * @param envId The index of the cell
+     * @param observations Observations from the scheduler of the cell
+     * @param isGameOver Whether the game/episode is over
+     * @param reward Reward for the current iteration
+     * @param extraInfo Additional information
+     * @param updateAllUeWeightsFn A callback function to update the weights of the UEs of the cell
+     *
+     * The step is deferred with Simulator::ScheduleNow until the other cells have reported, so
+     * the weights of the agent reach the cell after its current decision.
+     */
+    void NotifyCurrentIteration(
+        uint32_t envId,
+        const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+        bool isGameOver,
+        float reward,
+        const std::string& extraInfo,
+        const NrMacSchedulerUeInfoAi::UpdateAllUeWeightsFn& updateAllUeWeightsFn);
+
+  private:
+    /**
+     * @brief Send the observations gathered at the current time to the agent
+     */
+    void Step();
+
+    /**
+     * @brief Last report of a cell
+     */
+    struct CellState
+    {
+        bool reported{false}; //!< Whether the cell reported in the current step
+        std::vector<NrMacSchedulerUeInfoAi::LcObservation> observation; //!< Observed flows
+        bool gameOver{false};                                            //!< Game over flag
+        float reward{0.0};                                               //!< Reward
+        NrMacSchedulerUeInfoAi::UpdateAllUeWeightsFn updateAllUeWeightsFn; //!< Weights update
+    };
+
+    /**
+     * @brief A step sent to the RL model and not answered yet
+     */
+    struct PendingStep
+    {
+        uint64_t stepId;   //!< Step id assigned by the OpenGymInterface
+        uint32_t maxFlows; //!< Rows of each cell in the step
+        std::vector<CellState> cells; //!< Cells, as they were when the step was sent
+    };
+
+    static constexpr uint32_t COLUMNS = 7; //!< Columns of a row, validity mask included
+
+    uint32_t m_maxFlows{32};                //!< Rows of each cell in the observation
+    std::vector<CellState> m_cells;         //!< Current report of each cell
+    EventId m_stepEvent;                    //!< Step event at the current time
+    std::deque<PendingStep> m_pendingSteps; //!< Steps waiting for their action
+};
+} // namespace ns3
+#endif
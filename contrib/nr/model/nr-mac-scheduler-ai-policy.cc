@@ -0,0 +1,375 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-mac-scheduler-ai-policy.h"
+
+#include "ns3/abort.h"
+#include "ns3/double.h"
+#include "ns3/enum.h"
+#include "ns3/fatal-error.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace ns3
+{
+NS_LOG_COMPONENT_DEFINE("NrMacSchedulerAiPolicy");
+NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerAiPolicy);
+NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerAiQTablePolicy);
+NS_OBJECT_ENSURE_REGISTERED(NrMacSchedulerAiMlpPolicy);
+
+/**
+ * @brief Read a little endian float32 or float64 C-ordered array from a .npy file
+ * @param fileName the file
+ * @param shape the shape of the array
+ * @return the elements of the array
+ */
+static std::vector<double>
+ReadNpy(const std::string& fileName, std::vector<uint32_t>& shape)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    NS_ABORT_MSG_IF(!file.good(), "Cannot open " << fileName);
+
+    char magic[8];
+    file.read(magic, sizeof(magic));
+    NS_ABORT_MSG_IF(!file.good() || std::memcmp(magic, "\x93NUMPY", 6) != 0,
+                    fileName << " is not a .npy file");
+    uint32_t headerLen = 0;
+    if (magic[6] == 1)
+    {
+        uint8_t len[2];
+        file.read(reinterpret_cast<char*>(len), 2);
+        headerLen = len[0] | (len[1] << 8);
+    }
+    else
+    {
+        uint8_t len[4];
+        file.read(reinterpret_cast<char*>(len), 4);
+        headerLen = len[0] | (len[1] << 8) | (len[2] << 16) | (len[3] << 24);
+    }
+    std::string header(headerLen, ' ');
+    file.read(&header[0], headerLen);
+
+    // the header is a Python dict literal, e.g.
+    // {'descr': '<f8', 'fortran_order': False, 'shape': (10, 5, 11), }
+    NS_ABORT_MSG_IF(header.find("'fortran_order': False") == std::string::npos,
+                    fileName << ": only C-ordered arrays are supported");
+    bool isDouble = header.find("'descr': '<f8'") != std::string::npos;
+    bool isFloat = header.find("'descr': '<f4'") != std::string::npos;
+    NS_ABORT_MSG_IF(!isDouble && !isFloat,
+                    fileName << ": only little endian float32 and float64 arrays are supported");
+
+    size_t shapeStart = header.find('(', header.find("'shape'"));
+    size_t shapeEnd = header.find(')', shapeStart);
+    NS_ABORT_MSG_IF(shapeStart == std::string::npos || shapeEnd == std::string::npos,
+                    fileName << ": malformed header");
+    std::string dims = header.substr(shapeStart + 1, shapeEnd - shapeStart - 1);
+    std::replace(dims.begin(), dims.end(), ',', ' ');
+    std::istringstream dimStream(dims);
+    shape.clear();
+    size_t count = 1;
+    for (uint32_t dim; dimStream >> dim;)
+    {
+        shape.push_back(dim);
+        count *= dim;
+    }
+
+    std::vector<double> data(count);
+    if (isDouble)
+    {
+        file.read(reinterpret_cast<char*>(data.data()), count * sizeof(double));
+    }
+    else
+    {
+        std::vector<float> tmp(count);
+        file.read(reinterpret_cast<char*>(tmp.data()), count * sizeof(float));
+        std::copy(tmp.begin(), tmp.end(), data.begin());
+    }
+    NS_ABORT_MSG_IF(!file.good(), fileName << ": truncated data");
+    return data;
+}
+
+TypeId
+NrMacSchedulerAiPolicy::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrMacSchedulerAiPolicy").SetParent<Object>().SetGroupName("nr");
+    return tid;
+}
+
+std::array<float, NrMacSchedulerAiPolicy::NUM_FEATURES>
+NrMacSchedulerAiPolicy::GetFeatures(const NrMacSchedulerUeInfoAi::LcObservation& obs)
+{
+    auto asGym = [](uint64_t v) { return static_cast<float>(static_cast<uint16_t>(v)); };
+    return {asGym(obs.rnti),
+            asGym(obs.lcId),
+            asGym(obs.priority),
+            asGym(obs.holDelay),
+            asGym(obs.aoi),
+            asGym(obs.cqi)};
+}
+
+void
+NrMacSchedulerAiPolicy::NotifyCurrentIteration(
+    const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+    bool isGameOver,
+    float reward,
+    const std::string& extraInfo,
+    const NrMacSchedulerUeInfoAi::UpdateAllUeWeightsFn& updateAllUeWeightsFn)
+{
+    NS_LOG_FUNCTION(this << observations.size());
+    m_weights.resize(observations.size());
+    ComputeWeights(observations, m_weights);
+
+    m_ueWeights.clear();
+    for (size_t i = 0; i < observations.size(); ++i)
+    {
+        m_ueWeights[observations[i].rnti][observations[i].lcId] = m_weights[i];
+    }
+    updateAllUeWeightsFn(m_ueWeights);
+}
+
+TypeId
+NrMacSchedulerAiQTablePolicy::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrMacSchedulerAiQTablePolicy")
+            .SetParent<NrMacSchedulerAiPolicy>()
+            .SetGroupName("nr")
+            .AddConstructor<NrMacSchedulerAiQTablePolicy>()
+            .AddAttribute("MaxAoi",
+                          "AoI that is mapped to the last AoI bin (max_aoi of the agent)",
+                          DoubleValue(10000.0),
+                          MakeDoubleAccessor(&NrMacSchedulerAiQTablePolicy::m_maxAoi),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("MaxCqi",
+                          "CQI that is mapped to the last CQI bin (max_cqi of the agent)",
+                          DoubleValue(15.0),
+                          MakeDoubleAccessor(&NrMacSchedulerAiQTablePolicy::m_maxCqi),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("QTableFile",
+                          "The .npy file of the Q-table, of shape [aoiBins, cqiBins, weightBins]",
+                          StringValue(""),
+                          MakeStringAccessor(&NrMacSchedulerAiQTablePolicy::LoadQTable),
+                          MakeStringChecker());
+    return tid;
+}
+
+void
+NrMacSchedulerAiQTablePolicy::LoadQTable(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(this << fileName);
+    if (fileName.empty())
+    {
+        return;
+    }
+    std::vector<uint32_t> shape;
+    std::vector<double> qTable = ReadNpy(fileName, shape);
+    NS_ABORT_MSG_IF(shape.size() != 3 || shape[2] < 2,
+                    fileName << ": expected a Q-table of shape [aoiBins, cqiBins, weightBins]");
+
+    m_aoiBins = shape[0];
+    m_cqiBins = shape[1];
+    uint32_t weightBins = shape[2];
+    m_bestWeight.resize(m_aoiBins * m_cqiBins);
+    for (uint32_t state = 0; state < m_bestWeight.size(); ++state)
+    {
+        // first maximum, as np.argmax
+        auto q = qTable.begin() + state * weightBins;
+        auto best = std::max_element(q, q + weightBins);
+        m_bestWeight[state] = static_cast<float>(std::distance(q, best)) / (weightBins - 1);
+    }
+    NS_LOG_INFO("Loaded Q-table " << fileName << " with " << m_aoiBins << " AoI bins, "
+                                  << m_cqiBins << " CQI bins and " << weightBins
+                                  << " weight bins");
+}
+
+void
+NrMacSchedulerAiQTablePolicy::ComputeWeights(
+    const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+    std::vector<float>& weights)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_bestWeight.empty(), "No Q-table loaded, set the QTableFile attribute");
+    for (size_t i = 0; i < observations.size(); ++i)
+    {
+        // same operations as YeongymAgent::discretize, so that the bin edges match
+        auto features = GetFeatures(observations[i]);
+        uint32_t aoiBin = std::min(static_cast<uint32_t>(features[4] / m_maxAoi * m_aoiBins),
+                                   m_aoiBins - 1);
+        uint32_t cqiBin = std::min(static_cast<uint32_t>(features[5] / m_maxCqi * m_cqiBins),
+                                   m_cqiBins - 1);
+        weights[i] = m_bestWeight[aoiBin * m_cqiBins + cqiBin];
+    }
+}
+
+TypeId
+NrMacSchedulerAiMlpPolicy::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::NrMacSchedulerAiMlpPolicy")
+            .SetParent<NrMacSchedulerAiPolicy>()
+            .SetGroupName("nr")
+            .AddConstructor<NrMacSchedulerAiMlpPolicy>()
+            .AddAttribute("LayerSizes",
+                          "Comma separated size of each layer, inputs and outputs included",
+                          StringValue("6,32,32,1"),
+                          MakeStringAccessor(&NrMacSchedulerAiMlpPolicy::SetLayerSizes),
+                          MakeStringChecker())
+            .AddAttribute("OutputActivation",
+                          "Activation of the output layer",
+                          EnumValue(NrMacSchedulerAiMlpPolicy::SIGMOID),
+                          MakeEnumAccessor<OutputActivation>(
+                              &NrMacSchedulerAiMlpPolicy::m_outputActivation),
+                          MakeEnumChecker(NrMacSchedulerAiMlpPolicy::SIGMOID,
+                                          "Sigmoid",
+                                          NrMacSchedulerAiMlpPolicy::CLAMP,
+                                          "Clamp"))
+            .AddAttribute("WeightsFile",
+                          "The flat float32 file of the weights of the network",
+                          StringValue(""),
+                          MakeStringAccessor(&NrMacSchedulerAiMlpPolicy::LoadWeights),
+                          MakeStringChecker());
+    return tid;
+}
+
+void
+NrMacSchedulerAiMlpPolicy::SetLayerSizes(const std::string& layerSizes)
+{
+    NS_LOG_FUNCTION(this << layerSizes);
+    std::string sizes = layerSizes;
+    std::replace(sizes.begin(), sizes.end(), ',', ' ');
+    std::istringstream sizeStream(sizes);
+    m_layerSizes.clear();
+    for (uint32_t size; sizeStream >> size;)
+    {
+        NS_ABORT_MSG_IF(size == 0, "Empty layer in " << layerSizes);
+        m_layerSizes.push_back(size);
+    }
+    NS_ABORT_MSG_IF(m_layerSizes.size() < 2 || m_layerSizes.front() != NUM_FEATURES ||
+                        m_layerSizes.back() != 1,
+                    "The network must have " << NUM_FEATURES << " inputs and 1 output, got "
+                                             << layerSizes);
+    // weights loaded for other sizes are no longer valid
+    m_layers.clear();
+}
+
+void
+NrMacSchedulerAiMlpPolicy::LoadWeights(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(this << fileName);
+    if (fileName.empty())
+    {
+        return;
+    }
+    std::ifstream file(fileName, std::ios::binary);
+    NS_ABORT_MSG_IF(!file.good(), "Cannot open " << fileName);
+
+    m_layers.clear();
+    std::vector<float> w;
+    for (size_t l = 0; l + 1 < m_layerSizes.size(); ++l)
+    {
+        Layer layer;
+        layer.nIn = m_layerSizes[l];
+        layer.nOut = m_layerSizes[l + 1];
+        w.resize(layer.nOut * layer.nIn);
+        layer.bias.resize(layer.nOut);
+        file.read(reinterpret_cast<char*>(w.data()), w.size() * sizeof(float));
+        file.read(reinterpret_cast<char*>(layer.bias.data()), layer.bias.size() * sizeof(float));
+        NS_ABORT_MSG_IF(!file.good(),
+                        fileName << " is too short for layer sizes of the network");
+        // [out, in] -> [in, out], so that the kernel runs over contiguous outputs
+        layer.wT.resize(w.size());
+        for (uint32_t o = 0; o < layer.nOut; ++o)
+        {
+            for (uint32_t i = 0; i < layer.nIn; ++i)
+            {
+                layer.wT[i * layer.nOut + o] = w[o * layer.nIn + i];
+            }
+        }
+        m_layers.push_back(std::move(layer));
+    }
+    file.peek();
+    NS_ABORT_MSG_IF(!file.eof(), fileName << " is longer than the weights of the network");
+    NS_LOG_INFO("Loaded " << m_layers.size() << " layers from " << fileName);
+}
+
+void
+NrMacSchedulerAiMlpPolicy::DenseForward(const float* __restrict in,
+                                        size_t batch,
+                                        size_t nIn,
+                                        const float* __restrict wT,
+                                        const float* __restrict bias,
+                                        size_t nOut,
+                                        float* __restrict out)
+{
+    for (size_t b = 0; b < batch; ++b)
+    {
+        float* __restrict row = out + b * nOut;
+        std::copy(bias, bias + nOut, row);
+        for (size_t k = 0; k < nIn; ++k)
+        {
+            const float a = in[b * nIn + k];
+            const float* __restrict w = wT + k * nOut;
+            for (size_t j = 0; j < nOut; ++j)
+            {
+                row[j] += a * w[j];
+            }
+        }
+    }
+}
+
+void
+NrMacSchedulerAiMlpPolicy::ComputeWeights(
+    const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+    std::vector<float>& weights)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_layers.empty(), "No weights loaded, set the WeightsFile attribute");
+    size_t batch = observations.size();
+    m_in.resize(batch * NUM_FEATURES);
+    for (size_t i = 0; i < batch; ++i)
+    {
+        auto features = GetFeatures(observations[i]);
+        std::copy(features.begin(), features.end(), m_in.begin() + i * NUM_FEATURES);
+    }
+
+    for (size_t l = 0; l < m_layers.size(); ++l)
+    {
+        const Layer& layer = m_layers[l];
+        m_out.resize(batch * layer.nOut);
+        DenseForward(m_in.data(),
+                     batch,
+                     layer.nIn,
+                     layer.wT.data(),
+                     layer.bias.data(),
+                     layer.nOut,
+                     m_out.data());
+        if (l + 1 < m_layers.size())
+        {
+            for (auto& v : m_out)
+            {
+                v = std::max(v, 0.0F);
+            }
+        }
+        std::swap(m_in, m_out);
+    }
+
+    // the output layer has one output, m_in holds one value for each flow
+    for (size_t i = 0; i < batch; ++i)
+    {
+        float x = m_in[i];
+        weights[i] = m_outputActivation == SIGMOID ? 1.0F / (1.0F + std::exp(-x))
+                                                   : std::min(std::max(x, 0.0F), 1.0F);
+    }
+}
+
+} // namespace ns3
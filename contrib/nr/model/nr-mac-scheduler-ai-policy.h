@@ -0,0 +1,215 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#pragma once
+
+#include "nr-mac-scheduler-ue-info-ai.h"
+
+#include "ns3/object.h"
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * @ingroup scheduler
+ * @brief Trained scheduling policy evaluated inside the simulation
+ *
+ * A policy computes the weight of each observed flow without any external process: it
+ * replaces the NrMacSchedulerAiNs3GymEnv, the OpenGymInterface and the Python agent when the
+ * policy is already trained and the simulation is run only for evaluation. NotifyCurrentIteration
+ * has the signature of NrMacSchedulerUeInfoAi::NotifyCb, so that it can be bound to the
+ * NotifyCbUl or NotifyCbDl attribute of NrMacSchedulerOfdmaAi:
+ *
+ * \code{.cc}
+ * Ptr<NrMacSchedulerAiQTablePolicy> policy = CreateObject<NrMacSchedulerAiQTablePolicy>();
+ * policy->SetAttribute("QTableFile", StringValue("q_table.npy"));
+ * nrHelper->SetSchedulerAttribute(
+ *     "NotifyCbUl",
+ *     CallbackValue(MakeCallback(&NrMacSchedulerAiPolicy::NotifyCurrentIteration, policy)));
+ * \endcode
+ *
+ * The policies see each flow through the same features that the gym environment sends to the
+ * agent (see GetFeatures), so that a policy trained with the agent behaves in the same way.
+ */
+class NrMacSchedulerAiPolicy : public Object
+{
+  public:
+    /**
+     * @brief Number of features of a flow, i.e. the columns of the gym observation
+     */
+    static constexpr uint32_t NUM_FEATURES = 6;
+
+    /**
+     * @brief GetTypeId
+     * @return The TypeId of the class
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Compute the weights of the observed flows and apply them
+     * @param observations Observations from the scheduler
+     * @param isGameOver Whether the game/episode is over (unused)
+     * @param reward Reward for the current iteration (unused)
+     * @param extraInfo Additional information (unused)
+     * @param updateAllUeWeightsFn The function that applies the weights to the UEs
+     */
+    void NotifyCurrentIteration(
+        const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+        bool isGameOver,
+        float reward,
+        const std::string& extraInfo,
+        const NrMacSchedulerUeInfoAi::UpdateAllUeWeightsFn& updateAllUeWeightsFn);
+
+    /**
+     * @brief Compute the weight of each flow
+     * @param observations the observed flows
+     * @param weights the weights, one for each flow, in [0, 1]
+     */
+    virtual void ComputeWeights(
+        const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+        std::vector<float>& weights) = 0;
+
+    /**
+     * @brief The features of a flow, as the columns of the gym observation
+     * @param obs the observation of the flow
+     * @return rnti, lcId, priority, holDelay, aoi, cqi
+     *
+     * As in NrMacSchedulerAiNs3GymEnv::GetObservation, each feature is truncated to 16 bits.
+     */
+    static std::array<float, NUM_FEATURES> GetFeatures(
+        const NrMacSchedulerUeInfoAi::LcObservation& obs);
+
+  private:
+    std::vector<float> m_weights;                      //!< Weights of the last iteration
+    NrMacSchedulerUeInfoAi::UeWeightsMap m_ueWeights; //!< Weights by RNTI and LC ID
+};
+
+/**
+ * @ingroup scheduler
+ * @brief Tabular policy loaded from the Q-table saved by scratch/yeongym_agent.py
+ *
+ * The table is a NumPy array of shape [aoiBins, cqiBins, weightBins]. As in the agent, the AoI
+ * and the CQI of a flow are quantized in the bins min(int(x / max * bins), bins - 1) and the
+ * weight is the index of the best action divided by (weightBins - 1). The best action of each
+ * state is computed when the table is loaded, so that a flow costs two multiplications and a
+ * lookup.
+ */
+class NrMacSchedulerAiQTablePolicy : public NrMacSchedulerAiPolicy
+{
+  public:
+    /**
+     * @brief GetTypeId
+     * @return The TypeId of the class
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Load the Q-table from a .npy file
+     * @param fileName the file saved by YeongymAgent::save_q_table
+     */
+    void LoadQTable(const std::string& fileName);
+
+    void ComputeWeights(const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+                        std::vector<float>& weights) override;
+
+  private:
+    double m_maxAoi{10000.0};            //!< AoI mapped to the last AoI bin
+    double m_maxCqi{15.0};               //!< CQI mapped to the last CQI bin
+    uint32_t m_aoiBins{0};               //!< Number of AoI bins
+    uint32_t m_cqiBins{0};               //!< Number of CQI bins
+    std::vector<float> m_bestWeight;     //!< Weight of the best action of each state
+};
+
+/**
+ * @ingroup scheduler
+ * @brief Dense neural network policy loaded from a flat weights file
+ *
+ * The network has the layer sizes given by the LayerSizes attribute: the first one must be
+ * NUM_FEATURES, the last one must be 1. Hidden layers use a ReLU, the output layer the
+ * activation given by the OutputActivation attribute. The weights file contains, for each layer,
+ * the weight matrix [out, in] in row-major order followed by the bias [out], as little endian
+ * float32: it is the concatenation of the parameters of a sequence of torch.nn.Linear layers,
+ * e.g. np.concatenate([p.detach().numpy().ravel() for p in model.parameters()]).tofile(f).
+ * Any normalization of the inputs must be folded into the first layer.
+ *
+ * All the flows of an iteration are evaluated as one batch, with a matrix multiplication
+ * kernel whose inner loop runs over contiguous outputs, so that it is vectorized by the compiler.
+ */
+class NrMacSchedulerAiMlpPolicy : public NrMacSchedulerAiPolicy
+{
+  public:
+    /**
+     * @brief Activation of the output layer
+     */
+    enum OutputActivation
+    {
+        SIGMOID, //!< 1 / (1 + exp(-x))
+        CLAMP,   //!< x clamped to [0, 1]
+    };
+
+    /**
+     * @brief GetTypeId
+     * @return The TypeId of the class
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * @brief Load the weights of the network
+     * @param fileName the flat weights file
+     *
+     * The layer sizes must be set before.
+     */
+    void LoadWeights(const std::string& fileName);
+
+    /**
+     * @brief Set the size of each layer, inputs and outputs included
+     * @param layerSizes comma separated list, e.g. "6,32,32,1"
+     */
+    void SetLayerSizes(const std::string& layerSizes);
+
+    void ComputeWeights(const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+                        std::vector<float>& weights) override;
+
+    /**
+     * @brief Dense layer on a batch: out = in * W^T + bias
+     * @param in input, [batch, nIn] row-major
+     * @param batch number of rows
+     * @param nIn number of inputs
+     * @param wT transposed weights, [nIn, nOut] row-major
+     * @param bias bias, [nOut]
+     * @param nOut number of outputs
+     * @param out output, [batch, nOut] row-major
+     */
+    static void DenseForward(const float* in,
+                             size_t batch,
+                             size_t nIn,
+                             const float* wT,
+                             const float* bias,
+                             size_t nOut,
+                             float* out);
+
+  private:
+    /**
+     * @brief A dense layer
+     */
+    struct Layer
+    {
+        uint32_t nIn;            //!< Number of inputs
+        uint32_t nOut;           //!< Number of outputs
+        std::vector<float> wT;   //!< Weights, transposed to [nIn, nOut]
+        std::vector<float> bias; //!< Bias, [nOut]
+    };
+
+    std::vector<uint32_t> m_layerSizes;   //!< Size of each layer
+    std::vector<Layer> m_layers;          //!< Layers, empty until the weights are loaded
+    OutputActivation m_outputActivation{SIGMOID}; //!< Activation of the output layer
+    std::vector<float> m_in;              //!< Input buffer, reused at each iteration
+    std::vector<float> m_out;             //!< Output buffer, reused at each iteration
+};
+
+} // namespace ns3
@@ -10,6 +10,7 @@
 
 #include "nr-mac-scheduler-ns3.h"
 
+#include "nr-aoi-timestamp-tracker.h"
 #include "nr-fh-control.h"
 #include "nr-mac-scheduler-harq-rr.h"
 #include "nr-mac-scheduler-lc-rr.h"
@@ -1559,6 +1560,12 @@ NrMacSchedulerNs3::DoScheduleDlData(PointInFTPlane* spoint,
     return usedSym;
 }
 
+void
+NrMacSchedulerNs3::PrepareUlDataSched([[maybe_unused]] const ActiveUeMap& activeUl)
+{
+    NS_LOG_FUNCTION(this);
+}
+
 /**
  * \brief Scheduling new UL data
  * \param spoint Starting point of the blocks to add to the allocation list
@@ -2099,6 +2106,7 @@ NrMacSchedulerNs3::DoScheduleUl(const std::vector<UlHarqInfo>& ulHarqFeedback,
 
     if (ulSymAvail > 0 && !activeUlUe.empty())
     {
+        PrepareUlDataSched(activeUlUe);
         uint8_t usedUl =
             DoScheduleUlData(&ulAssignationStartPoint, ulSymAvail, activeUlUe, allocInfo);
         NS_LOG_INFO("For the slot " << ulSfn << " reserved " << static_cast<uint32_t>(usedUl)
@@ -2579,13 +2587,39 @@ NrMacSchedulerNs3::DoSchedUlTriggerReq(
     ScheduleUl(params, ulHarqFeedback);
 }
 
+uint64_t
+NrMacSchedulerNs3::GetAge(uint16_t ueRnti) const
+{
+    Ptr<NrAoiTimestampTracker> tracker = m_macSchedSapUser->GetAoiTimestampTracker();
+    if (tracker == nullptr)
+    {
+        return 0;
+    }
+    uint64_t aoi = tracker->GetAge(ueRnti, Simulator::Now().GetMicroSeconds());
+    NS_LOG_DEBUG("rnti " << ueRnti << "의 AoI = " << aoi);
+    return aoi;
+}
+
+bool
+NrMacSchedulerNs3::GetHarqAckResult(uint16_t ueRnti) const
+{
+    auto it = ns3_harqAckResult_map.find(ueRnti);
+    if (it == ns3_harqAckResult_map.end())
+    {
+        NS_LOG_DEBUG("해당 RNTI " << ueRnti << "가 harqAckResult_map에 존재하지 않음");
+        return false;
+    }
+    NS_LOG_DEBUG("rnti " << ueRnti << "의 이전 tti의 데이터 전송 결과 = " << it->second);
+    return it->second;
+}
+
 /**
  * \brief Save the SR list into m_srList
  * \param params SR list
  *
  * m_srList will be evaluated in DoScheduleUlSr()
  * gNB->Scheduler
- * rnti 별 패킷 생성 시간 큐 받아옴
+ * rnti 별 패킷 생성 시간은 GetAge()에서 gNB MAC의 tracker로 읽음
  */
 void
 NrMacSchedulerNs3::DoSchedUlSrInfoReq(
@@ -2598,28 +2632,6 @@ NrMacSchedulerNs3::DoSchedUlSrInfoReq(
     {
         NS_LOG_INFO("UE " << ue << " asked for a SR ");
 
-        // params(SchedUlSrInfo)의 rnti 별 패킷 생성 시간 큐 맵을 ns3-scheduler 멤버 변수에 저장
-        if (params.sched_packet_ctime_queue_map.find(ue) !=
-            params.sched_packet_ctime_queue_map.end())
-        {
-            ns3_packet_Ctime_queue_map[ue] = params.sched_packet_ctime_queue_map.at(ue);
-            // [Output 4] : gNB->scheduler-ns3
-            std::cout << "gNB->scheduler-ns3 (Queue Checking rnti " << ue << ") : \n";
-            std::queue<uint64_t> temp = ns3_packet_Ctime_queue_map[ue];
-            for (int i = 0; i < ns3_packet_Ctime_queue_map[ue].size(); i++)
-            {
-                if (!temp.empty())
-                {
-                    std::cout << temp.front() << std::endl;
-                }
-                else
-                {
-                    break;
-                }
-                temp.pop();
-            }
-        }
-
         auto it = std::find(m_srList.begin(), m_srList.end(), ue);
         if (it == m_srList.end())
         {
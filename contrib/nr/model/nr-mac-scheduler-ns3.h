@@ -234,68 +234,25 @@ class NrFhSchedSapProvider;
 class NrMacSchedulerNs3 : public NrMacScheduler
 {
   public:
-    std::unordered_map<uint16_t, std::queue<uint64_t>>
-        ns3_packet_Ctime_queue_map; // ns3-scheduler용 rnti별 패킷 생성시간 큐 맵 변수
     std::unordered_map<uint16_t, bool>
         ns3_harqAckResult_map; // ns3-scheduler용 rnti별 harq ACK result 큐 맵 변수
 
-    template <typename T>
-    void HandleHarqFeedback(const T& feedback, bool should_pop)
-    {
-        uint16_t rnti = feedback.m_rnti;
-        auto& queue = ns3_packet_Ctime_queue_map[rnti];
-        // std::cout << "RNTI: " << rnti << ", IsReceivedOk: " << (feedback.IsReceivedOk() ? "true"
-        // : "false") << "\n";
-        if (should_pop)
-        {
-            if (!queue.empty())
-            {
-                // std::cout<<"<HandleHarqFeedback> : Packet pop\n";
-                queue.pop();
-            }
-        }
-        else
-        {
-            // std::cout<<"<HandleHarqFeedback> : Packet Retransmit\n";
-        }
-        // NACK: 큐 유지
-    }
-
     /**
-     * Rnti 별 패킷 생성 큐 중에서 가장 오래된 패킷 생성 시간을 가져오는 메서드
-     * (ofdma-greedy에서 호출)
+     * Rnti 별 패킷 생성 큐 중에서 가장 오래된 패킷 생성 시간으로 AoI를 계산하는 메서드
+     * (ofdma-greedy, ofdma-ai에서 호출)
+     *
+     * The creation times are read from the gNB MAC through
+     * NrMacSchedSapUser::GetAoiTimestampTracker(), without copies.
+     * \param ueRnti the RNTI of the UE
+     * \return the AoI of the UE in microseconds, or 0 if no creation time is stored
      */
-    uint64_t GetAge(uint16_t ueRnti) const
-    {
-        auto it = ns3_packet_Ctime_queue_map.find(ueRnti);
-        if (it != ns3_packet_Ctime_queue_map.end())
-        {
-            uint64_t m_aoi = Simulator::Now().GetMicroSeconds() - it->second.front();
-            NS_LOG_UNCOND("[nr-mac-scheduler-ns3] : rnti " << ueRnti << "의 AoI = " << m_aoi);
-            return m_aoi;
-        }
-        else
-        {
-            return 0;
-        }
-    }
+    uint64_t GetAge(uint16_t ueRnti) const;
 
-    bool GetHarqAckResult(uint16_t ueRnti) const
-    {
-        auto it = ns3_harqAckResult_map.find(ueRnti);
-
-        if (it == ns3_harqAckResult_map.end())
-        {
-            NS_LOG_UNCOND("[nr-mac-scheduler-ns3] : 해당 RNTI가 harqAckResult_map에 존재하지 않음");
-            return false;
-        }
-
-        bool m_HarqAckResult = it->second;
-        NS_LOG_UNCOND("[nr-mac-scheduler-ns3] : rnti "
-                      << ueRnti << "의 이전 tti의 데이터 전송 결과 = " << m_HarqAckResult);
-
-        return m_HarqAckResult;
-    }
+    /**
+     * \param ueRnti the RNTI of the UE
+     * \return the result of the last UL HARQ feedback of the UE, false if unknown
+     */
+    bool GetHarqAckResult(uint16_t ueRnti) const;
 
     /**
      * \brief GetTypeId
@@ -701,6 +658,16 @@ class NrMacSchedulerNs3 : public NrMacScheduler
      */
     virtual BeamSymbolMap AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl) const = 0;
 
+    /**
+     * \brief Prepare the UL data scheduling of a slot
+     * \param activeUl Map of Beam and active UE per beam
+     *
+     * Called once per slot, before AssignULRBG, with the UEs of all the active beams. Unlike
+     * the assignment functions, it can change the state of the scheduler (e.g., to take a
+     * decision that holds for several slots). The default implementation does nothing.
+     */
+    virtual void PrepareUlDataSched(const ActiveUeMap& activeUl);
+
     /**
      * \brief Create a DCI for the specified UE for DL data
      * \param spoint Starting point
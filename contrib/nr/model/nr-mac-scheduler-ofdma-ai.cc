@@ -6,7 +6,10 @@
 #include "nr-mac-scheduler-ofdma-ai.h"
 
 #include "ns3/boolean.h"
+#include "ns3/enum.h"
 #include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
 #include <functional>
@@ -42,7 +45,36 @@ NrMacSchedulerOfdmaAi::GetTypeId()
                           "The flag to activate the AI model for the uplink",
                           BooleanValue(false),
                           MakeBooleanAccessor(&NrMacSchedulerOfdmaAi::m_activeUlAi),
-                          MakeBooleanChecker());
+                          MakeBooleanChecker())
+            .AddAttribute("UlDecisionGranularity",
+                          "When the AI model is queried for new uplink weights: before every RBG "
+                          "(PerRbg), once per slot (PerSlot), once every UlDecisionPeriod slots "
+                          "(EveryNSlots), or when the set of active UEs changes (OnUeSetChange). "
+                          "Outside PerRbg the weights are cached in the UEs between two queries.",
+                          EnumValue(NrMacSchedulerOfdmaAi::PER_RBG),
+                          MakeEnumAccessor<DecisionGranularity>(
+                              &NrMacSchedulerOfdmaAi::SetUlDecisionGranularity,
+                              &NrMacSchedulerOfdmaAi::GetUlDecisionGranularity),
+                          MakeEnumChecker(NrMacSchedulerOfdmaAi::PER_RBG,
+                                          "PerRbg",
+                                          NrMacSchedulerOfdmaAi::PER_SLOT,
+                                          "PerSlot",
+                                          NrMacSchedulerOfdmaAi::EVERY_N_SLOTS,
+                                          "EveryNSlots",
+                                          NrMacSchedulerOfdmaAi::ON_UE_SET_CHANGE,
+                                          "OnUeSetChange"))
+            .AddAttribute("UlDecisionPeriod",
+                          "Number of slots between two uplink queries when UlDecisionGranularity "
+                          "is EveryNSlots",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&NrMacSchedulerOfdmaAi::m_ulDecisionPeriod),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("UlMaxWeightAge",
+                          "Maximum age of the cached uplink weights. When exceeded, the AI model is "
+                          "queried regardless of UlDecisionGranularity. Zero disables the bound.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&NrMacSchedulerOfdmaAi::m_ulMaxWeightAge),
+                          MakeTimeChecker());
     return tid;
 }
 
@@ -56,11 +88,13 @@ NrMacSchedulerOfdmaAi::CreateUeRepresentation(
     const NrMacCschedSapProvider::CschedUeConfigReqParameters& params) const
 {
     NS_LOG_FUNCTION(this);
-    return std::make_shared<NrMacSchedulerUeInfoAi>(
+    auto ue = std::make_shared<NrMacSchedulerUeInfoAi>(
         m_alpha,
         params.m_rnti,
         params.m_beamId,
         std::bind(&NrMacSchedulerOfdmaAi::GetNumRbPerRbg, this));
+    ue->SetKeepUlWeights(m_ulDecisionGranularity != PER_RBG);
+    return ue;
 }
 
 std::function<bool(const NrMacSchedulerNs3::UePtrAndBufferReq& lhs,
@@ -85,6 +119,38 @@ NrMacSchedulerOfdmaAi::GetUeCompareUlFn() const
     return NrMacSchedulerUeInfoQos::CompareUeWeightsUl;
 }
 
+NrMacSchedulerOfdma::GetUeKeyFn
+NrMacSchedulerOfdmaAi::GetUeKeyDlFn() const
+{
+    if (m_activeDlAi)
+    {
+        return [](const NrMacSchedulerNs3::UePtrAndBufferReq& ue) {
+            return static_cast<const NrMacSchedulerUeInfoAi*>(ue.first.get())
+                ->GetDlAggregateWeight();
+        };
+    }
+    return nullptr;
+}
+
+NrMacSchedulerOfdma::GetUeKeyFn
+NrMacSchedulerOfdmaAi::GetUeKeyUlFn() const
+{
+    if (m_activeUlAi)
+    {
+        return [](const NrMacSchedulerNs3::UePtrAndBufferReq& ue) {
+            return static_cast<const NrMacSchedulerUeInfoAi*>(ue.first.get())
+                ->GetUlAggregateWeight();
+        };
+    }
+    return nullptr;
+}
+
+bool
+NrMacSchedulerOfdmaAi::IsNotAssignedUlInvariant() const
+{
+    return m_activeUlAi;
+}
+
 void
 NrMacSchedulerOfdmaAi::SetNotifyCbDl(NrMacSchedulerUeInfoAi::NotifyCb notifyCb)
 {
@@ -215,6 +281,103 @@ NrMacSchedulerOfdmaAi::CallNotifyUlFn(
     }
 }
 
+void
+NrMacSchedulerOfdmaAi::CallNotifyUlFnForSlot(
+    const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ueVector)
+{
+    NS_LOG_FUNCTION(this);
+    if (m_ulDecisionGranularity == PER_RBG)
+    {
+        return;
+    }
+
+    bool notify = !m_ulNotified;
+    switch (m_ulDecisionGranularity)
+    {
+    case PER_SLOT:
+        notify = true;
+        break;
+    case EVERY_N_SLOTS:
+        notify = notify || m_ulSlotsSinceNotify >= m_ulDecisionPeriod;
+        break;
+    case ON_UE_SET_CHANGE:
+        notify = notify || HasUlUeSetChanged(ueVector);
+        break;
+    default:
+        break;
+    }
+
+    if (!m_ulMaxWeightAge.IsZero() &&
+        Simulator::Now() - m_lastUlNotifyTime >= m_ulMaxWeightAge)
+    {
+        notify = true;
+    }
+
+    if (notify)
+    {
+        NS_LOG_DEBUG("Querying the UL model, " << m_ulSlotsSinceNotify
+                                               << " slots after the previous query");
+        CallNotifyUlFn(ueVector);
+        m_ulNotified = true;
+        m_lastUlNotifyTime = Simulator::Now();
+        m_ulSlotsSinceNotify = 0;
+        if (m_ulDecisionGranularity == ON_UE_SET_CHANGE)
+        {
+            m_ulNotifiedRntis.clear();
+            for (const auto& ue : ueVector)
+            {
+                m_ulNotifiedRntis.push_back(ue.first->GetRnti());
+            }
+            std::sort(m_ulNotifiedRntis.begin(), m_ulNotifiedRntis.end());
+        }
+    }
+    ++m_ulSlotsSinceNotify;
+}
+
+void
+NrMacSchedulerOfdmaAi::CallNotifyUlFnForRbg(
+    const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ueVector) const
+{
+    if (m_ulDecisionGranularity == PER_RBG)
+    {
+        CallNotifyUlFn(ueVector);
+    }
+}
+
+bool
+NrMacSchedulerOfdmaAi::HasUlUeSetChanged(
+    const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ueVector) const
+{
+    if (ueVector.size() != m_ulNotifiedRntis.size())
+    {
+        return true;
+    }
+    for (const auto& ue : ueVector)
+    {
+        if (!std::binary_search(m_ulNotifiedRntis.begin(),
+                                m_ulNotifiedRntis.end(),
+                                ue.first->GetRnti()))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+NrMacSchedulerOfdmaAi::SetUlDecisionGranularity(DecisionGranularity granularity)
+{
+    NS_LOG_FUNCTION(this << granularity);
+    m_ulDecisionGranularity = granularity;
+    m_ulNotified = false;
+}
+
+NrMacSchedulerOfdmaAi::DecisionGranularity
+NrMacSchedulerOfdmaAi::GetUlDecisionGranularity() const
+{
+    return m_ulDecisionGranularity;
+}
+
 void
 NrMacSchedulerOfdmaAi::UpdateAllUeWeightsDl(
     const NrMacSchedulerUeInfoAi::UeWeightsMap& ueWeights,
@@ -258,11 +421,34 @@ NrMacSchedulerOfdmaAi::UpdateAllUeWeightsUl(
     }
 }
 
+void
+NrMacSchedulerOfdmaAi::BeforeDlSched(const UePtrAndBufferReq& ue,
+                                     const FTResources& assignableInIteration) const
+{
+    NS_LOG_FUNCTION(this);
+    NrMacSchedulerOfdmaQos::BeforeDlSched(ue, assignableInIteration);
+    // the active LCs may have changed since the weights were set
+    std::static_pointer_cast<NrMacSchedulerUeInfoAi>(ue.first)->UpdateDlAggregateWeight();
+}
+
 void
 NrMacSchedulerOfdmaAi::BeforeUlSched(const UePtrAndBufferReq& ue,
                                      const FTResources& assignableInIteration) const
 {
     NS_LOG_FUNCTION(this);
+    auto uePtr = std::dynamic_pointer_cast<NrMacSchedulerUeInfoAi>(ue.first);
+    UpdateUlObservation(ue);
+    // the weights are cached across slots only if the model is not queried before every RBG
+    uePtr->SetKeepUlWeights(m_ulDecisionGranularity != PER_RBG);
+    // the active LCs may have changed since the weights were cached
+    uePtr->UpdateUlAggregateWeight();
+
+    // uePtr->IncrementNiceCount(ue_WMA);
+}
+
+void
+NrMacSchedulerOfdmaAi::UpdateUlObservation(const UePtrAndBufferReq& ue) const
+{
     auto uePtr = std::dynamic_pointer_cast<NrMacSchedulerUeInfoAi>(ue.first);
     uint16_t ue_rnti = ue.first->GetRnti();
     uint64_t ue_aoi = this->GetAge(ue_rnti);
@@ -270,8 +456,28 @@ NrMacSchedulerOfdmaAi::BeforeUlSched(const UePtrAndBufferReq& ue,
     // uint32_t ue_WMA = this->GetWMA(ue_rnti);
     uePtr->UpdateAoi(ue_aoi);
     uePtr->UpdateHarqAckResult(ue_harqAckResult);
+}
 
-    // uePtr->IncrementNiceCount(ue_WMA);
+void
+NrMacSchedulerOfdmaAi::PrepareUlDataSched(const ActiveUeMap& activeUl)
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_activeUlAi || m_ulDecisionGranularity == PER_RBG)
+    {
+        return;
+    }
+    // the slot-level decision sees the UEs of all the beams, with their current observation
+    std::vector<UePtrAndBufferReq> ueVector;
+    for (const auto& beam : activeUl)
+    {
+        for (const auto& ue : beam.second)
+        {
+            UpdateUlObservation(ue);
+            ueVector.emplace_back(ue);
+        }
+    }
+    // the weights cached in the UEs are then reused by the RBG loops of AssignULRBG
+    CallNotifyUlFnForSlot(ueVector);
 }
 
 } // namespace ns3
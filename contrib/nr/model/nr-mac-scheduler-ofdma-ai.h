@@ -8,6 +8,7 @@
 #include "nr-mac-scheduler-ofdma-qos.h"
 #include "nr-mac-scheduler-ue-info-ai.h"
 
+#include "ns3/nstime.h"
 #include "ns3/traced-value.h"
 
 namespace ns3
@@ -31,6 +32,13 @@ namespace ns3
  * to train the AI model. All information needed by the gym is sent once through
  * the NotifyCb callback function for each iteration.
  *
+ * The uplink model is not necessarily queried before every RBG assignment. The attribute
+ * UlDecisionGranularity selects the decision point: per RBG (the original behavior), once per
+ * slot, once every UlDecisionPeriod slots, or only when the set of active UL UEs changes. In all
+ * but the per-RBG mode the weights returned by the model are cached in NrMacSchedulerUeInfoAi and
+ * reused by every RBG iteration of the slot and by the following slots, until the next decision
+ * point. UlMaxWeightAge bounds how old the cached weights may get before a new query is forced.
+ *
  * Details in the class NrMacSchedulerUeInfoAI.
  */
 class NrMacSchedulerOfdmaAi : public NrMacSchedulerOfdmaQos
@@ -38,6 +46,17 @@ class NrMacSchedulerOfdmaAi : public NrMacSchedulerOfdmaQos
     friend class NrTestSchedulerAiCase;
 
   public:
+    /**
+     * @brief Point at which the AI model is queried for new weights
+     */
+    enum DecisionGranularity
+    {
+        PER_RBG,          //!< Query the model before every RBG assignment
+        PER_SLOT,         //!< Query the model once per slot
+        EVERY_N_SLOTS,    //!< Query the model once every UlDecisionPeriod slots
+        ON_UE_SET_CHANGE, //!< Query the model when the set of active UEs changes
+    };
+
     /**
      * @brief GetTypeId
      * @return The TypeId of the class
@@ -64,6 +83,40 @@ class NrMacSchedulerOfdmaAi : public NrMacSchedulerOfdmaQos
      */
     void CallNotifyUlFn(const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ueVector) const;
 
+    /**
+     * @brief Uplink decision point at the beginning of the RBG assignment of a slot
+     * @param ueVector A vector containing pointers to active UEs and their corresponding buffer
+     * requests
+     *
+     * Called once per slot by PrepareUlDataSched, with the UEs of all the active beams, before
+     * the RBGs are assigned. Depending on the configured granularity and on the age of the
+     * cached weights, it calls CallNotifyUlFn or leaves the weights cached in the UEs untouched,
+     * and it records the query for the next decisions.
+     */
+    void CallNotifyUlFnForSlot(const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ueVector);
+
+    /**
+     * @brief Uplink decision point before the assignment of each RBG
+     * @param ueVector A vector containing pointers to active UEs and their corresponding buffer
+     * requests
+     *
+     * Calls CallNotifyUlFn only if the granularity is PER_RBG.
+     */
+    void CallNotifyUlFnForRbg(
+        const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ueVector) const;
+
+    /**
+     * @brief Set the uplink decision granularity
+     * @param granularity the decision granularity
+     */
+    void SetUlDecisionGranularity(DecisionGranularity granularity);
+
+    /**
+     * @brief Get the uplink decision granularity
+     * @return the decision granularity
+     */
+    DecisionGranularity GetUlDecisionGranularity() const;
+
   protected:
     /**
      * @brief Create an UE representation of the type NrMacSchedulerUeInfoAi
@@ -91,6 +144,27 @@ class NrMacSchedulerOfdmaAi : public NrMacSchedulerOfdmaQos
                        const NrMacSchedulerNs3::UePtrAndBufferReq& rhs)>
     GetUeCompareUlFn() const override;
 
+    /**
+     * @brief Return the aggregate DL weight of a UE as its sort key, if the AI model is activated
+     * @return NrMacSchedulerUeInfoAi::GetDlAggregateWeight or an empty function
+     */
+    GetUeKeyFn GetUeKeyDlFn() const override;
+
+    /**
+     * @brief Return the aggregate UL weight of a UE as its sort key, if the AI model is activated
+     * @return NrMacSchedulerUeInfoAi::GetUlAggregateWeight or an empty function
+     */
+    GetUeKeyFn GetUeKeyUlFn() const override;
+
+    /**
+     * @brief Whether NotAssignedUlResources() can be skipped
+     * @return true if the AI model is activated
+     *
+     * The UEs are then ordered by the weights of the model, and the UL reward does not use the
+     * average throughput that NrMacSchedulerOfdmaQos::NotAssignedUlResources() updates.
+     */
+    bool IsNotAssignedUlInvariant() const override;
+
     /**
      * @brief Set the notify callback function for downlink
      * @param notifyCb The callback function to be set
@@ -171,12 +245,50 @@ class NrMacSchedulerOfdmaAi : public NrMacSchedulerOfdmaQos
         const NrMacSchedulerUeInfoAi::UeWeightsMap& ueWeights,
         const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ueVector) const;
 
+    /**
+     * @brief Compute the potential throughput (as the QoS scheduler) and the aggregate DL weight
+     * @param ue the UE
+     * @param assignableInIteration the resources assignable in each iteration
+     */
+    void BeforeDlSched(const UePtrAndBufferReq& ue,
+                       const FTResources& assignableInIteration) const override;
+
     virtual void BeforeUlSched(const UePtrAndBufferReq& ue,
                                const FTResources& assignableInIteration) const override;
 
+    /**
+     * @brief Take the slot-level UL decision, if the AI model is activated
+     * @param activeUl Map of Beam and active UE per beam
+     *
+     * Updates the observation of the UEs of all the beams and calls CallNotifyUlFnForSlot.
+     */
+    void PrepareUlDataSched(const ActiveUeMap& activeUl) override;
+
   private:
+    /**
+     * @brief Check whether the set of UEs differs from the one of the last UL query
+     * @param ueVector the UEs of the current slot
+     * @return true if at least one RNTI was added or removed
+     */
+    bool HasUlUeSetChanged(const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ueVector) const;
+
+    /**
+     * @brief Update the AoI and the HARQ result observed for a UE
+     * @param ue the UE
+     */
+    void UpdateUlObservation(const UePtrAndBufferReq& ue) const;
+
     float m_alpha{0.0};                            //!< PF Fairness index
     NrMacSchedulerUeInfoAi::NotifyCb m_notifyCbDl; //!< Notify callback function for downlink
     NrMacSchedulerUeInfoAi::NotifyCb m_notifyCbUl; //!< Notify callback function for uplink
+
+    DecisionGranularity m_ulDecisionGranularity{PER_RBG}; //!< UL decision point
+    uint32_t m_ulDecisionPeriod{1}; //!< Slots between two UL queries in EVERY_N_SLOTS mode
+    Time m_ulMaxWeightAge{0};       //!< Max age of the cached UL weights (0 disables the bound)
+
+    bool m_ulNotified{false};                //!< Whether the UL model was queried at least once
+    Time m_lastUlNotifyTime{0};              //!< Time of the last UL query
+    uint32_t m_ulSlotsSinceNotify{0};        //!< Slots elapsed since the last UL query
+    std::vector<uint16_t> m_ulNotifiedRntis; //!< Sorted RNTIs of the last UL query
 };
 } // namespace ns3
@@ -35,8 +35,8 @@ namespace ns3 {
     {
         return [] (const NrMacSchedulerNs3::UePtrAndBufferReq &lhs,
                 const NrMacSchedulerNs3::UePtrAndBufferReq &rhs) -> bool {
-        return std::static_pointer_cast<NrMacSchedulerUeInfoGreedy> (lhs.first)->GetAoi () >
-            std::static_pointer_cast<NrMacSchedulerUeInfoGreedy> (rhs.first)->GetAoi ();};
+        return static_cast<const NrMacSchedulerUeInfoGreedy *> (lhs.first.get ())->GetAoi () >
+            static_cast<const NrMacSchedulerUeInfoGreedy *> (rhs.first.get ())->GetAoi ();};
     }
 
     std::function<bool (const NrMacSchedulerNs3::UePtrAndBufferReq &lhs,const NrMacSchedulerNs3::UePtrAndBufferReq &rhs)>
@@ -45,6 +45,20 @@ namespace ns3 {
         return NrMacSchedulerUeInfoGreedy::CompareUeWeightsUl;
     }
 
+    NrMacSchedulerOfdma::GetUeKeyFn
+    NrMacSchedulerOfdmaGreedy::GetUeKeyDlFn () const
+    {
+        return [] (const NrMacSchedulerNs3::UePtrAndBufferReq &ue) -> double {
+        return static_cast<const NrMacSchedulerUeInfoGreedy *> (ue.first.get ())->GetAoi ();};
+    }
+
+    NrMacSchedulerOfdma::GetUeKeyFn
+    NrMacSchedulerOfdmaGreedy::GetUeKeyUlFn () const
+    {
+        return [] (const NrMacSchedulerNs3::UePtrAndBufferReq &ue) -> double {
+        return static_cast<const NrMacSchedulerUeInfoGreedy *> (ue.first.get ())->CalculateMetric ();};
+    }
+
     void
     NrMacSchedulerOfdmaGreedy::AssignedDlResources (const UePtrAndBufferReq &ue,
                                                     const FTResources &assigned,
@@ -126,7 +140,8 @@ namespace ns3 {
         uint16_t ue_rnti = ue.first->GetRnti ();
         uint64_t ue_aoi = this->GetAge (ue_rnti);
         // uint32_t ue_WMA = this->GetWMA(ue_rnti);
-        uePtr->UpdateAoi (ue_aoi);
+        // the metric is computed once here, not at each comparison
+        uePtr->UpdateMetric (ue_aoi, uePtr->GetNiceCount ());
         // uePtr->IncrementNiceCount(ue_WMA);
     }
 }
\ No newline at end of file
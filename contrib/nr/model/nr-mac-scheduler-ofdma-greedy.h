@@ -62,6 +62,18 @@ protected:
                               const NrMacSchedulerNs3::UePtrAndBufferReq &rhs)>
   GetUeCompareUlFn () const override;
 
+  /**
+   * \brief Return the AoI of a DL UE as its sort key
+   * \return a function giving NrMacSchedulerUeInfoGreedy::GetAoi
+   */
+  GetUeKeyFn GetUeKeyDlFn () const override;
+
+  /**
+   * \brief Return the metric of a UL UE as its sort key
+   * \return a function giving NrMacSchedulerUeInfoGreedy::CalculateMetric
+   */
+  GetUeKeyFn GetUeKeyUlFn () const override;
+
   /**
    * \brief Update the UE representation after a symbol (DL) has been assigned to it
    * \param ue UE to which a symbol has been assigned
@@ -100,6 +112,24 @@ protected:
   virtual void NotAssignedDlResources (const UePtrAndBufferReq &ue, const FTResources &notAssigned,
                                        const FTResources &totalAssigned) const override;
 
+  /**
+   * \brief The AoI metric does not depend on the resources not assigned
+   * \return true
+   */
+  bool IsNotAssignedDlInvariant () const override
+  {
+    return true;
+  }
+
+  /**
+   * \brief The AoI metric does not depend on the resources not assigned
+   * \return true
+   */
+  bool IsNotAssignedUlInvariant () const override
+  {
+    return true;
+  }
+
   virtual void BeforeDlSched (const UePtrAndBufferReq &ue,
                               const FTResources &assignableInIteration) const override;
 
@@ -110,6 +110,16 @@ class NrMacSchedulerOfdmaRR : public NrMacSchedulerOfdma
     {
     }
 
+    bool IsNotAssignedDlInvariant() const override
+    {
+        return true;
+    }
+
+    bool IsNotAssignedUlInvariant() const override
+    {
+        return true;
+    }
+
     void BeforeDlSched(const UePtrAndBufferReq& ue,
                        const FTResources& assignableInIteration) const override
     {
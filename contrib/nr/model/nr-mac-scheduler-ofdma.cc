@@ -13,6 +13,7 @@
 #include "nr-fh-control.h"
 #include "nr-mac-scheduler-ofdma-ai.h"
 
+#include <ns3/boolean.h>
 #include <ns3/log.h>
 
 #include <algorithm>
@@ -29,6 +30,13 @@ NrMacSchedulerOfdma::GetTypeId()
     static TypeId tid =
         TypeId("ns3::NrMacSchedulerOfdma")
             .SetParent<NrMacSchedulerTdma>()
+            .AddAttribute("IncrementalUeOrder",
+                          "Keep the UEs of a beam in a heap re-keyed after each RBG, instead of "
+                          "sorting all of them before each RBG. UEs of equal priority are then "
+                          "ordered by their initial position rather than by the previous sort.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrMacSchedulerOfdma::m_incrementalUeOrder),
+                          MakeBooleanChecker())
             .AddTraceSource(
                 "SymPerBeam",
                 "Number of assigned symbol per beam. Gets called every time an assignment is made",
@@ -184,52 +192,77 @@ NrMacSchedulerOfdma::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl)
             BeforeDlSched(ue, FTResources(rbgAssignable, beamSym));
         }
 
+        const GetUeKeyFn ueKeyFn = GetUeKeyDlFn();
+        const auto ueCompareFn = GetUeCompareDlFn();
+        const bool notAssignedInvariant = IsNotAssignedDlInvariant();
+        const bool fhOptimizeRbs =
+            m_nrFhSchedSapProvider && m_nrFhSchedSapProvider->GetFhControlMethod() ==
+                                          NrFhControl::FhControlMethod::OptimizeRBs;
+
+        // A UE which already has enough resources to transmit
+        auto isServed = [](const UePtrAndBufferReq& ue) {
+            return ue.first->m_dlTbSize >= std::max(ue.second, 10U);
+        };
+        // A UE which cannot get another RBG within the fronthaul capacity
+        auto isFhLimited = [this, rbgAssignable](const UePtrAndBufferReq& ue) {
+            uint32_t quantizationStep = rbgAssignable;
+            uint32_t maxAssignable =
+                m_nrFhSchedSapProvider->GetMaxRegAssignable(GetBwpId(),
+                                                            ue.first->m_dlMcs,
+                                                            ue.first->m_rnti,
+                                                            ue.first->m_dlRank); // in REGs
+            // set a minimum of the maxAssignable equal to 5 RBGs
+            maxAssignable = std::max(maxAssignable, 5 * rbgAssignable);
+
+            // the minimum allocation is one resource in freq, containing rbgAssignable
+            // in time (REGs)
+            return ue.first->m_dlRBG + quantizationStep > maxAssignable;
+        };
+
+        if (m_incrementalUeOrder)
+        {
+            m_ueHeap.Build(ueVector, ueKeyFn, ueCompareFn);
+        }
+
         while (resources > 0)
         {
             GetFirst GetUe;
-            std::stable_sort(ueVector.begin(), ueVector.end(), GetUeCompareDlFn());
             auto schedInfoIt = ueVector.begin();
-
-            // Ensure fairness: pass over UEs which already has enough resources to transmit
-            while (schedInfoIt != ueVector.end())
+            if (m_incrementalUeOrder)
             {
-                uint32_t bufQueueSize = schedInfoIt->second;
-                if (GetUe(*schedInfoIt)->m_dlTbSize >= std::max(bufQueueSize, 10U))
+                // Both conditions hold until the end of the slot: drop the UEs for good
+                while (!m_ueHeap.IsEmpty() &&
+                       (isServed(ueVector[m_ueHeap.GetTop()]) ||
+                        (fhOptimizeRbs && isFhLimited(ueVector[m_ueHeap.GetTop()]))))
                 {
-                    schedInfoIt++;
+                    m_ueHeap.Pop();
+                }
+                schedInfoIt = m_ueHeap.IsEmpty() ? ueVector.end()
+                                                 : ueVector.begin() + m_ueHeap.GetTop();
+            }
+            else
+            {
+                if (ueKeyFn)
+                {
+                    SortUesByKey(&ueVector, ueKeyFn);
                 }
                 else
                 {
-                    break;
+                    std::stable_sort(ueVector.begin(), ueVector.end(), ueCompareFn);
                 }
-            }
+                schedInfoIt = ueVector.begin();
 
-            if (m_nrFhSchedSapProvider)
-            {
-                if (m_nrFhSchedSapProvider->GetFhControlMethod() ==
-                    NrFhControl::FhControlMethod::OptimizeRBs)
+                // Ensure fairness: pass over UEs which already has enough resources to transmit
+                while (schedInfoIt != ueVector.end() && isServed(*schedInfoIt))
                 {
-                    uint32_t quantizationStep = rbgAssignable;
-                    while (schedInfoIt != ueVector.end())
-                    {
-                        uint32_t maxAssignable = m_nrFhSchedSapProvider->GetMaxRegAssignable(
-                            GetBwpId(),
-                            GetUe(*schedInfoIt)->m_dlMcs,
-                            GetUe(*schedInfoIt)->m_rnti,
-                            GetUe(*schedInfoIt)->m_dlRank); // maxAssignable is in REGs
-                        // set a minimum of the maxAssignable equal to 5 RBGs
-                        maxAssignable = std::max(maxAssignable, 5 * rbgAssignable);
+                    schedInfoIt++;
+                }
 
-                        // the minimum allocation is one resource in freq, containing rbgAssignable
-                        // in time (REGs)
-                        if (GetUe(*schedInfoIt)->m_dlRBG + quantizationStep > maxAssignable)
-                        {
-                            schedInfoIt++;
-                        }
-                        else
-                        {
-                            break;
-                        }
+                if (fhOptimizeRbs)
+                {
+                    while (schedInfoIt != ueVector.end() && isFhLimited(*schedInfoIt))
+                    {
+                        schedInfoIt++;
                     }
                 }
             }
@@ -266,11 +299,26 @@ NrMacSchedulerOfdma::AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl)
 
             // Update metrics for the unsuccessful UEs (who did not get any resource in this
             // iteration)
-            for (auto& ue : ueVector)
+            if (!notAssignedInvariant)
             {
-                if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                for (auto& ue : ueVector)
                 {
-                    NotAssignedDlResources(ue, FTResources(rbgAssignable, beamSym), assigned);
+                    if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                    {
+                        NotAssignedDlResources(ue, FTResources(rbgAssignable, beamSym), assigned);
+                    }
+                }
+            }
+
+            if (m_incrementalUeOrder)
+            {
+                if (notAssignedInvariant)
+                {
+                    m_ueHeap.Update(schedInfoIt - ueVector.begin());
+                }
+                else
+                {
+                    m_ueHeap.Refresh();
                 }
             }
         }
@@ -349,6 +397,33 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
     GetSecond GetUeVector;
     BeamSymbolMap symPerBeam = GetSymPerBeam(symAvail, activeUl);
 
+    // Prepare the UEs of all the beams first, with the weights of the slot-level decision
+    // taken by PrepareUlDataSched
+    for (const auto& el : activeUl)
+    {
+        uint32_t beamSym = symPerBeam.at(GetBeamId(el));
+        for (const auto& ue : GetUeVector(el))
+        {
+            BeforeUlSched(ue, FTResources(beamSym, beamSym));
+        }
+    }
+
+    const NrMacSchedulerOfdmaAi* aiScheduler = nullptr;
+    if (m_activeUlAi)
+    {
+        // this 포인터를 NrMacSchedulerOfdmaAi로 캐스팅
+        aiScheduler = dynamic_cast<const NrMacSchedulerOfdmaAi*>(this);
+        if (aiScheduler == nullptr)
+        {
+            NS_FATAL_ERROR(
+                "m_activeUlAi is true, but dynamic_cast to NrMacSchedulerOfdmaAi failed");
+        }
+    }
+    // the weights queried before each RBG change the metrics of all the UEs
+    const bool rbgDecision =
+        aiScheduler != nullptr &&
+        aiScheduler->GetUlDecisionGranularity() == NrMacSchedulerOfdmaAi::PER_RBG;
+
     // Iterate through the different beams
     for (const auto& el : activeUl)
     {
@@ -368,45 +443,59 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
             ueVector.emplace_back(ue);
         }
 
-        for (auto& ue : ueVector)
+        const GetUeKeyFn ueKeyFn = GetUeKeyUlFn();
+        const auto ueCompareFn = GetUeCompareUlFn();
+        const bool notAssignedInvariant = IsNotAssignedUlInvariant();
+
+        // A UE which already has enough resources to transmit
+        auto isServed = [](const UePtrAndBufferReq& ue) {
+            return ue.first->m_ulTbSize >= std::max(ue.second, 12U);
+        };
+
+        if (m_incrementalUeOrder)
         {
-            BeforeUlSched(ue, FTResources(rbgAssignable, beamSym));
+            m_ueHeap.Build(ueVector, ueKeyFn, ueCompareFn);
         }
 
         while (resources > 0)
         {
-            if (m_activeUlAi)
+            if (aiScheduler != nullptr)
+            {
+                aiScheduler->CallNotifyUlFnForRbg(ueVector);
+            }
+
+            GetFirst GetUe;
+            auto schedInfoIt = ueVector.begin();
+            if (m_incrementalUeOrder)
             {
-                // this 포인터를 NrMacSchedulerOfdmaAi로 캐스팅
-                auto aiScheduler = dynamic_cast<const NrMacSchedulerOfdmaAi*>(this);
-                if (aiScheduler != nullptr)
+                if (rbgDecision)
                 {
-                    // NS_LOG_UNCOND("[scheduler-ofdma] <AssignULRBG> : CallNotufyFn 시작");
-                    aiScheduler->CallNotifyUlFn(ueVector);
+                    m_ueHeap.Refresh();
                 }
-                else
+                // A served UE stays so until the end of the slot: drop it for good
+                while (!m_ueHeap.IsEmpty() && isServed(ueVector[m_ueHeap.GetTop()]))
                 {
-                    NS_FATAL_ERROR(
-                        "m_activeUlAi is true, but dynamic_cast to NrMacSchedulerOfdmaAi failed");
+                    m_ueHeap.Pop();
                 }
+                schedInfoIt = m_ueHeap.IsEmpty() ? ueVector.end()
+                                                 : ueVector.begin() + m_ueHeap.GetTop();
             }
-            // NS_LOG_UNCOND("[scheduler-ofdma] <AssignULRBG> : CallNotufyFn 끝");
-
-            GetFirst GetUe;
-            std::stable_sort(ueVector.begin(), ueVector.end(), GetUeCompareUlFn());
-            auto schedInfoIt = ueVector.begin();
-
-            // Ensure fairness: pass over UEs which already has enough resources to transmit
-            while (schedInfoIt != ueVector.end())
+            else
             {
-                uint32_t bufQueueSize = schedInfoIt->second;
-                if (GetUe(*schedInfoIt)->m_ulTbSize >= std::max(bufQueueSize, 12U))
+                if (ueKeyFn)
                 {
-                    schedInfoIt++;
+                    SortUesByKey(&ueVector, ueKeyFn);
                 }
                 else
                 {
-                    break;
+                    std::stable_sort(ueVector.begin(), ueVector.end(), ueCompareFn);
+                }
+                schedInfoIt = ueVector.begin();
+
+                // Ensure fairness: pass over UEs which already has enough resources to transmit
+                while (schedInfoIt != ueVector.end() && isServed(*schedInfoIt))
+                {
+                    schedInfoIt++;
                 }
             }
 
@@ -434,11 +523,27 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
 
             // Update metrics for the unsuccessful UEs (who did not get any resource in this
             // iteration)
-            for (auto& ue : ueVector)
+            if (!notAssignedInvariant)
             {
-                if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                for (auto& ue : ueVector)
                 {
-                    NotAssignedUlResources(ue, FTResources(rbgAssignable, beamSym), assigned);
+                    if (GetUe(ue)->m_rnti != GetUe(*schedInfoIt)->m_rnti)
+                    {
+                        NotAssignedUlResources(ue, FTResources(rbgAssignable, beamSym), assigned);
+                    }
+                }
+            }
+
+            // with per-RBG decisions, the heap is refreshed before the next RBG
+            if (m_incrementalUeOrder && !rbgDecision)
+            {
+                if (notAssignedInvariant)
+                {
+                    m_ueHeap.Update(schedInfoIt - ueVector.begin());
+                }
+                else
+                {
+                    m_ueHeap.Refresh();
                 }
             }
         }
@@ -447,6 +552,56 @@ NrMacSchedulerOfdma::AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl)
     return symPerBeam;
 }
 
+NrMacSchedulerOfdma::GetUeKeyFn
+NrMacSchedulerOfdma::GetUeKeyDlFn() const
+{
+    return nullptr;
+}
+
+NrMacSchedulerOfdma::GetUeKeyFn
+NrMacSchedulerOfdma::GetUeKeyUlFn() const
+{
+    return nullptr;
+}
+
+bool
+NrMacSchedulerOfdma::IsNotAssignedDlInvariant() const
+{
+    return false;
+}
+
+bool
+NrMacSchedulerOfdma::IsNotAssignedUlInvariant() const
+{
+    return false;
+}
+
+void
+NrMacSchedulerOfdma::SortUesByKey(std::vector<UePtrAndBufferReq>* ueVector,
+                                  const GetUeKeyFn& keyFn) const
+{
+    NS_LOG_FUNCTION(this);
+    m_ueSortKeys.clear();
+    for (uint32_t i = 0; i < ueVector->size(); ++i)
+    {
+        m_ueSortKeys.emplace_back(keyFn(ueVector->at(i)), i);
+    }
+    // Ties are broken by the position, which gives the order of std::stable_sort
+    std::sort(m_ueSortKeys.begin(),
+              m_ueSortKeys.end(),
+              [](const std::pair<double, uint32_t>& lhs, const std::pair<double, uint32_t>& rhs) {
+                  return lhs.first > rhs.first ||
+                         (lhs.first == rhs.first && lhs.second < rhs.second);
+              });
+
+    m_ueSortScratch.clear();
+    for (const auto& key : m_ueSortKeys)
+    {
+        m_ueSortScratch.emplace_back(std::move(ueVector->at(key.second)));
+    }
+    ueVector->swap(m_ueSortScratch);
+}
+
 /**
  * \brief Create the DL DCI in OFDMA mode
  * \param spoint Starting point
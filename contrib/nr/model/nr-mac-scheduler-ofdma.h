@@ -5,6 +5,7 @@
 #pragma once
 
 #include "nr-mac-scheduler-tdma.h"
+#include "nr-mac-scheduler-ue-heap.h"
 
 #include <ns3/traced-value.h>
 
@@ -69,6 +70,50 @@ class NrMacSchedulerOfdma : public NrMacSchedulerTdma
     }
 
   protected:
+    /**
+     * \brief Sort key of a UE: the UEs with the higher key are served first
+     */
+    using GetUeKeyFn = std::function<double(const UePtrAndBufferReq& ue)>;
+
+    /**
+     * \brief Return the function giving the sort key of a DL UE, if the scheduler policy has one
+     * \return an empty function (the default) to sort the UEs with GetUeCompareDlFn()
+     *
+     * A policy whose order is "higher metric first" can return the metric here, so that
+     * AssignDLRBG() reads it once per UE and sorts a contiguous key array instead of calling
+     * the comparison function O(n log n) times for every RBG. The resulting order is the
+     * one of std::stable_sort with a "lhs > rhs" comparison.
+     */
+    virtual GetUeKeyFn GetUeKeyDlFn() const;
+
+    /**
+     * \brief Return the function giving the sort key of a UL UE, if the scheduler policy has one
+     * \return an empty function (the default) to sort the UEs with GetUeCompareUlFn()
+     *
+     * \see GetUeKeyDlFn
+     */
+    virtual GetUeKeyFn GetUeKeyUlFn() const;
+
+    /**
+     * \brief Whether the policy declares NotAssignedDlResources() without effect on the order
+     * \return false (the default) to call NotAssignedDlResources() for every UE not served by
+     * an RBG
+     *
+     * A policy whose metrics do not depend on the resources not assigned (e.g., RR, which does
+     * nothing in NotAssignedDlResources()) returns true: the call is then skipped, and with
+     * the IncrementalUeOrder attribute only the served UE is re-keyed after each RBG.
+     */
+    virtual bool IsNotAssignedDlInvariant() const;
+
+    /**
+     * \brief Whether the policy declares NotAssignedUlResources() without effect on the order
+     * \return false (the default) to call NotAssignedUlResources() for every UE not served by
+     * an RBG
+     *
+     * \see IsNotAssignedDlInvariant
+     */
+    virtual bool IsNotAssignedUlInvariant() const;
+
     BeamSymbolMap AssignDLRBG(uint32_t symAvail, const ActiveUeMap& activeDl) const override;
     BeamSymbolMap AssignULRBG(uint32_t symAvail, const ActiveUeMap& activeUl) const override;
 
@@ -97,6 +142,17 @@ class NrMacSchedulerOfdma : public NrMacSchedulerTdma
     uint8_t GetTpc() const override;
 
   private:
+    /**
+     * \brief Sort the UEs by decreasing key, keeping the current order of equal keys
+     * \param ueVector the UEs to sort
+     * \param keyFn the sort key of a UE
+     */
+    void SortUesByKey(std::vector<UePtrAndBufferReq>* ueVector, const GetUeKeyFn& keyFn) const;
+
     TracedValue<uint32_t> m_tracedValueSymPerBeam;
+    bool m_incrementalUeOrder{false};  //!< Keep the UEs in m_ueHeap instead of sorting them
+    mutable NrMacSchedulerUeHeap m_ueHeap; //!< UEs of the beam being assigned
+    mutable std::vector<std::pair<double, uint32_t>> m_ueSortKeys; //!< Key and position of the UEs
+    mutable std::vector<UePtrAndBufferReq> m_ueSortScratch; //!< UEs in sorted order
 };
 } // namespace ns3
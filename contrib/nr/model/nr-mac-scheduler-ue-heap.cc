@@ -0,0 +1,144 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-mac-scheduler-ue-heap.h"
+
+#include <ns3/assert.h>
+
+#include <algorithm>
+
+namespace ns3
+{
+
+void
+NrMacSchedulerUeHeap::Build(const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ues,
+                            const KeyFn& keyFn,
+                            const CompareFn& compareFn)
+{
+    NS_ASSERT(keyFn || compareFn);
+    m_ues = &ues;
+    m_keyFn = keyFn;
+    m_compareFn = compareFn;
+    m_keys.resize(ues.size());
+    m_slot.resize(ues.size());
+    m_heap.resize(ues.size());
+    for (uint32_t ue = 0; ue < ues.size(); ++ue)
+    {
+        m_heap[ue] = ue;
+    }
+    Refresh();
+}
+
+void
+NrMacSchedulerUeHeap::Pop()
+{
+    NS_ASSERT(!m_heap.empty());
+    uint32_t last = m_heap.back();
+    m_heap.pop_back();
+    if (!m_heap.empty())
+    {
+        Place(0, last);
+        SiftDown(0);
+    }
+}
+
+void
+NrMacSchedulerUeHeap::Update(uint32_t ue)
+{
+    NS_ASSERT(m_slot[ue] < m_heap.size() && m_heap[m_slot[ue]] == ue);
+    if (m_keyFn)
+    {
+        m_keys[ue] = m_keyFn(m_ues->at(ue));
+    }
+    SiftDown(SiftUp(m_slot[ue]));
+}
+
+void
+NrMacSchedulerUeHeap::Refresh()
+{
+    for (uint32_t slot = 0; slot < m_heap.size(); ++slot)
+    {
+        uint32_t ue = m_heap[slot];
+        m_slot[ue] = slot;
+        if (m_keyFn)
+        {
+            m_keys[ue] = m_keyFn(m_ues->at(ue));
+        }
+    }
+    // Floyd's construction, from the last internal node up to the root
+    for (uint32_t slot = m_heap.size() / ARITY + 1; slot-- > 0;)
+    {
+        SiftDown(slot);
+    }
+}
+
+bool
+NrMacSchedulerUeHeap::IsBefore(uint32_t a, uint32_t b) const
+{
+    if (m_keyFn)
+    {
+        return m_keys[a] > m_keys[b] || (m_keys[a] == m_keys[b] && a < b);
+    }
+    const auto& lhs = m_ues->at(a);
+    const auto& rhs = m_ues->at(b);
+    if (m_compareFn(lhs, rhs))
+    {
+        return true;
+    }
+    return !m_compareFn(rhs, lhs) && a < b;
+}
+
+uint32_t
+NrMacSchedulerUeHeap::SiftUp(uint32_t slot)
+{
+    uint32_t ue = m_heap[slot];
+    while (slot > 0)
+    {
+        uint32_t parent = (slot - 1) / ARITY;
+        if (!IsBefore(ue, m_heap[parent]))
+        {
+            break;
+        }
+        Place(slot, m_heap[parent]);
+        slot = parent;
+    }
+    Place(slot, ue);
+    return slot;
+}
+
+void
+NrMacSchedulerUeHeap::SiftDown(uint32_t slot)
+{
+    if (slot >= m_heap.size())
+    {
+        return;
+    }
+    uint32_t ue = m_heap[slot];
+    while (true)
+    {
+        uint32_t first = slot * ARITY + 1;
+        if (first >= m_heap.size())
+        {
+            break;
+        }
+        uint32_t last = std::min<uint32_t>(first + ARITY, m_heap.size());
+        uint32_t best = first;
+        for (uint32_t child = first + 1; child < last; ++child)
+        {
+            if (IsBefore(m_heap[child], m_heap[best]))
+            {
+                best = child;
+            }
+        }
+        if (!IsBefore(m_heap[best], ue))
+        {
+            break;
+        }
+        Place(slot, m_heap[best]);
+        slot = best;
+    }
+    Place(slot, ue);
+}
+
+} // namespace ns3
@@ -0,0 +1,129 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#pragma once
+
+#include "nr-mac-scheduler-ns3.h"
+
+#include <functional>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief Indexed d-ary heap of the UEs of a beam, ordered by the scheduler policy
+ *
+ * The heap replaces the sort of the UE vector before the assignment of each RBG
+ * (see NrMacSchedulerOfdma::AssignDLRBG and NrMacSchedulerOfdma::AssignULRBG): the
+ * UE to serve is the top of the heap, and when only its metric changed after the
+ * assignment it is re-keyed with Update() in O(d log_d n) instead of sorting all the
+ * UEs again. Refresh() re-keys all the UEs in O(n), for the policies whose metrics
+ * all change at each RBG.
+ *
+ * The UEs are referred to by their position in the vector given to Build(), which
+ * must not be reordered while the heap is in use. The order is the one of the policy,
+ * given either by a sort key (higher key first, see NrMacSchedulerOfdma::GetUeKeyDlFn)
+ * or by the comparison function; UEs of equal priority are ordered by position.
+ */
+class NrMacSchedulerUeHeap
+{
+  public:
+    /**
+     * \brief Comparison function of the policy: true if lhs is served before rhs
+     */
+    using CompareFn = std::function<bool(const NrMacSchedulerNs3::UePtrAndBufferReq& lhs,
+                                         const NrMacSchedulerNs3::UePtrAndBufferReq& rhs)>;
+    /**
+     * \brief Sort key of the policy: the UEs with the higher key are served first
+     */
+    using KeyFn = std::function<double(const NrMacSchedulerNs3::UePtrAndBufferReq& ue)>;
+
+    static constexpr uint32_t ARITY = 4; //!< Children of each node
+
+    /**
+     * \brief Put all the UEs in the heap
+     * \param ues the UEs, which must outlive the heap use
+     * \param keyFn the sort key, or an empty function to use compareFn
+     * \param compareFn the comparison function, used when keyFn is empty
+     */
+    void Build(const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ues,
+               const KeyFn& keyFn,
+               const CompareFn& compareFn);
+
+    /**
+     * \return true if no UE is left in the heap
+     */
+    bool IsEmpty() const
+    {
+        return m_heap.empty();
+    }
+
+    /**
+     * \return the position of the UE to serve first
+     */
+    uint32_t GetTop() const
+    {
+        return m_heap.front();
+    }
+
+    /**
+     * \brief Remove the UE to serve first
+     */
+    void Pop();
+
+    /**
+     * \brief Re-key a UE after its metric changed
+     * \param ue the position of the UE, which must be in the heap
+     */
+    void Update(uint32_t ue);
+
+    /**
+     * \brief Re-key all the UEs left in the heap
+     */
+    void Refresh();
+
+  private:
+    /**
+     * \brief Whether a UE is served before another one
+     * \param a the position of the first UE
+     * \param b the position of the second UE
+     * \return true if a is served before b
+     */
+    bool IsBefore(uint32_t a, uint32_t b) const;
+
+    /**
+     * \brief Move the UE at a heap slot towards the root while it precedes its parent
+     * \param slot the heap slot
+     * \return the final heap slot
+     */
+    uint32_t SiftUp(uint32_t slot);
+
+    /**
+     * \brief Move the UE at a heap slot towards the leaves while a child precedes it
+     * \param slot the heap slot
+     */
+    void SiftDown(uint32_t slot);
+
+    /**
+     * \brief Place a UE at a heap slot
+     * \param slot the heap slot
+     * \param ue the position of the UE
+     */
+    void Place(uint32_t slot, uint32_t ue)
+    {
+        m_heap[slot] = ue;
+        m_slot[ue] = slot;
+    }
+
+    const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>* m_ues{nullptr}; //!< UEs
+    KeyFn m_keyFn;                //!< Sort key, empty when the comparison function is used
+    CompareFn m_compareFn;        //!< Comparison function
+    std::vector<double> m_keys;   //!< Key of each UE, when m_keyFn is set
+    std::vector<uint32_t> m_heap; //!< Positions of the UEs, in heap order
+    std::vector<uint32_t> m_slot; //!< Heap slot of each UE
+};
+
+} // namespace ns3
@@ -21,26 +21,80 @@ void
 NrMacSchedulerUeInfoAi::ResetDlSchedInfo()
 {
     m_weightsDl.clear();
+    m_dlAggregateWeight = 0.0;
     NrMacSchedulerUeInfoQos::ResetDlSchedInfo();
 }
 
 void
 NrMacSchedulerUeInfoAi::ResetUlSchedInfo()
 {
-    m_weightsUl.clear();
+    if (!m_keepUlWeights)
+    {
+        m_weightsUl.clear();
+        m_ulAggregateWeight = 0.0;
+    }
     NrMacSchedulerUeInfoQos::ResetUlSchedInfo();
 }
 
+void
+NrMacSchedulerUeInfoAi::SetKeepUlWeights(bool keep)
+{
+    m_keepUlWeights = keep;
+}
+
 void
 NrMacSchedulerUeInfoAi::UpdateDlWeights(const Weights& weights)
 {
     m_weightsDl = weights;
+    UpdateDlAggregateWeight();
 }
 
 void
 NrMacSchedulerUeInfoAi::UpdateUlWeights(const Weights& weights)
 {
     m_weightsUl = weights;
+    UpdateUlAggregateWeight();
+}
+
+/**
+ * @brief Sum of the weights of the active LCs, LCs without a weight counting as 0
+ * @param lcgs the LCGs of the UE
+ * @param weights the weights of the LCs
+ * @return the aggregate weight
+ */
+static double
+SumActiveLcWeights(const std::unordered_map<uint8_t, LCGPtr>& lcgs,
+                   const NrMacSchedulerUeInfoAi::Weights& weights)
+{
+    double sum = 0.0;
+    if (weights.empty())
+    {
+        return sum;
+    }
+    for (const auto& lcg : lcgs)
+    {
+        for (const auto lcId : lcg.second->GetActiveLCIds())
+        {
+            auto it = weights.find(lcId);
+            if (it != weights.end())
+            {
+                sum += it->second;
+            }
+        }
+    }
+    return sum;
+}
+
+void
+NrMacSchedulerUeInfoAi::UpdateDlAggregateWeight()
+{
+    m_dlAggregateWeight = SumActiveLcWeights(m_dlLCG, m_weightsDl);
+}
+
+void
+NrMacSchedulerUeInfoAi::UpdateUlAggregateWeight()
+{
+    m_ulAggregateWeight = SumActiveLcWeights(m_ulLCG, m_weightsUl);
 }
 
 void
@@ -168,7 +222,7 @@ NrMacSchedulerUeInfoAi::GetDlReward()
 float
 NrMacSchedulerUeInfoAi::GetUlReward()
 {
-    NS_LOG_UNCOND("[ue-info-ai] <GetUlReward>");
+    NS_LOG_FUNCTION(this);
 
     float totalReward = 0.0f;
     int lcCount = 0;
@@ -191,7 +245,7 @@ NrMacSchedulerUeInfoAi::GetUlReward()
             reward += -normAoi;       // AoI 높으면 패널티
             reward += 0.5f * normCqi; // CQI 좋으면 보너스
 
-            NS_LOG_UNCOND("[혹시나 해서 확인해봄] : " << it);
+            NS_LOG_DEBUG("HARQ ACK result: " << it);
             if (!it)
             {
                 reward -= 2.0f; // NACK 받으면 추가 패널티
@@ -219,20 +273,8 @@ bool
 NrMacSchedulerUeInfoAi::CompareUeWeightsDl(const NrMacSchedulerNs3::UePtrAndBufferReq& lue,
                                            const NrMacSchedulerNs3::UePtrAndBufferReq& rue)
 {
-    auto lPtr = dynamic_cast<NrMacSchedulerUeInfoAi*>(lue.first.get());
-    auto rPtr = dynamic_cast<NrMacSchedulerUeInfoAi*>(rue.first.get());
-
-    double lw = 0.0;
-    for (const auto& lc : lue.first->m_dlLCG)
-        for (const auto& id : lc.second->GetActiveLCIds())
-            lw += lPtr->m_weightsDl[id];
-
-    double rw = 0.0;
-    for (const auto& lc : rue.first->m_dlLCG)
-        for (const auto& id : lc.second->GetActiveLCIds())
-            rw += rPtr->m_weightsDl[id];
-
-    return lw > rw;
+    return static_cast<const NrMacSchedulerUeInfoAi*>(lue.first.get())->m_dlAggregateWeight >
+           static_cast<const NrMacSchedulerUeInfoAi*>(rue.first.get())->m_dlAggregateWeight;
 }
 
 // Agent가 할당한 UE의 weight를 비교
@@ -240,21 +282,8 @@ bool
 NrMacSchedulerUeInfoAi::CompareUeWeightsUl(const NrMacSchedulerNs3::UePtrAndBufferReq& lue,
                                            const NrMacSchedulerNs3::UePtrAndBufferReq& rue)
 {
-    auto lPtr = dynamic_cast<NrMacSchedulerUeInfoAi*>(lue.first.get());
-    auto rPtr = dynamic_cast<NrMacSchedulerUeInfoAi*>(rue.first.get());
-
-    double lw = 0.0;
-    for (const auto& lc : lue.first->m_ulLCG)
-        for (const auto& id : lc.second->GetActiveLCIds())
-            lw += lPtr->m_weightsUl[id];
-
-    double rw = 0.0;
-    for (const auto& lc : rue.first->m_ulLCG)
-        for (const auto& id : lc.second->GetActiveLCIds())
-            rw += rPtr->m_weightsUl[id];
-
-    // NS_LOG_UNCOND("lw : " << lw << " rw : " << rw);
-    return lw > rw;
+    return static_cast<const NrMacSchedulerUeInfoAi*>(lue.first.get())->m_ulAggregateWeight >
+           static_cast<const NrMacSchedulerUeInfoAi*>(rue.first.get())->m_ulAggregateWeight;
 }
 
 } // namespace ns3
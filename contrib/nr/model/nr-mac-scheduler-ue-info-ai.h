@@ -120,11 +120,19 @@ class NrMacSchedulerUeInfoAi : public NrMacSchedulerUeInfoQos
     /**
      * @brief Reset UL AI scheduler info
      *
-     * Clear the weights for the uplink.
-     * It also calls NrMacSchedulerUeInfoQos::ResetUlSchedInfo.
+     * Clear the weights for the uplink, unless SetKeepUlWeights(true) was called: in that case
+     * the weights are kept, so that the scheduler can reuse them in the following slots when the
+     * AI model is not queried every slot, until the next call to UpdateUlWeights.
+     * It calls also NrMacSchedulerUeInfoQos::ResetUlSchedInfo.
      */
     void ResetUlSchedInfo() override;
 
+    /**
+     * @brief Set whether ResetUlSchedInfo keeps the uplink weights
+     * @param keep true to keep the weights across slots, false to clear them every slot
+     */
+    void SetKeepUlWeights(bool keep);
+
     /**
      * @brief Get the current observation for downlink
      * @param ue the UE
@@ -169,6 +177,40 @@ class NrMacSchedulerUeInfoAi : public NrMacSchedulerUeInfoQos
      */
     void UpdateUlWeights(const Weights& weights);
 
+    /**
+     * @brief Recompute the sum of the DL weights of the active LCs
+     *
+     * The sum is the sort key of the UE (see CompareUeWeightsDl). It is computed when the
+     * weights change and before each slot, when the set of active LCs may have changed, so that
+     * sorting the UEs does not iterate over the LCs.
+     */
+    void UpdateDlAggregateWeight();
+
+    /**
+     * @brief Recompute the sum of the UL weights of the active LCs
+     *
+     * @see UpdateDlAggregateWeight
+     */
+    void UpdateUlAggregateWeight();
+
+    /**
+     * @brief Get the sum of the DL weights of the active LCs
+     * @return the value computed by the last UpdateDlAggregateWeight
+     */
+    double GetDlAggregateWeight() const
+    {
+        return m_dlAggregateWeight;
+    }
+
+    /**
+     * @brief Get the sum of the UL weights of the active LCs
+     * @return the value computed by the last UpdateUlAggregateWeight
+     */
+    double GetUlAggregateWeight() const
+    {
+        return m_ulAggregateWeight;
+    }
+
     /**
      * @brief Get the reward for downlink
      * @return The reward for the downlink
@@ -209,7 +251,8 @@ class NrMacSchedulerUeInfoAi : public NrMacSchedulerUeInfoQos
      * @param rue Right UE
      * @return true if the AI metric of the left UE is higher than the right UE
      *
-     * The AI metric is calculated in CalculateDlWeight()
+     * The AI metric is the aggregate weight computed by UpdateDlAggregateWeight(). Both UEs
+     * must be NrMacSchedulerUeInfoAi, as created by NrMacSchedulerOfdmaAi.
      */
     static bool CompareUeWeightsDl(const NrMacSchedulerNs3::UePtrAndBufferReq& lue,
                                    const NrMacSchedulerNs3::UePtrAndBufferReq& rue);
@@ -233,7 +276,8 @@ class NrMacSchedulerUeInfoAi : public NrMacSchedulerUeInfoQos
      * @param rue Right UE
      * @return true if the AI metric of the left UE is higher than the right UE
      *
-     * The AI metric is calculated in CalculateUlWeight()
+     * The AI metric is the aggregate weight computed by UpdateUlAggregateWeight(). Both UEs
+     * must be NrMacSchedulerUeInfoAi, as created by NrMacSchedulerOfdmaAi.
      */
     static bool CompareUeWeightsUl(const NrMacSchedulerNs3::UePtrAndBufferReq& lue,
                                    const NrMacSchedulerNs3::UePtrAndBufferReq& rue);
@@ -251,6 +295,9 @@ class NrMacSchedulerUeInfoAi : public NrMacSchedulerUeInfoQos
 
     Weights m_weightsDl; //!< Weights assigned to each flow for a UE in the downlink
     Weights m_weightsUl; //!< Weights assigned to each flow for a UE in the uplink
+    double m_dlAggregateWeight{0.0}; //!< Sum of m_weightsDl over the active DL LCs
+    double m_ulAggregateWeight{0.0}; //!< Sum of m_weightsUl over the active UL LCs
+    bool m_keepUlWeights{false};     //!< Whether ResetUlSchedInfo keeps m_weightsUl
 
     uint64_t m_aoi = 0;
     uint8_t m_cqi = 0;
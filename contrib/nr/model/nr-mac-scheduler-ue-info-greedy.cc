@@ -39,7 +39,9 @@ NrMacSchedulerUeInfoGreedy::UpdateMetric (uint64_t currentAoi, uint32_t newNiceC
   NS_LOG_FUNCTION (this << currentAoi << newNiceCount);
   m_aoi = currentAoi;
   m_niceCount = newNiceCount;
-  m_metric = m_aoiWeight * m_aoi + m_niceWeight * m_niceCount;
+  // in double, as the uncached 0.5 * AoI + 0.5 * Nice Count, so that the order is the same
+  m_metric = m_aoiWeight * static_cast<double> (m_aoi) +
+             m_niceWeight * static_cast<double> (m_niceCount);
 }
 
 double
@@ -52,32 +54,18 @@ bool
 NrMacSchedulerUeInfoGreedy::CompareUeWeightsDl (const NrMacSchedulerNs3::UePtrAndBufferReq &lue,
                                                    const NrMacSchedulerNs3::UePtrAndBufferReq &rue)
 {
-  auto luePtr = std::dynamic_pointer_cast<NrMacSchedulerUeInfoGreedy> (lue.first);
-  auto ruePtr = std::dynamic_pointer_cast<NrMacSchedulerUeInfoGreedy> (rue.first);
-
-  if (!luePtr || !ruePtr)
-    {
-      NS_ABORT_MSG ("Failed to cast UePtr to NrMacSchedulerUeInfoGreedy");
-    }
-
-  double lMetric = luePtr->CalculateMetric ();
-  double rMetric = ruePtr->CalculateMetric ();
-
   // Higher metric gets priority
-  return (lMetric > rMetric);
+  return static_cast<const NrMacSchedulerUeInfoGreedy *> (lue.first.get ())->CalculateMetric () >
+         static_cast<const NrMacSchedulerUeInfoGreedy *> (rue.first.get ())->CalculateMetric ();
 }
 
 bool
 NrMacSchedulerUeInfoGreedy::CompareUeWeightsUl (const NrMacSchedulerNs3::UePtrAndBufferReq &lue,
                                                    const NrMacSchedulerNs3::UePtrAndBufferReq &rue)
 {
-  auto luePtr = dynamic_cast<NrMacSchedulerUeInfoGreedy *> (lue.first.get ());
-  auto ruePtr = dynamic_cast<NrMacSchedulerUeInfoGreedy *> (rue.first.get ());
-  
-  double lMetric = 0.5 * luePtr->GetAoi () + 0.5 * luePtr->GetNiceCount ();
-  double rMetric = 0.5 * ruePtr->GetAoi () + 0.5 * ruePtr->GetNiceCount ();
-
+  // The metric 0.5 * AoI + 0.5 * Nice Count is cached by UpdateMetric
   // Higher metric gets priority
-  return (lMetric > rMetric);
+  return static_cast<const NrMacSchedulerUeInfoGreedy *> (lue.first.get ())->CalculateMetric () >
+         static_cast<const NrMacSchedulerUeInfoGreedy *> (rue.first.get ())->CalculateMetric ();
 }
 } // namespace ns3
@@ -71,9 +71,9 @@ public:
 
   uint64_t m_aoi; //!< Age of Information value
   uint32_t m_niceCount; //!< Nice Count value
-  float m_aoiWeight = 0.5; //!< Weight for AoI in the metric calculation
-  float m_niceWeight = 0.5; //!< Weight for Nice Count in the metric calculation
-  double m_metric; //!< Cached metric value for scheduling
+  double m_aoiWeight = 0.5; //!< Weight for AoI in the metric calculation
+  double m_niceWeight = 0.5; //!< Weight for Nice Count in the metric calculation
+  double m_metric; //!< Cached metric value for scheduling, computed in double
 };
 
 } // namespace ns3
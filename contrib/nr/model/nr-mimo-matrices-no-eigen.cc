@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include "nr-mimo-matrices.h"
+#include "nr-mimo-small-matrices.h"
 
 #include <ns3/fatal-error.h>
 
@@ -12,13 +13,15 @@ namespace ns3
 NrIntfNormChanMat
 NrCovMat::CalcIntfNormChannelMimo([[maybe_unused]] const ComplexMatrixArray& chanMat) const
 {
-    NS_FATAL_ERROR("MIMO channel normalization requires Eigen matrix library.");
+    NS_FATAL_ERROR("MIMO channel normalization with more than "
+                   << NrMimoKernels::MAX_DIM << " ports requires Eigen matrix library.");
 }
 
 ComplexMatrixArray
 NrIntfNormChanMat::ComputeMseMimo([[maybe_unused]] const ComplexMatrixArray& precMats) const
 {
-    NS_FATAL_ERROR("MIMO MSE computation requires Eigen matrix library.");
+    NS_FATAL_ERROR("MIMO MSE computation with more than "
+                   << NrMimoKernels::MAX_DIM << " ports or layers requires Eigen matrix library.");
 }
 
 } // namespace ns3
@@ -4,19 +4,51 @@
 
 #include "nr-mimo-matrices.h"
 
+#include "nr-mimo-small-matrices.h"
+
 namespace ns3
 {
 
 void
 NrCovMat::AddInterferenceSignal(const ComplexMatrixArray& rhs)
 {
-    *this += rhs * rhs.HermitianTranspose();
+    if (!AddHermitianProductFixed(rhs, 1.0))
+    {
+        *this += rhs * rhs.HermitianTranspose();
+    }
 }
 
 void
 NrCovMat::SubtractInterferenceSignal(const ComplexMatrixArray& rhs)
 {
-    *this -= rhs * rhs.HermitianTranspose();
+    if (!AddHermitianProductFixed(rhs, -1.0))
+    {
+        *this -= rhs * rhs.HermitianTranspose();
+    }
+}
+
+bool
+NrCovMat::AddHermitianProductFixed(const ComplexMatrixArray& rhs, double sign)
+{
+    if (rhs.GetNumRows() > NrMimoKernels::MAX_DIM || rhs.GetNumCols() > NrMimoKernels::MAX_DIM)
+    {
+        return false;
+    }
+    NS_ASSERT_MSG((GetNumRows() == rhs.GetNumRows()) && (GetNumPages() == rhs.GetNumPages()),
+                  "Dimensions mismatch");
+    NrMimoKernels::Dispatch(rhs.GetNumRows(), [&](auto n) {
+        NrMimoKernels::Dispatch(rhs.GetNumCols(), [&](auto k) {
+            constexpr size_t N = decltype(n)::value;
+            constexpr size_t K = decltype(k)::value;
+            for (size_t iRb = 0; iRb < rhs.GetNumPages(); iRb++)
+            {
+                NrMimoKernels::AddHermitianProduct<N, K>(GetPagePtr(iRb),
+                                                         rhs.GetPagePtr(iRb),
+                                                         sign);
+            }
+        });
+    });
+    return true;
 }
 
 NrIntfNormChanMat
@@ -37,13 +69,39 @@ NrCovMat::CalcIntfNormChannel(const ComplexMatrixArray& chanMat) const
     }
     else // MIMO
     {
-        return CalcIntfNormChannelMimo(chanMat);
+        // Fixed-size kernels for up to NrMimoKernels::MAX_DIM ports, generic ones otherwise
+        if (chanMat.GetNumRows() > NrMimoKernels::MAX_DIM ||
+            chanMat.GetNumCols() > NrMimoKernels::MAX_DIM)
+        {
+            return CalcIntfNormChannelMimo(chanMat);
+        }
+        auto res = NrIntfNormChanMat{
+            ComplexMatrixArray{chanMat.GetNumRows(), chanMat.GetNumCols(), chanMat.GetNumPages()}};
+        NrMimoKernels::Dispatch(chanMat.GetNumRows(), [&](auto n) {
+            NrMimoKernels::Dispatch(chanMat.GetNumCols(), [&](auto k) {
+                constexpr size_t N = decltype(n)::value;
+                constexpr size_t K = decltype(k)::value;
+                for (size_t iRb = 0; iRb < chanMat.GetNumPages(); iRb++)
+                {
+                    NrMimoKernels::WhitenChannel<N, K>(GetPagePtr(iRb),
+                                                       chanMat.GetPagePtr(iRb),
+                                                       res.GetPagePtr(iRb));
+                }
+            });
+        });
+        return res;
     }
 }
 
 NrSinrMatrix
 NrIntfNormChanMat::ComputeSinrForPrecoding(const ComplexMatrixArray& precMats) const
 {
+    auto sinrMat = ComputeSinrForPrecodingFixed(precMats);
+    if (sinrMat.GetSize() > 0)
+    {
+        return sinrMat;
+    }
+
     auto mseMat = ComputeMse(precMats);
 
     // Compute the SINR values from the diagonal elements of the mseMat.
@@ -60,6 +118,40 @@ NrIntfNormChanMat::ComputeSinrForPrecoding(const ComplexMatrixArray& precMats) c
     return NrSinrMatrix{res};
 }
 
+NrSinrMatrix
+NrIntfNormChanMat::ComputeSinrForPrecodingFixed(const ComplexMatrixArray& precMats) const
+{
+    auto nRows = GetNumRows();
+    auto nCols = GetNumCols();
+    auto rank = precMats.GetNumCols();
+    if ((nRows == 1 && nCols == 1) || nRows > NrMimoKernels::MAX_DIM ||
+        nCols > NrMimoKernels::MAX_DIM || rank > NrMimoKernels::MAX_DIM)
+    {
+        return NrSinrMatrix{};
+    }
+    NS_ASSERT_MSG((precMats.GetNumRows() == nCols) && (precMats.GetNumPages() == GetNumPages()),
+                  "Dimensions mismatch");
+
+    auto res = NrSinrMatrix{static_cast<uint8_t>(rank), GetNumPages()};
+    NrMimoKernels::Dispatch(nRows, [&](auto n) {
+        NrMimoKernels::Dispatch(nCols, [&](auto k) {
+            NrMimoKernels::Dispatch(rank, [&](auto r) {
+                constexpr size_t N = decltype(n)::value;
+                constexpr size_t K = decltype(k)::value;
+                constexpr size_t R = decltype(r)::value;
+                // The SINR values of an RB are contiguous in the rank x nRbs matrix
+                for (size_t iRb = 0; iRb < GetNumPages(); iRb++)
+                {
+                    NrMimoKernels::ComputeSinr<N, K, R>(GetPagePtr(iRb),
+                                                        precMats.GetPagePtr(iRb),
+                                                        &res(0, iRb));
+                }
+            });
+        });
+    });
+    return res;
+}
+
 ComplexMatrixArray
 NrIntfNormChanMat::ComputeMse(const ComplexMatrixArray& precMats) const
 {
@@ -17,6 +17,9 @@ class NrSinrMatrix;
 /// NrCovMat stores the interference-plus-noise covariance matrices of a MIMO signal, with one
 /// matrix page for each frequency bin. Operations for efficient computation, addition, and
 /// subtraction of covariance matrices of interfering MIMO signals are implemented.
+/// With up to NrMimoKernels::MAX_DIM ports, the operations use the fixed-size kernels of
+/// nr-mimo-small-matrices.h for each frequency bin, which do not require Eigen. More ports
+/// use the generic matrix operations, which are only available when Eigen is enabled.
 class NrCovMat : public ComplexMatrixArray
 {
   public:
@@ -39,11 +42,18 @@ class NrCovMat : public ComplexMatrixArray
     virtual NrIntfNormChanMat CalcIntfNormChannel(const ComplexMatrixArray& chanMat) const;
 
   private:
-    /// \brief Calculate the interference-normalized channel matrix for MIMO.
-    /// When the simulation is SISO only, this method will not be called.
+    /// \brief Calculate the interference-normalized channel matrix for MIMO with the generic
+    /// matrix operations. When the simulation is SISO only, or when there are at most
+    /// NrMimoKernels::MAX_DIM ports, this method will not be called.
     /// \param chanMat the frequency-domain channel matrix without precoding
     /// \return the channel matrix after applying interference-normalization/whitening
     virtual NrIntfNormChanMat CalcIntfNormChannelMimo(const ComplexMatrixArray& chanMat) const;
+
+    /// \brief Add or subtract an interference signal with the fixed-size kernels
+    /// \param rhs the full channel matrix (including precoding)
+    /// \param sign 1 to add the signal, -1 to subtract it
+    /// \return false if the dimensions are too large for the fixed-size kernels
+    bool AddHermitianProductFixed(const ComplexMatrixArray& rhs, double sign);
 };
 
 /// \ingroup Matrices
@@ -77,11 +87,19 @@ class NrIntfNormChanMat : public ComplexMatrixArray
     /// \returns the MSE value or matrix
     virtual ComplexMatrixArray ComputeMse(const ComplexMatrixArray& precMats) const;
 
-    /// \brief Compute the MSE (mean square error) matrix for a MIMO MMSE receiver
-    /// When the simulation is SISO only, this method will not be called.
+    /// \brief Compute the MSE (mean square error) matrix for a MIMO MMSE receiver with the
+    /// generic matrix operations. When the simulation is SISO only, or when the ports and the
+    /// rank are at most NrMimoKernels::MAX_DIM, this method will not be called.
     /// \param precMats the precoding matrices (dim: nTxPorts * rank * nRbs)
     /// \returns the MSE matrix as inv(I + precMats' * this' * this * precMats).
     virtual ComplexMatrixArray ComputeMseMimo(const ComplexMatrixArray& precMats) const;
+
+    /// \brief Compute the MIMO SINR with the fixed-size kernels, from the diagonal of the MSE
+    /// matrix of each RB only
+    /// \param precMats the precoding matrices (dim: nTxPorts * rank * nRbs)
+    /// \returns the SINR values for each layer and RB (dim: rank x nRbs), or an empty matrix
+    /// for SISO and for the dimensions too large for the fixed-size kernels
+    NrSinrMatrix ComputeSinrForPrecodingFixed(const ComplexMatrixArray& precMats) const;
 };
 
 /// \brief NrSinrMatrix stores the MIMO SINR matrix, with dimension rank x nRbs
@@ -0,0 +1,222 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_MIMO_SMALL_MATRICES_H
+#define NR_MIMO_SMALL_MATRICES_H
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+
+namespace ns3
+{
+
+/// \ingroup Matrices
+/// Kernels of the MIMO matrices of a single RB, with dimensions known at compile time.
+///
+/// With at most MAX_DIM receive ports, transmit ports and layers, the matrices of an RB are
+/// small enough to be kept on the stack, and the loops with compile-time bounds are fully
+/// unrolled by the compiler. The kernels operate on the column-major pages of a
+/// ComplexMatrixArray. NrCovMat and NrIntfNormChanMat dispatch to them per RB through
+/// Dispatch, and fall back to the generic ComplexMatrixArray / Eigen implementation for
+/// larger dimensions.
+namespace NrMimoKernels
+{
+
+/// Maximum dimension of the fixed-size kernels
+constexpr size_t MAX_DIM = 4;
+
+/// \brief Call a functor with a compile-time dimension
+/// \param dim the dimension, from 1 to MAX_DIM
+/// \param f the functor, called with std::integral_constant<size_t, dim>
+/// \return false if the dimension is not supported, in which case f is not called
+template <class F>
+inline bool
+Dispatch(size_t dim, F&& f)
+{
+    switch (dim)
+    {
+    case 1:
+        f(std::integral_constant<size_t, 1>{});
+        return true;
+    case 2:
+        f(std::integral_constant<size_t, 2>{});
+        return true;
+    case 3:
+        f(std::integral_constant<size_t, 3>{});
+        return true;
+    case 4:
+        f(std::integral_constant<size_t, 4>{});
+        return true;
+    default:
+        return false;
+    }
+}
+
+/// \brief Add or subtract a Hermitian product: cov += sign * h * h'
+/// \tparam N the number of rows of h
+/// \tparam K the number of columns of h
+/// \param cov the N x N covariance matrix
+/// \param h the N x K matrix
+/// \param sign 1 to add the product, -1 to subtract it
+template <size_t N, size_t K>
+inline void
+AddHermitianProduct(std::complex<double>* cov, const std::complex<double>* h, double sign)
+{
+    for (size_t j = 0; j < N; j++)
+    {
+        for (size_t i = j; i < N; i++)
+        {
+            std::complex<double> sum = 0;
+            for (size_t k = 0; k < K; k++)
+            {
+                sum += h[i + N * k] * std::conj(h[j + N * k]);
+            }
+            cov[i + N * j] += sign * sum;
+            if (i != j)
+            {
+                cov[j + N * i] += sign * std::conj(sum);
+            }
+        }
+    }
+}
+
+/// \brief Compute in place the lower Cholesky factor L of a Hermitian matrix A = L * L'
+/// \tparam N the dimension of the matrix
+/// \param a the N x N matrix, of which only the lower triangle is read and written
+template <size_t N>
+inline void
+CholeskyInPlace(std::array<std::complex<double>, N * N>& a)
+{
+    for (size_t j = 0; j < N; j++)
+    {
+        double diag = std::real(a[j + N * j]);
+        for (size_t k = 0; k < j; k++)
+        {
+            diag -= std::norm(a[j + N * k]);
+        }
+        diag = std::sqrt(diag);
+        a[j + N * j] = diag;
+        for (size_t i = j + 1; i < N; i++)
+        {
+            auto sum = a[i + N * j];
+            for (size_t k = 0; k < j; k++)
+            {
+                sum -= a[i + N * k] * std::conj(a[j + N * k]);
+            }
+            a[i + N * j] = sum / diag;
+        }
+    }
+}
+
+/// \brief Whiten a channel matrix: res = inv(L) * h, where L is the lower Cholesky factor of
+/// the interference-and-noise covariance matrix
+/// \tparam N the number of receive ports
+/// \tparam K the number of transmit ports
+/// \param cov the N x N covariance matrix, of which only the upper triangle is read
+/// \param h the N x K channel matrix
+/// \param res the N x K interference-normalized channel matrix
+template <size_t N, size_t K>
+inline void
+WhitenChannel(const std::complex<double>* cov,
+              const std::complex<double>* h,
+              std::complex<double>* res)
+{
+    std::array<std::complex<double>, N * N> l{};
+    for (size_t j = 0; j < N; j++)
+    {
+        for (size_t i = j; i < N; i++)
+        {
+            l[i + N * j] = std::conj(cov[j + N * i]);
+        }
+    }
+    CholeskyInPlace<N>(l);
+
+    // Forward substitution, column by column
+    for (size_t k = 0; k < K; k++)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            auto sum = h[i + N * k];
+            for (size_t m = 0; m < i; m++)
+            {
+                sum -= l[i + N * m] * res[m + N * k];
+            }
+            res[i + N * k] = sum / std::real(l[i + N * i]);
+        }
+    }
+}
+
+/// \brief Compute the SINR of each layer of an MMSE receiver, from the diagonal of the MSE
+/// matrix inv(I + (h * p)' * (h * p))
+/// \tparam N the number of receive ports
+/// \tparam K the number of transmit ports
+/// \tparam R the rank
+/// \param h the N x K interference-normalized channel matrix
+/// \param p the K x R precoding matrix
+/// \param sinr the R SINR values
+template <size_t N, size_t K, size_t R>
+inline void
+ComputeSinr(const std::complex<double>* h, const std::complex<double>* p, double* sinr)
+{
+    std::array<std::complex<double>, N * R> hp{};
+    for (size_t r = 0; r < R; r++)
+    {
+        for (size_t k = 0; k < K; k++)
+        {
+            for (size_t i = 0; i < N; i++)
+            {
+                hp[i + N * r] += h[i + N * k] * p[k + K * r];
+            }
+        }
+    }
+
+    // Lower triangle of G = I + hp' * hp, then its Cholesky factor L
+    std::array<std::complex<double>, R * R> g{};
+    for (size_t j = 0; j < R; j++)
+    {
+        for (size_t i = j; i < R; i++)
+        {
+            std::complex<double> sum = (i == j) ? 1.0 : 0.0;
+            for (size_t n = 0; n < N; n++)
+            {
+                sum += std::conj(hp[n + N * i]) * hp[n + N * j];
+            }
+            g[i + R * j] = sum;
+        }
+    }
+    CholeskyInPlace<R>(g);
+
+    // inv(G) = inv(L)' * inv(L), so that inv(G)(l, l) is the squared norm of column l of inv(L)
+    std::array<std::complex<double>, R * R> lInv{};
+    for (size_t j = 0; j < R; j++)
+    {
+        lInv[j + R * j] = 1.0 / std::real(g[j + R * j]);
+        for (size_t i = j + 1; i < R; i++)
+        {
+            std::complex<double> sum = 0;
+            for (size_t m = j; m < i; m++)
+            {
+                sum -= g[i + R * m] * lInv[m + R * j];
+            }
+            lInv[i + R * j] = sum / std::real(g[i + R * i]);
+        }
+    }
+    for (size_t l = 0; l < R; l++)
+    {
+        double mse = 0;
+        for (size_t i = l; i < R; i++)
+        {
+            mse += std::norm(lInv[i + R * l]);
+        }
+        sinr[l] = 1.0 / mse - 1.0;
+    }
+}
+
+} // namespace NrMimoKernels
+
+} // namespace ns3
+
+#endif // NR_MIMO_SMALL_MATRICES_H
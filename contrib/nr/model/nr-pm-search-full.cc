@@ -8,7 +8,9 @@
 #include <ns3/simulator.h>
 #include <ns3/uinteger.h>
 
+#include <map>
 #include <numeric>
+#include <sstream>
 
 namespace ns3
 {
@@ -26,10 +28,51 @@ NrPmSearchFull::GetTypeId()
                                           "Codebook class to be used",
                                           TypeIdValue(NrCbTwoPort::GetTypeId()),
                                           MakeTypeIdAccessor(&NrPmSearchFull::SetCodebookTypeId),
-                                          MakeTypeIdChecker());
+                                          MakeTypeIdChecker())
+                            .AddAttribute("NumThreads",
+                                          "Number of threads evaluating the wideband precoding "
+                                          "matrices of a rank. 0 or 1 means that they are "
+                                          "evaluated in the simulator thread. The threads are "
+                                          "shared by the instances with the same value.",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(&NrPmSearchFull::SetNumThreads,
+                                                               &NrPmSearchFull::GetNumThreads),
+                                          MakeUintegerChecker<uint32_t>())
+                            .AddAttribute("RankPruning",
+                                          "Skip the ranks whose upper bound of the capacity is "
+                                          "not larger than the capacity of a lower rank",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&NrPmSearchFull::m_rankPruning),
+                                          MakeBooleanChecker());
     return tid;
 }
 
+void
+NrPmSearchFull::SetNumThreads(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    // the threads sleep between the searches, which are not concurrent: share them between the
+    // UEs rather than creating threads for each of them
+    static std::map<uint32_t, Ptr<ThreadPool>> threadPools;
+    m_numThreads = numThreads;
+    m_threadPool = nullptr;
+    if (numThreads > 1)
+    {
+        auto& threadPool = threadPools[numThreads];
+        if (!threadPool)
+        {
+            threadPool = Create<ThreadPool>(numThreads);
+        }
+        m_threadPool = threadPool;
+    }
+}
+
+uint32_t
+NrPmSearchFull::GetNumThreads() const
+{
+    return m_numThreads;
+}
+
 void
 NrPmSearchFull::SetCodebookTypeId(const TypeId& typeId)
 {
@@ -59,7 +102,50 @@ NrPmSearchFull::InitCodebooks()
         m_cbFactory.Set("Rank", UintegerValue(rank));
         m_rankParams[rank].cb = m_cbFactory.Create<NrCbTypeOne>();
         m_rankParams[rank].cb->Init();
+        m_rankParams[rank].precoders = GetCodebookPrecoders(m_cbFactory, m_rankParams[rank].cb);
+    }
+}
+
+Ptr<const NrPmSearchFull::CodebookPrecoders>
+NrPmSearchFull::GetCodebookPrecoders(const ObjectFactory& cbFactory, Ptr<const NrCbTypeOne> cb)
+{
+    // The codebooks with the same type and attributes have the same precoding matrices
+    static std::map<std::string, Ptr<const CodebookPrecoders>> sharedPrecoders;
+    std::ostringstream key;
+    key << cbFactory;
+    auto it = sharedPrecoders.find(key.str());
+    if (it != sharedPrecoders.end())
+    {
+        return it->second;
     }
+
+    auto precoders = Create<CodebookPrecoders>();
+    precoders->numI2 = cb->GetNumI2();
+    for (auto i1 = size_t{0}; i1 < cb->GetNumI1(); i1++)
+    {
+        for (auto i2 = size_t{0}; i2 < precoders->numI2; i2++)
+        {
+            auto precMat = cb->GetBasePrecMat(i1, i2);
+            // Bound the largest eigenvalue of precMat' * precMat by its largest absolute row sum
+            for (size_t j = 0; j < precMat.GetNumCols(); j++)
+            {
+                double rowSum = 0;
+                for (size_t k = 0; k < precMat.GetNumCols(); k++)
+                {
+                    std::complex<double> gram = 0;
+                    for (size_t i = 0; i < precMat.GetNumRows(); i++)
+                    {
+                        gram += std::conj(precMat(i, j)) * precMat(i, k);
+                    }
+                    rowSum += std::abs(gram);
+                }
+                precoders->maxGain = std::max(precoders->maxGain, rowSum);
+            }
+            precoders->precMats.emplace_back(std::move(precMat));
+        }
+    }
+    sharedPrecoders.emplace(key.str(), precoders);
+    return precoders;
 }
 
 PmCqiInfo
@@ -83,6 +169,10 @@ NrPmSearchFull::CreateCqiFeedbackMimo(const NrMimoSignal& rxSignalRb, PmiUpdate
     auto optPrecForRanks = std::vector<PmCqiInfo>{};
     for (auto rank : m_ranks)
     {
+        if (rank != m_ranks.front() && !m_rankParams[rank].precParams)
+        {
+            continue; // The rank was pruned at the last wideband PMI update
+        }
         auto cqiMsg = CreateCqiForRank(rank, rbNormChanMat);
         optPrecForRanks.emplace_back(std::move(cqiMsg));
         // Skip higher ranks when the current is incapable of maintaining the connection
@@ -124,18 +214,36 @@ NrPmSearchFull::UpdateAllPrecoding(const NrIntfNormChanMat& rbNormChanMat)
     // Compute downsampled channel per subband
     auto sbNormChanMat = SubbandDownsampling(rbNormChanMat);
 
+    double maxCapacity = 0; // The capacity of the best lower rank
     for (auto rank : m_ranks)
     {
-        // Loop over wideband precoding matrices W1 (index i1).
-        std::vector<Ptr<PrecMatParams>> optSubbandPrecoders{};
-        auto numI1 = m_rankParams[rank].cb->GetNumI1();
-        for (auto i1 = size_t{0}; i1 < numI1; i1++)
+        if (m_rankPruning && rank != m_ranks.front() &&
+            ComputeCapacityUpperBound(sbNormChanMat, rank) <= maxCapacity)
         {
-            // Find the optimal subband PMI values (i2) for this particular i1
-            auto subbandParams = FindOptSubbandPrecoding(sbNormChanMat, i1, rank);
+            NS_LOG_LOGIC("Rank " << +rank << " cannot exceed the capacity " << maxCapacity);
+            m_rankParams[rank].precParams = nullptr;
+            continue;
+        }
 
-            // Store the parameters for this wideband index i1
-            optSubbandPrecoders.emplace_back(subbandParams);
+        // Loop over wideband precoding matrices W1 (index i1), and find the optimal subband
+        // PMI values (i2) for each i1. The results are stored per i1 and reduced in the order
+        // of i1, so that they do not depend on the threads.
+        auto numI1 = m_rankParams[rank].cb->GetNumI1();
+        std::vector<Ptr<PrecMatParams>> optSubbandPrecoders(numI1);
+        auto findOptSubbandPrecoding = [this, &sbNormChanMat, &optSubbandPrecoders, rank](
+                                           size_t i1) {
+            optSubbandPrecoders[i1] = FindOptSubbandPrecoding(sbNormChanMat, i1, rank);
+        };
+        if (m_threadPool)
+        {
+            m_threadPool->ParallelFor(numI1, findOptSubbandPrecoding);
+        }
+        else
+        {
+            for (auto i1 = size_t{0}; i1 < numI1; i1++)
+            {
+                findOptSubbandPrecoding(i1);
+            }
         }
 
         // Find the optimal wideband PMI i1
@@ -145,7 +253,62 @@ NrPmSearchFull::UpdateAllPrecoding(const NrIntfNormChanMat& rbNormChanMat)
                               [](const Ptr<PrecMatParams>& a, const Ptr<PrecMatParams>& b) {
                                   return a->perfMetric < b->perfMetric;
                               });
+        maxCapacity = std::max(maxCapacity, m_rankParams[rank].precParams->perfMetric);
+    }
+}
+
+double
+NrPmSearchFull::ComputeCapacityUpperBound(const NrIntfNormChanMat& sbNormChanMat,
+                                          uint8_t rank) const
+{
+    auto gain = m_rankParams[rank].precoders->maxGain;
+    auto nRows = sbNormChanMat.GetNumRows();
+    auto nCols = sbNormChanMat.GetNumCols();
+    double bound = 0;
+    for (size_t iSb = 0; iSb < sbNormChanMat.GetNumPages(); iSb++)
+    {
+        // A = I + gain * H * H', which has the same determinant as I + gain * H' * H
+        std::vector<std::complex<double>> a(nRows * nRows);
+        for (size_t i = 0; i < nRows; i++)
+        {
+            for (size_t j = 0; j <= i; j++)
+            {
+                std::complex<double> sum = 0;
+                for (size_t k = 0; k < nCols; k++)
+                {
+                    sum += sbNormChanMat.Elem(i, k, iSb) * std::conj(sbNormChanMat.Elem(j, k, iSb));
+                }
+                a[i * nRows + j] = gain * sum + (i == j ? 1.0 : 0.0);
+            }
+        }
+
+        // log2 det(A) from the Cholesky decomposition A = L * L', computed in place
+        double logDet = 0;
+        double trace = 0;
+        for (size_t j = 0; j < nRows; j++)
+        {
+            trace += std::real(a[j * nRows + j]) - 1.0;
+            auto diag = std::real(a[j * nRows + j]);
+            for (size_t k = 0; k < j; k++)
+            {
+                diag -= std::norm(a[j * nRows + k]);
+            }
+            diag = std::sqrt(std::max(diag, 1.0));
+            a[j * nRows + j] = diag;
+            logDet += 2 * std::log2(diag);
+            for (size_t i = j + 1; i < nRows; i++)
+            {
+                auto sum = a[i * nRows + j];
+                for (size_t k = 0; k < j; k++)
+                {
+                    sum -= a[i * nRows + k] * std::conj(a[j * nRows + k]);
+                }
+                a[i * nRows + j] = sum / diag;
+            }
+        }
+        bound += std::min(logDet, rank * std::log2(1.0 + trace / rank));
     }
+    return bound;
 }
 
 void
@@ -157,6 +320,10 @@ NrPmSearchFull::UpdateSubbandPrecoding(const NrIntfNormChanMat& rbNormChanMat)
     {
         // Recompute the best subband precoding (W2) for previously found W1 and store results
         auto& optPrec = m_rankParams[rank].precParams;
+        if (rank != m_ranks.front() && !optPrec)
+        {
+            continue; // The rank was pruned at the last wideband PMI update
+        }
         NS_ASSERT(optPrec);
         auto wbPmi = optPrec->wbPmi;
         optPrec = FindOptSubbandPrecoding(sbNormChanMat, wbPmi, rank);
@@ -242,14 +409,14 @@ NrPmSearchFull::FindOptSubbandPrecoding(const NrIntfNormChanMat& sbNormChanMat,
 std::vector<ComplexMatrixArray>
 NrPmSearchFull::CreateSubbandPrecoders(size_t i1, uint8_t rank, size_t nSubbands) const
 {
-    const auto& cb = m_rankParams[rank].cb;
-    auto numI2 = cb->GetNumI2();
+    const auto& precoders = *m_rankParams[rank].precoders;
+    auto numI2 = precoders.numI2;
 
     std::vector<ComplexMatrixArray> allPrecMats;
 
     for (auto i2 = size_t{0}; i2 < numI2; i2++)
     {
-        auto basePrecMat = cb->GetBasePrecMat(i1, i2);
+        const auto& basePrecMat = precoders.precMats[i1 * numI2 + i2];
         auto sbPrecMat = ExpandPrecodingMatrix(basePrecMat, nSubbands);
         allPrecMats.emplace_back(sbPrecMat);
     }
@@ -10,6 +10,7 @@
 #include "nr-pm-search.h"
 
 #include <ns3/object-factory.h>
+#include <ns3/thread-pool.h>
 
 namespace ns3
 {
@@ -20,6 +21,14 @@ namespace ns3
 /// When a PMI update is requested, the optimal precoding matrices (PMI) are updated using
 /// exhaustive search over all possible precoding matrices specified in a codebook that is
 /// compatible to 3GPP TS 38.214 Type-I.
+///
+/// The search can be sped up in three ways. The base precoding matrices of the codebooks are
+/// created once, and shared between the instances with the same codebook configuration. The
+/// wideband precoding matrices (index i1) of a rank can be evaluated by NumThreads threads;
+/// the results do not depend on the number of threads. With RankPruning, the ranks whose upper
+/// bound of the capacity is not larger than the capacity of a lower rank are skipped: since the
+/// rank is finally selected on the TB size rather than on the capacity, this may change the
+/// selected rank in corner cases, and it is disabled by default.
 class NrPmSearchFull : public NrPmSearch
 {
   public:
@@ -49,13 +58,48 @@ class NrPmSearchFull : public NrPmSearch
     /// \param attrVal the value of the attribute
     void SetCodebookAttribute(const std::string& attrName, const AttributeValue& attrVal);
 
+    /// \brief Set the number of threads evaluating the wideband precoding matrices.
+    /// \param numThreads the number of threads, 0 or 1 to evaluate them in the simulator thread
+    void SetNumThreads(uint32_t numThreads);
+
+    /// \return the number of threads evaluating the wideband precoding matrices
+    uint32_t GetNumThreads() const;
+
   protected:
+    /// \brief The base precoding matrices of a codebook, for all the values of i1 and i2
+    struct CodebookPrecoders : public SimpleRefCount<CodebookPrecoders>
+    {
+        size_t numI2{};                           ///< The number of subband indices i2
+        std::vector<ComplexMatrixArray> precMats; ///< The matrix of (i1, i2) at i1 * numI2 + i2
+        double maxGain{};                         ///< Upper bound of the largest eigenvalue of
+                                                  ///< precMat' * precMat for all the matrices
+    };
+
     struct RankParams
     {
-        Ptr<PrecMatParams> precParams; ///< The precoding parameters (WB/SB PMIs)
-        Ptr<NrCbTypeOne> cb;           ///< The codebook
+        Ptr<PrecMatParams> precParams;          ///< The precoding parameters (WB/SB PMIs), or
+                                                ///< nullptr if the rank was pruned
+        Ptr<NrCbTypeOne> cb;                    ///< The codebook
+        Ptr<const CodebookPrecoders> precoders; ///< The base precoding matrices of the codebook
     };
 
+    /// \brief Get the base precoding matrices of a codebook, from the matrices shared between the
+    /// instances if the codebook has the same configuration as a previous one.
+    /// \param cbFactory the factory with the type and the attributes of the codebook
+    /// \param cb the codebook
+    /// \return the base precoding matrices of the codebook
+    static Ptr<const CodebookPrecoders> GetCodebookPrecoders(const ObjectFactory& cbFactory,
+                                                             Ptr<const NrCbTypeOne> cb);
+
+    /// \brief Compute an upper bound of the capacity of any precoding matrix of a rank.
+    /// With G the channel matrix H' * H of a subband and g the maxGain of the codebook, the
+    /// capacity of the MMSE receiver is bounded by log2 det(I + g * G), and by
+    /// rank * log2(1 + g * trace(G) / rank).
+    /// \param sbNormChanMat the interference-normed channel matrix per subband
+    /// \param rank the rank (number of MIMO layers)
+    /// \return the upper bound of the sum of the capacities of the subbands
+    double ComputeCapacityUpperBound(const NrIntfNormChanMat& sbNormChanMat, uint8_t rank) const;
+
     /// \brief Update the WB and/or SB PMI, or neither.
     /// \param rbNormChanMat the interference-normed channel matrix per RB
     /// \param pmiUpdate the struct defining if updates to SB or WB PMI are necessary
@@ -84,7 +128,8 @@ class NrPmSearchFull : public NrPmSearch
                                                size_t i1,
                                                uint8_t rank) const;
 
-    /// \brief Create the subband precoding matrices for the given wideband precoding.
+    /// \brief Create the subband precoding matrices for the given wideband precoding, from the
+    /// cached base precoding matrices.
     /// \param i1 the index of the wideband precoding matrix W1
     /// \param rank the rank (number of MIMO layers)
     /// \param nSubbands the number of subbands (desired number of pages in each precoding matrix)
@@ -106,6 +151,9 @@ class NrPmSearchFull : public NrPmSearch
 
     std::vector<RankParams> m_rankParams; ///< The parameters (PMI values, codebook) for each rank
     ObjectFactory m_cbFactory;            ///< The factory used to create the codebooks
+    uint32_t m_numThreads{0};             ///< The number of threads evaluating the i1 values
+    Ptr<ThreadPool> m_threadPool;         ///< The threads evaluating the i1 values, if several
+    bool m_rankPruning{false};            ///< Whether the ranks that cannot win are skipped
 };
 
 } // namespace ns3
@@ -144,6 +144,16 @@ NrSpectrumPhy::GetTypeId()
                           MakeDoubleAccessor(&NrSpectrumPhy::SetCcaMode1Threshold,
                                              &NrSpectrumPhy::GetCcaMode1Threshold),
                           MakeDoubleChecker<double>())
+            .AddAttribute("NegligibleInterferenceThreshold",
+                          "The received power (dBm) below which the signals of other cells are "
+                          "negligible: they are only accounted as a noise rise of the "
+                          "interference, without tracking their MIMO channels nor dispatching "
+                          "them on their type. The PSS received by the UEs are never negligible. "
+                          "By default, -inf, no signal is negligible.",
+                          DoubleValue(-std::numeric_limits<double>::infinity()),
+                          MakeDoubleAccessor(&NrSpectrumPhy::SetNegligibleInterferenceThreshold,
+                                             &NrSpectrumPhy::GetNegligibleInterferenceThreshold),
+                          MakeDoubleChecker<double>())
             .AddTraceSource("RxPacketTraceGnb",
                             "The no. of packets received and transmitted by the Base Station",
                             MakeTraceSourceAccessor(&NrSpectrumPhy::m_rxPacketTraceGnb),
@@ -354,6 +364,21 @@ NrSpectrumPhy::GetCcaMode1Threshold() const
     return 10.0 * std::log10(m_ccaMode1ThresholdW * 1000.0);
 }
 
+void
+NrSpectrumPhy::SetNegligibleInterferenceThreshold(double thresholdDBm)
+{
+    NS_LOG_FUNCTION(this << thresholdDBm);
+    // convert dBm to Watt, -inf dBm is 0 W
+    m_negligibleInterferenceW = (std::pow(10.0, thresholdDBm / 10.0)) / 1000.0;
+}
+
+double
+NrSpectrumPhy::GetNegligibleInterferenceThreshold() const
+{
+    // convert Watt to dBm
+    return 10.0 * std::log10(m_negligibleInterferenceW * 1000.0);
+}
+
 void
 NrSpectrumPhy::SetUnlicensedMode(bool unlicensedMode)
 {
@@ -409,6 +434,26 @@ NrSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
     Time duration = params->duration;
     NS_LOG_INFO("Start receiving signal: " << rxPsd << " duration= " << duration);
 
+    if (IsNegligibleInterference(params))
+    {
+        // Only a noise rise of the interference, without MIMO tracking nor dispatching
+        NS_LOG_LOGIC("Negligible interference of power " << Integral(*rxPsd) << " W");
+        m_interferenceData->AddSignal(rxPsd, duration);
+        if (m_interferenceSrs)
+        {
+            m_interferenceSrs->AddSignal(rxPsd, duration);
+        }
+        if (DynamicCast<NrSpectrumSignalParametersDlCtrlFrame>(params))
+        {
+            m_interferenceCtrl->AddSignal(rxPsd, duration);
+        }
+        if (m_unlicensedMode && m_state == IDLE)
+        {
+            MaybeCcaBusy();
+        }
+        return;
+    }
+
     // pass it to interference calculations regardless of the type (nr or non-nr)
     m_interferenceData->AddSignalMimo(params, duration);
 
@@ -1708,6 +1753,38 @@ NrSpectrumPhy::CheckIfStillBusy()
     }
 }
 
+bool
+NrSpectrumPhy::IsNegligibleInterference(Ptr<const SpectrumSignalParameters> params) const
+{
+    if (m_negligibleInterferenceW <= 0)
+    {
+        return false;
+    }
+    // The signals of this cell are wanted, and the PSS of the other cells are measured by the UEs
+    if (auto dataParams = DynamicCast<const NrSpectrumSignalParametersDataFrame>(params))
+    {
+        if (dataParams->cellId == GetCellId())
+        {
+            return false;
+        }
+    }
+    else if (auto dlCtrlParams = DynamicCast<const NrSpectrumSignalParametersDlCtrlFrame>(params))
+    {
+        if (dlCtrlParams->cellId == GetCellId() || (dlCtrlParams->pss && !m_isGnb))
+        {
+            return false;
+        }
+    }
+    else if (auto ulCtrlParams = DynamicCast<const NrSpectrumSignalParametersUlCtrlFrame>(params))
+    {
+        if (ulCtrlParams->cellId == GetCellId())
+        {
+            return false;
+        }
+    }
+    return Integral(*params->psd) < m_negligibleInterferenceW;
+}
+
 bool
 NrSpectrumPhy::IsOnlySrs(const std::list<Ptr<NrControlMessage>>& ctrlMsgList)
 {
@@ -224,6 +224,16 @@ class NrSpectrumPhy : public SpectrumPhy
      * \return CCA threshold in dBms
      */
     double GetCcaMode1Threshold() const;
+    /**
+     * \brief Set the received power below which the signals of other cells are negligible
+     * \param thresholdDBm the threshold in dBm, -inf to consider all the signals
+     */
+    void SetNegligibleInterferenceThreshold(double thresholdDBm);
+    /**
+     * \brief Get the received power below which the signals of other cells are negligible
+     * \return the threshold in dBm
+     */
+    double GetNegligibleInterferenceThreshold() const;
     /**
      * \brief Sets whether to perform in unclicensed mode in which the channel monitoring is enabled
      * \param unlicensedMode if true the unlicensed mode is enabled
@@ -558,6 +568,16 @@ class NrSpectrumPhy : public SpectrumPhy
      */
     bool IsOnlySrs(const std::list<Ptr<NrControlMessage>>& ctrlMsgList);
 
+    /**
+     * \brief Checks whether a received signal is a negligible interference, before any
+     * dispatching on its type. The signals of this cell and the PSS received by a UE are never
+     * negligible; the other signals are if their received power is below
+     * NegligibleInterferenceThreshold.
+     * \param params the parameters of the received signal
+     * \returns true if the signal is only accounted as a noise rise of the interference
+     */
+    bool IsNegligibleInterference(Ptr<const SpectrumSignalParameters> params) const;
+
     /**
      * \brief Checks whether transport blocks were correctly received or were corrupted.
      */
@@ -594,6 +614,8 @@ class NrSpectrumPhy : public SpectrumPhy
     double m_ccaMode1ThresholdW{0}; //!< Clear channel assessment (CCA) threshold in Watts,
                                     //!< attribute that it configures it is
                                     //   CcaMode1Threshold and is configured in dBm
+    double m_negligibleInterferenceW{0}; //!< Received power in Watts below which the signals of
+                                         //!< other cells are negligible, 0 if disabled
     bool m_unlicensedMode{
         false}; //!< Whether this spectrum phy is configure to work in an unlicensed mode.
                 //   Unlicensed mode additionally to licensed mode allows channel monitoring to
@@ -244,6 +244,7 @@ NrUeMac::NrUeMac()
     m_macSapProvider = new UeMemberNrMacSapProvider(this);
     m_phySapUser = new MacUeMemberPhySapUser(this);
     m_raPreambleUniformVariable = CreateObject<UniformRandomVariable>();
+    m_aoiTracker = CreateObject<NrAoiTimestampTracker>();
 }
 
 NrUeMac::~NrUeMac()
@@ -258,6 +259,7 @@ NrUeMac::DoDispose()
     m_ulBsrReceived.clear();
     m_lcInfoMap.clear();
     m_raPreambleUniformVariable = nullptr;
+    m_aoiTracker = nullptr;
     delete m_macSapProvider;
     delete m_cmacSapProvider;
     delete m_phySapUser;
@@ -267,6 +269,19 @@ void
 NrUeMac::SetRnti(uint16_t rnti)
 {
     NS_LOG_FUNCTION(this);
+    ChangeRnti(rnti);
+}
+
+void
+NrUeMac::ChangeRnti(uint16_t rnti)
+{
+    NS_LOG_FUNCTION(this << rnti);
+    if (rnti != m_rnti)
+    {
+        // the packets stored with the previous RNTI will not be transmitted with it
+        m_aoiTracker->RemoveUe(m_rnti);
+        m_srReportedCount = 0;
+    }
     m_rnti = rnti;
 }
 
@@ -389,10 +404,7 @@ NrUeMac::DoTransmitPdu(NrMacSapProvider::TransmitPduParameters params)
     m_phySapProvider->SendMacPdu(params.pdu, m_ulDciSfnsf, m_ulDci->m_symStart, m_ulDci->m_rnti);
 
     // data를 설공적으로 보냈으면 패킷을 큐에서 삭제
-    if(!ue_mac_packet_Ctime_Queue_Map[m_rnti].empty())
-    {
-        ue_mac_packet_Ctime_Queue_Map[m_rnti].pop();
-    }
+    m_aoiTracker->Pop(m_rnti);
 }
 
 /**
@@ -420,14 +432,10 @@ NrUeMac::DoReportBufferStatus(NrMacSapProvider::ReportBufferStatusParameters par
 
     // rnti 별 packet creation time stamp 큐에 추가
     uint16_t rnti = params.rnti;
-    ue_mac_packet_Ctime_Queue_Map[rnti].push(Simulator::Now().GetMicroSeconds());
+    m_aoiTracker->Push(rnti, Simulator::Now().GetMicroSeconds());
     NS_LOG_INFO("Added packet creation time for RNTI " << rnti << ": "
                                                        << Simulator::Now().GetMicroSeconds());
 
-    // [Output 1] : 패킷 큐 확인용 메시지
-    // std::cout<<"현재 rnti "<<rnti<<"의 가장 오래된 패킷 생성시간 큐 상태 :
-    // "<<ue_mac_packet_Ctime_Queue_Map[rnti].front()<<std::endl;
-
     if (m_srState == INACTIVE)
     {
         NS_LOG_INFO("INACTIVE -> TO_SEND, bufSize " << GetTotalBufSize());
@@ -624,7 +632,7 @@ NrUeMac::DoSlotIndication(const SfnSf& sfn)
 }
 
 void
-NrUeMac::SendSR() const
+NrUeMac::SendSR()
 {
     NS_LOG_FUNCTION(this);
 
@@ -638,7 +646,13 @@ NrUeMac::SendSR() const
     Ptr<NrSRMessage> msg = Create<NrSRMessage>();
     msg->SetSourceBwp(GetBwpId());
     msg->SetRNTI(m_rnti);
-    msg->SetPacketCreationTimes(ue_mac_packet_Ctime_Queue_Map.at(m_rnti)); // 패킷 생성시간 큐 보냄
+    // 패킷 생성시간 보냄: only the ones not reported with a previous SR, which are counted
+    // rather than compared by time, as packets can share a creation time
+    uint64_t storedCount = m_aoiTracker->GetStoredCount(m_rnti);
+    std::vector<uint64_t> creationTimes;
+    m_aoiTracker->GetNewestStored(m_rnti, storedCount - m_srReportedCount, &creationTimes);
+    m_srReportedCount = storedCount;
+    msg->SetPacketCreationTimes(std::move(creationTimes));
     m_macTxedCtrlMsgsTrace(m_currentSlot, GetCellId(), m_rnti, GetBwpId(), msg);
     m_phySapProvider->SendControlMessage(msg);
 }
@@ -689,7 +703,7 @@ NrUeMac::RecvRaResponse(NrBuildRarListElement_s raResponse)
                          << +m_raPreambleId
                          << ", setting T-C-RNTI = " << raResponse.ulMsg3Dci->m_rnti
                          << " at: " << Simulator::Now().As(Time::MS));
-    m_rnti = raResponse.ulMsg3Dci->m_rnti;
+    ChangeRnti(raResponse.ulMsg3Dci->m_rnti);
     m_cmacSapUser->SetTemporaryCellRnti(m_rnti);
     // in principle we should wait for contention resolution,
     // but in the current NR model when two or more identical
@@ -1248,7 +1262,7 @@ NrUeMac::DoStartNonContentionBasedRandomAccessProcedure(uint16_t rnti,
     NS_ASSERT_MSG(prachMask == 0,
                   "requested PRACH MASK = " << (uint32_t)prachMask
                                             << ", but only PRACH MASK = 0 is supported");
-    m_rnti = rnti;
+    ChangeRnti(rnti);
     m_raPreambleId = preambleId;
     m_preambleTransmissionCounter = 0;
     bool contention = false;
@@ -1322,7 +1336,7 @@ NrUeMac::DoReset()
         }
     }
     // note: rnti will be assigned by the gNB using RA response message
-    m_rnti = 0;
+    ChangeRnti(0);
     m_noRaResponseReceivedEvent.Cancel();
     m_rachConfigured = false;
     m_ulBsrReceived.clear();
@@ -5,7 +5,7 @@
 #ifndef NR_UE_MAC_H
 #define NR_UE_MAC_H
 
-#include <queue>
+#include "nr-aoi-timestamp-tracker.h"
 #include "nr-ccm-mac-sap.h"
 #include "nr-phy-mac-common.h"
 #include "nr-ue-cmac-sap.h"
@@ -109,21 +109,11 @@ class NrUeMac : public Object
 
   public:
     /**
-     * UE별 패킷 생성 시간 큐를 map으로 구성함.
-     * BSR이 갱신될때마다 insert.
-     * 데이터를 gNB에서 제대로 수신했으면 HARQ ACK를 보내는데 이때는 delete.
-     * 업데이트는 위와 같이 구성함. 
-     * 
-     * // gNB에게 <ue,queue> map을 보낼때는
-     * // SendReportBSR 메서드에서 NrBsrMessage에 파라미터로 큐를 넣고
-     * // m_phySapProvider에서 SendControlMessage를 통해서 gNB에 송신할 예정
-     * (3.11) 변경
-     * SendReportBufferStatus에서 NrBsrMessage에 파라미터를 넣지 않는다.
-     * 대신에 SHORT_BSR 패킷에 테그를 붙여서 전송함 (데이터 전송 채널)
-     * 
-     */
-    // <UE, 데이터 패킷 생성 시간 큐> map
-    std::unordered_map<uint16_t, std::queue<uint64_t>> ue_mac_packet_Ctime_Queue_Map;
+     * UE별 패킷 생성 시간 큐
+     * BSR이 갱신될때마다 insert, 데이터 전송 후 delete.
+     * The creation times not reported yet are sent to the gNB with the SR.
+     */
+    Ptr<NrAoiTimestampTracker> m_aoiTracker;
 
     // PacketCreationTimeTag 정의
     struct PacketCreationTimeTag : public Tag
@@ -309,7 +299,16 @@ class NrUeMac : public Object
     /**
      * \brief Send to the PHY a SR
      */
-    void SendSR() const;
+    void SendSR();
+
+    /**
+     * \brief Set the RNTI of the UE
+     * \param rnti the new RNTI
+     *
+     * When the RNTI changes, the creation times stored for the previous one are
+     * removed, and none of the new one is considered reported with a SR.
+     */
+    void ChangeRnti(uint16_t rnti);
     /**
      * \brief Called by RLC to transmit a RLC PDU
      * \param params the RLC params
@@ -481,6 +480,8 @@ class NrUeMac : public Object
 
     SrBsrMachine m_srState{INACTIVE}; //!< Current state for the SR/BSR machine.
 
+    uint64_t m_srReportedCount{0}; //!< Creation times of m_rnti already sent with a SR
+
     Ptr<UniformRandomVariable> m_raPreambleUniformVariable;
     uint8_t m_raPreambleId{0}; //!< The RA Preamble ID
     uint8_t m_raRnti{0};       //!< The RA Rnti
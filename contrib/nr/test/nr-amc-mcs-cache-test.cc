@@ -0,0 +1,181 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/boolean.h>
+#include <ns3/double.h>
+#include <ns3/enum.h>
+#include <ns3/nr-amc.h>
+#include <ns3/nr-eesm-ir-t1.h>
+#include <ns3/nr-lte-mi-error-model.h>
+#include <ns3/nr-mimo-matrices.h>
+#include <ns3/spectrum-model.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+#include <cmath>
+
+/**
+ * \file nr-amc-mcs-cache-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the MCS cache of NrAmc: the CQI and MCS of SISO SINR vectors
+ * and of MIMO SINR matrices, over a range of SINRs, must be the same with and without
+ * the cache, and with the binary search of the MCS; repeating the SINRs must be answered
+ * by the cache, and the least recently used signatures must be evicted when it is full.
+ */
+namespace ns3
+{
+
+class NrAmcMcsCacheTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param errorModel the type of the error model
+     */
+    NrAmcMcsCacheTestCase(TypeId errorModel)
+        : TestCase("MCS cache of NrAmc with " + errorModel.GetName()),
+          m_errorModel(errorModel)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create an AMC in ErrorModel mode
+     * \param cacheSize the size of the MCS cache
+     * \param binarySearch whether the MCS is searched with a binary search
+     * \return the AMC
+     */
+    Ptr<NrAmc> CreateAmc(uint32_t cacheSize, bool binarySearch) const;
+
+    TypeId m_errorModel; //!< Type of the error model
+};
+
+Ptr<NrAmc>
+NrAmcMcsCacheTestCase::CreateAmc(uint32_t cacheSize, bool binarySearch) const
+{
+    Ptr<NrAmc> amc = CreateObject<NrAmc>();
+    amc->SetAttribute("AmcModel", EnumValue(NrAmc::ErrorModel));
+    amc->SetAttribute("ErrorModelType", TypeIdValue(m_errorModel));
+    amc->SetAttribute("McsCacheSize", UintegerValue(cacheSize));
+    amc->SetAttribute("BinaryMcsSearch", BooleanValue(binarySearch));
+    amc->SetDlMode();
+    return amc;
+}
+
+void
+NrAmcMcsCacheTestCase::DoRun()
+{
+    const uint32_t numRbs = 24;
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < numRbs; ++i)
+    {
+        freqs.push_back(3.5e9 + 180e3 * i);
+    }
+    Ptr<SpectrumModel> model = Create<SpectrumModel>(freqs);
+
+    // SINR from -10 to 30 dB, with some frequency selectivity and some RBs without signal
+    std::vector<SpectrumValue> sinrs;
+    for (int db = -10; db <= 30; db += 2)
+    {
+        SpectrumValue sinr(model);
+        for (uint32_t i = 0; i < numRbs; ++i)
+        {
+            sinr[i] = (i % 7 == 3) ? 0.0 : std::pow(10.0, (db + 3 * std::sin(0.5 * i)) / 10);
+        }
+        sinrs.push_back(sinr);
+    }
+
+    Ptr<NrAmc> reference = CreateAmc(0, false);
+    Ptr<NrAmc> cached = CreateAmc(64, false);
+    Ptr<NrAmc> binary = CreateAmc(0, true);
+
+    for (uint32_t round = 0; round < 2; ++round)
+    {
+        for (const auto& sinr : sinrs)
+        {
+            uint8_t refMcs = 0;
+            uint8_t cachedMcs = 0;
+            uint8_t binaryMcs = 0;
+            uint8_t refCqi = reference->CreateCqiFeedbackWbTdma(sinr, refMcs);
+            uint8_t cachedCqi = cached->CreateCqiFeedbackWbTdma(sinr, cachedMcs);
+            uint8_t binaryCqi = binary->CreateCqiFeedbackWbTdma(sinr, binaryMcs);
+            NS_TEST_ASSERT_MSG_EQ(+cachedMcs, +refMcs, "Cached MCS differs");
+            NS_TEST_ASSERT_MSG_EQ(+cachedCqi, +refCqi, "Cached CQI differs");
+            NS_TEST_ASSERT_MSG_EQ(+binaryMcs, +refMcs, "MCS of the binary search differs");
+            NS_TEST_ASSERT_MSG_EQ(+binaryCqi, +refCqi, "CQI of the binary search differs");
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(cached->GetMcsCacheMisses(), sinrs.size(), "Wrong number of misses");
+    NS_TEST_ASSERT_MSG_EQ(cached->GetMcsCacheHits(), sinrs.size(), "Wrong number of hits");
+    NS_TEST_ASSERT_MSG_EQ(reference->GetMcsCacheHits(), 0, "Disabled cache must not hit");
+
+    // MIMO: the same SINRs on two layers, the second one 6 dB lower
+    if (m_errorModel != NrLteMiErrorModel::GetTypeId())
+    {
+        for (const auto& sinr : sinrs)
+        {
+            NrSinrMatrix sinrMat(2, numRbs);
+            for (uint32_t i = 0; i < numRbs; ++i)
+            {
+                sinrMat(0, i) = sinr[i];
+                sinrMat(1, i) = sinr[i] / 4;
+            }
+            auto refParams = reference->GetMaxMcsParams(sinrMat, 4);
+            for (uint32_t round = 0; round < 2; ++round)
+            {
+                auto cachedParams = cached->GetMaxMcsParams(sinrMat, 4);
+                NS_TEST_ASSERT_MSG_EQ(+cachedParams.mcs, +refParams.mcs, "Cached MCS differs");
+                NS_TEST_ASSERT_MSG_EQ(+cachedParams.wbCqi, +refParams.wbCqi, "CQI differs");
+                NS_TEST_ASSERT_MSG_EQ(cachedParams.tbSize, refParams.tbSize, "TB size differs");
+            }
+            auto binaryParams = binary->GetMaxMcsParams(sinrMat, 4);
+            NS_TEST_ASSERT_MSG_EQ(+binaryParams.mcs, +refParams.mcs, "Binary MCS differs");
+        }
+        NS_TEST_ASSERT_MSG_EQ(cached->GetMcsCacheMisses(), 2 * sinrs.size(), "Wrong misses");
+        NS_TEST_ASSERT_MSG_EQ(cached->GetMcsCacheHits(), 2 * sinrs.size(), "Wrong hits");
+    }
+
+    // a cache of 2 entries: the least recently used signature is evicted
+    Ptr<NrAmc> small = CreateAmc(2, false);
+    uint8_t mcs = 0;
+    small->CreateCqiFeedbackWbTdma(sinrs[0], mcs);
+    small->CreateCqiFeedbackWbTdma(sinrs[1], mcs);
+    small->CreateCqiFeedbackWbTdma(sinrs[0], mcs); // hit, sinrs[1] becomes the oldest
+    small->CreateCqiFeedbackWbTdma(sinrs[2], mcs); // evicts sinrs[1]
+    small->CreateCqiFeedbackWbTdma(sinrs[0], mcs); // hit
+    small->CreateCqiFeedbackWbTdma(sinrs[1], mcs); // miss
+    NS_TEST_ASSERT_MSG_EQ(small->GetMcsCacheHits(), 2, "Wrong number of hits");
+    NS_TEST_ASSERT_MSG_EQ(small->GetMcsCacheMisses(), 4, "Wrong number of misses");
+
+    // quantized signatures with a step of 0.5 dB: 10.1 dB shares the MCS of 10 dB, while
+    // 10.3 dB does not
+    Ptr<NrAmc> quantized = CreateAmc(64, false);
+    quantized->SetAttribute("McsCacheSinrQuantum", DoubleValue(0.5));
+    uint8_t mcsFirst = 0;
+    uint8_t mcsClose = 0;
+    quantized->CreateCqiFeedbackWbTdma(SpectrumValue(model) + std::pow(10.0, 1.0), mcsFirst);
+    quantized->CreateCqiFeedbackWbTdma(SpectrumValue(model) + std::pow(10.0, 1.01), mcsClose);
+    quantized->CreateCqiFeedbackWbTdma(SpectrumValue(model) + std::pow(10.0, 1.03), mcs);
+    NS_TEST_ASSERT_MSG_EQ(quantized->GetMcsCacheHits(), 1, "Close SINR must hit the cache");
+    NS_TEST_ASSERT_MSG_EQ(quantized->GetMcsCacheMisses(), 2, "Far SINR must miss the cache");
+    NS_TEST_ASSERT_MSG_EQ(+mcsClose, +mcsFirst, "Close SINR must get the cached MCS");
+}
+
+class NrAmcMcsCacheTestSuite : public TestSuite
+{
+  public:
+    NrAmcMcsCacheTestSuite()
+        : TestSuite("nr-amc-mcs-cache", Type::UNIT)
+    {
+        AddTestCase(new NrAmcMcsCacheTestCase(NrEesmIrT1::GetTypeId()), Duration::QUICK);
+        AddTestCase(new NrAmcMcsCacheTestCase(NrLteMiErrorModel::GetTypeId()), Duration::QUICK);
+    }
+};
+
+static NrAmcMcsCacheTestSuite g_nrAmcMcsCacheTestSuite; //!< NrAmc MCS cache test suite
+
+} // namespace ns3
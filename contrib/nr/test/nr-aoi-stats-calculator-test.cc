@@ -0,0 +1,167 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-aoi-stats-calculator.h>
+#include <ns3/nstime.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/test.h>
+
+#include <fstream>
+
+/**
+ * \file nr-aoi-stats-calculator-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the UL AoI statistics: the AoI sawtooth of a UE is fed with
+ * a few deliveries, one of them older than the newest one already delivered, and the
+ * time-average, peak, maximum and violation probability are checked against the values
+ * computed by hand, both in the ongoing epoch and in the binary output file.
+ */
+namespace ns3
+{
+
+class NrAoiStatsCalculatorTestCase : public TestCase
+{
+  public:
+    NrAoiStatsCalculatorTestCase()
+        : TestCase("UL AoI sawtooth statistics")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Check the statistics of the ongoing epoch at 50 ms
+     * \param stats the AoI stats calculator
+     */
+    void CheckOngoingEpoch(Ptr<NrAoiStatsCalculator> stats);
+};
+
+void
+NrAoiStatsCalculatorTestCase::CheckOngoingEpoch(Ptr<NrAoiStatsCalculator> stats)
+{
+    // AoI: 5 ms at 10 ms, 25 ms at 30 ms (peak), 5 ms, 15 ms at 40 ms (older packet, so
+    // no reset and no peak), 25 ms at 50 ms; the areas are 0.3, 0.1 and 0.2 ms*s over 40 ms
+    const double tol = 1e-9;
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats->GetAoi(1, 1).GetSeconds(), 0.025, tol, "AoI");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats->GetAverageAoi(1, 1).GetSeconds(),
+                              0.015,
+                              tol,
+                              "Time-average AoI");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats->GetAveragePeakAoi(1, 1).GetSeconds(),
+                              0.025,
+                              tol,
+                              "Average peak AoI");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats->GetMaxAoi(1, 1).GetSeconds(), 0.025, tol, "Maximum AoI");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats->GetViolationProbability(1, 1),
+                              0.75,
+                              tol,
+                              "Violation probability");
+    NS_TEST_ASSERT_MSG_EQ(stats->GetAoi(1, 2), Time(0), "Unknown UE must have no AoI");
+}
+
+void
+NrAoiStatsCalculatorTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("nr-aoi-stats.bin");
+    Ptr<NrAoiStatsCalculator> stats = CreateObject<NrAoiStatsCalculator>();
+    stats->SetAttribute("EpochDuration", TimeValue(Seconds(1)));
+    stats->SetAttribute("AoiThreshold", TimeValue(MilliSeconds(10)));
+    stats->SetAttribute("OutputFilename", StringValue(filename));
+
+    Simulator::Schedule(MilliSeconds(10),
+                        &NrAoiStatsCalculator::UlDelivery,
+                        stats,
+                        1,
+                        1,
+                        MilliSeconds(5));
+    Simulator::Schedule(MilliSeconds(30),
+                        &NrAoiStatsCalculator::UlDelivery,
+                        stats,
+                        1,
+                        1,
+                        MilliSeconds(25));
+    Simulator::Schedule(MilliSeconds(40),
+                        &NrAoiStatsCalculator::UlDelivery,
+                        stats,
+                        1,
+                        1,
+                        MilliSeconds(20));
+    Simulator::Schedule(MilliSeconds(50),
+                        &NrAoiStatsCalculatorTestCase::CheckOngoingEpoch,
+                        this,
+                        stats);
+    Simulator::Stop(Seconds(1.5));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    // first epoch: the UE and the cell records; the second one, written at the end of the
+    // simulation, as well
+    std::ifstream in(filename, std::ios::binary);
+    NS_TEST_ASSERT_MSG_EQ(in.is_open(), true, "Output file not written");
+    char magic[8];
+    in.read(magic, sizeof(magic));
+    NS_TEST_ASSERT_MSG_EQ(std::string(magic, sizeof(magic)), "NrAoi001", "Wrong file header");
+
+    for (uint32_t record = 0; record < 4; ++record)
+    {
+        double start;
+        uint16_t cellId;
+        uint16_t rnti;
+        uint32_t deliveries;
+        double avgAoi;
+        double avgPeakAoi;
+        double maxAoi;
+        double violation;
+        in.read(reinterpret_cast<char*>(&start), sizeof(start));
+        in.read(reinterpret_cast<char*>(&cellId), sizeof(cellId));
+        in.read(reinterpret_cast<char*>(&rnti), sizeof(rnti));
+        in.read(reinterpret_cast<char*>(&deliveries), sizeof(deliveries));
+        in.read(reinterpret_cast<char*>(&avgAoi), sizeof(avgAoi));
+        in.read(reinterpret_cast<char*>(&avgPeakAoi), sizeof(avgPeakAoi));
+        in.read(reinterpret_cast<char*>(&maxAoi), sizeof(maxAoi));
+        in.read(reinterpret_cast<char*>(&violation), sizeof(violation));
+        NS_TEST_ASSERT_MSG_EQ(in.good(), true, "Missing record " << record);
+
+        NS_TEST_ASSERT_MSG_EQ(cellId, 1, "Wrong cell ID");
+        NS_TEST_ASSERT_MSG_EQ(rnti, (record % 2 == 0) ? 1 : 0, "Wrong RNTI");
+        if (record < 2)
+        {
+            // from 40 ms to 1 s the AoI grows from 15 ms to 975 ms
+            NS_TEST_ASSERT_MSG_EQ_TOL(start, 0.0, 1e-12, "Wrong epoch start");
+            NS_TEST_ASSERT_MSG_EQ(deliveries, 3, "Wrong number of deliveries");
+            NS_TEST_ASSERT_MSG_EQ_TOL(avgAoi, (0.0004 + 0.4752) / 0.99, 1e-9, "Time-average AoI");
+            NS_TEST_ASSERT_MSG_EQ_TOL(avgPeakAoi, 0.025, 1e-9, "Average peak AoI");
+            NS_TEST_ASSERT_MSG_EQ_TOL(maxAoi, 0.975, 1e-9, "Maximum AoI");
+            NS_TEST_ASSERT_MSG_EQ_TOL(violation, (0.015 + 0.005 + 0.96) / 0.99, 1e-9, "Violation");
+        }
+        else
+        {
+            // no delivery: the AoI grows from 975 ms to 1475 ms
+            NS_TEST_ASSERT_MSG_EQ_TOL(start, 1.0, 1e-12, "Wrong epoch start");
+            NS_TEST_ASSERT_MSG_EQ(deliveries, 0, "Wrong number of deliveries");
+            NS_TEST_ASSERT_MSG_EQ_TOL(avgAoi, 1.225, 1e-9, "Time-average AoI");
+            NS_TEST_ASSERT_MSG_EQ_TOL(maxAoi, 1.475, 1e-9, "Maximum AoI");
+            NS_TEST_ASSERT_MSG_EQ_TOL(violation, 1.0, 1e-9, "Violation");
+        }
+    }
+    in.peek();
+    NS_TEST_ASSERT_MSG_EQ(in.eof(), true, "Unexpected records");
+}
+
+class NrAoiStatsCalculatorTestSuite : public TestSuite
+{
+  public:
+    NrAoiStatsCalculatorTestSuite()
+        : TestSuite("nr-aoi-stats-calculator", Type::UNIT)
+    {
+        AddTestCase(new NrAoiStatsCalculatorTestCase, Duration::QUICK);
+    }
+};
+
+static NrAoiStatsCalculatorTestSuite g_nrAoiStatsCalculatorTestSuite; //!< AoI stats test suite
+
+} // namespace ns3
@@ -0,0 +1,109 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-aoi-timestamp-tracker.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+/**
+ * \file nr-aoi-timestamp-tracker-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the ring buffers of packet creation times used for the AoI:
+ * FIFO order across the wrap-around, drop of the new creation times when full, and
+ * the queries used by the UE MAC (GetStoredCount, GetNewestStored) and by the scheduler
+ * (GetAge).
+ */
+namespace ns3
+{
+
+class NrAoiTimestampTrackerTestCase : public TestCase
+{
+  public:
+    NrAoiTimestampTrackerTestCase()
+        : TestCase("AoI timestamp tracker ring buffers")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrAoiTimestampTrackerTestCase::DoRun()
+{
+    Ptr<NrAoiTimestampTracker> tracker = CreateObject<NrAoiTimestampTracker>();
+    tracker->SetAttribute("Capacity", UintegerValue(4));
+
+    NS_TEST_ASSERT_MSG_EQ(tracker->IsEmpty(1), true, "Unknown RNTI must be empty");
+    NS_TEST_ASSERT_MSG_EQ(tracker->GetAge(1, 100), 0, "No AoI without creation times");
+    NS_TEST_ASSERT_MSG_EQ(tracker->GetNewest(1), 0, "No newest creation time yet");
+
+    // Wrap around the ring buffer several times, keeping 3 creation times stored
+    uint64_t oldest = 10;
+    uint64_t next = 10;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        tracker->Push(1, next++);
+    }
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(tracker->GetOldest(1), oldest, "FIFO order lost");
+        tracker->Pop(1);
+        ++oldest;
+        NS_TEST_ASSERT_MSG_EQ(tracker->Push(1, next++), true, "Buffer not full");
+        NS_TEST_ASSERT_MSG_EQ(tracker->GetSize(1), 3, "Unexpected size");
+    }
+    NS_TEST_ASSERT_MSG_EQ(tracker->GetAge(1, 100), 100 - oldest, "Unexpected AoI");
+
+    NS_TEST_ASSERT_MSG_EQ(tracker->GetStoredCount(1), 13, "Popped creation times not counted");
+    std::vector<uint64_t> newer;
+    tracker->GetNewestStored(1, 2, &newer);
+    NS_TEST_ASSERT_MSG_EQ(newer.size(), 2, "Unexpected number of newest creation times");
+    NS_TEST_ASSERT_MSG_EQ(newer.front(), next - 2, "Newest creation times out of order");
+    NS_TEST_ASSERT_MSG_EQ(newer.back(), next - 1, "Newest creation times out of order");
+    newer.clear();
+    tracker->GetNewestStored(1, 10, &newer);
+    NS_TEST_ASSERT_MSG_EQ(newer.size(), 3, "Only the stored creation times can be returned");
+
+    // Creation times of the same microsecond are all kept
+    tracker->Pop(1);
+    tracker->Push(1, next - 1);
+    newer.clear();
+    tracker->GetNewestStored(1, 1, &newer);
+    NS_TEST_ASSERT_MSG_EQ(newer.size(), 1, "Unexpected number of newest creation times");
+    NS_TEST_ASSERT_MSG_EQ(newer.back(), next - 1, "Equal creation time lost");
+    ++oldest;
+
+    // Fill the buffer: the new creation times are dropped, the oldest are kept
+    NS_TEST_ASSERT_MSG_EQ(tracker->Push(1, next++), true, "Buffer not full");
+    NS_TEST_ASSERT_MSG_EQ(tracker->Push(1, next++), false, "Buffer full");
+    NS_TEST_ASSERT_MSG_EQ(tracker->GetDropped(), 1, "One creation time dropped");
+    NS_TEST_ASSERT_MSG_EQ(tracker->GetStoredCount(1), 15, "Dropped creation time counted");
+    NS_TEST_ASSERT_MSG_EQ(tracker->GetOldest(1), oldest, "Oldest creation time lost");
+    NS_TEST_ASSERT_MSG_EQ(tracker->GetNewest(1), next - 1, "Dropped newest still reported");
+
+    // The RNTIs are independent
+    tracker->Push(2, 50);
+    tracker->RemoveUe(1);
+    NS_TEST_ASSERT_MSG_EQ(tracker->IsEmpty(1), true, "Removed RNTI must be empty");
+    NS_TEST_ASSERT_MSG_EQ(tracker->GetOldest(2), 50, "Other RNTI affected");
+    tracker->Pop(2);
+    tracker->Pop(2);
+    NS_TEST_ASSERT_MSG_EQ(tracker->IsEmpty(2), true, "Pop on empty buffer must be a no-op");
+}
+
+class NrAoiTimestampTrackerTestSuite : public TestSuite
+{
+  public:
+    NrAoiTimestampTrackerTestSuite()
+        : TestSuite("nr-aoi-timestamp-tracker", Type::UNIT)
+    {
+        AddTestCase(new NrAoiTimestampTrackerTestCase, Duration::QUICK);
+    }
+};
+
+static NrAoiTimestampTrackerTestSuite g_nrAoiTimestampTrackerTestSuite; //!< AoI tracker test suite
+
+} // namespace ns3
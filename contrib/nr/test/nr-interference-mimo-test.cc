@@ -0,0 +1,390 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-interference.h>
+#include <ns3/nr-mimo-chunk-processor.h>
+#include <ns3/nr-spectrum-signal-parameters.h>
+#include <ns3/simulator.h>
+#include <ns3/test.h>
+
+#include <cmath>
+#include <random>
+
+/**
+ * \file nr-interference-mimo-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing of the MIMO interference of NrInterference: two UL signals of the same
+ * cell are received together, with an out-of-cell interferer during the whole reception and
+ * another one in the middle of it, together with a negligible interferer without channel matrix,
+ * i.e., a white noise rise. The SINR and the covariance matrices of the chunks, computed from the
+ * covariance matrix of all the signals updated as they start and end, must be the same as when
+ * the covariance matrices are computed from scratch.
+ *
+ * The interference plus noise, the SINR and the RSSI computed in a single pass by
+ * NrInterferenceBase::ComputeInterfAndSinr for random PSDs must also be the same as with the
+ * SpectrumValue operations that they replace.
+ */
+namespace ns3
+{
+
+class NrInterferenceMimoTestCase : public TestCase
+{
+  public:
+    NrInterferenceMimoTestCase()
+        : TestCase("Incremental MIMO interference covariance of NrInterference")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create a signal with a random channel matrix
+     * \param nTxPorts the number of transmit ports
+     * \param rank the rank of the precoding matrix, 0 for no precoding matrix
+     * \param rnti the RNTI of the signal
+     * \return the signal
+     */
+    Ptr<NrSpectrumSignalParametersDataFrame> CreateSignal(size_t nTxPorts,
+                                                          size_t rank,
+                                                          uint16_t rnti);
+
+    /**
+     * \brief Compute from scratch the covariance matrix of noise and interference
+     * \param interferers the interfering signals
+     * \param noiseRise the noise rise per RB of the interferers without channel matrix
+     * \return the covariance matrix
+     */
+    NrCovMat ComputeCovMat(
+        const std::vector<Ptr<NrSpectrumSignalParametersDataFrame>>& interferers,
+        double noiseRise) const;
+
+    /**
+     * \brief Compute the SINR of a signal from scratch
+     * \param signal the received signal
+     * \param interferers the interfering signals
+     * \param noiseRise the noise rise per RB of the interferers without channel matrix
+     * \return the SINR
+     */
+    NrSinrMatrix ComputeSinr(
+        Ptr<NrSpectrumSignalParametersDataFrame> signal,
+        const std::vector<Ptr<NrSpectrumSignalParametersDataFrame>>& interferers,
+        double noiseRise) const;
+
+    static constexpr size_t N_RX_PORTS = 2;    //!< Number of receive ports
+    static constexpr size_t N_RBS = 6;         //!< Number of RBs
+    static constexpr double NOISE = 1e-3;      //!< Noise power per RB
+    static constexpr double NOISE_RISE = 2e-3; //!< Power per RB of the negligible interferer
+
+    Ptr<SpectrumModel> m_model;                                  //!< Spectrum model of the RBs
+    std::mt19937 m_generator{1};                                 //!< Generator
+    std::normal_distribution<double> m_normal{0.0, std::sqrt(0.5)}; //!< Gaussian distribution
+};
+
+Ptr<NrSpectrumSignalParametersDataFrame>
+NrInterferenceMimoTestCase::CreateSignal(size_t nTxPorts, size_t rank, uint16_t rnti)
+{
+    auto createMatrix = [this](size_t nRows, size_t nCols) {
+        auto res = Create<ComplexMatrixArray>(nRows, nCols, N_RBS);
+        for (size_t p = 0; p < N_RBS; p++)
+        {
+            for (size_t j = 0; j < nCols; j++)
+            {
+                for (size_t i = 0; i < nRows; i++)
+                {
+                    (*res)(i, j, p) = {m_normal(m_generator), m_normal(m_generator)};
+                }
+            }
+        }
+        return res;
+    };
+
+    auto signal = Create<NrSpectrumSignalParametersDataFrame>();
+    signal->rnti = rnti;
+    signal->psd = Create<SpectrumValue>(m_model);
+    *signal->psd = 1.0;
+    signal->spectrumChannelMatrix = createMatrix(N_RX_PORTS, nTxPorts);
+    if (rank > 0)
+    {
+        signal->precodingMatrix = createMatrix(nTxPorts, rank);
+    }
+    return signal;
+}
+
+NrCovMat
+NrInterferenceMimoTestCase::ComputeCovMat(
+    const std::vector<Ptr<NrSpectrumSignalParametersDataFrame>>& interferers,
+    double noiseRise) const
+{
+    auto covMat = NrCovMat{ComplexMatrixArray{N_RX_PORTS, N_RX_PORTS, N_RBS}};
+    for (size_t iRb = 0; iRb < N_RBS; iRb++)
+    {
+        for (size_t i = 0; i < N_RX_PORTS; i++)
+        {
+            covMat(i, i, iRb) = NOISE + noiseRise;
+        }
+    }
+    for (const auto& interferer : interferers)
+    {
+        auto chanMat = *interferer->spectrumChannelMatrix;
+        if (interferer->precodingMatrix)
+        {
+            chanMat = chanMat * (*interferer->precodingMatrix);
+        }
+        covMat += chanMat * chanMat.HermitianTranspose();
+    }
+    return covMat;
+}
+
+NrSinrMatrix
+NrInterferenceMimoTestCase::ComputeSinr(
+    Ptr<NrSpectrumSignalParametersDataFrame> signal,
+    const std::vector<Ptr<NrSpectrumSignalParametersDataFrame>>& interferers,
+    double noiseRise) const
+{
+    auto covMat = ComputeCovMat(interferers, noiseRise);
+    auto normChanMat = covMat.CalcIntfNormChannel(*signal->spectrumChannelMatrix);
+    return normChanMat.ComputeSinrForPrecoding(*signal->precodingMatrix);
+}
+
+void
+NrInterferenceMimoTestCase::DoRun()
+{
+    std::vector<double> centerFrequencies;
+    for (size_t iRb = 0; iRb < N_RBS; iRb++)
+    {
+        centerFrequencies.push_back(1e9 + iRb * 1e6);
+    }
+    m_model = Create<SpectrumModel>(centerFrequencies);
+    auto noise = Create<SpectrumValue>(m_model);
+    *noise = NOISE;
+
+    auto interference = CreateObject<NrInterference>();
+    interference->SetNoisePowerSpectralDensity(noise);
+    std::vector<MimoSinrChunk> sinrChunks;
+    std::vector<MimoSignalChunk> signalChunks;
+    auto cp = Create<NrMimoChunkProcessor>();
+    cp->AddCallback(MimoSinrChunksCb{[&](const std::vector<MimoSinrChunk>& chunks) {
+        sinrChunks = chunks;
+    }});
+    cp->AddCallback(MimoSignalChunksCb{[&](const std::vector<MimoSignalChunk>& chunks) {
+        signalChunks = chunks;
+    }});
+    interference->AddMimoChunkProcessor(cp);
+
+    // UL: two signals of the same cell from 0 to 6 ms, on orthogonal RBs, an out-of-cell
+    // interferer from 0 to 10 ms, and another one without precoding matrix from 2 to 4 ms,
+    // together with a negligible interferer without channel matrix
+    auto rx1 = CreateSignal(2, 1, 1);
+    auto rx2 = CreateSignal(4, 2, 2);
+    for (size_t iRb = 0; iRb < N_RBS; iRb++)
+    {
+        (*(iRb < N_RBS / 2 ? rx2 : rx1)->psd)[iRb] = 0.0;
+    }
+    auto intf1 = CreateSignal(4, 2, 3);
+    auto intf2 = CreateSignal(1, 0, 4);
+    auto noiseRise = Create<SpectrumValue>(m_model);
+    *noiseRise = NOISE_RISE;
+    Simulator::Schedule(MilliSeconds(6), &NrInterference::EndRx, interference);
+    Simulator::Schedule(Seconds(0), [&]() {
+        interference->AddSignalMimo(intf1, MilliSeconds(10));
+        interference->AddSignalMimo(rx1, MilliSeconds(6));
+        interference->AddSignalMimo(rx2, MilliSeconds(6));
+        interference->StartRxMimo(rx1);
+        interference->StartRxMimo(rx2);
+    });
+    Simulator::Schedule(MilliSeconds(2), [&]() {
+        interference->AddSignalMimo(intf2, MilliSeconds(2));
+        interference->AddSignal(noiseRise, MilliSeconds(2));
+    });
+    Simulator::Run();
+    Simulator::Destroy();
+
+    // One chunk per signal in [0, 2), [2, 4) and [4, 6) ms
+    std::vector<std::vector<Ptr<NrSpectrumSignalParametersDataFrame>>> outOfCell{{intf1},
+                                                                                {intf1, intf2},
+                                                                                {intf1}};
+    std::vector<double> noiseRises{0.0, NOISE_RISE, 0.0};
+    NS_TEST_ASSERT_MSG_EQ(sinrChunks.size(), 6, "Wrong number of SINR chunks");
+    NS_TEST_ASSERT_MSG_EQ(signalChunks.size(), 6, "Wrong number of signal chunks");
+    for (size_t iChunk = 0; iChunk < 3; iChunk++)
+    {
+        for (const auto& rxSignal : {rx1, rx2})
+        {
+            auto i = 2 * iChunk + rxSignal->rnti - 1;
+            auto interferers = outOfCell[iChunk];
+            interferers.push_back(rxSignal == rx1 ? rx2 : rx1);
+            const auto& sinr = sinrChunks[i].mimoSinr;
+            auto expectedSinr = ComputeSinr(rxSignal, interferers, noiseRises[iChunk]);
+            NS_TEST_EXPECT_MSG_EQ(sinrChunks[i].rnti, rxSignal->rnti, "Wrong RNTI");
+            NS_TEST_EXPECT_MSG_EQ(sinrChunks[i].dur, MilliSeconds(2), "Wrong duration");
+            NS_TEST_EXPECT_MSG_EQ(+sinr.GetRank(), +expectedSinr.GetRank(), "Wrong rank");
+            NS_TEST_EXPECT_MSG_EQ(sinr.IsAlmostEqual(expectedSinr, 1e-6),
+                                  true,
+                                  "Wrong SINR of chunk " << iChunk << " RNTI "
+                                                         << rxSignal->rnti);
+            NS_TEST_EXPECT_MSG_EQ(
+                signalChunks[i].interfNoiseCov.IsAlmostEqual(
+                    ComputeCovMat(outOfCell[iChunk], noiseRises[iChunk]),
+                    1e-9),
+                true,
+                "Wrong out-of-cell covariance matrix of chunk " << iChunk);
+        }
+    }
+}
+
+/**
+ * \brief NrInterference giving access to the single-pass computation of the interference plus
+ * noise, the SINR and the RSSI
+ */
+class NrInterferenceFusedTestInterference : public NrInterference
+{
+  public:
+    /**
+     * \brief Compute the interference plus noise, the SINR and the RSSI of given PSDs
+     * \param rx the PSD of the signal being received
+     * \param all the PSD of all the signals, including the one being received
+     * \param noise the noise PSD
+     * \param rssiBandwidth the bandwidth of a band (Hz), 0 not to compute the RSSI
+     * \return the RSSI (W)
+     */
+    double Compute(Ptr<SpectrumValue> rx,
+                   Ptr<SpectrumValue> all,
+                   Ptr<const SpectrumValue> noise,
+                   double rssiBandwidth)
+    {
+        m_rxSignal = rx;
+        m_allSignals = all;
+        m_noise = noise;
+        return ComputeInterfAndSinr(rssiBandwidth);
+    }
+
+    /**
+     * \return the interference plus noise of the last computation
+     */
+    const SpectrumValue& GetInterf() const
+    {
+        return *m_interfScratch;
+    }
+
+    /**
+     * \return the SINR of the last computation
+     */
+    const SpectrumValue& GetSinr() const
+    {
+        return *m_sinrScratch;
+    }
+};
+
+/**
+ * \brief Check that the single-pass computation of the interference plus noise, the SINR and
+ * the RSSI gives the same values as the SpectrumValue operations, for random PSDs
+ */
+class NrInterferenceFusedSinrTestCase : public TestCase
+{
+  public:
+    NrInterferenceFusedSinrTestCase()
+        : TestCase("Single-pass interference, SINR and RSSI of NrInterferenceBase")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create a PSD with random values spanning several orders of magnitude
+     * \param model the spectrum model
+     * \param zeroProbability the probability that the value of a band is zero
+     * \return the PSD
+     */
+    Ptr<SpectrumValue> CreatePsd(Ptr<const SpectrumModel> model, double zeroProbability);
+
+    std::mt19937 m_generator{1};                                //!< Generator
+    std::uniform_real_distribution<double> m_uniform{0.0, 1.0}; //!< Uniform distribution
+};
+
+Ptr<SpectrumValue>
+NrInterferenceFusedSinrTestCase::CreatePsd(Ptr<const SpectrumModel> model, double zeroProbability)
+{
+    auto psd = Create<SpectrumValue>(model);
+    for (auto it = psd->ValuesBegin(); it != psd->ValuesEnd(); ++it)
+    {
+        bool zero = m_uniform(m_generator) < zeroProbability;
+        *it = zero ? 0.0 : std::pow(10.0, -20.0 + 8.0 * m_uniform(m_generator));
+    }
+    return psd;
+}
+
+void
+NrInterferenceFusedSinrTestCase::DoRun()
+{
+    auto interference = CreateObject<NrInterferenceFusedTestInterference>();
+    // the scratch buffers are reused with the same spectrum model and reallocated when it changes
+    for (size_t numBands : {6, 6, 25, 273, 25})
+    {
+        std::vector<double> centerFrequencies;
+        for (size_t iRb = 0; iRb < numBands; iRb++)
+        {
+            centerFrequencies.push_back(1e9 + iRb * 180e3);
+        }
+        auto model = Create<SpectrumModel>(centerFrequencies);
+        const double rbWidth = model->Begin()->fh - model->Begin()->fl;
+
+        for (size_t iter = 0; iter < 10; iter++)
+        {
+            // the received signal uses a part of the bands only, as an allocation of RBs
+            auto rx = CreatePsd(model, 0.3);
+            auto all = Create<SpectrumValue>(model);
+            *all += *rx;
+            for (size_t i = 0; i < iter % 4; i++)
+            {
+                *all += *CreatePsd(model, 0.5);
+            }
+            auto noise = CreatePsd(model, 0.0);
+
+            double rssi = interference->Compute(rx, all, noise, rbWidth);
+            SpectrumValue interf = (*all) - (*rx) + (*noise);
+            SpectrumValue sinr = (*rx) / interf;
+            double expectedRssi = Sum((*noise + *all) * rbWidth);
+
+            for (size_t i = 0; i < numBands; i++)
+            {
+                NS_TEST_ASSERT_MSG_EQ(interference->GetInterf()[i],
+                                      interf[i],
+                                      "Wrong interference plus noise in band " << i << " of "
+                                                                               << numBands);
+                NS_TEST_ASSERT_MSG_EQ(interference->GetSinr()[i],
+                                      sinr[i],
+                                      "Wrong SINR in band " << i << " of " << numBands);
+            }
+            // the products may be fused with the sum into FMA instructions when building
+            // with NS3_NATIVE_OPTIMIZATIONS, so the RSSI is checked with a relative tolerance
+            NS_TEST_ASSERT_MSG_EQ_TOL(rssi,
+                                      expectedRssi,
+                                      expectedRssi * 1e-12,
+                                      "Wrong RSSI with " << numBands << " bands");
+            NS_TEST_ASSERT_MSG_EQ(interference->Compute(rx, all, noise, 0.0),
+                                  0.0,
+                                  "The RSSI must not be computed without bandwidth");
+        }
+    }
+    interference->Dispose();
+}
+
+class NrInterferenceMimoTestSuite : public TestSuite
+{
+  public:
+    NrInterferenceMimoTestSuite()
+        : TestSuite("nr-interference-mimo", Type::UNIT)
+    {
+        AddTestCase(new NrInterferenceMimoTestCase(), Duration::QUICK);
+        AddTestCase(new NrInterferenceFusedSinrTestCase(), Duration::QUICK);
+    }
+};
+
+/// NrInterference MIMO test suite
+static NrInterferenceMimoTestSuite g_nrInterferenceMimoTestSuite;
+
+} // namespace ns3
@@ -0,0 +1,341 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-mac-scheduler-ai-ns3-gym-env.h>
+#include <ns3/nr-mac-scheduler-ai-ns3-gym-vec-env.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+/**
+ * \file nr-mac-scheduler-ai-gym-env-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the layout of the observations and actions exchanged by the Gym
+ * environments of the AI scheduler. The shapes must not depend on the reported flows, the
+ * empty rows must be zero with a zero validity mask, and the weights of the empty rows must
+ * be ignored. The tests need the opengym module and are empty without it.
+ */
+namespace ns3
+{
+
+#ifdef HAVE_OPENGYM
+
+/**
+ * \ingroup test
+ * \brief Observation of a flow whose columns are derived from its RNTI and LC ID
+ * \param rnti the RNTI of the flow
+ * \param lcId the LC ID of the flow
+ * \return the observation of the flow
+ */
+static NrMacSchedulerUeInfoAi::LcObservation
+MakeGymTestObservation(uint16_t rnti, uint8_t lcId)
+{
+    NrMacSchedulerUeInfoAi::LcObservation obs{};
+    obs.rnti = rnti;
+    obs.lcId = lcId;
+    obs.priority = 10 + lcId;
+    obs.holDelay = 100 + rnti;
+    obs.aoi = 1000 + rnti;
+    obs.cqi = 7;
+    return obs;
+}
+
+/**
+ * \ingroup test
+ * \brief Check the padded [K, MaxFlows, 7] layout of NrMacSchedulerAiNs3GymVecEnv
+ *
+ * Three cells and three rows per cell: the first cell reports two flows, the second one four
+ * flows (one more than the rows) and the third one does not report.
+ */
+class NrGymVecEnvLayoutTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrGymVecEnvLayoutTestCase()
+        : TestCase("Fixed padded layout of the vectorized Gym environment")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrGymVecEnvLayoutTestCase::DoRun()
+{
+    const uint32_t numEnvs = 3;
+    const uint32_t maxFlows = 3;
+    Ptr<NrMacSchedulerAiNs3GymVecEnv> env = CreateObject<NrMacSchedulerAiNs3GymVecEnv>(numEnvs);
+    env->SetAttribute("MaxFlows", UintegerValue(maxFlows));
+    NS_TEST_ASSERT_MSG_EQ(env->GetNumEnvs(), numEnvs, "The number of cells was not kept");
+
+    const std::vector<uint32_t> obsShape{numEnvs, maxFlows, 7};
+    const std::vector<uint32_t> actShape{numEnvs, maxFlows};
+    auto checkSpaces = [&](const std::string& when) {
+        auto obsSpace = DynamicCast<OpenGymBoxSpace>(env->GetObservationSpace());
+        auto actSpace = DynamicCast<OpenGymBoxSpace>(env->GetActionSpace());
+        NS_TEST_ASSERT_MSG_EQ((obsSpace->GetShape() == obsShape),
+                              true,
+                              "Wrong observation space " << when);
+        NS_TEST_ASSERT_MSG_EQ((actSpace->GetShape() == actShape),
+                              true,
+                              "Wrong action space " << when);
+    };
+    checkSpaces("before the first report");
+
+    // the interface is not initialized: no step is sent and the step ids are 0
+    env->SetOpenGymInterface(CreateObject<OpenGymInterface>());
+
+    std::vector<NrMacSchedulerUeInfoAi::UeWeightsMap> weights(numEnvs);
+    auto updateFn = [&weights](uint32_t k) {
+        return [&weights, k](const NrMacSchedulerUeInfoAi::UeWeightsMap& ueWeights) {
+            weights[k] = ueWeights;
+        };
+    };
+    env->NotifyCurrentIteration(0,
+                                {MakeGymTestObservation(1, 3), MakeGymTestObservation(2, 4)},
+                                false,
+                                1.0,
+                                "",
+                                updateFn(0));
+    env->NotifyCurrentIteration(1,
+                                {MakeGymTestObservation(11, 3),
+                                 MakeGymTestObservation(12, 3),
+                                 MakeGymTestObservation(13, 3),
+                                 MakeGymTestObservation(14, 3)},
+                                false,
+                                3.0,
+                                "",
+                                updateFn(1));
+    checkSpaces("after the reports");
+
+    auto observation = DynamicCast<OpenGymBoxContainer<uint16_t>>(env->GetObservation());
+    NS_TEST_ASSERT_MSG_EQ((observation->GetShape() == obsShape), true, "Wrong observation shape");
+    const std::vector<uint16_t>& data = observation->GetDataRef();
+    NS_TEST_ASSERT_MSG_EQ(data.size(), numEnvs * maxFlows * 7, "Wrong observation size");
+
+    const std::vector<std::vector<uint16_t>> rntis{{1, 2}, {11, 12, 13}, {}};
+    for (uint32_t k = 0; k < numEnvs; ++k)
+    {
+        for (uint32_t row = 0; row < maxFlows; ++row)
+        {
+            auto value = data.begin() + (k * maxFlows + row) * 7;
+            if (row < rntis[k].size())
+            {
+                auto expected = MakeGymTestObservation(rntis[k][row], k == 0 ? 3 + row : 3);
+                NS_TEST_ASSERT_MSG_EQ(value[0], expected.rnti, "Wrong RNTI");
+                NS_TEST_ASSERT_MSG_EQ(value[1], expected.lcId, "Wrong LC ID");
+                NS_TEST_ASSERT_MSG_EQ(value[2], expected.priority, "Wrong priority");
+                NS_TEST_ASSERT_MSG_EQ(value[3], expected.holDelay, "Wrong HOL delay");
+                NS_TEST_ASSERT_MSG_EQ(value[4], expected.aoi, "Wrong AoI");
+                NS_TEST_ASSERT_MSG_EQ(value[5], expected.cqi, "Wrong CQI");
+                NS_TEST_ASSERT_MSG_EQ(value[6], 1, "Row of a flow not marked valid");
+            }
+            else
+            {
+                for (uint32_t column = 0; column < 7; ++column)
+                {
+                    NS_TEST_ASSERT_MSG_EQ(value[column],
+                                          0,
+                                          "Column " << column << " of the empty row " << row
+                                                    << " of cell " << k << " is not zero");
+                }
+            }
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ_TOL(env->GetReward(), 2.0, 1e-6, "Wrong average reward");
+
+    Ptr<OpenGymBoxContainer<float>> action = CreateObject<OpenGymBoxContainer<float>>(actShape);
+    std::vector<float> actionData(numEnvs * maxFlows);
+    for (uint32_t i = 0; i < actionData.size(); ++i)
+    {
+        actionData[i] = 0.1F * (i + 1);
+    }
+    action->SetData(actionData);
+    NS_TEST_ASSERT_MSG_EQ(env->ExecuteActions(action), true, "The action matches no step");
+
+    NS_TEST_ASSERT_MSG_EQ(weights[0].size(), 2, "Wrong number of UEs weighted in cell 0");
+    NS_TEST_ASSERT_MSG_EQ_TOL(weights[0].at(1).at(3), 0.1F, 1e-6, "Wrong weight of row 0");
+    NS_TEST_ASSERT_MSG_EQ_TOL(weights[0].at(2).at(4), 0.2F, 1e-6, "Wrong weight of row 1");
+    NS_TEST_ASSERT_MSG_EQ(weights[1].size(), 3, "The flow beyond MaxFlows was weighted");
+    for (uint32_t row = 0; row < maxFlows; ++row)
+    {
+        NS_TEST_ASSERT_MSG_EQ_TOL(weights[1].at(rntis[1][row]).at(3),
+                                  0.1F * (maxFlows + row + 1),
+                                  1e-6,
+                                  "Wrong weight of row " << row << " of cell 1");
+    }
+    NS_TEST_ASSERT_MSG_EQ(weights[2].empty(), true, "A cell that did not report was weighted");
+
+    // the step sent with ScheduleNow is never run: it would connect to the agent
+    env->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup test
+ * \brief The Gym environment, with an interface that can be detached
+ *
+ * NotifyCurrentIteration sends the step through the interface, if any: the interface is
+ * detached while the scheduler reports, and attached to read the observation and execute the
+ * action, as the interface does.
+ */
+class NrGymTestEnv : public NrMacSchedulerAiNs3GymEnv
+{
+  public:
+    /**
+     * \brief Attach or detach the interface
+     * \param openGymInterface the interface, nullptr to detach it
+     */
+    void SetInterface(Ptr<OpenGymInterface> openGymInterface)
+    {
+        m_openGymInterface = openGymInterface;
+    }
+};
+
+/**
+ * \ingroup test
+ * \brief Check the fixed-shape [MaxFlows, 7] layout of NrMacSchedulerAiNs3GymEnv
+ *
+ * Three rows and three steps: flows 1 and 2 take rows 0 and 1; then flow 2 keeps its row, flow 3
+ * takes the unused row 2 and row 0 is empty; then flow 4 takes row 0, the row unseen for the
+ * longest time, and the weight of the empty row 1 is ignored.
+ */
+class NrGymEnvLayoutTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrGymEnvLayoutTestCase()
+        : TestCase("Fixed padded layout of the Gym environment")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrGymEnvLayoutTestCase::DoRun()
+{
+    const uint32_t maxFlows = 3;
+    Ptr<NrGymTestEnv> env = CreateObject<NrGymTestEnv>();
+    env->SetMaxFlows(maxFlows);
+    Ptr<OpenGymInterface> openGymInterface = CreateObject<OpenGymInterface>();
+
+    const std::vector<uint32_t> obsShape{maxFlows, 7};
+    const std::vector<uint32_t> actShape{maxFlows};
+    NrMacSchedulerUeInfoAi::UeWeightsMap weights;
+    auto updateFn = [&weights](const NrMacSchedulerUeInfoAi::UeWeightsMap& ueWeights) {
+        weights = ueWeights;
+    };
+
+    // RNTIs reported in each step, and RNTI expected in each row (0 for an empty row)
+    const std::vector<std::vector<uint16_t>> steps{{1, 2}, {2, 3}, {4, 3}};
+    const std::vector<std::vector<uint16_t>> rows{{1, 2, 0}, {0, 2, 3}, {4, 0, 3}};
+    for (uint32_t step = 0; step < steps.size(); ++step)
+    {
+        std::vector<NrMacSchedulerUeInfoAi::LcObservation> observations;
+        for (uint16_t rnti : steps[step])
+        {
+            observations.push_back(MakeGymTestObservation(rnti, 4));
+        }
+        env->SetInterface(nullptr);
+        env->NotifyCurrentIteration(observations, false, 0.0, "", updateFn);
+        env->SetOpenGymInterface(openGymInterface);
+
+        auto obsSpace = DynamicCast<OpenGymBoxSpace>(env->GetObservationSpace());
+        auto actSpace = DynamicCast<OpenGymBoxSpace>(env->GetActionSpace());
+        NS_TEST_ASSERT_MSG_EQ((obsSpace->GetShape() == obsShape),
+                              true,
+                              "Step " << step << ": wrong observation space");
+        NS_TEST_ASSERT_MSG_EQ((actSpace->GetShape() == actShape),
+                              true,
+                              "Step " << step << ": wrong action space");
+
+        auto observation = DynamicCast<OpenGymBoxContainer<uint16_t>>(env->GetObservation());
+        NS_TEST_ASSERT_MSG_EQ((observation->GetShape() == obsShape),
+                              true,
+                              "Step " << step << ": wrong observation shape");
+        const std::vector<uint16_t>& data = observation->GetDataRef();
+        NS_TEST_ASSERT_MSG_EQ(data.size(), maxFlows * 7, "Wrong observation size");
+        for (uint32_t row = 0; row < maxFlows; ++row)
+        {
+            auto value = data.begin() + row * 7;
+            uint16_t rnti = rows[step][row];
+            if (rnti != 0)
+            {
+                auto expected = MakeGymTestObservation(rnti, 4);
+                NS_TEST_ASSERT_MSG_EQ(value[0], expected.rnti, "Step " << step << ": wrong RNTI");
+                NS_TEST_ASSERT_MSG_EQ(value[1], expected.lcId, "Wrong LC ID");
+                NS_TEST_ASSERT_MSG_EQ(value[2], expected.priority, "Wrong priority");
+                NS_TEST_ASSERT_MSG_EQ(value[3], expected.holDelay, "Wrong HOL delay");
+                NS_TEST_ASSERT_MSG_EQ(value[4], expected.aoi, "Wrong AoI");
+                NS_TEST_ASSERT_MSG_EQ(value[5], expected.cqi, "Wrong CQI");
+                NS_TEST_ASSERT_MSG_EQ(value[6], 1, "Row of a flow not marked valid");
+            }
+            else
+            {
+                for (uint32_t column = 0; column < 7; ++column)
+                {
+                    NS_TEST_ASSERT_MSG_EQ(value[column],
+                                          0,
+                                          "Step " << step << ": column " << column
+                                                  << " of the empty row " << row
+                                                  << " is not zero");
+                }
+            }
+        }
+
+        Ptr<OpenGymBoxContainer<float>> action =
+            CreateObject<OpenGymBoxContainer<float>>(actShape);
+        action->SetData({0.1F, 0.2F, 0.3F});
+        weights.clear();
+        NS_TEST_ASSERT_MSG_EQ(env->ExecuteActions(action), true, "The action matches no step");
+        NS_TEST_ASSERT_MSG_EQ(weights.size(),
+                              steps[step].size(),
+                              "Step " << step << ": the weights of the empty rows are not ignored");
+        for (uint32_t row = 0; row < maxFlows; ++row)
+        {
+            uint16_t rnti = rows[step][row];
+            if (rnti != 0)
+            {
+                NS_TEST_ASSERT_MSG_EQ_TOL(weights.at(rnti).at(4),
+                                          0.1F * (row + 1),
+                                          1e-6,
+                                          "Step " << step << ": wrong weight of row " << row);
+            }
+        }
+    }
+
+    env->Dispose();
+    Simulator::Destroy();
+}
+
+#endif // HAVE_OPENGYM
+
+/**
+ * \ingroup test
+ * \brief Test suite for the Gym environments of the AI scheduler
+ */
+class NrMacSchedulerAiGymEnvTestSuite : public TestSuite
+{
+  public:
+    NrMacSchedulerAiGymEnvTestSuite()
+        : TestSuite("nr-mac-scheduler-ai-gym-env", Type::UNIT)
+    {
+#ifdef HAVE_OPENGYM
+        AddTestCase(new NrGymEnvLayoutTestCase(), Duration::QUICK);
+        AddTestCase(new NrGymVecEnvLayoutTestCase(), Duration::QUICK);
+#endif
+    }
+};
+
+static NrMacSchedulerAiGymEnvTestSuite
+    g_nrMacSchedulerAiGymEnvTestSuite; //!< Gym environments test suite
+
+} // namespace ns3
@@ -0,0 +1,194 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-mac-scheduler-ai-policy.h>
+#include <ns3/string.h>
+#include <ns3/test.h>
+
+#include <cmath>
+#include <fstream>
+
+/**
+ * \file nr-mac-scheduler-ai-policy-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the in-process policies of the AI scheduler. The Q-table
+ * policy must choose the same weights as scratch/yeongym_agent.py in inference mode,
+ * and the MLP policy must match a reference evaluation of the network.
+ */
+namespace ns3
+{
+
+static NrMacSchedulerUeInfoAi::LcObservation
+MakeObservation(uint16_t rnti, uint8_t lcId, uint64_t aoi, uint8_t cqi)
+{
+    NrMacSchedulerUeInfoAi::LcObservation obs{};
+    obs.rnti = rnti;
+    obs.lcId = lcId;
+    obs.priority = 1;
+    obs.holDelay = 3;
+    obs.aoi = aoi;
+    obs.cqi = cqi;
+    return obs;
+}
+
+class NrMacSchedulerAiQTablePolicyTestCase : public TestCase
+{
+  public:
+    NrMacSchedulerAiQTablePolicyTestCase()
+        : TestCase("Q-table policy loaded from a .npy file")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrMacSchedulerAiQTablePolicyTestCase::DoRun()
+{
+    const uint32_t aoiBins = 10;
+    const uint32_t cqiBins = 5;
+    const uint32_t weightBins = 11;
+    // the best action of the state (a, c) is (a + c) % weightBins
+    std::vector<double> qTable(aoiBins * cqiBins * weightBins, 0.0);
+    for (uint32_t a = 0; a < aoiBins; ++a)
+    {
+        for (uint32_t c = 0; c < cqiBins; ++c)
+        {
+            qTable[(a * cqiBins + c) * weightBins + (a + c) % weightBins] = 1.0;
+        }
+    }
+
+    // .npy version 1.0, as written by np.save
+    std::string header = "{'descr': '<f8', 'fortran_order': False, 'shape': (10, 5, 11), }";
+    header.append(64 - (10 + header.size() + 1) % 64, ' ');
+    header.push_back('\n');
+    std::string fileName = CreateTempDirFilename("q_table.npy");
+    {
+        std::ofstream file(fileName, std::ios::binary);
+        file.write("\x93NUMPY\x01\x00", 8);
+        uint16_t len = header.size();
+        char lenBytes[2] = {static_cast<char>(len & 0xff), static_cast<char>(len >> 8)};
+        file.write(lenBytes, 2);
+        file.write(header.data(), header.size());
+        file.write(reinterpret_cast<const char*>(qTable.data()), qTable.size() * sizeof(double));
+    }
+
+    Ptr<NrMacSchedulerAiQTablePolicy> policy = CreateObject<NrMacSchedulerAiQTablePolicy>();
+    policy->SetAttribute("QTableFile", StringValue(fileName));
+
+    std::vector<NrMacSchedulerUeInfoAi::LcObservation> observations = {
+        MakeObservation(1, 4, 0, 0),        // bins (0, 0)
+        MakeObservation(2, 4, 2500, 7),     // bins (2, 2)
+        MakeObservation(3, 5, 9999, 15),    // bins (9, 4)
+        MakeObservation(4, 4, 65535, 3),    // AoI clamped to the last bin
+        MakeObservation(5, 4, 65536 + 1000, 3), // AoI truncated to 16 bits as in the gym
+    };
+    std::vector<uint32_t> expectedBest = {0, 4, 13 % weightBins, 9 + 1, 1 + 1};
+
+    NrMacSchedulerUeInfoAi::UeWeightsMap applied;
+    policy->NotifyCurrentIteration(
+        observations,
+        false,
+        0.0,
+        "",
+        [&applied](const NrMacSchedulerUeInfoAi::UeWeightsMap& weights) { applied = weights; });
+
+    NS_TEST_ASSERT_MSG_EQ(applied.size(), observations.size(), "One entry for each UE expected");
+    for (size_t i = 0; i < observations.size(); ++i)
+    {
+        double weight = applied.at(observations[i].rnti).at(observations[i].lcId);
+        NS_TEST_ASSERT_MSG_EQ_TOL(weight,
+                                  expectedBest[i] / 10.0,
+                                  1e-6,
+                                  "Unexpected weight for flow " << i);
+    }
+}
+
+class NrMacSchedulerAiMlpPolicyTestCase : public TestCase
+{
+  public:
+    NrMacSchedulerAiMlpPolicyTestCase()
+        : TestCase("MLP policy loaded from a flat weights file")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrMacSchedulerAiMlpPolicyTestCase::DoRun()
+{
+    const uint32_t nIn = NrMacSchedulerAiPolicy::NUM_FEATURES;
+    const uint32_t nHidden = 5;
+    std::vector<float> w1(nHidden * nIn);
+    std::vector<float> b1(nHidden);
+    std::vector<float> w2(nHidden);
+    std::vector<float> b2 = {-0.25F};
+    for (uint32_t o = 0; o < nHidden; ++o)
+    {
+        for (uint32_t i = 0; i < nIn; ++i)
+        {
+            w1[o * nIn + i] = 0.01F * ((o * 7 + i * 3) % 11) - 0.05F;
+        }
+        b1[o] = 0.1F * o - 0.2F;
+        w2[o] = 0.3F - 0.1F * o;
+    }
+
+    std::string fileName = CreateTempDirFilename("mlp.bin");
+    {
+        std::ofstream file(fileName, std::ios::binary);
+        for (const auto* v : {&w1, &b1, &w2, &b2})
+        {
+            file.write(reinterpret_cast<const char*>(v->data()), v->size() * sizeof(float));
+        }
+    }
+
+    Ptr<NrMacSchedulerAiMlpPolicy> policy = CreateObject<NrMacSchedulerAiMlpPolicy>();
+    policy->SetAttribute("LayerSizes", StringValue("6,5,1"));
+    policy->SetAttribute("WeightsFile", StringValue(fileName));
+
+    std::vector<NrMacSchedulerUeInfoAi::LcObservation> observations;
+    for (uint16_t rnti = 1; rnti <= 9; ++rnti)
+    {
+        observations.push_back(MakeObservation(rnti, 4, rnti * 37, rnti % 16));
+    }
+    std::vector<float> weights(observations.size());
+    policy->ComputeWeights(observations, weights);
+
+    for (size_t n = 0; n < observations.size(); ++n)
+    {
+        auto x = NrMacSchedulerAiPolicy::GetFeatures(observations[n]);
+        double out = b2[0];
+        for (uint32_t o = 0; o < nHidden; ++o)
+        {
+            double h = b1[o];
+            for (uint32_t i = 0; i < nIn; ++i)
+            {
+                h += w1[o * nIn + i] * x[i];
+            }
+            out += w2[o] * std::max(h, 0.0);
+        }
+        double expected = 1.0 / (1.0 + std::exp(-out));
+        NS_TEST_ASSERT_MSG_EQ_TOL(weights[n], expected, 1e-5, "Unexpected weight for flow " << n);
+    }
+}
+
+class NrMacSchedulerAiPolicyTestSuite : public TestSuite
+{
+  public:
+    NrMacSchedulerAiPolicyTestSuite()
+        : TestSuite("nr-mac-scheduler-ai-policy", Type::UNIT)
+    {
+        AddTestCase(new NrMacSchedulerAiQTablePolicyTestCase(), Duration::QUICK);
+        AddTestCase(new NrMacSchedulerAiMlpPolicyTestCase(), Duration::QUICK);
+    }
+};
+
+static NrMacSchedulerAiPolicyTestSuite g_nrMacSchedulerAiPolicyTestSuite; //!< AI policy test
+
+} // namespace ns3
@@ -0,0 +1,339 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/boolean.h>
+#include <ns3/enum.h>
+#include <ns3/nr-amc.h>
+#include <ns3/nr-aoi-timestamp-tracker.h>
+#include <ns3/nr-eps-bearer.h>
+#include <ns3/nr-mac-sched-sap.h>
+#include <ns3/nr-mac-scheduler-lcg.h>
+#include <ns3/nr-mac-scheduler-ofdma-ai.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+#include <set>
+
+/**
+ * \file nr-mac-scheduler-ofdma-ai-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the UL decision granularity of the AI scheduler. With two beams,
+ * the slot-level modes must query the model once per slot (or less) with the UEs of both
+ * beams, and the UL weights must be kept across slots only outside the PerRbg mode.
+ */
+namespace ns3
+{
+
+/**
+ * \ingroup test
+ * \brief A CSCHED SAP user which ignores all the confirmations
+ */
+class NrAiTestCschedSapUser : public NrMacCschedSapUser
+{
+  public:
+    void CschedCellConfigCnf(
+        [[maybe_unused]] const struct CschedCellConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigCnf(
+        [[maybe_unused]] const struct CschedUeConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcConfigCnf(
+        [[maybe_unused]] const struct CschedLcConfigCnfParameters& params) override
+    {
+    }
+
+    void CschedLcReleaseCnf(
+        [[maybe_unused]] const struct CschedLcReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeReleaseCnf(
+        [[maybe_unused]] const struct CschedUeReleaseCnfParameters& params) override
+    {
+    }
+
+    void CschedUeConfigUpdateInd(
+        [[maybe_unused]] const struct CschedUeConfigUpdateIndParameters& params) override
+    {
+    }
+
+    void CschedCellConfigUpdateInd(
+        [[maybe_unused]] const struct CschedCellConfigUpdateIndParameters& params) override
+    {
+    }
+};
+
+/**
+ * \ingroup test
+ * \brief A SCHED SAP user with hard-coded values and without AoI tracker
+ */
+class NrAiTestSchedSapUser : public NrMacSchedSapUser
+{
+  public:
+    void SchedConfigInd([[maybe_unused]] const struct SchedConfigIndParameters& params) override
+    {
+    }
+
+    Ptr<const SpectrumModel> GetSpectrumModel() const override
+    {
+        return nullptr;
+    }
+
+    uint32_t GetNumRbPerRbg() const override
+    {
+        return 1;
+    }
+
+    uint8_t GetNumHarqProcess() const override
+    {
+        return 20;
+    }
+
+    uint16_t GetBwpId() const override
+    {
+        return 0;
+    }
+
+    uint16_t GetCellId() const override
+    {
+        return 0;
+    }
+
+    uint32_t GetSymbolsPerSlot() const override
+    {
+        return 14;
+    }
+
+    Time GetSlotPeriod() const override
+    {
+        return MilliSeconds(1);
+    }
+
+    void BuildRarList([[maybe_unused]] SlotAllocInfo& allocInfo) override
+    {
+    }
+
+    Ptr<NrAoiTimestampTracker> GetAoiTimestampTracker() const override
+    {
+        return nullptr;
+    }
+};
+
+/**
+ * \ingroup test
+ * \brief Run the UL RBG assignment of a few slots with two beams, and count the queries
+ * to the AI model
+ */
+class NrTestSchedulerAiCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param granularity the UL decision granularity under test
+     * \param name the name of the granularity
+     */
+    NrTestSchedulerAiCase(NrMacSchedulerOfdmaAi::DecisionGranularity granularity,
+                          const std::string& name)
+        : TestCase("UL AI decision granularity " + name + " with two beams"),
+          m_granularity(granularity)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief The UL model: record the UEs of the observation, and give them a weight
+     * \param observations the observation of each active flow
+     * \param isGameOver unused
+     * \param reward unused
+     * \param extraInfo unused
+     * \param updateWeightsFn the function to update the weights of the UEs
+     */
+    void NotifyUl(const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+                  bool isGameOver,
+                  float reward,
+                  const std::string& extraInfo,
+                  const NrMacSchedulerUeInfoAi::UpdateAllUeWeightsFn& updateWeightsFn);
+
+    NrMacSchedulerOfdmaAi::DecisionGranularity m_granularity; //!< Granularity under test
+    std::vector<std::set<uint16_t>> m_queries; //!< RNTIs of each query in the current slot
+};
+
+void
+NrTestSchedulerAiCase::NotifyUl(
+    const std::vector<NrMacSchedulerUeInfoAi::LcObservation>& observations,
+    [[maybe_unused]] bool isGameOver,
+    [[maybe_unused]] float reward,
+    [[maybe_unused]] const std::string& extraInfo,
+    const NrMacSchedulerUeInfoAi::UpdateAllUeWeightsFn& updateWeightsFn)
+{
+    std::set<uint16_t> rntis;
+    NrMacSchedulerUeInfoAi::UeWeightsMap weights;
+    for (const auto& obs : observations)
+    {
+        rntis.insert(obs.rnti);
+        weights[obs.rnti][obs.lcId] = 1.0;
+    }
+    m_queries.push_back(rntis);
+    updateWeightsFn(weights);
+}
+
+void
+NrTestSchedulerAiCase::DoRun()
+{
+    NrAiTestCschedSapUser cschedSapUser;
+    NrAiTestSchedSapUser schedSapUser;
+    const uint16_t bandwidthInRbg = 4;
+
+    Ptr<NrMacSchedulerOfdmaAi> sched = CreateObject<NrMacSchedulerOfdmaAi>();
+    sched->SetAttribute("ActiveUlAi", BooleanValue(true));
+    sched->SetAttribute("UlDecisionGranularity", EnumValue(m_granularity));
+    sched->SetAttribute("UlDecisionPeriod", UintegerValue(2));
+    sched->SetAttribute("NotifyCbUl",
+                        CallbackValue(MakeCallback(&NrTestSchedulerAiCase::NotifyUl, this)));
+    sched->SetMacCschedSapUser(&cschedSapUser);
+    sched->SetMacSchedSapUser(&schedSapUser);
+    sched->InstallUlAmc(CreateObject<NrAmc>());
+
+    NrMacCschedSapProvider::CschedCellConfigReqParameters cellConfig;
+    cellConfig.m_ulBandwidth = bandwidthInRbg;
+    cellConfig.m_dlBandwidth = bandwidthInRbg;
+    sched->DoCschedCellConfigReq(cellConfig);
+
+    // Two UEs in each of two beams, each with a UL flow that is never served in a slot
+    std::vector<std::shared_ptr<NrMacSchedulerUeInfoAi>> ues;
+    NrMacSchedulerNs3::ActiveUeMap activeUl;
+    for (uint16_t rnti = 1; rnti <= 4; ++rnti)
+    {
+        NrMacCschedSapProvider::CschedUeConfigReqParameters params;
+        params.m_rnti = rnti;
+        params.m_beamId = BeamId(rnti <= 2 ? 0 : 1, 90.0);
+        auto ue = std::dynamic_pointer_cast<NrMacSchedulerUeInfoAi>(
+            sched->CreateUeRepresentation(params));
+
+        nr::LogicalChannelConfigListElement_s lcConfig;
+        lcConfig.m_logicalChannelIdentity = 4;
+        lcConfig.m_logicalChannelGroup = 1;
+        lcConfig.m_qci = NrEpsBearer::NGBR_VIDEO_TCP_DEFAULT;
+        auto lcg = std::make_unique<NrMacSchedulerLCG>(1);
+        lcg->Insert(std::make_unique<NrMacSchedulerLC>(lcConfig));
+        lcg->UpdateInfo(1000000);
+        ue->m_ulLCG.emplace(1, std::move(lcg));
+
+        ues.push_back(ue);
+        activeUl[params.m_beamId].emplace_back(ue, 1000000);
+    }
+    const std::set<uint16_t> allRntis = {1, 2, 3, 4};
+
+    const uint32_t numSlots = 4;
+    for (uint32_t slot = 0; slot < numSlots; ++slot)
+    {
+        if (slot == numSlots - 1)
+        {
+            // A UE of the second beam becomes inactive
+            activeUl[BeamId(1, 90.0)].pop_back();
+        }
+        m_queries.clear();
+        // as DoScheduleUl: the slot-level decision, then the RBG assignment
+        sched->PrepareUlDataSched(activeUl);
+        sched->AssignULRBG(12, activeUl);
+
+        switch (m_granularity)
+        {
+        case NrMacSchedulerOfdmaAi::PER_RBG:
+            // One query for each RBG of each beam, with the UEs of that beam
+            NS_TEST_ASSERT_MSG_EQ(m_queries.size(),
+                                  2U * bandwidthInRbg,
+                                  "Slot " << slot << ": one query per RBG and beam expected");
+            for (const auto& query : m_queries)
+            {
+                bool firstBeam = query == std::set<uint16_t>{1, 2};
+                bool secondBeam = query == (slot == numSlots - 1 ? std::set<uint16_t>{3}
+                                                                 : std::set<uint16_t>{3, 4});
+                NS_TEST_ASSERT_MSG_EQ((firstBeam || secondBeam),
+                                      true,
+                                      "Slot " << slot << ": a query must cover one beam");
+            }
+            break;
+        case NrMacSchedulerOfdmaAi::PER_SLOT:
+            NS_TEST_ASSERT_MSG_EQ(m_queries.size(),
+                                  1,
+                                  "Slot " << slot << ": one query per slot expected");
+            break;
+        case NrMacSchedulerOfdmaAi::EVERY_N_SLOTS:
+            NS_TEST_ASSERT_MSG_EQ(m_queries.size(),
+                                  (slot % 2 == 0 ? 1 : 0),
+                                  "Slot " << slot << ": one query every 2 slots expected");
+            break;
+        case NrMacSchedulerOfdmaAi::ON_UE_SET_CHANGE:
+            NS_TEST_ASSERT_MSG_EQ(m_queries.size(),
+                                  (slot == 0 || slot == numSlots - 1 ? 1 : 0),
+                                  "Slot " << slot << ": one query per change of UEs expected");
+            break;
+        }
+
+        if (m_granularity != NrMacSchedulerOfdmaAi::PER_RBG && !m_queries.empty())
+        {
+            std::set<uint16_t> expected = allRntis;
+            if (slot == numSlots - 1)
+            {
+                expected.erase(4);
+            }
+            NS_TEST_ASSERT_MSG_EQ((m_queries.front() == expected),
+                                  true,
+                                  "Slot " << slot << ": the query must cover both beams");
+        }
+
+        for (auto& beam : activeUl)
+        {
+            for (auto& ue : beam.second)
+            {
+                ue.first->ResetUlSchedInfo();
+            }
+        }
+        for (const auto& ue : ues)
+        {
+            if (slot == numSlots - 1 && ue->m_rnti == 4)
+            {
+                continue;
+            }
+            NS_TEST_ASSERT_MSG_EQ(ue->m_weightsUl.empty(),
+                                  (m_granularity == NrMacSchedulerOfdmaAi::PER_RBG),
+                                  "Slot " << slot << ": UL weights of UE " << ue->m_rnti
+                                          << " must be kept only outside PerRbg");
+        }
+    }
+}
+
+/**
+ * \ingroup test
+ * \brief Test suite for the UL decision granularity of the AI scheduler
+ */
+class NrTestSchedulerAiSuite : public TestSuite
+{
+  public:
+    NrTestSchedulerAiSuite()
+        : TestSuite("nr-mac-scheduler-ofdma-ai", Type::UNIT)
+    {
+        AddTestCase(new NrTestSchedulerAiCase(NrMacSchedulerOfdmaAi::PER_RBG, "PerRbg"),
+                    Duration::QUICK);
+        AddTestCase(new NrTestSchedulerAiCase(NrMacSchedulerOfdmaAi::PER_SLOT, "PerSlot"),
+                    Duration::QUICK);
+        AddTestCase(new NrTestSchedulerAiCase(NrMacSchedulerOfdmaAi::EVERY_N_SLOTS, "EveryNSlots"),
+                    Duration::QUICK);
+        AddTestCase(
+            new NrTestSchedulerAiCase(NrMacSchedulerOfdmaAi::ON_UE_SET_CHANGE, "OnUeSetChange"),
+            Duration::QUICK);
+    }
+};
+
+static NrTestSchedulerAiSuite g_nrTestSchedulerAiSuite; //!< AI scheduler decision granularity test
+
+} // namespace ns3
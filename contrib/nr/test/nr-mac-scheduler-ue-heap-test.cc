@@ -0,0 +1,168 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-mac-scheduler-ue-heap.h>
+#include <ns3/nr-mac-scheduler-ue-info.h>
+#include <ns3/test.h>
+
+#include <algorithm>
+#include <random>
+
+/**
+ * \file nr-mac-scheduler-ue-heap-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the heap that orders the UEs in the OFDMA schedulers. The UEs
+ * must leave the heap in the order of std::stable_sort with the same policy, also after
+ * their metrics are updated one at a time or all together.
+ */
+namespace ns3
+{
+
+class NrMacSchedulerUeHeapTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param useKey whether the policy is given as a sort key or as a comparison function
+     */
+    NrMacSchedulerUeHeapTestCase(bool useKey)
+        : TestCase(useKey ? "UE heap ordered by a sort key"
+                          : "UE heap ordered by a comparison function"),
+          m_useKey(useKey)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Pop all the UEs and check their order against std::stable_sort
+     * \param heap the heap, built on ues
+     * \param ues the UEs
+     * \param what the step under test
+     */
+    void CheckOrder(NrMacSchedulerUeHeap& heap,
+                    const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ues,
+                    const std::string& what);
+
+    bool m_useKey;                 //!< Use the sort key instead of the comparison function
+    std::vector<double> m_metrics; //!< Metric of each UE, by RNTI
+};
+
+void
+NrMacSchedulerUeHeapTestCase::CheckOrder(
+    NrMacSchedulerUeHeap& heap,
+    const std::vector<NrMacSchedulerNs3::UePtrAndBufferReq>& ues,
+    const std::string& what)
+{
+    auto compare = [this](const NrMacSchedulerNs3::UePtrAndBufferReq& lhs,
+                          const NrMacSchedulerNs3::UePtrAndBufferReq& rhs) {
+        return m_metrics[lhs.first->m_rnti] > m_metrics[rhs.first->m_rnti];
+    };
+    std::vector<NrMacSchedulerNs3::UePtrAndBufferReq> sorted = ues;
+    std::stable_sort(sorted.begin(), sorted.end(), compare);
+
+    for (const auto& expected : sorted)
+    {
+        NS_TEST_ASSERT_MSG_EQ(heap.IsEmpty(), false, what << ": heap empty too early");
+        NS_TEST_ASSERT_MSG_EQ(ues[heap.GetTop()].first->m_rnti,
+                              expected.first->m_rnti,
+                              what << ": unexpected UE order");
+        heap.Pop();
+    }
+    NS_TEST_ASSERT_MSG_EQ(heap.IsEmpty(), true, what << ": UEs left in the heap");
+}
+
+void
+NrMacSchedulerUeHeapTestCase::DoRun()
+{
+    const uint32_t numUes = 37;
+    std::mt19937 rng(7);
+    // few distinct values, so that ties are frequent
+    std::uniform_int_distribution<int> metric(0, 9);
+
+    std::vector<NrMacSchedulerNs3::UePtrAndBufferReq> ues;
+    m_metrics.assign(numUes, 0.0);
+    for (uint16_t rnti = 0; rnti < numUes; ++rnti)
+    {
+        auto ue =
+            std::make_shared<NrMacSchedulerUeInfo>(rnti, BeamId(), []() -> uint32_t { return 1; });
+        ues.emplace_back(ue, 100);
+        m_metrics[rnti] = metric(rng);
+    }
+
+    NrMacSchedulerUeHeap::KeyFn keyFn;
+    NrMacSchedulerUeHeap::CompareFn compareFn;
+    if (m_useKey)
+    {
+        keyFn = [this](const NrMacSchedulerNs3::UePtrAndBufferReq& ue) {
+            return m_metrics[ue.first->m_rnti];
+        };
+    }
+    else
+    {
+        compareFn = [this](const NrMacSchedulerNs3::UePtrAndBufferReq& lhs,
+                           const NrMacSchedulerNs3::UePtrAndBufferReq& rhs) {
+            return m_metrics[lhs.first->m_rnti] > m_metrics[rhs.first->m_rnti];
+        };
+    }
+
+    NrMacSchedulerUeHeap heap;
+    heap.Build(ues, keyFn, compareFn);
+    CheckOrder(heap, ues, "Build");
+
+    // Serve the top UE many times, lowering its metric as an assignment would
+    heap.Build(ues, keyFn, compareFn);
+    for (uint32_t rbg = 0; rbg < 200; ++rbg)
+    {
+        uint32_t top = heap.GetTop();
+        m_metrics[ues[top].first->m_rnti] -= metric(rng) / 10.0;
+        heap.Update(top);
+    }
+    // and raise the metric of a UE in the middle of the heap
+    m_metrics[ues[numUes / 2].first->m_rnti] += 100.0;
+    heap.Update(numUes / 2);
+    CheckOrder(heap, ues, "Update");
+
+    // Change all the metrics
+    heap.Build(ues, keyFn, compareFn);
+    heap.Pop();
+    heap.Pop();
+    for (auto& m : m_metrics)
+    {
+        m = metric(rng);
+    }
+    heap.Refresh();
+    std::vector<NrMacSchedulerNs3::UePtrAndBufferReq> left;
+    NrMacSchedulerUeHeap copy = heap;
+    while (!copy.IsEmpty())
+    {
+        left.push_back(ues[copy.GetTop()]);
+        copy.Pop();
+    }
+    NS_TEST_ASSERT_MSG_EQ(left.size(), numUes - 2, "Two UEs were popped");
+    for (size_t i = 1; i < left.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ((m_metrics[left[i - 1].first->m_rnti] >=
+                               m_metrics[left[i].first->m_rnti]),
+                              true,
+                              "Refresh: UEs not in decreasing metric order");
+    }
+}
+
+class NrMacSchedulerUeHeapTestSuite : public TestSuite
+{
+  public:
+    NrMacSchedulerUeHeapTestSuite()
+        : TestSuite("nr-mac-scheduler-ue-heap", Type::UNIT)
+    {
+        AddTestCase(new NrMacSchedulerUeHeapTestCase(true), Duration::QUICK);
+        AddTestCase(new NrMacSchedulerUeHeapTestCase(false), Duration::QUICK);
+    }
+};
+
+static NrMacSchedulerUeHeapTestSuite g_nrMacSchedulerUeHeapTestSuite; //!< UE heap test suite
+
+} // namespace ns3
@@ -0,0 +1,307 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-mimo-matrices.h>
+#include <ns3/nr-mimo-small-matrices.h>
+#include <ns3/test.h>
+
+#include <Eigen/Dense>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+/**
+ * \file nr-mimo-small-matrices-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing of the fixed-size kernels of the MIMO matrices: the covariance matrices,
+ * the interference-normalized channel matrices and the SINR values computed for up to
+ * NrMimoKernels::MAX_DIM ports and layers must be the same as with a reference computed with
+ * Eigen. A performance suite times both implementations for each RB.
+ */
+
+using namespace ns3;
+
+/// Dynamic-size Eigen matrix mapped on a page of a ComplexMatrixArray
+using EigenPage = Eigen::Map<Eigen::MatrixXcd>;
+/// Dynamic-size Eigen matrix mapped on a constant page of a ComplexMatrixArray
+using ConstEigenPage = Eigen::Map<const Eigen::MatrixXcd>;
+
+/**
+ * \brief Reference interference-normalized channel, inv(L) * H with L the lower Cholesky
+ * factor of the covariance matrix, computed with Eigen for each RB
+ * \param covMat the covariance matrix (dim: nRxPorts * nRxPorts * nRbs)
+ * \param chanMat the channel matrix (dim: nRxPorts * nTxPorts * nRbs)
+ * \return the interference-normalized channel matrix
+ */
+static ComplexMatrixArray
+ReferenceIntfNormChannel(const ComplexMatrixArray& covMat, const ComplexMatrixArray& chanMat)
+{
+    ComplexMatrixArray res{chanMat.GetNumRows(), chanMat.GetNumCols(), chanMat.GetNumPages()};
+    for (size_t iRb = 0; iRb < chanMat.GetNumPages(); iRb++)
+    {
+        ConstEigenPage cov(covMat.GetPagePtr(iRb), covMat.GetNumRows(), covMat.GetNumCols());
+        ConstEigenPage chan(chanMat.GetPagePtr(iRb), chanMat.GetNumRows(), chanMat.GetNumCols());
+        EigenPage(res.GetPagePtr(iRb), res.GetNumRows(), res.GetNumCols()) =
+            cov.selfadjointView<Eigen::Upper>().llt().matrixL().solve(chan);
+    }
+    return res;
+}
+
+/**
+ * \brief Reference SINR of an MMSE receiver, 1 / diag(inv(I + P' * H' * H * P)) - 1, computed
+ * with Eigen for each RB
+ * \param normChanMat the interference-normalized channel matrix H
+ * \param precMats the precoding matrices P (dim: nTxPorts * rank * nRbs)
+ * \returns the SINR values for each layer and RB (dim: rank x nRbs)
+ */
+static NrSinrMatrix
+ReferenceSinr(const ComplexMatrixArray& normChanMat, const ComplexMatrixArray& precMats)
+{
+    auto rank = precMats.GetNumCols();
+    auto res = NrSinrMatrix{static_cast<uint8_t>(rank), precMats.GetNumPages()};
+    for (size_t iRb = 0; iRb < precMats.GetNumPages(); iRb++)
+    {
+        ConstEigenPage chan(normChanMat.GetPagePtr(iRb),
+                            normChanMat.GetNumRows(),
+                            normChanMat.GetNumCols());
+        ConstEigenPage prec(precMats.GetPagePtr(iRb), precMats.GetNumRows(), rank);
+        Eigen::MatrixXcd chanPrec = chan * prec;
+        Eigen::MatrixXcd mse =
+            (Eigen::MatrixXcd::Identity(rank, rank) + chanPrec.adjoint() * chanPrec).inverse();
+        for (size_t layer = 0; layer < rank; layer++)
+        {
+            res(layer, iRb) = 1.0 / std::real(mse(layer, layer)) - 1.0;
+        }
+    }
+    return res;
+}
+
+/**
+ * \brief Random MIMO matrices of the tests
+ */
+class NrMimoRandomMatrices
+{
+  public:
+    /**
+     * \brief Create a random matrix with unit-power Gaussian elements
+     * \param nRows the number of rows
+     * \param nCols the number of columns
+     * \param nPages the number of pages
+     * \return the matrix
+     */
+    ComplexMatrixArray CreateMatrix(size_t nRows, size_t nCols, size_t nPages)
+    {
+        ComplexMatrixArray res{nRows, nCols, nPages};
+        for (size_t p = 0; p < nPages; p++)
+        {
+            for (size_t j = 0; j < nCols; j++)
+            {
+                for (size_t i = 0; i < nRows; i++)
+                {
+                    res(i, j, p) = {m_normal(m_generator), m_normal(m_generator)};
+                }
+            }
+        }
+        return res;
+    }
+
+    /**
+     * \brief Create a covariance matrix with noise and one interferer of 4 ports
+     * \param nRxPorts the number of receive ports
+     * \param nRbs the number of RBs
+     * \return the covariance matrix
+     */
+    NrCovMat CreateCovMat(size_t nRxPorts, size_t nRbs)
+    {
+        NrCovMat res{ComplexMatrixArray{nRxPorts, nRxPorts, nRbs}};
+        for (size_t iRb = 0; iRb < nRbs; iRb++)
+        {
+            for (size_t i = 0; i < nRxPorts; i++)
+            {
+                res(i, i, iRb) = 0.1;
+            }
+        }
+        auto intf = CreateMatrix(nRxPorts, 4, nRbs);
+        res += intf * intf.HermitianTranspose();
+        return res;
+    }
+
+  private:
+    std::mt19937 m_generator{1};                                 //!< Generator
+    std::normal_distribution<double> m_normal{0.0, std::sqrt(0.5)}; //!< Gaussian distribution
+};
+
+/**
+ * \brief Check that the fixed-size kernels compute the same matrices as the Eigen reference,
+ * for all the dimensions up to NrMimoKernels::MAX_DIM
+ */
+class NrMimoSmallMatricesTestCase : public TestCase
+{
+  public:
+    NrMimoSmallMatricesTestCase()
+        : TestCase("Fixed-size kernels of the MIMO matrices")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrMimoSmallMatricesTestCase::DoRun()
+{
+    const size_t nRbs = 10;
+    const double tol = 1e-9;
+    NrMimoRandomMatrices random;
+    for (size_t nRx = 1; nRx <= NrMimoKernels::MAX_DIM; nRx++)
+    {
+        for (size_t nTx = 1; nTx <= NrMimoKernels::MAX_DIM; nTx++)
+        {
+            std::ostringstream msg;
+            msg << nRx << "x" << nTx;
+            auto chanMat = random.CreateMatrix(nRx, nTx, nRbs);
+            auto covMat = random.CreateCovMat(nRx, nRbs);
+
+            auto sum = covMat;
+            sum.AddInterferenceSignal(chanMat);
+            ComplexMatrixArray expected = covMat + chanMat * chanMat.HermitianTranspose();
+            NS_TEST_EXPECT_MSG_EQ(sum.IsAlmostEqual(expected, tol),
+                                  true,
+                                  msg.str() << ": wrong sum of covariance matrices");
+            sum.SubtractInterferenceSignal(chanMat);
+            NS_TEST_EXPECT_MSG_EQ(sum.IsAlmostEqual(covMat, tol),
+                                  true,
+                                  msg.str() << ": wrong difference of covariance matrices");
+
+            if (nRx == 1 && nTx == 1)
+            {
+                continue; // SISO does not use the MIMO kernels
+            }
+            auto normChanMat = covMat.CalcIntfNormChannel(chanMat);
+            auto normChanMatRef = ReferenceIntfNormChannel(covMat, chanMat);
+            NS_TEST_EXPECT_MSG_EQ(normChanMat.IsAlmostEqual(normChanMatRef, tol),
+                                  true,
+                                  msg.str() << ": wrong interference-normalized channel");
+
+            for (size_t rank = 1; rank <= nTx; rank++)
+            {
+                auto precMats = random.CreateMatrix(nTx, rank, nRbs);
+                auto sinr = normChanMat.ComputeSinrForPrecoding(precMats);
+                auto sinrRef = ReferenceSinr(normChanMat, precMats);
+                NS_TEST_EXPECT_MSG_EQ(+sinr.GetRank(), rank, msg.str() << ": wrong rank");
+                NS_TEST_EXPECT_MSG_EQ(sinr.IsAlmostEqual(sinrRef, tol),
+                                      true,
+                                      msg.str() << " rank " << rank << ": wrong SINR");
+            }
+        }
+    }
+}
+
+/**
+ * \brief Time the fixed-size kernels of the MIMO matrices and the Eigen reference, per RB
+ */
+class NrMimoSmallMatricesBenchmark : public TestCase
+{
+  public:
+    NrMimoSmallMatricesBenchmark()
+        : TestCase("Benchmark of the fixed-size kernels of the MIMO matrices")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Time a function
+     * \param f the function, called for all the RBs
+     * \return the time per RB in ns
+     */
+    template <class F>
+    static double TimePerRb(F f);
+
+    static constexpr size_t N_RBS = 273;       //!< Number of RBs, 100 MHz with 30 kHz SCS
+    static constexpr size_t REPETITIONS = 200; //!< Number of repetitions
+};
+
+template <class F>
+double
+NrMimoSmallMatricesBenchmark::TimePerRb(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < REPETITIONS; i++)
+    {
+        f();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() /
+           (REPETITIONS * N_RBS);
+}
+
+void
+NrMimoSmallMatricesBenchmark::DoRun()
+{
+    NrMimoRandomMatrices random;
+    std::cout << "MIMO matrices, ns per RB: ports, rank, fixed-size / Eigen reference" << std::endl;
+    for (size_t nPorts : {2, 4})
+    {
+        auto chanMat = random.CreateMatrix(nPorts, nPorts, N_RBS);
+        auto covMat = random.CreateCovMat(nPorts, N_RBS);
+        auto normChanMat = covMat.CalcIntfNormChannel(chanMat);
+        double checksum = 0;
+
+        auto sum = covMat;
+        auto covFixed = TimePerRb([&]() { sum.AddInterferenceSignal(chanMat); });
+        auto covGeneric = TimePerRb([&]() { sum += chanMat * chanMat.HermitianTranspose(); });
+        auto normFixed =
+            TimePerRb([&]() { checksum += covMat.CalcIntfNormChannel(chanMat)(0, 0, 0).real(); });
+        auto normRef = TimePerRb(
+            [&]() { checksum += ReferenceIntfNormChannel(covMat, chanMat)(0, 0, 0).real(); });
+        std::cout << std::fixed << std::setprecision(1) << "covariance " << nPorts << "x"
+                  << nPorts << ": " << covFixed << " / " << covGeneric << std::endl;
+        std::cout << "interference normalization " << nPorts << "x" << nPorts << ": "
+                  << normFixed << " / " << normRef << std::endl;
+
+        for (size_t rank = 1; rank <= nPorts; rank++)
+        {
+            auto precMats = random.CreateMatrix(nPorts, rank, N_RBS);
+            auto sinrFixed = TimePerRb(
+                [&]() { checksum += normChanMat.ComputeSinrForPrecoding(precMats)(0, 0); });
+            auto sinrRef =
+                TimePerRb([&]() { checksum += ReferenceSinr(normChanMat, precMats)(0, 0); });
+            std::cout << "SINR " << nPorts << "x" << nPorts << " rank " << rank << ": "
+                      << sinrFixed << " / " << sinrRef << std::endl;
+        }
+        NS_TEST_EXPECT_MSG_EQ(std::isfinite(checksum), true, "Invalid results");
+    }
+}
+
+class NrMimoSmallMatricesTestSuite : public TestSuite
+{
+  public:
+    NrMimoSmallMatricesTestSuite()
+        : TestSuite("nr-mimo-small-matrices", Type::UNIT)
+    {
+        AddTestCase(new NrMimoSmallMatricesTestCase(), Duration::QUICK);
+    }
+};
+
+/// Fixed-size MIMO kernels test suite
+static NrMimoSmallMatricesTestSuite g_nrMimoSmallMatricesTestSuite;
+
+class NrMimoSmallMatricesPerfTestSuite : public TestSuite
+{
+  public:
+    NrMimoSmallMatricesPerfTestSuite()
+        : TestSuite("nr-mimo-small-matrices-perf", Type::PERFORMANCE)
+    {
+        AddTestCase(new NrMimoSmallMatricesBenchmark(), Duration::QUICK);
+    }
+};
+
+/// Fixed-size MIMO kernels benchmark suite
+static NrMimoSmallMatricesPerfTestSuite g_nrMimoSmallMatricesPerfTestSuite;
@@ -0,0 +1,228 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/boolean.h>
+#include <ns3/enum.h>
+#include <ns3/nr-amc.h>
+#include <ns3/nr-cb-type-one-sp.h>
+#include <ns3/nr-eesm-ir-t1.h>
+#include <ns3/nr-pm-search-full.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+#include <cmath>
+#include <random>
+#include <sstream>
+
+/**
+ * \file nr-pm-search-full-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the search of NrPmSearchFull: the CQI/PMI/RI feedback must be the
+ * same when the wideband precoding matrices are evaluated by several threads, the upper bound
+ * of the capacity of each rank must not be smaller than the capacity of its optimal precoding
+ * matrix, and with the rank pruning, the rank 2 must be skipped for a rank-1 channel along a
+ * precoding matrix of the codebook, without changing the feedback.
+ */
+namespace ns3
+{
+
+/**
+ * \brief NrPmSearchFull with access to the capacity bound and to the optimal precoding
+ * matrices of each rank
+ */
+class NrPmSearchFullTestAccess : public NrPmSearchFull
+{
+  public:
+    using NrPmSearchFull::ComputeCapacityUpperBound;
+    using NrPmSearchFull::m_rankParams;
+};
+
+class NrPmSearchFullTestCase : public TestCase
+{
+  public:
+    NrPmSearchFullTestCase()
+        : TestCase("Parallel and pruned search of NrPmSearchFull")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Create a search engine for a gNB with 2x1 dual-polarized ports and a UE with 2 ports
+     * \param numThreads the number of threads
+     * \param rankPruning whether the ranks that cannot win are skipped
+     * \return the search engine
+     */
+    Ptr<NrPmSearchFullTestAccess> CreatePmSearch(uint32_t numThreads, bool rankPruning) const;
+
+    /**
+     * \brief Check that two feedback messages are the same
+     * \param actual the feedback to check
+     * \param expected the expected feedback
+     * \param msg the context of the check
+     */
+    void CheckFeedback(const PmCqiInfo& actual, const PmCqiInfo& expected, std::string msg);
+
+    /**
+     * \brief Create a received signal with a noise covariance equal to the identity
+     * \param chanMat the channel matrix
+     * \return the received signal
+     */
+    static NrMimoSignal CreateSignal(const ComplexMatrixArray& chanMat);
+
+    Ptr<NrAmc> m_amc; //!< The AMC of the search engines
+};
+
+Ptr<NrPmSearchFullTestAccess>
+NrPmSearchFullTestCase::CreatePmSearch(uint32_t numThreads, bool rankPruning) const
+{
+    auto pmSearch = CreateObject<NrPmSearchFullTestAccess>();
+    pmSearch->SetAttribute("CodebookType", TypeIdValue(NrCbTypeOneSp::GetTypeId()));
+    pmSearch->SetAttribute("SubbandSize", UintegerValue(4));
+    pmSearch->SetAttribute("NumThreads", UintegerValue(numThreads));
+    pmSearch->SetAttribute("RankPruning", BooleanValue(rankPruning));
+    pmSearch->SetAmc(m_amc);
+    pmSearch->SetGnbParams(true, 2, 1);
+    pmSearch->SetUeParams(2);
+    pmSearch->InitCodebooks();
+    return pmSearch;
+}
+
+void
+NrPmSearchFullTestCase::CheckFeedback(const PmCqiInfo& actual,
+                                      const PmCqiInfo& expected,
+                                      std::string msg)
+{
+    NS_TEST_EXPECT_MSG_EQ(+actual.m_rank, +expected.m_rank, msg << ": rank differs");
+    NS_TEST_EXPECT_MSG_EQ(actual.m_wbPmi, expected.m_wbPmi, msg << ": wideband PMI differs");
+    NS_TEST_EXPECT_MSG_EQ((actual.m_sbPmis == expected.m_sbPmis),
+                          true,
+                          msg << ": subband PMIs differ");
+    NS_TEST_EXPECT_MSG_EQ(+actual.m_mcs, +expected.m_mcs, msg << ": MCS differs");
+    NS_TEST_EXPECT_MSG_EQ(actual.m_tbSize, expected.m_tbSize, msg << ": TB size differs");
+    NS_TEST_EXPECT_MSG_EQ((*actual.m_optPrecMat == *expected.m_optPrecMat),
+                          true,
+                          msg << ": precoding matrix differs");
+}
+
+NrMimoSignal
+NrPmSearchFullTestCase::CreateSignal(const ComplexMatrixArray& chanMat)
+{
+    MimoSignalChunk chunk;
+    chunk.chanSpct = chanMat;
+    chunk.interfNoiseCov = NrCovMat{ComplexMatrixArray{2, 2, chanMat.GetNumPages()}};
+    for (size_t iRb = 0; iRb < chanMat.GetNumPages(); iRb++)
+    {
+        chunk.interfNoiseCov(0, 0, iRb) = 1.0;
+        chunk.interfNoiseCov(1, 1, iRb) = 1.0;
+    }
+    chunk.dur = NanoSeconds(1);
+    return NrMimoSignal{{chunk}};
+}
+
+void
+NrPmSearchFullTestCase::DoRun()
+{
+    const size_t numRbs = 24;
+    m_amc = CreateObject<NrAmc>();
+    m_amc->SetAttribute("AmcModel", EnumValue(NrAmc::ErrorModel));
+    m_amc->SetAttribute("ErrorModelType", TypeIdValue(NrEesmIrT1::GetTypeId()));
+    m_amc->SetDlMode();
+
+    auto serial = CreatePmSearch(0, false);
+    auto parallel = CreatePmSearch(4, false);
+    auto pmiUpdateWb = NrPmSearch::PmiUpdate{true, true};
+    auto pmiUpdateSb = NrPmSearch::PmiUpdate{false, true};
+
+    // Frequency-selective Rayleigh channels, from -5 to 25 dB
+    std::mt19937 generator(1);
+    std::normal_distribution<double> normal(0.0, std::sqrt(0.5));
+    for (int snrDb = -5; snrDb <= 25; snrDb += 5)
+    {
+        auto amplitude = std::pow(10.0, snrDb / 20.0);
+        ComplexMatrixArray chanMat{2, 4, numRbs};
+        for (size_t i = 0; i < 2; i++)
+        {
+            for (size_t j = 0; j < 4; j++)
+            {
+                std::complex<double> tap0{normal(generator), normal(generator)};
+                std::complex<double> tap1{normal(generator), normal(generator)};
+                for (size_t iRb = 0; iRb < numRbs; iRb++)
+                {
+                    auto phase = std::polar(1.0, -2 * M_PI * iRb / 8.0);
+                    chanMat(i, j, iRb) = amplitude * (tap0 + tap1 * phase) / std::sqrt(2.0);
+                }
+            }
+        }
+        auto signal = CreateSignal(chanMat);
+        std::ostringstream msg;
+        msg << "SNR " << snrDb << " dB";
+
+        auto serialCqi = serial->CreateCqiFeedbackMimo(signal, pmiUpdateWb);
+        auto parallelCqi = parallel->CreateCqiFeedbackMimo(signal, pmiUpdateWb);
+        CheckFeedback(parallelCqi, serialCqi, msg.str() + ", wideband update");
+        serialCqi = serial->CreateCqiFeedbackMimo(signal, pmiUpdateSb);
+        parallelCqi = parallel->CreateCqiFeedbackMimo(signal, pmiUpdateSb);
+        CheckFeedback(parallelCqi, serialCqi, msg.str() + ", subband update");
+
+        // The bound of each rank is not smaller than the capacity of its optimal precoding
+        serial->CreateCqiFeedbackMimo(signal, pmiUpdateWb);
+        auto sbNormChanMat =
+            serial->SubbandDownsampling(signal.m_covMat.CalcIntfNormChannel(signal.m_chanMat));
+        for (uint8_t rank = 1; rank <= 2; rank++)
+        {
+            auto capacity = serial->m_rankParams[rank].precParams->perfMetric;
+            NS_TEST_EXPECT_MSG_GT_OR_EQ(serial->ComputeCapacityUpperBound(sbNormChanMat, rank),
+                                        capacity * (1 - 1e-9),
+                                        msg.str() << ": bound of rank " << +rank);
+        }
+    }
+
+    // A rank-1 channel along a precoding matrix of the codebook: the rank 2 cannot win
+    auto cb = CreateObjectWithAttributes<NrCbTypeOneSp>("N1",
+                                                        UintegerValue(2),
+                                                        "N2",
+                                                        UintegerValue(1),
+                                                        "IsDualPol",
+                                                        BooleanValue(true),
+                                                        "Rank",
+                                                        UintegerValue(1));
+    cb->Init();
+    auto precMat = cb->GetBasePrecMat(1, 2);
+    ComplexMatrixArray chanMat{2, 4, numRbs};
+    for (size_t iRb = 0; iRb < numRbs; iRb++)
+    {
+        for (size_t j = 0; j < 4; j++)
+        {
+            chanMat(0, j, iRb) = 10.0 * std::conj(precMat(j, 0));
+            chanMat(1, j, iRb) = 5.0 * std::conj(precMat(j, 0));
+        }
+    }
+    auto signal = CreateSignal(chanMat);
+    auto pruned = CreatePmSearch(0, true);
+    auto prunedCqi = pruned->CreateCqiFeedbackMimo(signal, pmiUpdateWb);
+    auto serialCqi = serial->CreateCqiFeedbackMimo(signal, pmiUpdateWb);
+    CheckFeedback(prunedCqi, serialCqi, "Rank-1 channel");
+    NS_TEST_EXPECT_MSG_EQ(+prunedCqi.m_rank, 1, "Wrong rank for a rank-1 channel");
+    NS_TEST_EXPECT_MSG_EQ(pruned->m_rankParams[2].precParams, nullptr, "Rank 2 is not pruned");
+    CheckFeedback(pruned->CreateCqiFeedbackMimo(signal, pmiUpdateSb),
+                  serial->CreateCqiFeedbackMimo(signal, pmiUpdateSb),
+                  "Rank-1 channel, subband update");
+}
+
+class NrPmSearchFullTestSuite : public TestSuite
+{
+  public:
+    NrPmSearchFullTestSuite()
+        : TestSuite("nr-pm-search-full", Type::UNIT)
+    {
+        AddTestCase(new NrPmSearchFullTestCase(), Duration::QUICK);
+    }
+};
+
+static NrPmSearchFullTestSuite g_nrPmSearchFullTestSuite; //!< NrPmSearchFull test suite
+
+} // namespace ns3
@@ -0,0 +1,177 @@
+// Copyright (c) 2024 Seoul National University (SNU)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/antenna-module.h>
+#include <ns3/core-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/nr-module.h>
+
+#include <cstdio>
+
+/**
+ * \file nr-rem-helper-test.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the threads of the NrRadioEnvironmentMapHelper. A coverage area
+ * REM of two gNBs is computed with one and with four threads, on tiles whose number is
+ * not a multiple of the number of threads, and the values of the REM points must be the
+ * same.
+ */
+namespace ns3
+{
+
+/**
+ * \ingroup test
+ * \brief Compare the REM computed with one and with four threads
+ */
+class NrRemThreadsTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     */
+    NrRemThreadsTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Build the scenario and compute its REM
+     * \param numThreads the number of threads computing the REM points
+     * \return the SNR and SINR of each REM point, in dB
+     */
+    std::vector<std::pair<double, double>> ComputeRem(uint32_t numThreads);
+};
+
+NrRemThreadsTestCase::NrRemThreadsTestCase()
+    : TestCase("REM computed with one and with four threads")
+{
+}
+
+std::vector<std::pair<double, double>>
+NrRemThreadsTestCase::ComputeRem(uint32_t numThreads)
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(2);
+    ueNodes.Create(1);
+
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(0.0, 0.0, 10.0));
+    positionAlloc->Add(Vector(40.0, 0.0, 10.0));
+    positionAlloc->Add(Vector(10.0, 10.0, 1.5));
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(NodeContainer(gnbNodes, ueNodes));
+
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    CcBwpCreator::SimpleOperationBandConf bandConf(28e9, 20e6, 1, BandwidthPartInfo::UMa);
+    CcBwpCreator ccBwpCreator;
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(2));
+    nrHelper->SetGnbAntennaAttribute("AntennaElement",
+                                     PointerValue(CreateObject<ThreeGppAntennaModel>()));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(1));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(1));
+    nrHelper->SetUeAntennaAttribute("AntennaElement",
+                                    PointerValue(CreateObject<IsotropicAntennaModel>()));
+
+    NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueDevs = nrHelper->InstallUeDevice(ueNodes, allBwps);
+    int64_t randomStream = 1;
+    randomStream += nrHelper->AssignStreams(gnbDevs, randomStream);
+    randomStream += nrHelper->AssignStreams(ueDevs, randomStream);
+    for (auto it = gnbDevs.Begin(); it != gnbDevs.End(); ++it)
+    {
+        DynamicCast<NrGnbNetDevice>(*it)->UpdateConfig();
+    }
+    for (auto it = ueDevs.Begin(); it != ueDevs.End(); ++it)
+    {
+        DynamicCast<NrUeNetDevice>(*it)->UpdateConfig();
+    }
+
+    // 6x5 points in tiles of 3 points: 10 tiles, computed by rounds of 4 tiles
+    Ptr<NrRadioEnvironmentMapHelper> remHelper = CreateObject<NrRadioEnvironmentMapHelper>();
+    remHelper->SetAttribute("RemMode", EnumValue(NrRadioEnvironmentMapHelper::COVERAGE_AREA));
+    remHelper->SetAttribute("NumThreads", UintegerValue(numThreads));
+    remHelper->SetAttribute("TileSize", UintegerValue(3));
+    remHelper->SetAttribute("FirstStream", IntegerValue(randomStream));
+    remHelper->SetMinX(-20.0);
+    remHelper->SetMaxX(60.0);
+    remHelper->SetResX(5);
+    remHelper->SetMinY(-20.0);
+    remHelper->SetMaxY(20.0);
+    remHelper->SetResY(4);
+    remHelper->SetZ(1.5);
+    remHelper->SetSimTag("test-threads");
+    remHelper->CreateRem(gnbDevs, ueDevs.Get(0), 0);
+
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+
+    std::vector<std::pair<double, double>> rem;
+    for (const auto& remPoint : remHelper->m_rem)
+    {
+        rem.emplace_back(remPoint.avgSnrDb, remPoint.avgSinrDb);
+    }
+    Simulator::Destroy();
+
+    for (const auto& suffix :
+         {".out", "-gnbs.txt", "-ues.txt", "-buildings.txt", "-plot-rem.gnuplot"})
+    {
+        std::remove((std::string("nr-rem-test-threads") + suffix).c_str());
+    }
+    return rem;
+}
+
+void
+NrRemThreadsTestCase::DoRun()
+{
+    auto singleThread = ComputeRem(1);
+    auto fourThreads = ComputeRem(4);
+
+    NS_TEST_ASSERT_MSG_EQ(singleThread.size(), 30, "Wrong number of REM points");
+    NS_TEST_ASSERT_MSG_EQ(fourThreads.size(),
+                          singleThread.size(),
+                          "The number of REM points depends on the number of threads");
+    for (size_t i = 0; i < singleThread.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ_TOL(fourThreads[i].first,
+                                  singleThread[i].first,
+                                  1e-9,
+                                  "The SNR of REM point " << i
+                                                          << " depends on the number of threads");
+        NS_TEST_ASSERT_MSG_EQ_TOL(fourThreads[i].second,
+                                  singleThread[i].second,
+                                  1e-9,
+                                  "The SINR of REM point " << i
+                                                           << " depends on the number of threads");
+    }
+}
+
+/**
+ * \ingroup test
+ * \brief Test suite for the threads of the NrRadioEnvironmentMapHelper
+ */
+class NrRemHelperTestSuite : public TestSuite
+{
+  public:
+    NrRemHelperTestSuite()
+        : TestSuite("nr-rem-helper", Type::UNIT)
+    {
+        AddTestCase(new NrRemThreadsTestCase(), Duration::QUICK);
+    }
+};
+
+static NrRemHelperTestSuite g_nrRemHelperTestSuite; //!< REM helper threads test suite
+
+} // namespace ns3
@@ -8,8 +8,11 @@
 #include <ns3/nr-eesm-error-model.h>
 #include <ns3/nr-eesm-ir-t1.h>
 #include <ns3/nr-eesm-ir-t2.h>
+#include <ns3/spectrum-value.h>
 #include <ns3/test.h>
 
+#include <cmath>
+
 /**
  * \file nr-test-l2sm-eesm.cc
  * \ingroup test
@@ -17,7 +20,8 @@
  * \brief This test validates specific functions of the NR PHY abstraction model.
  * The test checks two issues: 1) LDPC base graph (BG) selection works properly, and 2)
  * BLER values are properly obtained from the BLER-SINR look up tables for different
- * block sizes, MCS Tables, BG types, and SINR values.
+ * block sizes, MCS Tables, BG types, and SINR values. It also checks that the flattened
+ * BLER-SINR tables match the original ones, and the sum of exponential SINRs of EESM.
  *
  */
 namespace ns3
@@ -48,6 +52,8 @@ class NrL2smEesmTestCase : public TestCase
     void TestMappingSinrBler2(const Ptr<NrEesmErrorModel>& em);
     void TestBgType1(const Ptr<NrEesmErrorModel>& em);
     void TestBgType2(const Ptr<NrEesmErrorModel>& em);
+    void TestFlatBlerTable(const Ptr<NrEesmErrorModel>& em);
+    void TestSinrExp(const Ptr<NrEesmErrorModel>& em);
 
     void TestEesmCcTable1();
     void TestEesmCcTable2();
@@ -210,6 +216,79 @@ NrL2smEesmTestCase::TestMappingSinrBler2(const Ptr<NrEesmErrorModel>& em)
     }
 }
 
+void
+NrL2smEesmTestCase::TestFlatBlerTable(const Ptr<NrEesmErrorModel>& em)
+{
+    // flatten the table through a lookup, then compare it with the nested one
+    em->MappingSinrBler(1.0, 0, 1000);
+    const NrEesmErrorModel::FlatBlerTable* flat = em->m_flatBler;
+    NS_TEST_ASSERT_MSG_NE(flat, nullptr, "The BLER-SINR table was not flattened");
+
+    const auto* table = em->GetSimulatedBlerFromSINR();
+    for (uint32_t bg = 0; bg < table->size(); ++bg)
+    {
+        for (uint32_t mcs = 0; mcs < table->at(bg).size(); ++mcs)
+        {
+            uint32_t index = bg * flat->m_numMcs + mcs;
+            NS_TEST_ASSERT_MSG_EQ(flat->m_first[index + 1] - flat->m_first[index],
+                                  table->at(bg).at(mcs).size(),
+                                  "Wrong number of curves for BG " << bg << " MCS " << mcs);
+            uint32_t c = flat->m_first[index];
+            for (const auto& [cbSize, curve] : table->at(bg).at(mcs))
+            {
+                const auto& flatCurve = flat->m_curves[c++];
+                NS_TEST_ASSERT_MSG_EQ(flatCurve.m_cbSize, cbSize, "Curves not sorted by CB size");
+                NS_TEST_ASSERT_MSG_EQ(flatCurve.m_size,
+                                      std::get<0>(curve).size(),
+                                      "Wrong number of points");
+                for (uint32_t i = 0; i < flatCurve.m_size; ++i)
+                {
+                    NS_TEST_ASSERT_MSG_EQ(flat->m_sinrDb[flatCurve.m_offset + i],
+                                          std::get<0>(curve)[i],
+                                          "Wrong SINR point");
+                    NS_TEST_ASSERT_MSG_EQ(flat->m_bler[flatCurve.m_offset + i],
+                                          std::get<1>(curve)[i],
+                                          "Wrong BLER point");
+                }
+            }
+        }
+    }
+}
+
+void
+NrL2smEesmTestCase::TestSinrExp(const Ptr<NrEesmErrorModel>& em)
+{
+    // more RBs than the block of exponentials, and an RB used twice
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < 150; ++i)
+    {
+        freqs.push_back(3.5e9 + 180e3 * i);
+    }
+    Ptr<SpectrumModel> model = Create<SpectrumModel>(freqs);
+    SpectrumValue sinr(model);
+    std::vector<int> map;
+    for (uint32_t i = 0; i < freqs.size(); ++i)
+    {
+        sinr[i] = std::pow(10.0, (i % 30) / 10.0);
+        map.push_back(i);
+    }
+    map.push_back(3);
+
+    for (uint8_t mcs = 0; mcs <= em->GetMaxMcs(); ++mcs)
+    {
+        double beta = em->GetBetaTable()->at(mcs);
+        double expected = 0.0;
+        for (int i : map)
+        {
+            expected += std::exp(-sinr[i] / beta);
+        }
+        NS_TEST_ASSERT_MSG_EQ_TOL(em->SinrExp(sinr, map, mcs),
+                                  expected,
+                                  expected * 0.00173,
+                                  "Wrong sum of exponential SINRs for MCS " << +mcs);
+    }
+}
+
 void
 NrL2smEesmTestCase::TestEesmCcTable1()
 {
@@ -223,6 +302,8 @@ NrL2smEesmTestCase::TestEesmCcTable1()
     // Test here the functions:
     TestBgType1(em);
     TestMappingSinrBler1(em);
+    TestFlatBlerTable(em);
+    TestSinrExp(em);
 }
 
 void
@@ -238,6 +319,8 @@ NrL2smEesmTestCase::TestEesmCcTable2()
     // Test here the functions:
     TestBgType2(em);
     TestMappingSinrBler2(em);
+    TestFlatBlerTable(em);
+    TestSinrExp(em);
 }
 
 void
@@ -253,6 +336,8 @@ NrL2smEesmTestCase::TestEesmIrTable1()
     // Test here the functions:
     TestBgType1(em);
     TestMappingSinrBler1(em);
+    TestFlatBlerTable(em);
+    TestSinrExp(em);
 }
 
 void
@@ -268,6 +353,8 @@ NrL2smEesmTestCase::TestEesmIrTable2()
     // Test here the functions:
     TestBgType2(em);
     TestMappingSinrBler2(em);
+    TestFlatBlerTable(em);
+    TestSinrExp(em);
 }
 
 void
@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: GPL-2.0-only
 
+#include <ns3/nr-aoi-timestamp-tracker.h>
 #include <ns3/nr-mac-sched-sap.h>
 #include <ns3/nr-mac-scheduler-ns3.h>
 #include <ns3/object-factory.h>
@@ -176,6 +177,11 @@ class TestSchedSapUser : public NrMacSchedSapUser
     {
     }
 
+    Ptr<NrAoiTimestampTracker> GetAoiTimestampTracker() const override
+    {
+        return nullptr;
+    }
+
   private:
     NrSchedGeneralTestCase* m_testCase;
 };
@@ -107,6 +107,14 @@ public:
 
   bool SetData(std::vector<T> data);
   std::vector<T> GetData();
+  /**
+   * \brief Read-only access to the data, without copying it
+   */
+  const std::vector<T> &GetDataRef() const;
+  /**
+   * \brief Access to the data, to update it in place without reallocating it
+   */
+  std::vector<T> &GetDataRef();
 
   std::vector<uint32_t> GetShape();
 
@@ -259,6 +267,20 @@ OpenGymBoxContainer<T>::GetData()
   return m_data;
 }
 
+template <typename T>
+const std::vector<T> &
+OpenGymBoxContainer<T>::GetDataRef() const
+{
+  return m_data;
+}
+
+template <typename T>
+std::vector<T> &
+OpenGymBoxContainer<T>::GetDataRef()
+{
+  return m_data;
+}
+
 template <typename T>
 void
 OpenGymBoxContainer<T>::Print(std::ostream& where) const
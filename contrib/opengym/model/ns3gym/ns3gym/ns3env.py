@@ -11,6 +11,7 @@ from gym.utils import seeding
 from enum import IntEnum
 
 from ns3gym.start_sim import start_sim_script, build_ns3_project
+from ns3gym.shm import Ns3ShmChannel
 
 import ns3gym.messages_pb2 as pb
 from google.protobuf.any_pb2 import Any
@@ -24,20 +25,23 @@ __email__ = "gawlowicz@tkn.tu-berlin.de"
 
 class Ns3ZmqBridge(object):
     """docstring for Ns3ZmqBridge"""
-    def __init__(self, port=0, startSim=True, simSeed=0, simArgs={}, debug=False):
+    def __init__(self, port=0, startSim=True, simSeed=0, simArgs={}, debug=False, pipelined=False):
         super(Ns3ZmqBridge, self).__init__()
         port = int(port)
         self.port = port
         self.startSim = startSim
         self.simSeed = simSeed
         self.simArgs = simArgs
+        self.pipelined = pipelined
         self.envStopped = False
         self.simPid = None
         self.wafPid = None
         self.ns3Process = None
 
         context = zmq.Context()
-        self.socket = context.socket(zmq.REP)
+        # in the pipelined mode ns-3 sends observations without waiting for the actions,
+        # so the strict request/reply alternation of REQ/REP cannot be used
+        self.socket = context.socket(zmq.PAIR if pipelined else zmq.REP)
         try:
             if port == 0 and self.startSim:
                 port = self.socket.bind_to_random_port('tcp://*', min_port=5001, max_port=10000, max_tries=100)
@@ -78,6 +82,9 @@ class Ns3ZmqBridge(object):
         self.gameOverReason = None
         self.extraInfo = None
         self.newStateRx = False
+        self.stepId = 0
+        # set when ns-3 uses the shared memory transport (Transport=SharedMemory)
+        self.shm = None
 
     def close(self):
         try:
@@ -86,6 +93,9 @@ class Ns3ZmqBridge(object):
                 self.force_env_stop()
                 self.rx_env_state()
                 self.send_close_command()
+                if self.shm:
+                    self.shm.close()
+                    self.shm = None
                 self.ns3Process.kill()
                 if self.simPid:
                     os.kill(self.simPid, signal.SIGTERM)
@@ -154,8 +164,16 @@ class Ns3ZmqBridge(object):
 
         self.simPid = int(simInitMsg.simProcessId)
         self.wafPid = int(simInitMsg.wafShellProcessId)
+        if simInitMsg.pipelined != self.pipelined:
+            print("ns-3 simulation pipelined mode ({}) does not match the agent one ({})".format(
+                simInitMsg.pipelined, self.pipelined))
+            print("Please set the OpenGymInterface Pipelined attribute and the agent pipelined flag consistently")
+            sys.exit()
         self._action_space = self._create_space(simInitMsg.actSpace)
         self._observation_space = self._create_space(simInitMsg.obsSpace)
+        if simInitMsg.shmName:
+            # ns-3 created the segment before sending the init msg
+            self.shm = Ns3ShmChannel(simInitMsg.shmName)
 
         reply = pb.SimInitAck()
         reply.done = True
@@ -177,10 +195,25 @@ class Ns3ZmqBridge(object):
         if self.newStateRx:
             return
 
+        if self.shm:
+            self._rx_env_state_shm()
+            return
+
         request = self.socket.recv()
         envStateMsg = pb.EnvStateMsg()
         envStateMsg.ParseFromString(request)
 
+        if self.pipelined:
+            # answer only the most recent observation, the older ones are already stale
+            while not envStateMsg.isGameOver:
+                try:
+                    request = self.socket.recv(flags=zmq.NOBLOCK)
+                except zmq.Again:
+                    break
+                envStateMsg = pb.EnvStateMsg()
+                envStateMsg.ParseFromString(request)
+
+        self.stepId = envStateMsg.stepId
         self.obsData = self._create_data(envStateMsg.obsData)
         self.reward = envStateMsg.reward
         self.gameOver = envStateMsg.isGameOver
@@ -200,9 +233,32 @@ class Ns3ZmqBridge(object):
 
         self.newStateRx = True
 
+    def _rx_env_state_shm(self):
+        # the observation is a view of the shared memory, valid until the next action is sent
+        self.stepId, self.obsData, self.reward, self.gameOver, self.gameOverReason, self.extraInfo = \
+            self.shm.rx_state(newestOnly=self.pipelined)
+
+        if self.gameOver:
+            if self.gameOverReason == pb.EnvStateMsg.SimulationEnd:
+                self.envStopped = True
+            else:
+                self.forceEnvStop = True
+            self.send_close_command()
+
+        if not self.extraInfo:
+            self.extraInfo = {}
+
+        self.newStateRx = True
+
     def send_close_command(self):
+        if self.shm:
+            self.shm.send_action(self.stepId, None, pb.FLOAT, stopSimReq=True)
+            self.newStateRx = False
+            return True
+
         reply = pb.EnvActMsg()
         reply.stopSimReq = True
+        reply.stepId = self.stepId
 
         replyMsg = reply.SerializeToString()
         self.socket.send(replyMsg)
@@ -210,6 +266,12 @@ class Ns3ZmqBridge(object):
         return True
 
     def send_actions(self, actions):
+        if self.shm:
+            self.shm.send_action(self.stepId, actions, self._box_pb_dtype(self._action_space),
+                                 stopSimReq=self.forceEnvStop)
+            self.newStateRx = False
+            return True
+
         reply = pb.EnvActMsg()
 
         actionMsg = self._pack_data(actions, self._action_space)
@@ -218,6 +280,8 @@ class Ns3ZmqBridge(object):
         reply.stopSimReq = False
         if self.forceEnvStop:
             reply.stopSimReq = True
+        # tag the action with the observation it answers
+        reply.stepId = self.stepId
 
         replyMsg = reply.SerializeToString()
         self.socket.send(replyMsg)
@@ -254,8 +318,11 @@ class Ns3ZmqBridge(object):
             else:
                 data = boxContainerPb.floatData
 
-            # TODO: reshape using shape info
+            # same layout as the shared memory transport: the shape of the box
             data = np.array(data)
+            shape = tuple(boxContainerPb.shape)
+            if shape and int(np.prod(shape)) == data.size:
+                data = data.reshape(shape)
             return data
 
         elif (dataContainerPb.type == pb.Tuple):
@@ -291,6 +358,15 @@ class Ns3ZmqBridge(object):
     def get_extra_info(self):
         return self.extraInfo
 
+    def _box_pb_dtype(self, spaceDesc):
+        if (spaceDesc.dtype in ['int', 'int8', 'int16', 'int32', 'int64']):
+            return pb.INT
+        elif (spaceDesc.dtype in ['uint', 'uint8', 'uint16', 'uint32', 'uint64']):
+            return pb.UINT
+        elif (spaceDesc.dtype in ['double']):
+            return pb.DOUBLE
+        return pb.FLOAT
+
     # add a context for the nested action, an Optional[Space]
     def _pack_data(self, actions, spaceDesc, context=None):
         dataContainer = pb.DataContainer()
@@ -306,27 +382,23 @@ class Ns3ZmqBridge(object):
         elif spaceType == spaces.Box:
             dataContainer.type = pb.Box
             boxContainerPb = pb.BoxDataContainer()
+            # multi-dimensional actions (e.g. of vectorized envs) are sent flattened
+            if isinstance(actions, np.ndarray) and actions.ndim > 1:
+                actions = actions.ravel().tolist()
             shape = [len(actions)]
             boxContainerPb.shape.extend(shape)
 
-            if (spaceDesc.dtype in ['int', 'int8', 'int16', 'int32', 'int64']):
-                boxContainerPb.dtype = pb.INT
+            boxContainerPb.dtype = self._box_pb_dtype(spaceDesc)
+            if boxContainerPb.dtype == pb.INT:
                 boxContainerPb.intData.extend(actions)
 
-            elif (spaceDesc.dtype in ['uint', 'uint8', 'uint16', 'uint32', 'uint64']):
-                boxContainerPb.dtype = pb.UINT
+            elif boxContainerPb.dtype == pb.UINT:
                 boxContainerPb.uintData.extend(actions)
 
-            elif (spaceDesc.dtype in ['float', 'float32', 'float64']):
-                boxContainerPb.dtype = pb.FLOAT
-                boxContainerPb.floatData.extend(actions)
-
-            elif (spaceDesc.dtype in ['double']):
-                boxContainerPb.dtype = pb.DOUBLE
+            elif boxContainerPb.dtype == pb.DOUBLE:
                 boxContainerPb.doubleData.extend(actions)
 
             else:
-                boxContainerPb.dtype = pb.FLOAT
                 boxContainerPb.floatData.extend(actions)
 
             dataContainer.data.Pack(boxContainerPb)
@@ -375,13 +447,14 @@ class Ns3ZmqBridge(object):
 
 
 class Ns3Env(gym.Env):
-    def __init__(self, stepTime=0, port=0, startSim=True, simSeed=0, simArgs={}, debug=False):
+    def __init__(self, stepTime=0, port=0, startSim=True, simSeed=0, simArgs={}, debug=False, pipelined=False):
         self.stepTime = stepTime
         self.port = port
         self.startSim = startSim
         self.simSeed = simSeed
         self.simArgs = simArgs
         self.debug = debug
+        self.pipelined = pipelined
 
         # Filled in reset function
         self.ns3ZmqBridge = None
@@ -392,7 +465,7 @@ class Ns3Env(gym.Env):
         self.state = None
         self.steps_beyond_done = None
 
-        self.ns3ZmqBridge = Ns3ZmqBridge(self.port, self.startSim, self.simSeed, self.simArgs, self.debug)
+        self.ns3ZmqBridge = Ns3ZmqBridge(self.port, self.startSim, self.simSeed, self.simArgs, self.debug, self.pipelined)
         self.ns3ZmqBridge.initialize_env(self.stepTime)
         self.action_space = self.ns3ZmqBridge.get_action_space()
         self.observation_space = self.ns3ZmqBridge.get_observation_space()
@@ -427,7 +500,7 @@ class Ns3Env(gym.Env):
             self.ns3ZmqBridge = None
 
         self.envDirty = False
-        self.ns3ZmqBridge = Ns3ZmqBridge(self.port, self.startSim, self.simSeed, self.simArgs, self.debug)
+        self.ns3ZmqBridge = Ns3ZmqBridge(self.port, self.startSim, self.simSeed, self.simArgs, self.debug, self.pipelined)
         self.ns3ZmqBridge.initialize_env(self.stepTime)
         self.action_space = self.ns3ZmqBridge.get_action_space()
         self.observation_space = self.ns3ZmqBridge.get_observation_space()
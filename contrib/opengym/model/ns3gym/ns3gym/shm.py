@@ -0,0 +1,196 @@
+import ctypes
+import ctypes.util
+import mmap
+import os
+import platform
+import struct
+import time
+
+import numpy as np
+
+import ns3gym.messages_pb2 as pb
+
+
+__author__ = "Piotr Gawlowicz"
+__copyright__ = "Copyright (c) 2018, Technische Universität Berlin"
+__version__ = "0.1.0"
+__email__ = "gawlowicz@tkn.tu-berlin.de"
+
+
+# Layout of the segment, mirrors opengym_shm_transport.h
+SHM_MAGIC = 0x6e336779
+SHM_VERSION = 1
+CONTROL_BYTES = 4096
+OBS_SEQ_OFFSET = 64
+OBS_READ_SEQ_OFFSET = 128
+ACT_SEQ_OFFSET = 192
+ACT_READ_SEQ_OFFSET = 256
+STATE_SLOT_HEADER = struct.Struct("<QfIII4I4sIII200s")
+ACTION_SLOT_HEADER = struct.Struct("<QIIII40x")
+
+FUTEX_WAIT = 0
+FUTEX_WAKE = 1
+SYS_FUTEX = {"x86_64": 202, "aarch64": 98, "armv7l": 240, "ppc64le": 221}
+
+# On these (TSO) machines plain aligned 32 bit loads and stores already have the
+# acquire and release semantics of the C++ side; elsewhere libatomic provides them
+TSO_MACHINES = ("x86_64", "AMD64", "i386", "i686")
+ATOMIC_ACQUIRE = 2
+ATOMIC_RELEASE = 3
+
+# sleep bounds of the polling loop used when futexes are not available, in seconds
+POLL_MIN_SLEEP = 50e-6
+POLL_MAX_SLEEP = 1e-3
+
+# numpy type string of the actions, by protobuf dtype
+ACTION_DTYPES = {pb.INT: "<i4", pb.UINT: "<u4", pb.FLOAT: "<f4", pb.DOUBLE: "<f8"}
+
+
+class _Timespec(ctypes.Structure):
+    _fields_ = [("tv_sec", ctypes.c_long), ("tv_nsec", ctypes.c_long)]
+
+
+class Ns3ShmChannel(object):
+    """Shared memory channel created by the ns-3 OpenGymInterface (Transport=SharedMemory)
+
+    Observations are returned as numpy views of the segment: they are valid
+    until the action answering them is sent, copy them to keep them longer.
+    """
+    def __init__(self, name):
+        super(Ns3ShmChannel, self).__init__()
+        self.name = name
+        fd = os.open("/dev/shm/" + name.lstrip("/"), os.O_RDWR)
+        try:
+            self.mm = mmap.mmap(fd, 0, mmap.MAP_SHARED, mmap.PROT_READ | mmap.PROT_WRITE)
+        finally:
+            os.close(fd)
+
+        magic, version, self.slots, self.maxObsBytes, self.maxActBytes, \
+            self.stateSlotBytes, self.actSlotBytes = struct.unpack_from("<7I", self.mm, 0)
+        if magic != SHM_MAGIC or version != SHM_VERSION:
+            raise RuntimeError("Unsupported ns-3 shared memory segment {} (version {})".format(name, version))
+
+        # the counters are 32 bit words shared with ns-3, accessed through numpy views
+        self.obsSeq = np.frombuffer(self.mm, dtype=np.uint32, count=1, offset=OBS_SEQ_OFFSET)
+        self.obsReadSeq = np.frombuffer(self.mm, dtype=np.uint32, count=1, offset=OBS_READ_SEQ_OFFSET)
+        self.actSeq = np.frombuffer(self.mm, dtype=np.uint32, count=1, offset=ACT_SEQ_OFFSET)
+        self.actReadSeq = np.frombuffer(self.mm, dtype=np.uint32, count=1, offset=ACT_READ_SEQ_OFFSET)
+
+        machine = platform.machine()
+        self.libatomic = None
+        if machine not in TSO_MACHINES:
+            libName = ctypes.util.find_library("atomic")
+            if libName is None:
+                raise RuntimeError("libatomic is needed to share the ring counters with ns-3 on " + machine)
+            self.libatomic = ctypes.CDLL(libName)
+            self.libatomic.__atomic_load_4.argtypes = [ctypes.c_void_p, ctypes.c_int]
+            self.libatomic.__atomic_load_4.restype = ctypes.c_uint32
+            self.libatomic.__atomic_store_4.argtypes = [ctypes.c_void_p, ctypes.c_uint32, ctypes.c_int]
+            self.libatomic.__atomic_store_4.restype = None
+        self.readSeq = self._load(self.obsReadSeq)
+
+        self.libc = ctypes.CDLL(None, use_errno=True)
+        self.sysFutex = SYS_FUTEX.get(machine)
+        # wake up periodically to stay responsive to signals
+        self.timeout = _Timespec(0, 100 * 1000 * 1000)
+
+    def close(self):
+        self.obsSeq = self.obsReadSeq = self.actSeq = self.actReadSeq = None
+        try:
+            self.mm.close()
+        except BufferError:
+            # observations still referenced by the agent keep the mapping alive
+            pass
+
+    def _load(self, counter):
+        """Read a counter published by ns-3 (acquire)"""
+        if self.libatomic is None:
+            return int(counter[0])
+        return self.libatomic.__atomic_load_4(counter.ctypes.data, ATOMIC_ACQUIRE)
+
+    def _store(self, counter, value):
+        """Publish a counter to ns-3 (release), after the slot it refers to"""
+        if self.libatomic is None:
+            counter[0] = value
+        else:
+            self.libatomic.__atomic_store_4(counter.ctypes.data, value, ATOMIC_RELEASE)
+
+    def _wait_while_equal(self, counter, value):
+        sleep = POLL_MIN_SLEEP
+        while self._load(counter) == value:
+            if self.sysFutex is None:
+                # no futex on this machine: poll with an exponential backoff
+                time.sleep(sleep)
+                sleep = min(2 * sleep, POLL_MAX_SLEEP)
+                continue
+            self.libc.syscall(self.sysFutex, ctypes.c_void_p(counter.ctypes.data), FUTEX_WAIT,
+                              ctypes.c_uint32(value), ctypes.byref(self.timeout), None, 0)
+
+    def _wake(self, counter):
+        if self.sysFutex is not None:
+            self.libc.syscall(self.sysFutex, ctypes.c_void_p(counter.ctypes.data), FUTEX_WAKE,
+                              0x7fffffff, None, None, 0)
+
+    def _state_slot_offset(self, seq):
+        return CONTROL_BYTES + (seq % self.slots) * self.stateSlotBytes
+
+    def _action_slot_offset(self, seq):
+        return CONTROL_BYTES + self.slots * self.stateSlotBytes + (seq % self.slots) * self.actSlotBytes
+
+    def rx_state(self, newestOnly=False):
+        """Wait for the next state and return (stepId, obs, reward, isGameOver, reason, info)
+
+        With newestOnly, the states queued by a pipelined simulation are skipped
+        up to the most recent one.
+        """
+        self._wait_while_equal(self.obsSeq, self.readSeq)
+        if newestOnly:
+            newest = (self._load(self.obsSeq) - 1) & 0xffffffff
+            if newest != self.readSeq:
+                # release the skipped states to ns-3
+                self.readSeq = newest
+                self._store(self.obsReadSeq, newest)
+                self._wake(self.obsReadSeq)
+
+        offset = self._state_slot_offset(self.readSeq)
+        stepId, reward, isGameOver, reason, ndim, s0, s1, s2, s3, dtype, dataBytes, infoBytes, _, info = \
+            STATE_SLOT_HEADER.unpack_from(self.mm, offset)
+        obs = None
+        dtype = dtype.rstrip(b"\0").decode()
+        if dtype:
+            shape = (s0, s1, s2, s3)[:ndim]
+            npDtype = np.dtype("<" + dtype)
+            obs = np.frombuffer(self.mm, dtype=npDtype, count=dataBytes // npDtype.itemsize,
+                                offset=offset + STATE_SLOT_HEADER.size).reshape(shape)
+        info = info[:infoBytes].decode(errors="replace")
+        return stepId, obs, reward, bool(isGameOver), reason, info
+
+    def send_action(self, stepId, actions, pbDtype, stopSimReq=False):
+        """Write the action answering the state read last and release that state"""
+        seq = self._load(self.actSeq)
+        readSeq = self._load(self.actReadSeq)
+        while ((seq - readSeq) & 0xffffffff) >= self.slots:
+            self._wait_while_equal(self.actReadSeq, readSeq)
+            readSeq = self._load(self.actReadSeq)
+
+        offset = self._action_slot_offset(seq)
+        count = 0
+        dataBytes = 0
+        if actions is not None:
+            npDtype = np.dtype(ACTION_DTYPES.get(pbDtype, "<f4"))
+            data = np.asarray(actions, dtype=npDtype).ravel()
+            count = data.size
+            dataBytes = data.nbytes
+            if dataBytes > self.maxActBytes:
+                raise ValueError("Action of {} bytes does not fit in the {} bytes of a shared memory slot"
+                                 .format(dataBytes, self.maxActBytes))
+            dst = np.frombuffer(self.mm, dtype=npDtype, count=count, offset=offset + ACTION_SLOT_HEADER.size)
+            dst[:] = data
+        ACTION_SLOT_HEADER.pack_into(self.mm, offset, stepId, int(stopSimReq), pbDtype, count, dataBytes)
+
+        self._store(self.actSeq, (seq + 1) & 0xffffffff)
+        self._wake(self.actSeq)
+        # the observation view can now be overwritten
+        self.readSeq = (self.readSeq + 1) & 0xffffffff
+        self._store(self.obsReadSeq, self.readSeq)
+        self._wake(self.obsReadSeq)
@@ -24,7 +24,11 @@
 #include "ns3/log.h"
 #include "ns3/config.h"
 #include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/enum.h"
 #include "opengym_interface.h"
+#include "opengym_shm_transport.h"
 #include "opengym_env.h"
 #include "container.h"
 #include "spaces.h"
@@ -44,6 +48,46 @@ OpenGymInterface::GetTypeId (void)
     .SetParent<Object> ()
     .SetGroupName ("OpenGym")
     .AddConstructor<OpenGymInterface> ()
+    .AddAttribute ("Pipelined",
+                   "If true, the simulation does not wait for the action of the agent after "
+                   "sending an observation: it keeps running with the last executed action and "
+                   "executes the action of the agent when it arrives. The agent must be started "
+                   "in the pipelined mode as well.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&OpenGymInterface::m_pipelined),
+                   MakeBooleanChecker ())
+    .AddAttribute ("MaxActionLag",
+                   "In the pipelined mode, the maximum number of observations that can be sent "
+                   "without having received the action for them. When reached, the simulation "
+                   "blocks until the agent catches up. Zero is equivalent to the synchronous mode.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&OpenGymInterface::m_maxActionLag),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("Transport",
+                   "How the observations and the actions are exchanged with the agent. With "
+                   "SharedMemory, Box observations and actions are copied into a shared memory "
+                   "segment (Linux only) and only the initial handshake goes through ZMQ.",
+                   EnumValue (OpenGymInterface::ZMQ),
+                   MakeEnumAccessor<Transport> (&OpenGymInterface::m_transport),
+                   MakeEnumChecker (OpenGymInterface::ZMQ, "Zmq",
+                                    OpenGymInterface::SHARED_MEMORY, "SharedMemory"))
+    .AddAttribute ("ShmSlots",
+                   "Number of observations (and of actions) that the shared memory segment can "
+                   "hold at the same time. One is enough in the synchronous mode; in the "
+                   "pipelined mode it should be larger than MaxActionLag.",
+                   UintegerValue (4),
+                   MakeUintegerAccessor (&OpenGymInterface::m_shmSlots),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("ShmMaxObservationBytes",
+                   "Capacity in bytes of an observation in the shared memory segment",
+                   UintegerValue (65536),
+                   MakeUintegerAccessor (&OpenGymInterface::m_shmMaxObsBytes),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("ShmMaxActionBytes",
+                   "Capacity in bytes of an action in the shared memory segment",
+                   UintegerValue (16384),
+                   MakeUintegerAccessor (&OpenGymInterface::m_shmMaxActBytes),
+                   MakeUintegerChecker<uint32_t> (1))
     ;
   return tid;
 }
@@ -79,7 +123,10 @@ OpenGymInterface::Delete (void)
 
 OpenGymInterface::OpenGymInterface(uint32_t port):
   m_port(port), m_zmq_context(1), m_zmq_socket(m_zmq_context, ZMQ_REQ),
-  m_simEnd(false), m_stopEnvRequested(false), m_initSimMsgSent(false)
+  m_simEnd(false), m_stopEnvRequested(false), m_initSimMsgSent(false),
+  m_pipelined(false), m_maxActionLag(1), m_stepId(0), m_lastAnsweredStepId(0),
+  m_actionStepId(0), m_transport(ZMQ), m_shmSlots(4), m_shmMaxObsBytes(65536),
+  m_shmMaxActBytes(16384)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -93,6 +140,7 @@ void
 OpenGymInterface::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  m_shm.reset ();
 }
 
 void
@@ -160,6 +208,11 @@ OpenGymInterface::Init()
   }
   m_initSimMsgSent = true;
 
+  if (m_pipelined) {
+    // REQ sockets enforce a strict send/recv alternation, PAIR sockets do not
+    m_zmq_socket = zmq::socket_t (m_zmq_context, ZMQ_PAIR);
+  }
+
   std::string connectAddr = "tcp://localhost:" + std::to_string(m_port);
   zmq_connect ((void*)m_zmq_socket, connectAddr.c_str());
 
@@ -173,6 +226,14 @@ OpenGymInterface::Init()
   ns3opengym::SimInitMsg simInitMsg;
   simInitMsg.set_simprocessid(::getpid());
   simInitMsg.set_wafshellprocessid(::getppid());
+  simInitMsg.set_pipelined(m_pipelined);
+
+  if (m_transport == SHARED_MEMORY) {
+    // one segment per simulation process, the agent opens it after the handshake
+    std::string shmName = "/ns3gym-" + std::to_string(m_port) + "-" + std::to_string(::getpid());
+    m_shm.reset (new OpenGymShmTransport (shmName, m_shmSlots, m_shmMaxObsBytes, m_shmMaxActBytes));
+    simInitMsg.set_shmname(shmName);
+  }
 
   if (obsSpace) {
     ns3opengym::SpaceDescription spaceDesc;
@@ -224,54 +285,125 @@ OpenGymInterface::NotifyCurrentState()
   }
 
   // collect current env state
+  m_stepId++;
   Ptr<OpenGymDataContainer> obsDataContainer = GetObservation();
   float reward = GetReward();
   bool isGameOver = IsGameOver();
   std::string extraInfo = GetExtraInfo();
+  ns3opengym::EnvStateMsg::Reason reason = m_simEnd ? ns3opengym::EnvStateMsg::SimulationEnd
+                                                    : ns3opengym::EnvStateMsg::GameOver;
+
+  if (m_shm) {
+    m_shm->SendState (m_stepId, obsDataContainer, reward, isGameOver, reason, extraInfo);
+  } else {
+    ns3opengym::EnvStateMsg envStateMsg;
+    // observation
+    ns3opengym::DataContainer obsDataContainerPbMsg;
+    if (obsDataContainer) {
+      obsDataContainerPbMsg = obsDataContainer->GetDataContainerPbMsg();
+      envStateMsg.mutable_obsdata()->CopyFrom(obsDataContainerPbMsg);
+    }
+    // reward
+    envStateMsg.set_reward(reward);
+    // game over
+    envStateMsg.set_isgameover(false);
+    if (isGameOver)
+    {
+      envStateMsg.set_isgameover(true);
+      envStateMsg.set_reason(reason);
+    }
+
+    // extra info
+    envStateMsg.set_info(extraInfo);
+    envStateMsg.set_stepid(m_stepId);
 
-  ns3opengym::EnvStateMsg envStateMsg;
-  // observation
-  ns3opengym::DataContainer obsDataContainerPbMsg;
-  if (obsDataContainer) {
-    obsDataContainerPbMsg = obsDataContainer->GetDataContainerPbMsg();
-    envStateMsg.mutable_obsdata()->CopyFrom(obsDataContainerPbMsg);
+    // send env state msg to python
+    zmq::message_t request(envStateMsg.ByteSizeLong());;
+    envStateMsg.SerializeToArray(request.data(), envStateMsg.ByteSizeLong());
+    m_zmq_socket.send (request, zmq::send_flags::none);
   }
-  // reward
-  envStateMsg.set_reward(reward);
-  // game over
-  envStateMsg.set_isgameover(false);
-  if (isGameOver)
-  {
-    envStateMsg.set_isgameover(true);
-    if (m_simEnd) {
-      envStateMsg.set_reason(ns3opengym::EnvStateMsg::SimulationEnd);
-    } else {
-      envStateMsg.set_reason(ns3opengym::EnvStateMsg::GameOver);
+
+  if (m_pipelined) {
+    // at the end of the simulation wait for the answer to the last observation
+    ReceivePipelinedActions (m_simEnd ? 0 : m_maxActionLag);
+    return;
+  }
+
+  // receive act msg form python
+  ReceiveAction (true);
+}
+
+void
+OpenGymInterface::ReceivePipelinedActions (uint64_t maxLag)
+{
+  NS_LOG_FUNCTION (this << maxLag);
+  while (m_lastAnsweredStepId < m_stepId) {
+    bool block = (m_stepId - m_lastAnsweredStepId) > maxLag;
+    if (!ReceiveAction (block)) {
+      // nothing arrived yet and the lag is within the bound: keep simulating
+      break;
     }
   }
+}
 
-  // extra info
-  envStateMsg.set_info(extraInfo);
+bool
+OpenGymInterface::ReceiveAction (bool block)
+{
+  NS_LOG_FUNCTION (this << block);
+  uint64_t stepId = 0;
+  bool stopSimReq = false;
+  Ptr<OpenGymDataContainer> actDataContainer;
+
+  if (m_shm) {
+    if (!m_shm->ReceiveAction (block, stepId, stopSimReq, actDataContainer)) {
+      return false;
+    }
+  } else {
+    zmq::message_t reply;
+    zmq::recv_result_t received = m_zmq_socket.recv (reply, block ? zmq::recv_flags::none
+                                                                   : zmq::recv_flags::dontwait);
+    if (!received) {
+      return false;
+    }
+    ns3opengym::EnvActMsg envActMsg;
+    envActMsg.ParseFromArray(reply.data(), reply.size());
+    stepId = envActMsg.stepid();
+    stopSimReq = envActMsg.stopsimreq();
+    if (!stopSimReq && !m_simEnd) {
+      ns3opengym::DataContainer actDataContainerPbMsg = envActMsg.actdata();
+      actDataContainer = OpenGymDataContainer::CreateFromDataContainerPbMsg(actDataContainerPbMsg);
+    }
+  }
 
-  // send env state msg to python
-  zmq::message_t request(envStateMsg.ByteSizeLong());;
-  envStateMsg.SerializeToArray(request.data(), envStateMsg.ByteSizeLong());
-  m_zmq_socket.send (request, zmq::send_flags::none);
+  HandleAction (stepId, stopSimReq, actDataContainer);
+  return true;
+}
 
-  // receive act msg form python
-  ns3opengym::EnvActMsg envActMsg;
-  zmq::message_t reply;
-  (void) m_zmq_socket.recv (reply, zmq::recv_flags::none);
-  envActMsg.ParseFromArray(reply.data(), reply.size());
+void
+OpenGymInterface::HandleAction (uint64_t stepId, bool stopSimReq, Ptr<OpenGymDataContainer> action)
+{
+  NS_LOG_FUNCTION (this << stepId << stopSimReq);
+  if (m_pipelined) {
+    // the action must answer an observation that was sent and not answered yet
+    if (stepId <= m_lastAnsweredStepId || stepId > m_stepId) {
+      NS_LOG_WARN ("Discarding action for step " << stepId << ", last answered step "
+                   << m_lastAnsweredStepId << ", last sent step " << m_stepId);
+      return;
+    }
+  } else if (stepId != 0 && stepId != m_stepId) {
+    // agents that do not tag their actions (stepId 0) are accepted in the synchronous mode
+    NS_LOG_WARN ("Action for step " << stepId << " received as answer to step " << m_stepId);
+  }
+  // the agent may answer only the most recent of several queued observations
+  m_lastAnsweredStepId = m_pipelined ? stepId : m_stepId;
 
   if (m_simEnd) {
     // if sim end only rx ms and quit
     return;
   }
 
-  bool stopSim = envActMsg.stopsimreq();
-  if (stopSim) {
-    NS_LOG_DEBUG("---Stop requested: " << stopSim);
+  if (stopSimReq) {
+    NS_LOG_DEBUG("---Stop requested: " << stopSimReq);
     m_stopEnvRequested = true;
     Simulator::Stop();
     Simulator::Destroy ();
@@ -279,10 +411,20 @@ OpenGymInterface::NotifyCurrentState()
   }
 
   // first step after reset is called without actions, just to get current state
-  ns3opengym::DataContainer actDataContainerPbMsg = envActMsg.actdata();
-  Ptr<OpenGymDataContainer> actDataContainer = OpenGymDataContainer::CreateFromDataContainerPbMsg(actDataContainerPbMsg);
-  ExecuteActions(actDataContainer);
+  m_actionStepId = m_lastAnsweredStepId;
+  ExecuteActions(action);
+}
 
+uint64_t
+OpenGymInterface::GetCurrentStepId () const
+{
+  return m_stepId;
+}
+
+uint64_t
+OpenGymInterface::GetActionStepId () const
+{
+  return m_actionStepId;
 }
 
 void
@@ -24,16 +24,27 @@
 
 #include "ns3/object.h"
 #include <zmq.hpp>
+#include <memory>
 
 namespace ns3 {
 
 class OpenGymSpace;
 class OpenGymDataContainer;
 class OpenGymEnv;
+class OpenGymShmTransport;
 
 class OpenGymInterface : public Object
 {
 public:
+  /**
+   * \brief How the states and the actions are exchanged with the agent
+   */
+  enum Transport
+  {
+    ZMQ,            //!< protobuf messages over the ZMQ socket
+    SHARED_MEMORY   //!< raw arrays in a shared memory segment, see OpenGymShmTransport
+  };
+
   static Ptr<OpenGymInterface> Get (uint32_t port=5555);
 
   OpenGymInterface (uint32_t port=5555);
@@ -65,6 +76,20 @@ public:
 
   void Notify(Ptr<OpenGymEnv> entity);
 
+  /**
+   * \brief Id of the step whose observation is being collected or was sent last
+   *
+   * Step ids start from 1 and increase by one at each NotifyCurrentState.
+   */
+  uint64_t GetCurrentStepId () const;
+  /**
+   * \brief Id of the step answered by the action being executed
+   *
+   * In the synchronous mode it is always equal to GetCurrentStepId. In the
+   * pipelined mode it can refer to an older step, up to MaxActionLag steps behind.
+   */
+  uint64_t GetActionStepId () const;
+
 protected:
   // Inherited
   virtual void DoInitialize (void);
@@ -74,6 +99,31 @@ private:
   static Ptr<OpenGymInterface> *DoGet (uint32_t port=5555);
   static void Delete (void);
 
+  /**
+   * \brief Receive the actions of the agent in the pipelined mode
+   * \param maxLag maximum number of sent observations that can stay unanswered
+   *
+   * Executes the actions already received, without blocking, and blocks only
+   * while more than maxLag observations are still waiting for an action.
+   */
+  void ReceivePipelinedActions (uint64_t maxLag);
+  /**
+   * \brief Receive the next action of the agent, over ZMQ or shared memory
+   * \param block if false, return immediately when no action is available
+   * \return true if an action was received and handled
+   */
+  bool ReceiveAction (bool block);
+  /**
+   * \brief Handle an action received from the agent
+   * \param stepId id of the step answered by the action
+   * \param stopSimReq true if the agent requests to stop the simulation
+   * \param action the action
+   *
+   * Checks the step id of the action against the observations sent so far,
+   * then stops the simulation or executes the action.
+   */
+  void HandleAction (uint64_t stepId, bool stopSimReq, Ptr<OpenGymDataContainer> action);
+
   uint32_t m_port;
   zmq::context_t m_zmq_context;
   zmq::socket_t m_zmq_socket;
@@ -82,6 +132,18 @@ private:
   bool m_stopEnvRequested;
   bool m_initSimMsgSent;
 
+  bool m_pipelined;          //!< true if the observations are not waited for by the agent
+  uint32_t m_maxActionLag;   //!< max number of unanswered observations in the pipelined mode
+  uint64_t m_stepId;         //!< id of the last observation sent to the agent
+  uint64_t m_lastAnsweredStepId; //!< id of the last observation answered by the agent
+  uint64_t m_actionStepId;   //!< id of the observation answered by the executed action
+
+  Transport m_transport;     //!< transport of the states and actions
+  uint32_t m_shmSlots;       //!< number of slots of the shared memory rings
+  uint32_t m_shmMaxObsBytes; //!< capacity of an observation in shared memory
+  uint32_t m_shmMaxActBytes; //!< capacity of an action in shared memory
+  std::unique_ptr<OpenGymShmTransport> m_shm; //!< shared memory transport, if in use
+
   Callback< Ptr<OpenGymSpace> > m_actionSpaceCb;
   Callback< Ptr<OpenGymSpace> > m_observationSpaceCb;
   Callback< bool > m_gameOverCb;
@@ -0,0 +1,337 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "opengym_shm_transport.h"
+#include "container.h"
+#include "messages.pb.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+#include "ns3/fatal-error.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OpenGymShmTransport");
+
+static_assert (sizeof (OpenGymShmControl) <= 4096, "control block must fit in a page");
+static_assert (offsetof (OpenGymShmControl, obsSeq) == 64, "layout mirrored by ns3gym/shm.py");
+static_assert (offsetof (OpenGymShmControl, obsReadSeq) == 128, "layout mirrored by ns3gym/shm.py");
+static_assert (offsetof (OpenGymShmControl, actSeq) == 192, "layout mirrored by ns3gym/shm.py");
+static_assert (offsetof (OpenGymShmControl, actReadSeq) == 256, "layout mirrored by ns3gym/shm.py");
+static_assert (sizeof (OpenGymShmStateSlot) == 256, "layout mirrored by ns3gym/shm.py");
+static_assert (sizeof (OpenGymShmActionSlot) == 64, "layout mirrored by ns3gym/shm.py");
+static_assert (sizeof (std::atomic<uint32_t>) == sizeof (uint32_t)
+               && std::atomic<uint32_t>::is_always_lock_free,
+               "futexes need plain 32 bit lock free atomics");
+
+static const size_t CONTROL_BYTES = 4096; //!< the control block takes a page
+static const uint32_t SPIN_COUNT = 1000;  //!< polls before sleeping on the futex
+
+static uint32_t
+RoundUp64 (uint32_t bytes)
+{
+  return (bytes + 63u) & ~63u;
+}
+
+#ifdef __linux__
+static void
+FutexWait (std::atomic<uint32_t> *addr, uint32_t expected)
+{
+  // the segment is shared with another process: no FUTEX_PRIVATE_FLAG
+  syscall (SYS_futex, reinterpret_cast<uint32_t *> (addr), FUTEX_WAIT, expected,
+           nullptr, nullptr, 0);
+}
+
+static void
+FutexWake (std::atomic<uint32_t> *addr)
+{
+  syscall (SYS_futex, reinterpret_cast<uint32_t *> (addr), FUTEX_WAKE, INT_MAX,
+           nullptr, nullptr, 0);
+}
+#endif
+
+/**
+ * \brief Wait until the counter changes from the given value
+ */
+static void
+WaitWhileEqual (std::atomic<uint32_t> *addr, uint32_t value)
+{
+  for (uint32_t i = 0; i < SPIN_COUNT; ++i)
+    {
+      if (addr->load (std::memory_order_acquire) != value)
+        {
+          return;
+        }
+    }
+#ifdef __linux__
+  while (addr->load (std::memory_order_acquire) == value)
+    {
+      FutexWait (addr, value);
+    }
+#endif
+}
+
+template <typename T>
+static bool
+WriteBox (Ptr<OpenGymDataContainer> obs, const char *dtype, OpenGymShmStateSlot *slot,
+          uint32_t capacity)
+{
+  Ptr<OpenGymBoxContainer<T> > box = DynamicCast<OpenGymBoxContainer<T> > (obs);
+  if (!box)
+    {
+      return false;
+    }
+  const std::vector<T> &data = box->GetDataRef ();
+  uint32_t bytes = static_cast<uint32_t> (data.size () * sizeof (T));
+  NS_ABORT_MSG_IF (bytes > capacity, "Observation of " << bytes << " bytes does not fit in the "
+                   << capacity << " bytes of a shared memory slot, increase ShmMaxObservationBytes");
+
+  std::vector<uint32_t> shape = box->GetShape ();
+  NS_ABORT_MSG_IF (shape.size () > 4, "Observations with more than 4 dimensions are not supported");
+  slot->ndim = static_cast<uint32_t> (shape.size ());
+  std::copy (shape.begin (), shape.end (), slot->shape);
+  std::memset (slot->dtype, 0, sizeof (slot->dtype));
+  std::memcpy (slot->dtype, dtype, std::min (std::strlen (dtype), sizeof (slot->dtype)));
+  slot->dataBytes = bytes;
+  std::memcpy (reinterpret_cast<uint8_t *> (slot) + sizeof (OpenGymShmStateSlot),
+               data.data (), bytes);
+  return true;
+}
+
+template <typename T>
+static Ptr<OpenGymDataContainer>
+ReadBox (const OpenGymShmActionSlot *slot, uint32_t capacity)
+{
+  NS_ABORT_MSG_IF (slot->count > capacity / sizeof (T), "Action of " << slot->count
+                   << " elements of " << sizeof (T) << " bytes does not fit in the "
+                   << capacity << " bytes of a shared memory slot");
+  const T *begin = reinterpret_cast<const T *> (reinterpret_cast<const uint8_t *> (slot)
+                                                + sizeof (OpenGymShmActionSlot));
+  Ptr<OpenGymBoxContainer<T> > box = CreateObject<OpenGymBoxContainer<T> > ();
+  box->SetData (std::vector<T> (begin, begin + slot->count));
+  return box;
+}
+
+OpenGymShmTransport::OpenGymShmTransport (const std::string &name, uint32_t slots,
+                                          uint32_t maxObsBytes, uint32_t maxActBytes)
+  : m_name (name),
+    m_slots (slots),
+    m_maxObsBytes (RoundUp64 (maxObsBytes)),
+    m_maxActBytes (RoundUp64 (maxActBytes)),
+    m_size (0),
+    m_base (nullptr),
+    m_control (nullptr)
+{
+  NS_LOG_FUNCTION (this << name << slots << maxObsBytes << maxActBytes);
+  NS_ABORT_MSG_IF (slots == 0, "At least one shared memory slot is needed");
+#ifdef __linux__
+  uint32_t stateSlotBytes = sizeof (OpenGymShmStateSlot) + m_maxObsBytes;
+  uint32_t actSlotBytes = sizeof (OpenGymShmActionSlot) + m_maxActBytes;
+  m_size = CONTROL_BYTES + static_cast<size_t> (slots) * (stateSlotBytes + actSlotBytes);
+
+  // a segment left by a crashed run with the same name is replaced
+  shm_unlink (m_name.c_str ());
+  int fd = shm_open (m_name.c_str (), O_CREAT | O_EXCL | O_RDWR, 0600);
+  NS_ABORT_MSG_IF (fd < 0, "Cannot create the shared memory segment " << m_name
+                   << ": " << std::strerror (errno));
+  if (ftruncate (fd, static_cast<off_t> (m_size)) != 0)
+    {
+      int err = errno;
+      close (fd);
+      shm_unlink (m_name.c_str ());
+      NS_FATAL_ERROR ("Cannot size the shared memory segment " << m_name << ": "
+                      << std::strerror (err));
+    }
+  void *addr = mmap (nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (addr == MAP_FAILED)
+    {
+      int err = errno;
+      shm_unlink (m_name.c_str ());
+      NS_FATAL_ERROR ("Cannot map the shared memory segment " << m_name << ": "
+                      << std::strerror (err));
+    }
+  // ftruncate zero-fills the segment, so the counters start from 0
+  m_base = static_cast<uint8_t *> (addr);
+  m_control = new (m_base) OpenGymShmControl ();
+  m_control->magic = MAGIC;
+  m_control->version = VERSION;
+  m_control->slots = slots;
+  m_control->maxObsBytes = m_maxObsBytes;
+  m_control->maxActBytes = m_maxActBytes;
+  m_control->stateSlotBytes = stateSlotBytes;
+  m_control->actSlotBytes = actSlotBytes;
+  m_control->obsSeq.store (0, std::memory_order_relaxed);
+  m_control->obsReadSeq.store (0, std::memory_order_relaxed);
+  m_control->actSeq.store (0, std::memory_order_relaxed);
+  m_control->actReadSeq.store (0, std::memory_order_release);
+#else
+  NS_FATAL_ERROR ("The shared memory transport of OpenGym is only available on Linux");
+#endif
+}
+
+OpenGymShmTransport::~OpenGymShmTransport ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef __linux__
+  if (m_base != nullptr)
+    {
+      munmap (m_base, m_size);
+      shm_unlink (m_name.c_str ());
+    }
+#endif
+  m_base = nullptr;
+  m_control = nullptr;
+}
+
+std::string
+OpenGymShmTransport::GetName () const
+{
+  return m_name;
+}
+
+uint32_t
+OpenGymShmTransport::GetSlots () const
+{
+  return m_slots;
+}
+
+OpenGymShmStateSlot *
+OpenGymShmTransport::GetStateSlot (uint32_t seq) const
+{
+  size_t offset = CONTROL_BYTES + static_cast<size_t> (seq % m_slots) * m_control->stateSlotBytes;
+  return reinterpret_cast<OpenGymShmStateSlot *> (m_base + offset);
+}
+
+OpenGymShmActionSlot *
+OpenGymShmTransport::GetActionSlot (uint32_t seq) const
+{
+  size_t offset = CONTROL_BYTES + static_cast<size_t> (m_slots) * m_control->stateSlotBytes
+    + static_cast<size_t> (seq % m_slots) * m_control->actSlotBytes;
+  return reinterpret_cast<OpenGymShmActionSlot *> (m_base + offset);
+}
+
+void
+OpenGymShmTransport::SendState (uint64_t stepId, Ptr<OpenGymDataContainer> obs, float reward,
+                                bool isGameOver, uint32_t reason, const std::string &info)
+{
+  NS_LOG_FUNCTION (this << stepId);
+  uint32_t seq = m_control->obsSeq.load (std::memory_order_relaxed);
+  // wait for a free slot: the agent may still be reading the older observations
+  uint32_t readSeq = m_control->obsReadSeq.load (std::memory_order_acquire);
+  while (seq - readSeq >= m_slots)
+    {
+      WaitWhileEqual (&m_control->obsReadSeq, readSeq);
+      readSeq = m_control->obsReadSeq.load (std::memory_order_acquire);
+    }
+
+  OpenGymShmStateSlot *slot = GetStateSlot (seq);
+  slot->stepId = stepId;
+  slot->reward = reward;
+  slot->isGameOver = isGameOver ? 1 : 0;
+  slot->reason = reason;
+  slot->ndim = 0;
+  slot->dataBytes = 0;
+  std::memset (slot->dtype, 0, sizeof (slot->dtype));
+  slot->infoBytes = static_cast<uint32_t> (std::min (info.size (), sizeof (slot->info)));
+  if (info.size () > sizeof (slot->info))
+    {
+      NS_LOG_LOGIC ("Extra info truncated to " << sizeof (slot->info) << " bytes");
+    }
+  std::memcpy (slot->info, info.data (), slot->infoBytes);
+
+  if (obs)
+    {
+      bool written = WriteBox<uint8_t> (obs, "u1", slot, m_maxObsBytes)
+        || WriteBox<uint16_t> (obs, "u2", slot, m_maxObsBytes)
+        || WriteBox<uint32_t> (obs, "u4", slot, m_maxObsBytes)
+        || WriteBox<uint64_t> (obs, "u8", slot, m_maxObsBytes)
+        || WriteBox<int8_t> (obs, "i1", slot, m_maxObsBytes)
+        || WriteBox<int16_t> (obs, "i2", slot, m_maxObsBytes)
+        || WriteBox<int32_t> (obs, "i4", slot, m_maxObsBytes)
+        || WriteBox<int64_t> (obs, "i8", slot, m_maxObsBytes)
+        || WriteBox<float> (obs, "f4", slot, m_maxObsBytes)
+        || WriteBox<double> (obs, "f8", slot, m_maxObsBytes);
+      NS_ABORT_MSG_UNLESS (written, "The shared memory transport supports only Box observations");
+    }
+
+  m_control->obsSeq.store (seq + 1, std::memory_order_release);
+#ifdef __linux__
+  FutexWake (&m_control->obsSeq);
+#endif
+}
+
+bool
+OpenGymShmTransport::ReceiveAction (bool block, uint64_t &stepId, bool &stopSimReq,
+                                    Ptr<OpenGymDataContainer> &action)
+{
+  NS_LOG_FUNCTION (this << block);
+  uint32_t seq = m_control->actReadSeq.load (std::memory_order_relaxed);
+  if (m_control->actSeq.load (std::memory_order_acquire) == seq)
+    {
+      if (!block)
+        {
+          return false;
+        }
+      WaitWhileEqual (&m_control->actSeq, seq);
+    }
+
+  const OpenGymShmActionSlot *slot = GetActionSlot (seq);
+  stepId = slot->stepId;
+  stopSimReq = slot->stopSimReq != 0;
+  NS_ABORT_MSG_IF (slot->dataBytes > m_maxActBytes, "Action of " << slot->dataBytes
+                   << " bytes does not fit in a shared memory slot");
+  // same container types as OpenGymDataContainer::CreateFromDataContainerPbMsg
+  switch (slot->dtype)
+    {
+    case ns3opengym::INT:
+      action = ReadBox<int32_t> (slot, m_maxActBytes);
+      break;
+    case ns3opengym::UINT:
+      action = ReadBox<uint32_t> (slot, m_maxActBytes);
+      break;
+    case ns3opengym::DOUBLE:
+      action = ReadBox<double> (slot, m_maxActBytes);
+      break;
+    default:
+      action = ReadBox<float> (slot, m_maxActBytes);
+      break;
+    }
+
+  m_control->actReadSeq.store (seq + 1, std::memory_order_release);
+#ifdef __linux__
+  FutexWake (&m_control->actReadSeq);
+#endif
+  return true;
+}
+
+} // end of namespace ns3
@@ -0,0 +1,161 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef OPENGYM_SHM_TRANSPORT_H
+#define OPENGYM_SHM_TRANSPORT_H
+
+#include "ns3/ptr.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace ns3 {
+
+class OpenGymDataContainer;
+
+/**
+ * \brief Layout of the control block at the beginning of the shared memory segment
+ *
+ * The segment is made of the control block, followed by OpenGymShmTransport::GetSlots
+ * state slots and by the same number of action slots. Each counter is written by a
+ * single side and waited on with a futex by the other one; a slot is free when the
+ * writer counter is less than the reader counter plus the number of slots.
+ *
+ * The layout is mirrored by ns3gym/shm.py: any change must be reflected there
+ * and must increase the version.
+ */
+struct OpenGymShmControl
+{
+  uint32_t magic;              //!< OpenGymShmTransport::MAGIC
+  uint32_t version;            //!< OpenGymShmTransport::VERSION
+  uint32_t slots;              //!< number of state slots and of action slots
+  uint32_t maxObsBytes;        //!< capacity of the observation data of a state slot
+  uint32_t maxActBytes;        //!< capacity of the action data of an action slot
+  uint32_t stateSlotBytes;     //!< size of a state slot, header included
+  uint32_t actSlotBytes;       //!< size of an action slot, header included
+  uint32_t pad0;
+  alignas (64) std::atomic<uint32_t> obsSeq;      //!< states written by ns-3
+  alignas (64) std::atomic<uint32_t> obsReadSeq;  //!< states released by the agent
+  alignas (64) std::atomic<uint32_t> actSeq;      //!< actions written by the agent
+  alignas (64) std::atomic<uint32_t> actReadSeq;  //!< actions consumed by ns-3
+};
+
+/**
+ * \brief Header of a state slot, followed by the observation data
+ */
+struct OpenGymShmStateSlot
+{
+  uint64_t stepId;             //!< id of the step (see OpenGymInterface::GetCurrentStepId)
+  float reward;                //!< reward
+  uint32_t isGameOver;         //!< 1 if the game is over
+  uint32_t reason;             //!< ns3opengym::EnvStateMsg::Reason
+  uint32_t ndim;               //!< number of dimensions of the observation
+  uint32_t shape[4];           //!< shape of the observation
+  char dtype[4];               //!< numpy type string of the elements, e.g. "u2"
+  uint32_t dataBytes;          //!< size of the observation data
+  uint32_t infoBytes;          //!< size of the extra info
+  uint32_t pad0;
+  char info[200];              //!< extra info, truncated
+};
+
+/**
+ * \brief Header of an action slot, followed by the action data
+ */
+struct OpenGymShmActionSlot
+{
+  uint64_t stepId;             //!< id of the step answered by the action
+  uint32_t stopSimReq;         //!< 1 if the agent requests to stop the simulation
+  uint32_t dtype;              //!< ns3opengym::Dtype of the elements
+  uint32_t count;              //!< number of elements
+  uint32_t dataBytes;          //!< size of the action data
+  uint8_t pad0[40];
+};
+
+/**
+ * \brief Shared memory transport of the states and actions of OpenGymInterface
+ *
+ * Observations and actions of Box spaces are copied once, as raw arrays, into
+ * a POSIX shared memory segment instead of being serialized with protobuf and
+ * sent over ZMQ. The agent reads the observation through a numpy view of the
+ * segment, without any copy. The two processes synchronize with futexes on the
+ * counters of the control block: a waiting side first polls the counter, so it
+ * does not sleep when the peer answers quickly, and each publication of a
+ * counter is followed by a FUTEX_WAKE system call, whether or not the peer
+ * sleeps.
+ *
+ * The handshake (SimInitMsg) still goes through ZMQ and advertises the name of
+ * the segment, which is created by ns-3 and unlinked at destruction.
+ */
+class OpenGymShmTransport
+{
+public:
+  static const uint32_t MAGIC = 0x6e336779; //!< "n3gy"
+  static const uint32_t VERSION = 1;
+
+  /**
+   * \brief Create and map the shared memory segment
+   * \param name POSIX name of the segment, starting with '/'
+   * \param slots number of state slots and of action slots
+   * \param maxObsBytes capacity of the observation data
+   * \param maxActBytes capacity of the action data
+   */
+  OpenGymShmTransport (const std::string &name, uint32_t slots,
+                       uint32_t maxObsBytes, uint32_t maxActBytes);
+  ~OpenGymShmTransport ();
+
+  OpenGymShmTransport (const OpenGymShmTransport &) = delete;
+  OpenGymShmTransport &operator= (const OpenGymShmTransport &) = delete;
+
+  std::string GetName () const;
+  uint32_t GetSlots () const;
+
+  /**
+   * \brief Write a state in the next state slot and wake the agent
+   *
+   * Blocks while all the state slots are still in use by the agent. The
+   * observation must be a OpenGymBoxContainer of a numeric type.
+   */
+  void SendState (uint64_t stepId, Ptr<OpenGymDataContainer> obs, float reward,
+                  bool isGameOver, uint32_t reason, const std::string &info);
+
+  /**
+   * \brief Read the next action written by the agent
+   * \param block if true, wait for the action, otherwise return false if there is none
+   * \param [out] stepId id of the step answered by the action
+   * \param [out] stopSimReq true if the agent requests to stop the simulation
+   * \param [out] action the action, as a OpenGymBoxContainer of the type chosen by the agent
+   * \return true if an action was read
+   */
+  bool ReceiveAction (bool block, uint64_t &stepId, bool &stopSimReq,
+                      Ptr<OpenGymDataContainer> &action);
+
+private:
+  OpenGymShmStateSlot *GetStateSlot (uint32_t seq) const;
+  OpenGymShmActionSlot *GetActionSlot (uint32_t seq) const;
+
+  std::string m_name;           //!< POSIX name of the segment
+  uint32_t m_slots;             //!< number of slots of each ring
+  uint32_t m_maxObsBytes;       //!< observation data capacity
+  uint32_t m_maxActBytes;       //!< action data capacity
+  size_t m_size;                //!< size of the mapping
+  uint8_t *m_base;              //!< start of the mapping
+  OpenGymShmControl *m_control; //!< control block at the start of the mapping
+};
+
+} // end of namespace ns3
+
+#endif /* OPENGYM_SHM_TRANSPORT_H */
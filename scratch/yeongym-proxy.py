@@ -13,13 +13,19 @@ parser = argparse.ArgumentParser()
 parser.add_argument("--port", type=int, default=5555, help="Port to connect with ns-3 environment")
 parser.add_argument("--seed", type=int, default=0, help="Seed for environment reproducibility")
 parser.add_argument("--simTime", type=int, default=10, help="Simulation time")
+parser.add_argument("--pipelined", action="store_true",
+                    help="Pipelined mode (ns-3 started with --openGymPipelined=true)")
+parser.add_argument("--maxFlows", type=int, default=0,
+                    help="Fixed observation rows (ns-3 started with --gymMaxFlows=N)")
 args = parser.parse_args()
+obs_columns = 7 if args.maxFlows > 0 else 6
 
 # === ns-3 환경과 연결 ===
 env = ns3env.Ns3Env(
     port=args.port,
     stepTime=0.1,
     startSim=False, 
+    pipelined=args.pipelined,
     simArgs={
         # "--simTime": str(args.simTime),
         # "--simSeed": str(args.seed)
@@ -30,7 +36,7 @@ obs = env.reset()
 done = False
 
 action_space = env.action_space
-agent = YeongymAgent()
+agent = YeongymAgent(obs_columns=obs_columns)
 
 rewards = []
 step_count = 0
@@ -39,15 +45,15 @@ max_train_steps = 5000
 
 while not done and step_count < max_train_steps:
     # print("\n=== Observation per Flow ===")
-    for i in range(0, len(obs), 6): # sinr 추가시 7로 변경경
-        rnti = obs[i]
-        lcid = obs[i+1]
-        priority = obs[i+2]
-        hol_delay = obs[i+3]
-        aoi = obs[i+4]
-        cqi = obs[i+5]
-        # sinr = obs[i+6]
-        # print(f"[Flow {i//6}] RNTI: {rnti}, LCID: {lcid}, Priority: {priority}, "
+    for i, row in enumerate(np.asarray(obs).reshape(-1, obs_columns)):
+        rnti = row[0]
+        lcid = row[1]
+        priority = row[2]
+        hol_delay = row[3]
+        aoi = row[4]
+        cqi = row[5]
+        # sinr = row[6]
+        # print(f"[Flow {i}] RNTI: {rnti}, LCID: {lcid}, Priority: {priority}, "
         #       f"HOL Delay: {hol_delay}, AoI: {aoi}, CQI: {cqi}")
     action = agent.act(obs)
     obs, reward, done, info = env.step(action)
@@ -25,6 +25,8 @@
 #include "ns3/network-module.h"
 #include "ns3/nr-helper.h"
 #include "ns3/nr-mac-scheduler-ai-ns3-gym-env.h"
+#include "ns3/nr-mac-scheduler-ai-ns3-gym-vec-env.h"
+#include "ns3/nr-mac-scheduler-ai-policy.h"
 #include "ns3/nr-module.h"
 #include "ns3/nr-point-to-point-epc-helper.h"
 #include "ns3/nr-ue-rrc.h"
@@ -210,6 +212,18 @@ main(int argc, char* argv[])
     double simTime = 320;     // Simulation Time
 
     uint32_t openGymPort = 5555;
+    bool openGymPipelined = false;  // agent 응답을 기다리지 않고 시뮬레이션 진행
+    uint32_t openGymMaxActionLag = 1;
+    std::string openGymTransport = "Zmq"; // SharedMemory : obs/action 을 shm 으로 전달
+    std::string aiPolicy = "gym"; // gym : python agent, qtable/mlp : 학습된 정책을 ns-3 안에서 실행
+    std::string aiPolicyFile = "q_table.npy";
+    std::string aiMlpLayers = "6,32,32,1";
+    bool gymVecEnv = false; // gNB 마다 독립된 env, 하나의 agent step 으로 모든 gNB 를 처리
+    uint32_t gymMaxFlows = 0; // 0 : flow 수에 따라 obs 크기 변경, >0 : [gymMaxFlows, 7] 고정
+    std::string ulDecisionGranularity = "PerRbg"; // agent 호출 시점 (PerRbg, PerSlot, ...)
+    uint32_t ulDecisionPeriod = 1;
+    double ulMaxWeightAgeMs = 0.0; // 0 : weight 유효기간 제한 없음
+    bool incrementalUeOrder = false; // RBG 마다 UE 전체를 정렬하지 않고 heap 으로 관리
 
     CommandLine cmd;
     cmd.AddValue("centralFrequencyBand1",
@@ -224,6 +238,44 @@ main(int argc, char* argv[])
     cmd.AddValue("nPackets", "Number of paackets in each ue", nPackets);
     cmd.AddValue("simTime", "The simulation time", simTime);
     cmd.AddValue("openGymPort", "OpenGym communication port", openGymPort);
+    cmd.AddValue("openGymPipelined",
+                 "Keep simulating while the agent computes its action (start the agent with "
+                 "--pipelined)",
+                 openGymPipelined);
+    cmd.AddValue("openGymMaxActionLag",
+                 "Max number of unanswered observations in the pipelined mode",
+                 openGymMaxActionLag);
+    cmd.AddValue("openGymTransport",
+                 "How observations and actions are exchanged with the agent: Zmq or SharedMemory",
+                 openGymTransport);
+    cmd.AddValue("aiPolicy",
+                 "Where the weights of the AI scheduler come from: gym (Python agent), qtable or "
+                 "mlp (trained policy evaluated in the simulation, no agent needed)",
+                 aiPolicy);
+    cmd.AddValue("aiPolicyFile",
+                 "The .npy Q-table (qtable) or the flat weights file (mlp) of the policy",
+                 aiPolicyFile);
+    cmd.AddValue("aiMlpLayers", "Layer sizes of the mlp policy", aiMlpLayers);
+    cmd.AddValue("gymVecEnv",
+                 "One env per gNB, stepped together: observations [gNBNum, MaxFlows, 7] and "
+                 "actions [gNBNum, MaxFlows], MaxFlows given by gymMaxFlows (32 if 0)",
+                 gymVecEnv);
+    cmd.AddValue("gymMaxFlows",
+                 "Rows of the fixed-shape observation [gymMaxFlows, 7] with a validity mask "
+                 "column (0: one row per observed flow)",
+                 gymMaxFlows);
+    cmd.AddValue("ulDecisionGranularity",
+                 "When the agent is queried: PerRbg, PerSlot, EveryNSlots or OnUeSetChange",
+                 ulDecisionGranularity);
+    cmd.AddValue("ulDecisionPeriod",
+                 "Slots between two agent queries with EveryNSlots",
+                 ulDecisionPeriod);
+    cmd.AddValue("ulMaxWeightAgeMs",
+                 "Max age of the cached agent weights in ms (0 disables it)",
+                 ulMaxWeightAgeMs);
+    cmd.AddValue("incrementalUeOrder",
+                 "Keep the UEs in a heap re-keyed after each RBG instead of sorting them",
+                 incrementalUeOrder);
 
     cmd.Parse(argc, argv);
 
@@ -349,6 +401,9 @@ main(int argc, char* argv[])
      * 4 : OFDMA Ai (Reinforcement Learning)
      */
     int select_sch = 4;
+#ifdef HAVE_OPENGYM
+    Ptr<NrMacSchedulerAiNs3GymVecEnv> vecEnv; // gymVecEnv 사용 시에만 생성
+#endif
     if (select_sch == 1)
     {
         nrHelper->SetSchedulerTypeId(NrMacSchedulerOfdmaRR::GetTypeId());
@@ -366,19 +421,70 @@ main(int argc, char* argv[])
         std::cout << "[yeongym] <Scheduler Type : OfdmaAi>\n";
         nrHelper->SetSchedulerTypeId(NrMacSchedulerOfdmaAi::GetTypeId());
 
-        // AI 환경 객체 생성
-        Ptr<NrMacSchedulerAiNs3GymEnv> env = CreateObject<NrMacSchedulerAiNs3GymEnv>();
-        Ptr<NrMacSchedulerOfdmaAi> scheduler = CreateObject<NrMacSchedulerOfdmaAi>();
-        Ptr<OpenGymInterface> interface = CreateObject<OpenGymInterface>(openGymPort);
-        env->SetOpenGymInterface(interface);
-        env->SetScheduler(scheduler);
-
-        nrHelper->SetSchedulerAttribute(
-            "NotifyCbUl",
-            CallbackValue(MakeCallback(&NrMacSchedulerAiNs3GymEnv::NotifyCurrentIteration, env)));
+        if (aiPolicy == "qtable" || aiPolicy == "mlp")
+        {
+            // 학습된 정책을 scheduler callback 안에서 직접 실행 (python, ZMQ 불필요)
+            Ptr<NrMacSchedulerAiPolicy> policy;
+            if (aiPolicy == "qtable")
+            {
+                policy = CreateObject<NrMacSchedulerAiQTablePolicy>();
+                policy->SetAttribute("QTableFile", StringValue(aiPolicyFile));
+            }
+            else
+            {
+                policy = CreateObject<NrMacSchedulerAiMlpPolicy>();
+                policy->SetAttribute("LayerSizes", StringValue(aiMlpLayers));
+                policy->SetAttribute("WeightsFile", StringValue(aiPolicyFile));
+            }
+            nrHelper->SetSchedulerAttribute(
+                "NotifyCbUl",
+                CallbackValue(MakeCallback(&NrMacSchedulerAiPolicy::NotifyCurrentIteration, policy)));
+        }
+        else
+        {
+#ifdef HAVE_OPENGYM
+            Ptr<OpenGymInterface> interface = CreateObject<OpenGymInterface>(openGymPort);
+            interface->SetAttribute("Pipelined", BooleanValue(openGymPipelined));
+            interface->SetAttribute("MaxActionLag", UintegerValue(openGymMaxActionLag));
+            interface->SetAttribute("Transport", StringValue(openGymTransport));
+            if (gymVecEnv)
+            {
+                // gNB 별 scheduler 는 device 설치 후에 env 에 연결
+                vecEnv = CreateObject<NrMacSchedulerAiNs3GymVecEnv>(gNBNum);
+                if (gymMaxFlows > 0)
+                {
+                    vecEnv->SetAttribute("MaxFlows", UintegerValue(gymMaxFlows));
+                }
+                vecEnv->SetOpenGymInterface(interface);
+            }
+            else
+            {
+                // AI 환경 객체 생성
+                Ptr<NrMacSchedulerAiNs3GymEnv> env = CreateObject<NrMacSchedulerAiNs3GymEnv>();
+                Ptr<NrMacSchedulerOfdmaAi> scheduler = CreateObject<NrMacSchedulerOfdmaAi>();
+                env->SetAttribute("MaxFlows", UintegerValue(gymMaxFlows));
+                env->SetOpenGymInterface(interface);
+                env->SetScheduler(scheduler);
+
+                nrHelper->SetSchedulerAttribute(
+                    "NotifyCbUl",
+                    CallbackValue(
+                        MakeCallback(&NrMacSchedulerAiNs3GymEnv::NotifyCurrentIteration, env)));
+            }
+#else
+            NS_FATAL_ERROR("The gym policy needs the opengym module, use aiPolicy=qtable or mlp");
+#endif
+        }
         nrHelper->SetSchedulerAttribute("ActiveUlAi", BooleanValue(true));
+        nrHelper->SetSchedulerAttribute("UlDecisionGranularity",
+                                        StringValue(ulDecisionGranularity));
+        nrHelper->SetSchedulerAttribute("UlDecisionPeriod", UintegerValue(ulDecisionPeriod));
+        nrHelper->SetSchedulerAttribute("UlMaxWeightAge",
+                                        TimeValue(MicroSeconds(ulMaxWeightAgeMs * 1000)));
     }
 
+    nrHelper->SetSchedulerAttribute("IncrementalUeOrder", BooleanValue(incrementalUeOrder));
+
     // For data drop
     // === SrsSymbol setting ===
     nrHelper->SetSchedulerAttribute("SrsSymbols", UintegerValue(4));
@@ -444,6 +550,17 @@ main(int argc, char* argv[])
                                      PointerValue(CreateObject<ThreeGppAntennaModel>()));
     // Install NetDevice
     NetDeviceContainer enbNetDev = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+#ifdef HAVE_OPENGYM
+    if (vecEnv)
+    {
+        // gNB k 의 scheduler 가 vectorized env 의 k 번째 cell
+        for (uint32_t k = 0; k < enbNetDev.GetN(); ++k)
+        {
+            NrHelper::GetScheduler(enbNetDev.Get(k), 0)
+                ->SetAttribute("NotifyCbUl", CallbackValue(vecEnv->GetNotifyCb(k)));
+        }
+    }
+#endif
     NetDeviceContainer ueNetDev = nrHelper->InstallUeDevice(ueNodes, allBwps);
 
     // Set the attribute of the netdevice (enbNetDev.Get (0)) and bandwidth part (0)
@@ -2,7 +2,7 @@ import numpy as np
 import random
 
 class YeongymAgent:
-    def __init__(self, max_aoi=10000, max_cqi=15, aoi_bins=10, cqi_bins=5, num_weight_bins=11, epsilon=0.1, alpha=0.5, gamma=0.99,inference_mode=False):
+    def __init__(self, max_aoi=10000, max_cqi=15, aoi_bins=10, cqi_bins=5, num_weight_bins=11, epsilon=0.1, alpha=0.5, gamma=0.99,inference_mode=False, obs_columns=6):
         self.max_aoi = max_aoi
         self.max_cqi = max_cqi
        
@@ -23,6 +23,9 @@ class YeongymAgent:
 
         self.inference_mode = inference_mode
 
+        # 7 : ns-3 의 MaxFlows 사용 시, 마지막 column 은 valid mask (0 인 row 는 빈 row)
+        self.obs_columns = obs_columns
+
     def discretize(self, aoi, cqi):
         aoi_bin = min(int((aoi / self.max_aoi) * self.aoi_bins), self.aoi_bins-1)
         cqi_bin = min(int((cqi / self.max_cqi) * self.cqi_bins), self.cqi_bins-1)
@@ -36,10 +39,16 @@ class YeongymAgent:
         print(f"받은 observation 길이 = {len(observation)}")
         print(f"obs 내용: {observation}")
 
-        for i in range(0, len(observation), 6): # sinr 추가시 7로 변경경
-            aoi = observation[i + 4]
-            cqi = observation[i + 5]
-            # sinr = observation[i + 6]
+        # observation : [numFlows, obs_columns] (ZMQ 와 shared memory 모두 같은 shape)
+        for row in np.asarray(observation).reshape(-1, self.obs_columns):
+            if self.obs_columns > 6 and row[6] == 0:
+                # 빈 row : weight 는 무시되고 학습에서도 제외
+                self.current_states.append(None)
+                actions.append(0.0)
+                continue
+            aoi = row[4]
+            cqi = row[5]
+            # sinr = row[6]
 
             aoi_bin, cqi_bin= self.discretize(aoi, cqi)
             self.current_states.append((aoi_bin, cqi_bin))
@@ -62,8 +71,13 @@ class YeongymAgent:
     def learn(self, reward):
         if self.last_state is None or self.last_action is None:
             return
+        if all(state is None for state in self.last_state):
+            return
         
-        for idx, (aoi_bin, cqi_bin) in enumerate(self.last_state):
+        for idx, state in enumerate(self.last_state):
+            if state is None:
+                continue
+            aoi_bin, cqi_bin = state
             action_bin = int(round(self.last_action[idx] * (self.num_weight_bins - 1)))
 
             current_q = self.q_table[aoi_bin, cqi_bin, action_bin]
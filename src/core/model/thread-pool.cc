@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "thread-pool.h"
+
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup system
+ * ns3::ThreadPool implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ThreadPool");
+
+ThreadPool::ThreadPool(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    NS_ASSERT_MSG(numThreads > 0, "A thread pool needs at least one thread");
+    for (uint32_t i = 1; i < numThreads; ++i)
+    {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    NS_LOG_FUNCTION(this);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_jobReady.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+uint32_t
+ThreadPool::GetNThreads() const
+{
+    return static_cast<uint32_t>(m_workers.size()) + 1;
+}
+
+void
+ThreadPool::ParallelFor(std::size_t n, const std::function<void(std::size_t)>& f)
+{
+    NS_LOG_FUNCTION(this << n);
+    if (m_workers.empty() || n <= 1)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            f(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        NS_ASSERT_MSG(m_job == nullptr, "ParallelFor called concurrently");
+        m_job = &f;
+        m_size = n;
+        m_next.store(0, std::memory_order_relaxed);
+        m_busyWorkers = static_cast<uint32_t>(m_workers.size());
+        ++m_generation;
+    }
+    m_jobReady.notify_all();
+
+    RunIterations();
+
+    // the job must outlive the workers that may still be running its last iterations
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_jobDone.wait(lock, [this]() { return m_busyWorkers == 0; });
+    m_job = nullptr;
+}
+
+void
+ThreadPool::RunIterations()
+{
+    for (std::size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < m_size;
+         i = m_next.fetch_add(1, std::memory_order_relaxed))
+    {
+        (*m_job)(i);
+    }
+}
+
+void
+ThreadPool::WorkerLoop()
+{
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobReady.wait(lock, [this, generation]() {
+                return m_stop || m_generation != generation;
+            });
+            if (m_stop)
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        RunIterations();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busyWorkers == 0)
+        {
+            m_jobDone.notify_one();
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "simple-ref-count.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup system
+ * ns3::ThreadPool declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup system
+ * \brief A fixed set of worker threads running the iterations of a loop in parallel.
+ *
+ * ParallelFor(n, f) calls f(0), ..., f(n - 1) on the workers and on the calling thread,
+ * and returns when all the calls are done. The calls are not ordered: to keep a
+ * simulation deterministic, each call must only write to data of its own index, and
+ * anything that depends on the order (random variables, events, traces, reference
+ * counts of objects shared between indexes) must be done by the caller, before or after
+ * ParallelFor. In particular, the reference counts of ns3::Ptr are not atomic.
+ *
+ * The workers sleep between two calls of ParallelFor. A pool of one thread has no worker,
+ * and runs the loop on the calling thread.
+ */
+class ThreadPool : public SimpleRefCount<ThreadPool>
+{
+  public:
+    /**
+     * \brief Create the workers
+     * \param numThreads the number of threads running the loops, including the calling one
+     */
+    explicit ThreadPool(uint32_t numThreads);
+
+    /**
+     * \brief Stop and join the workers
+     */
+    ~ThreadPool();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * \return the number of threads running the loops, including the calling one
+     */
+    uint32_t GetNThreads() const;
+
+    /**
+     * \brief Call f(i) for each i in [0, n), in parallel
+     *
+     * Must not be called concurrently, nor from within f.
+     *
+     * \param n the number of iterations
+     * \param f the body of the loop
+     */
+    void ParallelFor(std::size_t n, const std::function<void(std::size_t)>& f);
+
+  private:
+    /**
+     * \brief Loop of a worker: wait for a job, run its iterations, repeat until stopped
+     */
+    void WorkerLoop();
+
+    /**
+     * \brief Run iterations of the current job until none is left
+     */
+    void RunIterations();
+
+    std::vector<std::thread> m_workers; //!< Worker threads
+    std::mutex m_mutex;                 //!< Protects the job and the counters below
+    std::condition_variable m_jobReady; //!< Signals a new job, or the stop, to the workers
+    std::condition_variable m_jobDone;  //!< Signals the end of the job to the caller
+    uint64_t m_generation{0};           //!< Number of the current job
+    uint32_t m_busyWorkers{0};          //!< Workers that did not finish the current job
+    bool m_stop{false};                 //!< Whether the workers must exit
+
+    const std::function<void(std::size_t)>* m_job{nullptr}; //!< Body of the current loop
+    std::size_t m_size{0};                                   //!< Iterations of the current loop
+    std::atomic<std::size_t> m_next{0};                      //!< Next iteration to run
+};
+
+} // namespace ns3
+
+#endif /* THREAD_POOL_H */
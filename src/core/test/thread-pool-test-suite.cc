@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/thread-pool.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup core-tests
+ * ThreadPool test suite
+ */
+
+/**
+ * \ingroup core-tests
+ *
+ * \brief Check that ParallelFor runs each iteration exactly once, for several loops in a
+ * row, with a given number of threads.
+ */
+class ThreadPoolTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param threads The number of threads of the pool.
+     */
+    ThreadPoolTestCase(uint32_t threads);
+
+  private:
+    void DoRun() override;
+
+    uint32_t m_threads; //!< The number of threads of the pool.
+};
+
+ThreadPoolTestCase::ThreadPoolTestCase(uint32_t threads)
+    : TestCase("Check ThreadPool::ParallelFor with " + std::to_string(threads) + " threads"),
+      m_threads(threads)
+{
+}
+
+void
+ThreadPoolTestCase::DoRun()
+{
+    ThreadPool pool(m_threads);
+    NS_TEST_ASSERT_MSG_EQ(pool.GetNThreads(), m_threads, "Wrong number of threads");
+
+    for (std::size_t n : {0, 1, 2, 7, 1000, 3, 10000})
+    {
+        std::vector<uint32_t> calls(n, 0);
+        std::vector<double> values(n, 0.0);
+        pool.ParallelFor(n, [&](std::size_t i) {
+            ++calls[i];
+            double x = 0;
+            for (std::size_t k = 0; k <= i % 64; ++k)
+            {
+                x += 1.0 / (k + 1);
+            }
+            values[i] = x;
+        });
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            NS_TEST_ASSERT_MSG_EQ(calls[i], 1, "Iteration " << i << " not run exactly once");
+            double x = 0;
+            for (std::size_t k = 0; k <= i % 64; ++k)
+            {
+                x += 1.0 / (k + 1);
+            }
+            NS_TEST_ASSERT_MSG_EQ(values[i], x, "Wrong value of iteration " << i);
+        }
+    }
+}
+
+/**
+ * \ingroup core-tests
+ *
+ * \brief The ThreadPool test suite.
+ */
+class ThreadPoolTestSuite : public TestSuite
+{
+  public:
+    ThreadPoolTestSuite()
+        : TestSuite("thread-pool", Type::UNIT)
+    {
+        for (uint32_t threads : {1, 2, 4, 9})
+        {
+            AddTestCase(new ThreadPoolTestCase(threads), TestCase::Duration::QUICK);
+        }
+    }
+};
+
+static ThreadPoolTestSuite g_threadPoolTestSuite; //!< Static variable for test initialization
@@ -226,6 +226,11 @@ ChannelConditionModel::~ChannelConditionModel()
 {
 }
 
+void
+ChannelConditionModel::RemoveNode(uint32_t nodeId)
+{
+}
+
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED(AlwaysLosChannelConditionModel);
@@ -445,6 +450,7 @@ ThreeGppChannelConditionModel::GetChannelCondition(Ptr<const MobilityModel> a,
         Item mapItem;
         mapItem.m_condition = cond;
         mapItem.m_generatedTime = Simulator::Now();
+        mapItem.m_nodeIds = {a->GetObject<Node>()->GetId(), b->GetObject<Node>()->GetId()};
         const_cast<ThreeGppChannelConditionModel*>(this)->m_channelConditionMap[key] = mapItem;
     }
 
@@ -559,6 +565,23 @@ ThreeGppChannelConditionModel::AssignStreams(int64_t stream)
     return 3;
 }
 
+void
+ThreeGppChannelConditionModel::RemoveNode(uint32_t nodeId)
+{
+    NS_LOG_FUNCTION(this << nodeId);
+    for (auto it = m_channelConditionMap.begin(); it != m_channelConditionMap.end();)
+    {
+        if (it->second.m_nodeIds.first == nodeId || it->second.m_nodeIds.second == nodeId)
+        {
+            it = m_channelConditionMap.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
 double
 ThreeGppChannelConditionModel::Calculate2dDistance(const Vector& a, const Vector& b)
 {
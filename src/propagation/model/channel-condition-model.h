@@ -26,6 +26,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <utility>
 
 namespace ns3
 {
@@ -277,6 +278,15 @@ class ChannelConditionModel : public Object
      * \return the number of stream indices assigned by this model
      */
     virtual int64_t AssignStreams(int64_t stream) = 0;
+
+    /**
+     * Forget the channel conditions of a node, if the model keeps them, so that they
+     * are generated anew the next time they are requested. The default implementation
+     * does nothing.
+     *
+     * \param nodeId the ID of the node
+     */
+    virtual void RemoveNode(uint32_t nodeId);
 };
 
 /**
@@ -484,6 +494,13 @@ class ThreeGppChannelConditionModel : public ChannelConditionModel
      */
     int64_t AssignStreams(int64_t stream) override;
 
+    /**
+     * Removes the channel conditions of the pairs of nodes including a node
+     *
+     * \param nodeId the ID of the node
+     */
+    void RemoveNode(uint32_t nodeId) override;
+
     /**
      * Computes and quantizes the elevation angle to a two-digits integer in [10, 90].
      * Asserts that the provided mobility models are of the expected type, i.e.,
@@ -574,8 +591,9 @@ class ThreeGppChannelConditionModel : public ChannelConditionModel
      */
     struct Item
     {
-        Ptr<ChannelCondition> m_condition; //!< the channel condition
-        Time m_generatedTime;              //!< the time when the condition was generated
+        Ptr<ChannelCondition> m_condition;         //!< the channel condition
+        Time m_generatedTime;                      //!< the time when the condition was generated
+        std::pair<uint32_t, uint32_t> m_nodeIds{}; //!< the IDs of the nodes of the channel
     };
 
     std::unordered_map<uint32_t, Item>
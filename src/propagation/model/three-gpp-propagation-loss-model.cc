@@ -484,6 +484,7 @@ ThreeGppPropagationLossModel::GetO2iLowPenetrationLoss(
         notFound = true;
         // add a new entry in the map and update the iterator
         O2iLossMapItem newItem;
+        newItem.m_nodeIds = {a->GetObject<Node>()->GetId(), b->GetObject<Node>()->GetId()};
         it = m_o2iLossMap.insert(it, std::make_pair(key, newItem));
     }
 
@@ -554,6 +555,7 @@ ThreeGppPropagationLossModel::GetO2iHighPenetrationLoss(
         notFound = true;
         // add a new entry in the map and update the iterator
         O2iLossMapItem newItem;
+        newItem.m_nodeIds = {a->GetObject<Node>()->GetId(), b->GetObject<Node>()->GetId()};
         it = m_o2iLossMap.insert(it, std::make_pair(key, newItem));
     }
 
@@ -647,6 +649,7 @@ ThreeGppPropagationLossModel::GetShadowing(Ptr<MobilityModel> a,
 
         // add a new entry in the map and update the iterator
         ShadowingMapItem newItem;
+        newItem.m_nodeIds = {a->GetObject<Node>()->GetId(), b->GetObject<Node>()->GetId()};
         it = m_shadowingMap.insert(it, std::make_pair(key, newItem));
     }
 
@@ -713,6 +716,27 @@ ThreeGppPropagationLossModel::GetKey(Ptr<MobilityModel> a, Ptr<MobilityModel> b)
     return key;
 }
 
+void
+ThreeGppPropagationLossModel::RemoveNode(uint32_t nodeId)
+{
+    NS_LOG_FUNCTION(this << nodeId);
+    auto removeNode = [nodeId](auto& map) {
+        for (auto it = map.begin(); it != map.end();)
+        {
+            if (it->second.m_nodeIds.first == nodeId || it->second.m_nodeIds.second == nodeId)
+            {
+                it = map.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    };
+    removeNode(m_shadowingMap);
+    removeNode(m_o2iLossMap);
+}
+
 Vector
 ThreeGppPropagationLossModel::GetVectorDifference(Ptr<MobilityModel> a, Ptr<MobilityModel> b)
 {
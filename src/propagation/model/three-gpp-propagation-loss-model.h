@@ -86,6 +86,17 @@ class ThreeGppPropagationLossModel : public PropagationLossModel
      */
     bool IsO2iLowPenetrationLoss(Ptr<const ChannelCondition> cond) const;
 
+    /**
+     * \brief Removes the shadowing and o2i losses of the pairs of nodes including a node
+     *
+     * The losses of the channels of the node are generated anew, as independent
+     * realizations, the next time they are computed. The channel conditions are
+     * kept by the channel condition model, see ChannelConditionModel::RemoveNode.
+     *
+     * \param nodeId the ID of the node
+     */
+    void RemoveNode(uint32_t nodeId);
+
   private:
     /**
      * Computes the received power by applying the pathloss model described in
@@ -286,6 +297,7 @@ class ThreeGppPropagationLossModel : public PropagationLossModel
         double m_shadowing;                              //!< the shadowing loss in dB
         ChannelCondition::LosConditionValue m_condition; //!< the LOS/NLOS condition
         Vector m_distance;                               //!< the vector AB
+        std::pair<uint32_t, uint32_t> m_nodeIds{};       //!< the IDs of the nodes
     };
 
     mutable std::unordered_map<uint32_t, ShadowingMapItem>
@@ -296,6 +308,7 @@ class ThreeGppPropagationLossModel : public PropagationLossModel
     {
         double m_o2iLoss;                                //!< the o2i loss in dB
         ChannelCondition::LosConditionValue m_condition; //!< the LOS/NLOS condition
+        std::pair<uint32_t, uint32_t> m_nodeIds{};       //!< the IDs of the nodes
     };
 
     mutable std::unordered_map<uint32_t, O2iLossMapItem>
@@ -25,6 +25,7 @@
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/mobility-helper.h"
+#include "ns3/rng-seed-manager.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 #include "ns3/three-gpp-propagation-loss-model.h"
@@ -1302,6 +1303,72 @@ ThreeGppShadowingTestCase::DoRun()
     }
 }
 
+/**
+ * \ingroup propagation-tests
+ *
+ * Test to check that the shadowing and the channel condition of a pair of nodes are
+ * kept until one of the nodes is removed with RemoveNode
+ */
+class ThreeGppRemoveNodeTestCase : public TestCase
+{
+  public:
+    ThreeGppRemoveNodeTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+ThreeGppRemoveNodeTestCase::ThreeGppRemoveNodeTestCase()
+    : TestCase("Test to check that RemoveNode forgets the shadowing and the channel condition")
+{
+}
+
+void
+ThreeGppRemoveNodeTestCase::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+    a->SetPosition(Vector(0.0, 0.0, 25.0));
+    nodes.Get(0)->AggregateObject(a);
+    Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+    b->SetPosition(Vector(100.0, 0.0, 1.5));
+    nodes.Get(1)->AggregateObject(b);
+
+    auto conditionModel = CreateObject<ThreeGppUmaChannelConditionModel>();
+    conditionModel->AssignStreams(1);
+    Ptr<ChannelCondition> condition = conditionModel->GetChannelCondition(a, b);
+    NS_TEST_EXPECT_MSG_EQ(conditionModel->GetChannelCondition(b, a),
+                          condition,
+                          "The channel condition should be kept");
+    conditionModel->RemoveNode(nodes.Get(1)->GetId());
+    NS_TEST_EXPECT_MSG_NE(conditionModel->GetChannelCondition(a, b),
+                          condition,
+                          "The channel condition should be generated anew");
+
+    auto lossModel = CreateObject<ThreeGppUmaPropagationLossModel>();
+    lossModel->SetAttribute("Frequency", DoubleValue(3.5e9));
+    lossModel->SetChannelConditionModel(CreateObject<AlwaysLosChannelConditionModel>());
+    lossModel->AssignStreams(2);
+    // the first realization is stored without the distance vector: the second one is
+    // correlated with it, and kept from then on since the nodes do not move
+    lossModel->CalcRxPower(0, a, b);
+    double rxPower = lossModel->CalcRxPower(0, a, b);
+    NS_TEST_EXPECT_MSG_EQ_TOL(lossModel->CalcRxPower(0, a, b),
+                              rxPower,
+                              1e-9,
+                              "The shadowing should be kept");
+    lossModel->RemoveNode(nodes.Get(0)->GetId());
+    NS_TEST_EXPECT_MSG_GT(std::abs(lossModel->CalcRxPower(0, a, b) - rxPower),
+                          1e-9,
+                          "The shadowing should be generated anew");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup propagation-tests
  *
@@ -1332,6 +1399,7 @@ ThreeGppPropagationLossModelsTestSuite::ThreeGppPropagationLossModelsTestSuite()
     AddTestCase(new ThreeGppV2vUrbanPropagationLossModelTestCase, TestCase::Duration::QUICK);
     AddTestCase(new ThreeGppV2vHighwayPropagationLossModelTestCase, TestCase::Duration::QUICK);
     AddTestCase(new ThreeGppShadowingTestCase, TestCase::Duration::QUICK);
+    AddTestCase(new ThreeGppRemoveNodeTestCase, TestCase::Duration::QUICK);
 }
 
 /// Static variable for test initialization
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup spectrum
+ *
+ * Micro-benchmark of the SpectrumValue arithmetic.
+ *
+ * Measures, for a SpectrumModel of a given number of bands:
+ *   - the element-wise kernels (+=, *=, /=) against the plain iterator loops they replaced;
+ *   - the SINR-like chain (a - b + c) / d with the SpectrumValue operators, which create
+ *     a temporary at each step, against the same chain as a single-pass expression
+ *     (see spectrum-value-expression.h);
+ *   - Log10, Sum and Integral, with and without expressions.
+ *
+ * The iterator loops are compiled within this program, so at -O3 they are inlined and
+ * auto-vectorized as well: the kernels matter most for the builds at -O2 and below, while
+ * the expressions save the temporaries at any optimization level.
+ *
+ * The time per call is printed in nanoseconds. Build in optimized mode (and, e.g., with
+ * NS3_NATIVE_OPTIMIZATIONS to use AVX2) for meaningful figures:
+ *
+ * \code
+ *   ./ns3 run "spectrum-value-benchmark --bands=273 --iterations=200000"
+ * \endcode
+ */
+
+#include <ns3/command-line.h>
+#include <ns3/spectrum-model.h>
+#include <ns3/spectrum-value-expression.h>
+#include <ns3/spectrum-value.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace ns3;
+
+/// Sink of the benchmarked results, so that the compiler cannot drop the computations
+static double g_sink = 0;
+
+/**
+ * Run a function many times and print the time per call
+ * \param name the name of the benchmark
+ * \param iterations the number of calls
+ * \param f the function
+ * \return the time per call in nanoseconds
+ */
+template <typename F>
+double
+Measure(const std::string& name, uint32_t iterations, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i)
+    {
+        f();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(12) << std::fixed
+              << std::setprecision(1) << ns << " ns" << std::endl;
+    return ns;
+}
+
+/**
+ * Element-wise in-place operation written as the iterator loops of the previous
+ * SpectrumValue implementation
+ * \param x the values to update
+ * \param y the other operand
+ * \param op the operation
+ */
+template <typename Op>
+void
+ReferenceLoop(SpectrumValue& x, const SpectrumValue& y, Op op)
+{
+    auto it1 = x.GetValues().begin();
+    auto it2 = y.GetValues().begin();
+    while (it1 != x.GetValues().end())
+    {
+        op(*it1, *it2);
+        ++it1;
+        ++it2;
+    }
+}
+
+/**
+ * Print the speedup of a benchmark against its reference
+ * \param reference the time per call of the reference
+ * \param optimized the time per call of the optimized version
+ */
+void
+PrintSpeedup(double reference, double optimized)
+{
+    std::cout << std::left << std::setw(40) << "  speedup" << std::right << std::setw(12)
+              << std::setprecision(2) << reference / optimized << " x" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t bands = 273;
+    uint32_t iterations = 100000;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("bands", "Number of bands of the SpectrumModel", bands);
+    cmd.AddValue("iterations", "Number of calls of each benchmark", iterations);
+    cmd.Parse(argc, argv);
+
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < bands; ++i)
+    {
+        freqs.push_back(3.5e9 + 360e3 * i);
+    }
+    Ptr<SpectrumModel> model = Create<SpectrumModel>(freqs);
+
+    SpectrumValue a(model);
+    SpectrumValue b(model);
+    SpectrumValue c(model);
+    SpectrumValue d(model);
+    SpectrumValue g(model); // close to 1, so that x does not overflow or underflow
+    for (uint32_t i = 0; i < bands; ++i)
+    {
+        a[i] = (1.5 + std::sin(0.7 * i)) * 1e-13;
+        b[i] = (1.2 + std::cos(1.3 * i)) * 3e-14;
+        c[i] = 1e-15 / (1 + i);
+        d[i] = (2 + std::sin(0.1 * i)) * 1e-14;
+        g[i] = 1 + 1e-9 * std::sin(0.3 * i);
+    }
+    SpectrumValue x = a;
+
+    std::cout << "SpectrumValue benchmark: " << bands << " bands, " << iterations
+              << " iterations" << std::endl;
+
+    double ref;
+    double opt;
+    ref = Measure("x += b (iterator loop)", iterations, [&]() {
+        ReferenceLoop(x, b, [](double& p, double q) { p += q; });
+    });
+    opt = Measure("x += b", iterations, [&]() { x += b; });
+    PrintSpeedup(ref, opt);
+
+    ref = Measure("x *= g (iterator loop)", iterations, [&]() {
+        ReferenceLoop(x, g, [](double& p, double q) { p *= q; });
+    });
+    opt = Measure("x *= g", iterations, [&]() { x *= g; });
+    PrintSpeedup(ref, opt);
+
+    ref = Measure("x /= g (iterator loop)", iterations, [&]() {
+        ReferenceLoop(x, g, [](double& p, double q) { p /= q; });
+    });
+    opt = Measure("x /= g", iterations, [&]() { x /= g; });
+    PrintSpeedup(ref, opt);
+
+    ref = Measure("x = (a - b + c) / d", iterations, [&]() { x = (a - b + c) / d; });
+    opt = Measure("x = (Lazy(a) - b + c) / d", iterations, [&]() { x = (Lazy(a) - b + c) / d; });
+    PrintSpeedup(ref, opt);
+
+    ref = Measure("x = 10 * Log10(a / d)", iterations, [&]() { x = 10 * Log10(a / d); });
+    opt = Measure("x = 10 * Log10(Lazy(a) / d)", iterations, [&]() {
+        x = 10 * Log10(Lazy(a) / d);
+    });
+    PrintSpeedup(ref, opt);
+
+    ref = Measure("Sum(a * b)", iterations, [&]() { g_sink += Sum(a * b); });
+    opt = Measure("Sum(Lazy(a) * b)", iterations, [&]() { g_sink += Sum(Lazy(a) * b); });
+    PrintSpeedup(ref, opt);
+
+    ref = Measure("Integral(a + c)", iterations, [&]() { g_sink += Integral(a + c); });
+    opt = Measure("Integral(Lazy(a) + c)", iterations, [&]() {
+        g_sink += Integral(Lazy(a) + c);
+    });
+    PrintSpeedup(ref, opt);
+
+    g_sink += Sum(x);
+    std::cout << "(checksum " << std::setprecision(6) << std::scientific << g_sink << ")"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup spectrum
+ *
+ * Benchmark of a cell-scan beam sweep with the ThreeGppSpectrumPropagationLossModel.
+ *
+ * A gNB with a UPA of gnbRows x gnbCols elements serves ues UEs with UPAs of
+ * ueRows x ueCols elements, in a UMa scenario. As the cell scan of the ideal
+ * beamforming algorithms, each sweep computes the received PSD for all the pairs of
+ * beams of the codebooks of the gNB and of the UE, i.e., the sectors of the rows of the
+ * UPA at the elevations of 60, 90 and 120 degrees. There are several sweeps per update
+ * of the channels, every 100 ms.
+ *
+ * The sweeps are timed with MaxBeamPairs equal to 1, i.e., a single pair of beams
+ * kept per pair of nodes, and to the number of pairs of beams of the codebooks, so that
+ * the long term components are only computed at the first sweep after an update. The
+ * checksums of the received PSDs are the same. Build in optimized mode for meaningful
+ * figures:
+ *
+ * \code
+ *   ./ns3 run "three-gpp-beam-sweep-benchmark --ues=10 --sweeps=4"
+ * \endcode
+ */
+
+#include <ns3/channel-condition-model.h>
+#include <ns3/command-line.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/isotropic-antenna-model.h>
+#include <ns3/node-container.h>
+#include <ns3/pointer.h>
+#include <ns3/simulator.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/string.h>
+#include <ns3/three-gpp-channel-model.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
+#include <ns3/uinteger.h>
+#include <ns3/uniform-planar-array.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/// Time spent in the sweeps (ns)
+static double g_sweepNs = 0;
+/// Sum of the received PSDs
+static double g_checksum = 0;
+
+/**
+ * Create the codebook of a UPA, as the cell scan of the ideal beamforming algorithms
+ * \param antenna the UPA
+ * \param rows the number of rows of the UPA
+ * \return the beamforming vectors of the codebook
+ */
+std::vector<PhasedArrayModel::ComplexVector>
+CreateCodebook(Ptr<PhasedArrayModel> antenna, uint32_t rows)
+{
+    std::vector<PhasedArrayModel::ComplexVector> codebook;
+    for (double theta : {60.0, 90.0, 120.0})
+    {
+        for (uint32_t sector = 0; sector <= rows; ++sector)
+        {
+            double azimuth = M_PI * sector / rows - 0.5 * M_PI;
+            codebook.push_back(antenna->GetBeamformingVector(Angles(azimuth, theta * M_PI / 180)));
+        }
+    }
+    return codebook;
+}
+
+/**
+ * Sweep the pairs of beams between the gNB and each UE, and measure the time
+ * \param lossModel the spectrum propagation loss model
+ * \param txParams the transmitted signal
+ * \param gnbMobility the mobility model of the gNB
+ * \param gnbAntenna the antenna of the gNB
+ * \param gnbCodebook the codebook of the gNB
+ * \param ueMobilities the mobility models of the UEs
+ * \param ueAntennas the antennas of the UEs
+ * \param ueCodebook the codebook of the UEs
+ */
+void
+Sweep(Ptr<ThreeGppSpectrumPropagationLossModel> lossModel,
+      Ptr<const SpectrumSignalParameters> txParams,
+      Ptr<MobilityModel> gnbMobility,
+      Ptr<PhasedArrayModel> gnbAntenna,
+      const std::vector<PhasedArrayModel::ComplexVector>& gnbCodebook,
+      const std::vector<Ptr<MobilityModel>>& ueMobilities,
+      const std::vector<Ptr<PhasedArrayModel>>& ueAntennas,
+      const std::vector<PhasedArrayModel::ComplexVector>& ueCodebook)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t ue = 0; ue < ueMobilities.size(); ++ue)
+    {
+        for (const auto& gnbBeam : gnbCodebook)
+        {
+            gnbAntenna->SetBeamformingVector(gnbBeam);
+            for (const auto& ueBeam : ueCodebook)
+            {
+                ueAntennas[ue]->SetBeamformingVector(ueBeam);
+                auto rxParams = lossModel->DoCalcRxPowerSpectralDensity(txParams,
+                                                                        gnbMobility,
+                                                                        ueMobilities[ue],
+                                                                        gnbAntenna,
+                                                                        ueAntennas[ue]);
+                g_checksum += Sum(*rxParams->psd);
+            }
+        }
+    }
+    auto stop = std::chrono::steady_clock::now();
+    g_sweepNs += std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t gnbRows = 4;
+    uint32_t gnbCols = 8;
+    uint32_t ueRows = 2;
+    uint32_t ueCols = 2;
+    uint32_t ues = 10;
+    uint32_t sweeps = 4;
+    uint32_t updates = 5;
+    double frequency = 28e9;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("gnbRows", "Number of rows of the UPA of the gNB", gnbRows);
+    cmd.AddValue("gnbCols", "Number of columns of the UPA of the gNB", gnbCols);
+    cmd.AddValue("ueRows", "Number of rows of the UPAs of the UEs", ueRows);
+    cmd.AddValue("ueCols", "Number of columns of the UPAs of the UEs", ueCols);
+    cmd.AddValue("ues", "Number of UEs", ues);
+    cmd.AddValue("sweeps", "Number of sweeps per update of the channels", sweeps);
+    cmd.AddValue("updates", "Number of updates of the channels, every 100 ms", updates);
+    cmd.AddValue("frequency", "Operating frequency in Hz", frequency);
+    cmd.Parse(argc, argv);
+
+    auto createUpa = [](uint32_t rows, uint32_t cols) {
+        Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumRows",
+            UintegerValue(rows),
+            "NumColumns",
+            UintegerValue(cols),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>()));
+        return antenna;
+    };
+
+    NodeContainer nodes;
+    nodes.Create(ues + 1);
+    Ptr<MobilityModel> gnbMobility = CreateObject<ConstantPositionMobilityModel>();
+    gnbMobility->SetPosition(Vector(0, 0, 25));
+    nodes.Get(0)->AggregateObject(gnbMobility);
+    auto gnbAntenna = createUpa(gnbRows, gnbCols);
+    auto gnbCodebook = CreateCodebook(gnbAntenna, gnbRows);
+
+    std::vector<Ptr<MobilityModel>> ueMobilities;
+    std::vector<Ptr<PhasedArrayModel>> ueAntennas;
+    for (uint32_t ue = 0; ue < ues; ++ue)
+    {
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        double distance = 50 + 250.0 * ue / ues;
+        mobility->SetPosition(
+            Vector(distance * std::cos(2.4 * ue), distance * std::sin(2.4 * ue), 1.5));
+        nodes.Get(ue + 1)->AggregateObject(mobility);
+        ueMobilities.push_back(mobility);
+        ueAntennas.push_back(createUpa(ueRows, ueCols));
+    }
+    auto ueCodebook = CreateCodebook(ueAntennas[0], ueRows);
+    uint32_t beamPairs = gnbCodebook.size() * ueCodebook.size();
+
+    // 100 MHz with 66 RBs of 1.44 MHz
+    std::vector<double> centerFrequencies;
+    for (uint32_t rb = 0; rb < 66; ++rb)
+    {
+        centerFrequencies.push_back(frequency + (rb - 33) * 1.44e6);
+    }
+    auto psd = Create<SpectrumValue>(Create<SpectrumModel>(centerFrequencies));
+    *psd = 1e-8;
+    auto txParams = Create<SpectrumSignalParameters>();
+    txParams->psd = psd;
+
+    std::cout << "3GPP beam sweep benchmark: gNB " << gnbRows << "x" << gnbCols << ", UE "
+              << ueRows << "x" << ueCols << ", " << ues << " UEs, " << beamPairs
+              << " pairs of beams, " << sweeps << " sweeps per update, " << updates
+              << " updates" << std::endl;
+
+    for (uint32_t maxBeamPairs : {1U, beamPairs})
+    {
+        g_sweepNs = 0;
+        g_checksum = 0;
+
+        auto conditionModel = CreateObject<ThreeGppUmaChannelConditionModel>();
+        conditionModel->SetAttribute("UpdatePeriod", TimeValue(MilliSeconds(100)));
+        conditionModel->AssignStreams(1);
+        auto lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel>();
+        lossModel->SetChannelModelAttribute("Scenario", StringValue("UMa"));
+        lossModel->SetChannelModelAttribute("Frequency", DoubleValue(frequency));
+        lossModel->SetChannelModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(100)));
+        lossModel->SetChannelModelAttribute("ChannelConditionModel",
+                                            PointerValue(conditionModel));
+        lossModel->SetAttribute("MaxBeamPairs", UintegerValue(maxBeamPairs));
+        DynamicCast<ThreeGppChannelModel>(lossModel->GetChannelModel())->AssignStreams(2);
+
+        for (uint32_t update = 0; update < updates; ++update)
+        {
+            for (uint32_t sweep = 0; sweep < sweeps; ++sweep)
+            {
+                Simulator::Schedule(MilliSeconds(100 * update + sweep),
+                                    &Sweep,
+                                    lossModel,
+                                    txParams,
+                                    gnbMobility,
+                                    gnbAntenna,
+                                    gnbCodebook,
+                                    ueMobilities,
+                                    ueAntennas,
+                                    ueCodebook);
+            }
+        }
+        Simulator::Run();
+        Simulator::Destroy();
+
+        std::cout << "MaxBeamPairs " << std::left << std::setw(26) << maxBeamPairs << std::right
+                  << std::setw(12) << std::fixed << std::setprecision(1)
+                  << g_sweepNs / (ues * beamPairs * sweeps * updates) << " ns per pair of beams"
+                  << " (checksum " << std::hexfloat << g_checksum << std::defaultfloat << ")"
+                  << std::endl;
+    }
+    return 0;
+}
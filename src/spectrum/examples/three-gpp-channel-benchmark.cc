@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/**
+ * \file
+ * \ingroup spectrum
+ *
+ * Benchmark of the generation of the 3GPP channel matrices.
+ *
+ * A gNB with a UPA of gnbRows x gnbCols elements serves ues UEs with UPAs of
+ * ueRows x ueCols elements, in a UMa scenario, and the channels are updated every
+ * 100 ms, as with the UpdatePeriod of the ThreeGppChannelModel, for a number of updates.
+ * Each node has several antenna arrays (panels): at each update, the channel of the
+ * first panels generates the new channel parameters of the pair of nodes, and the
+ * channels of the other panels only generate a channel matrix, with
+ * ThreeGppChannelModel::GetNewChannel. The time of the latter is printed per channel
+ * matrix, with the time of the former, per pair of nodes.
+ *
+ * The checksum of the channel matrices does not depend on the optimizations of the
+ * channel model. Build in optimized mode for meaningful figures:
+ *
+ * \code
+ *   ./ns3 run "three-gpp-channel-benchmark --ues=50 --updates=10"
+ * \endcode
+ */
+
+#include <ns3/abort.h>
+#include <ns3/boolean.h>
+#include <ns3/channel-condition-model.h>
+#include <ns3/command-line.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/node-container.h>
+#include <ns3/pointer.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/three-gpp-channel-model.h>
+#include <ns3/uinteger.h>
+#include <ns3/uniform-planar-array.h>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/// Time spent in the generation of the channel parameters and matrices (ns)
+static double g_paramsNs = 0;
+/// Time spent in the generation of the channel matrices only (ns)
+static double g_matrixNs = 0;
+/// Sum of the elements of the generated channel matrices
+static double g_checksum = 0;
+
+/**
+ * Get the channels between the gNB and the UEs, and measure the time
+ * \param channelModel the channel model
+ * \param gnbMobility the mobility model of the gNB
+ * \param gnbPanels the antenna arrays of the gNB
+ * \param ueMobilities the mobility models of the UEs
+ * \param uePanels the antenna arrays of each UE
+ */
+void
+UpdateChannels(Ptr<ThreeGppChannelModel> channelModel,
+               Ptr<MobilityModel> gnbMobility,
+               const std::vector<Ptr<PhasedArrayModel>>& gnbPanels,
+               const std::vector<Ptr<MobilityModel>>& ueMobilities,
+               const std::vector<std::vector<Ptr<PhasedArrayModel>>>& uePanels)
+{
+    auto addToChecksum = [](Ptr<const MatrixBasedChannelModel::ChannelMatrix> matrix) {
+        const auto& h = matrix->m_channel;
+        for (size_t i = 0; i < h.GetSize(); ++i)
+        {
+            g_checksum += h.GetValues()[i].real() + h.GetValues()[i].imag();
+        }
+    };
+
+    // the first panels: new channel parameters and matrices
+    auto start = std::chrono::steady_clock::now();
+    for (size_t ue = 0; ue < ueMobilities.size(); ++ue)
+    {
+        addToChecksum(channelModel->GetChannel(gnbMobility,
+                                               ueMobilities[ue],
+                                               gnbPanels[0],
+                                               uePanels[ue][0]));
+    }
+    auto stop = std::chrono::steady_clock::now();
+    g_paramsNs += std::chrono::duration<double, std::nano>(stop - start).count();
+
+    // the other panels: new channel matrices
+    start = std::chrono::steady_clock::now();
+    for (size_t ue = 0; ue < ueMobilities.size(); ++ue)
+    {
+        for (size_t panel = 1; panel < gnbPanels.size(); ++panel)
+        {
+            addToChecksum(channelModel->GetChannel(gnbMobility,
+                                                   ueMobilities[ue],
+                                                   gnbPanels[panel],
+                                                   uePanels[ue][panel]));
+        }
+    }
+    stop = std::chrono::steady_clock::now();
+    g_matrixNs += std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t gnbRows = 4;
+    uint32_t gnbCols = 4;
+    uint32_t ueRows = 2;
+    uint32_t ueCols = 4;
+    bool dualPolarized = false;
+    uint32_t ues = 20;
+    uint32_t panels = 4;
+    uint32_t updates = 10;
+    double frequency = 3.5e9;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("gnbRows", "Number of rows of the UPA of the gNB", gnbRows);
+    cmd.AddValue("gnbCols", "Number of columns of the UPA of the gNB", gnbCols);
+    cmd.AddValue("ueRows", "Number of rows of the UPAs of the UEs", ueRows);
+    cmd.AddValue("ueCols", "Number of columns of the UPAs of the UEs", ueCols);
+    cmd.AddValue("dualPolarized", "Whether the UPAs are dual polarized", dualPolarized);
+    cmd.AddValue("ues", "Number of UEs", ues);
+    cmd.AddValue("panels", "Number of antenna arrays of each node, at least 2", panels);
+    cmd.AddValue("updates", "Number of updates of the channels, every 100 ms", updates);
+    cmd.AddValue("frequency", "Operating frequency in Hz", frequency);
+    cmd.Parse(argc, argv);
+    NS_ABORT_MSG_IF(panels < 2, "At least 2 panels are needed");
+
+    auto conditionModel = CreateObject<ThreeGppUmaChannelConditionModel>();
+    conditionModel->SetAttribute("UpdatePeriod", TimeValue(MilliSeconds(100)));
+    conditionModel->AssignStreams(1);
+    auto channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Scenario", StringValue("UMa"));
+    channelModel->SetAttribute("Frequency", DoubleValue(frequency));
+    channelModel->SetAttribute("UpdatePeriod", TimeValue(MilliSeconds(100)));
+    channelModel->SetAttribute("ChannelConditionModel", PointerValue(conditionModel));
+    channelModel->AssignStreams(2);
+
+    auto createPanel = [dualPolarized](uint32_t rows, uint32_t cols) {
+        Ptr<PhasedArrayModel> panel =
+            CreateObjectWithAttributes<UniformPlanarArray>("NumRows",
+                                                           UintegerValue(rows),
+                                                           "NumColumns",
+                                                           UintegerValue(cols),
+                                                           "IsDualPolarized",
+                                                           BooleanValue(dualPolarized));
+        return panel;
+    };
+
+    NodeContainer nodes;
+    nodes.Create(ues + 1);
+    Ptr<MobilityModel> gnbMobility = CreateObject<ConstantPositionMobilityModel>();
+    gnbMobility->SetPosition(Vector(0, 0, 25));
+    nodes.Get(0)->AggregateObject(gnbMobility);
+    std::vector<Ptr<PhasedArrayModel>> gnbPanels;
+    for (uint32_t panel = 0; panel < panels; ++panel)
+    {
+        gnbPanels.push_back(createPanel(gnbRows, gnbCols));
+    }
+
+    std::vector<Ptr<MobilityModel>> ueMobilities;
+    std::vector<std::vector<Ptr<PhasedArrayModel>>> uePanels(ues);
+    for (uint32_t ue = 0; ue < ues; ++ue)
+    {
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        double distance = 50 + 450.0 * ue / ues;
+        mobility->SetPosition(
+            Vector(distance * std::cos(2.4 * ue), distance * std::sin(2.4 * ue), 1.5));
+        nodes.Get(ue + 1)->AggregateObject(mobility);
+        ueMobilities.push_back(mobility);
+        for (uint32_t panel = 0; panel < panels; ++panel)
+        {
+            uePanels[ue].push_back(createPanel(ueRows, ueCols));
+        }
+    }
+
+    for (uint32_t update = 0; update < updates; ++update)
+    {
+        Simulator::Schedule(MilliSeconds(100 * update),
+                            &UpdateChannels,
+                            channelModel,
+                            gnbMobility,
+                            gnbPanels,
+                            ueMobilities,
+                            uePanels);
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::cout << "3GPP channel benchmark: gNB " << gnbRows << "x" << gnbCols << ", UE " << ueRows
+              << "x" << ueCols << (dualPolarized ? " dual polarized" : "") << ", " << ues
+              << " UEs, " << panels << " panels, " << updates << " updates" << std::endl;
+    std::cout << std::left << std::setw(40) << "channel parameters and matrix" << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1)
+              << g_paramsNs / (ues * updates) << " ns" << std::endl;
+    std::cout << std::left << std::setw(40) << "channel matrix" << std::right << std::setw(12)
+              << g_matrixNs / (ues * (panels - 1) * updates) << " ns" << std::endl;
+    std::cout << "(checksum " << std::hexfloat << g_checksum << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHANNEL_CACHE_H
+#define CHANNEL_CACHE_H
+
+#include <ns3/nstime.h>
+#include <ns3/simulator.h>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace ns3
+{
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Cache of the channel realizations of a channel model, per pair of nodes or antennas
+ *
+ * The entries are kept in the order of their last access, most recent first. With a
+ * maximum size, inserting an entry in a full cache evicts the least recently used one.
+ * With an idle time, the entries that were not accessed for longer are evicted; they
+ * are found from the end of the list at each access, so that the cost of the expiry is
+ * proportional to the number of evicted entries. A maximum size or an idle time of zero
+ * disables the corresponding eviction, in which case the cache behaves as a plain map.
+ *
+ * The lookups that find an entry are counted as hits and the others as misses; the
+ * entries removed by the maximum size, the idle time and Erase are counted as evictions.
+ *
+ * \tparam T the type of the cached values
+ */
+template <class T>
+class ChannelCache
+{
+  public:
+    /**
+     * \brief Set the maximum number of entries
+     * \param maxSize the maximum number of entries, 0 for no limit
+     */
+    void SetMaxSize(uint32_t maxSize)
+    {
+        m_maxSize = maxSize;
+        EvictOverflow();
+    }
+
+    /**
+     * \return the maximum number of entries, 0 for no limit
+     */
+    uint32_t GetMaxSize() const
+    {
+        return m_maxSize;
+    }
+
+    /**
+     * \brief Set the time after which an entry that is not accessed is evicted
+     * \param idleTime the idle time, 0 to never evict the idle entries
+     */
+    void SetIdleTime(Time idleTime)
+    {
+        m_idleTime = idleTime;
+    }
+
+    /**
+     * \return the time after which an entry that is not accessed is evicted
+     */
+    Time GetIdleTime() const
+    {
+        return m_idleTime;
+    }
+
+    /**
+     * \brief Look up an entry, and mark it as the most recently used one
+     * \param key the key of the entry
+     * \return a pointer to the value of the entry, or nullptr if not found. It is valid
+     *         until the next call to a non-const method.
+     */
+    T* Find(uint64_t key)
+    {
+        EvictIdle();
+        auto it = m_index.find(key);
+        if (it == m_index.end())
+        {
+            ++m_misses;
+            return nullptr;
+        }
+        ++m_hits;
+        it->second->m_lastAccess = Simulator::Now();
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return &it->second->m_value;
+    }
+
+    /**
+     * \brief Look up an entry, without counting the lookup or marking the entry as used
+     * \param key the key of the entry
+     * \return a pointer to the value of the entry, or nullptr if not found
+     */
+    const T* Peek(uint64_t key) const
+    {
+        auto it = m_index.find(key);
+        return it == m_index.end() ? nullptr : &it->second->m_value;
+    }
+
+    /**
+     * \brief Insert or replace an entry, as the most recently used one
+     * \param key the key of the entry
+     * \param value the value of the entry
+     */
+    void Insert(uint64_t key, T value)
+    {
+        auto it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            it->second->m_value = std::move(value);
+            it->second->m_lastAccess = Simulator::Now();
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return;
+        }
+        m_entries.push_front(Entry{key, std::move(value), Simulator::Now()});
+        m_index.emplace(key, m_entries.begin());
+        EvictOverflow();
+    }
+
+    /**
+     * \brief Evict the entries whose value satisfies a predicate
+     * \param predicate the predicate, called with the value of each entry
+     * \return the number of evicted entries
+     */
+    template <class Predicate>
+    std::size_t Erase(Predicate predicate)
+    {
+        std::size_t erased = 0;
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if (predicate(it->m_value))
+            {
+                m_index.erase(it->m_key);
+                it = m_entries.erase(it);
+                ++erased;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        m_evictions += erased;
+        return erased;
+    }
+
+    /**
+     * \brief Remove all the entries, without counting them as evictions
+     */
+    void Clear()
+    {
+        m_entries.clear();
+        m_index.clear();
+    }
+
+    /**
+     * \return the number of entries
+     */
+    std::size_t GetSize() const
+    {
+        return m_entries.size();
+    }
+
+    /**
+     * \return the number of lookups that found an entry
+     */
+    uint64_t GetHits() const
+    {
+        return m_hits;
+    }
+
+    /**
+     * \return the number of lookups that did not find an entry
+     */
+    uint64_t GetMisses() const
+    {
+        return m_misses;
+    }
+
+    /**
+     * \return the number of evicted entries
+     */
+    uint64_t GetEvictions() const
+    {
+        return m_evictions;
+    }
+
+  private:
+    /**
+     * \brief Entry of the cache
+     */
+    struct Entry
+    {
+        uint64_t m_key;    //!< Key
+        T m_value;         //!< Value
+        Time m_lastAccess; //!< Time of the last lookup or insertion
+    };
+
+    /**
+     * \brief Evict the least recently used entries beyond the maximum size
+     */
+    void EvictOverflow()
+    {
+        while (m_maxSize > 0 && m_entries.size() > m_maxSize)
+        {
+            EvictBack();
+        }
+    }
+
+    /**
+     * \brief Evict the entries not accessed for longer than the idle time
+     */
+    void EvictIdle()
+    {
+        if (m_idleTime.IsZero())
+        {
+            return;
+        }
+        Time now = Simulator::Now();
+        while (!m_entries.empty() && now - m_entries.back().m_lastAccess > m_idleTime)
+        {
+            EvictBack();
+        }
+    }
+
+    /**
+     * \brief Evict the least recently used entry
+     */
+    void EvictBack()
+    {
+        m_index.erase(m_entries.back().m_key);
+        m_entries.pop_back();
+        ++m_evictions;
+    }
+
+    uint32_t m_maxSize{0};      //!< Maximum number of entries, 0 for no limit
+    Time m_idleTime;            //!< Idle time of the evicted entries, 0 for none
+    std::list<Entry> m_entries; //!< Entries, most recently used first
+    std::unordered_map<uint64_t, typename std::list<Entry>::iterator>
+        m_index;                //!< Entry of each key
+    uint64_t m_hits{0};         //!< Lookups that found an entry
+    uint64_t m_misses{0};       //!< Lookups that did not find an entry
+    uint64_t m_evictions{0};    //!< Evicted entries
+};
+
+} // namespace ns3
+
+#endif /* CHANNEL_CACHE_H */
@@ -27,4 +27,9 @@ MatrixBasedChannelModel::~MatrixBasedChannelModel()
 {
 }
 
+void
+MatrixBasedChannelModel::RemoveNode(uint32_t nodeId)
+{
+}
+
 } // namespace ns3
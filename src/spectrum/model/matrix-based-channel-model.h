@@ -211,6 +211,14 @@ class MatrixBasedChannelModel : public Object
     virtual Ptr<const ChannelParams> GetParams(Ptr<const MobilityModel> aMob,
                                                Ptr<const MobilityModel> bMob) const = 0;
 
+    /**
+     * Forget the channels of a node, e.g., when it is detached from the channel, so that
+     * they do not stay in memory. The default implementation does nothing.
+     *
+     * \param nodeId the ID of the node
+     */
+    virtual void RemoveNode(uint32_t nodeId);
+
     /**
      * Generate a unique value for the pair of unsigned integer of 32 bits,
      * where the order does not matter, i.e., the same value will be returned for (a,b) and (b,a).
@@ -37,6 +37,7 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/propagation-loss-model.h>
 #include <ns3/simulator.h>
+#include <ns3/uinteger.h>
 
 #include <algorithm>
 #include <iostream>
@@ -92,21 +93,44 @@ MultiModelSpectrumChannel::DoDispose()
     NS_LOG_FUNCTION(this);
     m_txSpectrumModelInfoMap.clear();
     m_rxSpectrumModelInfoMap.clear();
+    m_threadPool = nullptr;
     SpectrumChannel::DoDispose();
 }
 
 TypeId
 MultiModelSpectrumChannel::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::MultiModelSpectrumChannel")
-                            .SetParent<SpectrumChannel>()
-                            .SetGroupName("Spectrum")
-                            .AddConstructor<MultiModelSpectrumChannel>()
-
-        ;
+    static TypeId tid =
+        TypeId("ns3::MultiModelSpectrumChannel")
+            .SetParent<SpectrumChannel>()
+            .SetGroupName("Spectrum")
+            .AddConstructor<MultiModelSpectrumChannel>()
+            .AddAttribute("RxThreads",
+                          "Number of threads computing in parallel the received PSDs of the "
+                          "receptions of a transmission that start at the same time. With 0 or "
+                          "1, each received PSD is computed when its reception starts. The "
+                          "results are the same.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultiModelSpectrumChannel::SetRxThreads,
+                                               &MultiModelSpectrumChannel::GetRxThreads),
+                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
+void
+MultiModelSpectrumChannel::SetRxThreads(uint32_t numThreads)
+{
+    NS_LOG_FUNCTION(this << numThreads);
+    m_rxThreads = numThreads;
+    m_threadPool = numThreads > 1 ? Create<ThreadPool>(numThreads) : nullptr;
+}
+
+uint32_t
+MultiModelSpectrumChannel::GetRxThreads() const
+{
+    return m_rxThreads;
+}
+
 void
 MultiModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
 {
@@ -240,6 +264,9 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
     auto txSpectrumModelUid = txParams->psd->GetSpectrumModelUid();
     NS_LOG_LOGIC("txSpectrumModelUid " << txSpectrumModelUid);
 
+    // with threads, the receptions are scheduled as without, but they share the batch
+    auto batch = m_threadPool ? Create<RxBatch>() : nullptr;
+
     for (auto rxInfoIterator = m_rxSpectrumModelInfoMap.begin();
          rxInfoIterator != m_rxSpectrumModelInfoMap.end();
          ++rxInfoIterator)
@@ -336,7 +363,30 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
-                if (rxNetDevice)
+                if (batch)
+                {
+                    batch->m_rxs.push_back(
+                        RxBatch::Rx{rxParams, *rxPhyIterator, Simulator::Now() + delay});
+                    auto index = batch->m_rxs.size() - 1;
+                    if (rxNetDevice)
+                    {
+                        Simulator::ScheduleWithContext(rxNetDevice->GetNode()->GetId(),
+                                                       delay,
+                                                       &MultiModelSpectrumChannel::StartBatchRx,
+                                                       this,
+                                                       batch,
+                                                       index);
+                    }
+                    else
+                    {
+                        Simulator::Schedule(delay,
+                                            &MultiModelSpectrumChannel::StartBatchRx,
+                                            this,
+                                            batch,
+                                            index);
+                    }
+                }
+                else if (rxNetDevice)
                 {
                     // the receiver has a NetDevice, so we expect that it is attached to a Node
                     auto dstNode = rxNetDevice->GetNode()->GetId();
@@ -364,6 +414,87 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
 
 void
 MultiModelSpectrumChannel::StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
+{
+    NS_LOG_FUNCTION(this);
+    auto rxParams = CalcRxParams(params, receiver, nullptr);
+    if (rxParams)
+    {
+        receiver->StartRx(rxParams);
+    }
+}
+
+void
+MultiModelSpectrumChannel::StartBatchRx(Ptr<RxBatch> batch, std::size_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    auto& rx = batch->m_rxs[index];
+    if (!rx.m_prepared)
+    {
+        PrepareBatchRx(*batch, index);
+    }
+    if (rx.m_params)
+    {
+        rx.m_receiver->StartRx(rx.m_params);
+    }
+    // the batch lives until its last reception: release this one now
+    rx.m_params = nullptr;
+    rx.m_receiver = nullptr;
+}
+
+void
+MultiModelSpectrumChannel::PrepareBatchRx(RxBatch& batch, std::size_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+    // the receptions starting now are scheduled one after the other, from this one: the
+    // parts of their calculations that use the state of the models are done in their order
+    auto now = Simulator::Now();
+    std::vector<std::size_t> ready;
+    std::vector<PhasedArraySpectrumPropagationLossModel::DeferredCalculation> deferred;
+    for (std::size_t i = index; i < batch.m_rxs.size(); ++i)
+    {
+        auto& rx = batch.m_rxs[i];
+        if (rx.m_prepared || rx.m_startTime != now)
+        {
+            continue;
+        }
+        deferred.emplace_back();
+        rx.m_params = CalcRxParams(rx.m_params, rx.m_receiver, &deferred.back());
+        rx.m_prepared = true;
+        ready.push_back(i);
+    }
+
+    // the deferred calculations of the same receiver node may share the channel: they are
+    // run in sequence, and those of different nodes in parallel
+    std::vector<std::vector<std::size_t>> groups;
+    std::map<const MobilityModel*, std::size_t> groupOfMobility;
+    for (std::size_t k = 0; k < ready.size(); ++k)
+    {
+        if (!deferred[k])
+        {
+            continue;
+        }
+        auto mobility = PeekPointer(batch.m_rxs[ready[k]].m_receiver->GetMobility());
+        auto [it, inserted] = groupOfMobility.emplace(mobility, groups.size());
+        if (inserted)
+        {
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(k);
+    }
+    NS_LOG_LOGIC(ready.size() << " receptions, " << groups.size() << " receiver nodes");
+    m_threadPool->ParallelFor(groups.size(), [&groups, &deferred](std::size_t g) {
+        for (auto k : groups[g])
+        {
+            deferred[k]();
+        }
+    });
+}
+
+Ptr<SpectrumSignalParameters>
+MultiModelSpectrumChannel::CalcRxParams(
+    Ptr<SpectrumSignalParameters> params,
+    Ptr<SpectrumPhy> receiver,
+    PhasedArraySpectrumPropagationLossModel::DeferredCalculation* deferred)
 {
     NS_LOG_FUNCTION(this);
     const auto txSpectrumModelUid = params->psd->GetSpectrumModelUid();
@@ -394,7 +525,7 @@ MultiModelSpectrumChannel::StartRx(Ptr<SpectrumSignalParameters> params, Ptr<Spe
         if (rxConverterIterator == txInfoIteratorerator->second.m_spectrumConverterMap.end())
         {
             // No converter means TX SpectrumModel is orthogonal to RX SpectrumModel
-            return;
+            return nullptr;
         }
         convertedPsd = rxConverterIterator->second.Convert(params->psd);
         NS_LOG_LOGIC("convertedPsd " << convertedPsd->GetValuesN());
@@ -416,14 +547,27 @@ MultiModelSpectrumChannel::StartRx(Ptr<SpectrumSignalParameters> params, Ptr<Spe
                       "PhasedArrayModel instances should be installed at both TX and RX "
                       "SpectrumPhy in order to use PhasedArraySpectrumPropagationLoss.");
 
-        params = m_phasedArraySpectrumPropagationLoss->CalcRxPowerSpectralDensity(
-            params,
-            params->txPhy->GetMobility(),
-            receiver->GetMobility(),
-            txPhasedArrayModel,
-            rxPhasedArrayModel);
+        if (deferred)
+        {
+            params = m_phasedArraySpectrumPropagationLoss->PrepareRxPowerSpectralDensity(
+                params,
+                params->txPhy->GetMobility(),
+                receiver->GetMobility(),
+                txPhasedArrayModel,
+                rxPhasedArrayModel,
+                *deferred);
+        }
+        else
+        {
+            params = m_phasedArraySpectrumPropagationLoss->CalcRxPowerSpectralDensity(
+                params,
+                params->txPhy->GetMobility(),
+                receiver->GetMobility(),
+                txPhasedArrayModel,
+                rxPhasedArrayModel);
+        }
     }
-    receiver->StartRx(params);
+    return params;
 }
 
 std::size_t
@@ -20,15 +20,18 @@
 #ifndef MULTI_MODEL_SPECTRUM_CHANNEL_H
 #define MULTI_MODEL_SPECTRUM_CHANNEL_H
 
+#include "phased-array-spectrum-propagation-loss-model.h"
 #include "spectrum-channel.h"
 #include "spectrum-converter.h"
 #include "spectrum-propagation-loss-model.h"
 #include "spectrum-value.h"
 
 #include <ns3/propagation-delay-model.h>
+#include <ns3/thread-pool.h>
 
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3
 {
@@ -99,6 +102,17 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * With a PhasedArraySpectrumPropagationLossModel, the received PSD of each receiver,
+ * i.e., the channel matrix and the beamforming gain, is computed when its reception
+ * starts. If RxThreads is larger than 1, the received PSDs of the receptions of a
+ * transmission that start at the same time are computed together, when the first of
+ * them starts: the part of the calculation that uses the state of the models is done in
+ * the order of the receivers, and the rest (see
+ * PhasedArraySpectrumPropagationLossModel::PrepareRxPowerSpectralDensity) in parallel on
+ * RxThreads threads. The receptions then start one by one, in the same order as without
+ * threads, and the results are the same, provided that starting a reception does not
+ * change the antenna or the mobility of the other receivers of the same transmission.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -116,6 +130,19 @@ class MultiModelSpectrumChannel : public SpectrumChannel
     void AddRx(Ptr<SpectrumPhy> phy) override;
     void StartTx(Ptr<SpectrumSignalParameters> params) override;
 
+    /**
+     * Set the number of threads computing the received PSDs of a transmission
+     *
+     * \param numThreads the number of threads, 0 or 1 to compute each received PSD when its
+     *        reception starts
+     */
+    void SetRxThreads(uint32_t numThreads);
+
+    /**
+     * \return the number of threads computing the received PSDs of a transmission
+     */
+    uint32_t GetRxThreads() const;
+
     // inherited from Channel
     std::size_t GetNDevices() const override;
     Ptr<NetDevice> GetDevice(std::size_t i) const override;
@@ -145,6 +172,59 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      */
     virtual void StartRx(Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+    /**
+     * Receptions of a transmission whose received PSDs are computed together
+     */
+    struct RxBatch : public SimpleRefCount<RxBatch>
+    {
+        /**
+         * Reception of the transmission by a receiver
+         */
+        struct Rx
+        {
+            Ptr<SpectrumSignalParameters> m_params; //!< The signal parameters, then the received
+                                                    //!< ones, or nullptr if not received
+            Ptr<SpectrumPhy> m_receiver;            //!< The receiver SpectrumPhy
+            Time m_startTime;                       //!< Start time of the reception
+            bool m_prepared{false};                 //!< Whether m_params is the received one
+        };
+
+        std::vector<Rx> m_rxs; //!< Receptions, in the order of the receivers
+    };
+
+    /**
+     * Used internally to start a reception of a batch after the propagation delay.
+     *
+     * \param batch The receptions of the transmission.
+     * \param index The index of the reception in the batch.
+     */
+    void StartBatchRx(Ptr<RxBatch> batch, std::size_t index);
+
+    /**
+     * Compute the received parameters of the receptions of a batch that start now, from
+     * a given one.
+     *
+     * \param batch The receptions of the transmission.
+     * \param index The index of the first reception starting now.
+     */
+    void PrepareBatchRx(RxBatch& batch, std::size_t index);
+
+    /**
+     * Convert the PSD to the spectrum model of the receiver and apply the spectrum
+     * propagation loss.
+     *
+     * \param params The signal parameters, whose PSD is replaced by the converted one.
+     * \param receiver A pointer to the receiver SpectrumPhy.
+     * \param deferred If not nullptr, where the deferred part of the calculation of a
+     *        PhasedArraySpectrumPropagationLossModel is stored, if any.
+     * \return The received signal parameters, or nullptr if the TX and RX spectrum models
+     *         are orthogonal.
+     */
+    Ptr<SpectrumSignalParameters> CalcRxParams(
+        Ptr<SpectrumSignalParameters> params,
+        Ptr<SpectrumPhy> receiver,
+        PhasedArraySpectrumPropagationLossModel::DeferredCalculation* deferred);
+
     /**
      * Data structure holding, for each TX SpectrumModel,  all the
      * converters to any RX SpectrumModel, and all the corresponding
@@ -163,6 +243,9 @@ class MultiModelSpectrumChannel : public SpectrumChannel
      * Number of devices connected to the channel.
      */
     std::size_t m_numDevices;
+
+    uint32_t m_rxThreads{0};       //!< Number of threads computing the received PSDs
+    Ptr<ThreadPool> m_threadPool; //!< Threads computing the received PSDs, if more than one
 };
 
 } // namespace ns3
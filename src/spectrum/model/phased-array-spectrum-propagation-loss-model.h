@@ -25,6 +25,8 @@
 #include <ns3/object.h>
 #include <ns3/phased-array-model.h>
 
+#include <functional>
+
 namespace ns3
 {
 
@@ -68,6 +70,13 @@ class PhasedArraySpectrumPropagationLossModel : public Object
      */
     Ptr<PhasedArraySpectrumPropagationLossModel> GetNext() const;
 
+    /**
+     * Part of the calculation of a received PSD that can be run later, on any thread,
+     * concurrently with the deferred parts of the calculations for other receivers, see
+     * PrepareRxPowerSpectralDensity
+     */
+    using DeferredCalculation = std::function<void()>;
+
     /**
      * This method is to be called to calculate
      *
@@ -89,6 +98,38 @@ class PhasedArraySpectrumPropagationLossModel : public Object
         Ptr<const PhasedArrayModel> aPhasedArrayModel,
         Ptr<const PhasedArrayModel> bPhasedArrayModel) const;
 
+    /**
+     * Same as CalcRxPowerSpectralDensity, except that the calculation can be split in two
+     * parts: this method does the part that depends on or changes the state of the model,
+     * e.g., the generation of the channel and its caches, and returns the parameters that
+     * will be updated by the deferred calculation, if set. The deferred calculation is
+     * self-contained: it does not depend on the simulation time nor on the mobility and
+     * the antennas, and it only writes to the returned parameters and to the channel
+     * between a and b, so that the deferred calculations for receivers at different nodes
+     * can run concurrently. The returned parameters are valid once the deferred calculation
+     * has run.
+     *
+     * The default implementation, and any chain of models, does the whole calculation in
+     * this method, and leaves the deferred calculation empty.
+     *
+     * @param params the spectrum signal parameters.
+     * @param a sender mobility
+     * @param b receiver mobility
+     * @param aPhasedArrayModel the instance of the phased antenna array of the sender
+     * @param bPhasedArrayModel the instance of the phased antenna array of the receiver
+     * @param deferred the deferred part of the calculation, or empty if none
+     *
+     * @return SpectrumSignalParameters that will contain the received PSD and the
+     * chanSpectrumMatrix once the deferred calculation has run
+     */
+    Ptr<SpectrumSignalParameters> PrepareRxPowerSpectralDensity(
+        Ptr<const SpectrumSignalParameters> params,
+        Ptr<const MobilityModel> a,
+        Ptr<const MobilityModel> b,
+        Ptr<const PhasedArrayModel> aPhasedArrayModel,
+        Ptr<const PhasedArrayModel> bPhasedArrayModel,
+        DeferredCalculation& deferred) const;
+
     /**
      * If this loss model uses objects of type RandomVariableStream,
      * set the stream numbers to the integers starting with the offset
@@ -114,6 +155,30 @@ class PhasedArraySpectrumPropagationLossModel : public Object
      */
     virtual int64_t DoAssignStreams(int64_t stream) = 0;
 
+    /**
+     * Split the calculation of the received PSD, see PrepareRxPowerSpectralDensity.
+     *
+     * The default implementation calls DoCalcRxPowerSpectralDensity and leaves the deferred
+     * calculation empty.
+     *
+     * @param params the spectrum signal parameters.
+     * @param a sender mobility
+     * @param b receiver mobility
+     * @param aPhasedArrayModel the instance of the phased antenna array of the sender
+     * @param bPhasedArrayModel the instance of the phased antenna array of the receiver
+     * @param deferred the deferred part of the calculation, or empty if none
+     *
+     * @return SpectrumSignalParameters that will contain the received PSD and the
+     * chanSpectrumMatrix once the deferred calculation has run
+     */
+    virtual Ptr<SpectrumSignalParameters> DoPrepareRxPowerSpectralDensity(
+        Ptr<const SpectrumSignalParameters> params,
+        Ptr<const MobilityModel> a,
+        Ptr<const MobilityModel> b,
+        Ptr<const PhasedArrayModel> aPhasedArrayModel,
+        Ptr<const PhasedArrayModel> bPhasedArrayModel,
+        DeferredCalculation& deferred) const;
+
   private:
     /**
      *
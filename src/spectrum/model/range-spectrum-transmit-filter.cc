@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "range-spectrum-transmit-filter.h"
+
+#include "spectrum-phy.h"
+#include "spectrum-signal-parameters.h"
+#include "spectrum-value.h"
+
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("RangeSpectrumTransmitFilter");
+
+NS_OBJECT_ENSURE_REGISTERED(RangeSpectrumTransmitFilter);
+
+RangeSpectrumTransmitFilter::RangeSpectrumTransmitFilter()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+RangeSpectrumTransmitFilter::~RangeSpectrumTransmitFilter()
+{
+    NS_LOG_FUNCTION(this);
+    // the channel does not dispose its filters: stop following the course changes here
+    Clear();
+}
+
+TypeId
+RangeSpectrumTransmitFilter::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::RangeSpectrumTransmitFilter")
+            .SetParent<SpectrumTransmitFilter>()
+            .SetGroupName("Spectrum")
+            .AddConstructor<RangeSpectrumTransmitFilter>()
+            .AddAttribute("MaxRange",
+                          "Maximum distance (m) between a transmitter and a receiver. The "
+                          "default value corresponds to no limit.",
+                          DoubleValue(1.0e9),
+                          MakeDoubleAccessor(&RangeSpectrumTransmitFilter::m_maxRange),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("MinRxPower",
+                          "Minimum received power (dBm), with a free-space propagation loss "
+                          "and a total gain of MaxGain dB, for a signal to be passed to a "
+                          "receiver. The default value corresponds to no limit.",
+                          DoubleValue(-1.0e9),
+                          MakeDoubleAccessor(&RangeSpectrumTransmitFilter::m_minRxPowerDbm),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("MaxGain",
+                          "Maximum total gain (dB) on top of the free-space propagation loss "
+                          "used with MinRxPower: antenna and beamforming gains, and a margin "
+                          "for the shadowing. Tune this value with care.",
+                          DoubleValue(30.0),
+                          MakeDoubleAccessor(&RangeSpectrumTransmitFilter::m_maxGainDb),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("GridCellSize",
+                          "Side (m) of the square cells of the grid indexing the receivers. "
+                          "It should be of the order of the range.",
+                          DoubleValue(250.0),
+                          MakeDoubleAccessor(&RangeSpectrumTransmitFilter::m_cellSize),
+                          MakeDoubleChecker<double>(0.1));
+    return tid;
+}
+
+void
+RangeSpectrumTransmitFilter::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+    SpectrumTransmitFilter::DoDispose();
+}
+
+int64_t
+RangeSpectrumTransmitFilter::DoAssignStreams(int64_t stream)
+{
+    return 0;
+}
+
+double
+RangeSpectrumTransmitFilter::GetRange(Ptr<const SpectrumSignalParameters> params) const
+{
+    double range = m_maxRange;
+    if (params->psd)
+    {
+        double txPowerW = Integral(*params->psd);
+        if (txPowerW > 0)
+        {
+            // free-space loss 20 log10 (4 pi d f / c), at the lowest frequency of the signal,
+            // which gives the largest range
+            double frequency = std::numeric_limits<double>::max();
+            for (auto band = params->psd->ConstBandsBegin(); band != params->psd->ConstBandsEnd();
+                 ++band)
+            {
+                frequency = std::min(frequency, band->fc);
+            }
+            double maxLossDb = 10 * std::log10(txPowerW) + 30 + m_maxGainDb - m_minRxPowerDbm;
+            double lambda = 299792458.0 / frequency;
+            range = std::min(range, lambda / (4 * M_PI) * std::pow(10.0, maxLossDb / 20));
+        }
+    }
+    return range;
+}
+
+bool
+RangeSpectrumTransmitFilter::DoFilter(Ptr<const SpectrumSignalParameters> params,
+                                      Ptr<const SpectrumPhy> receiverPhy)
+{
+    NS_LOG_FUNCTION(this << params << receiverPhy);
+
+    auto txMobility = params->txPhy ? params->txPhy->GetMobility() : nullptr;
+    auto rxMobility = receiverPhy->GetMobility();
+    if (!txMobility || !rxMobility)
+    {
+        NS_LOG_DEBUG("No mobility model: do not filter");
+        return false;
+    }
+
+    // the channel calls the filter for all its receivers in a row for a transmission
+    if (params != m_txParams || Simulator::Now() != m_txTime)
+    {
+        FindReceiversInRange(params);
+    }
+
+    bool filter;
+    if (m_entries.find(PeekPointer(rxMobility)) == m_entries.end())
+    {
+        // first signal for this receiver: it was not in the index for the search
+        AddMobility(rxMobility);
+        filter = CalculateDistance(rxMobility->GetPosition(), txMobility->GetPosition()) >
+                 GetRange(params);
+    }
+    else
+    {
+        filter = m_inRange.count(PeekPointer(rxMobility)) == 0;
+    }
+    NS_LOG_DEBUG("Returning " << filter);
+    return filter;
+}
+
+void
+RangeSpectrumTransmitFilter::FindReceiversInRange(Ptr<const SpectrumSignalParameters> params)
+{
+    NS_LOG_FUNCTION(this << params);
+    m_txParams = params;
+    m_txTime = Simulator::Now();
+    m_inRange.clear();
+
+    auto txPosition = params->txPhy->GetMobility()->GetPosition();
+    double range = GetRange(params);
+
+    auto addIfInRange = [this, &txPosition, range](const MobilityModel* mobility,
+                                                   const Vector& position) {
+        if (CalculateDistance(position, txPosition) <= range)
+        {
+            m_inRange.insert(mobility);
+        }
+    };
+
+    // look up the cells intersecting the range, or go through the occupied cells if there
+    // are fewer of them
+    double minX = std::floor((txPosition.x - range) / m_cellSize);
+    double maxX = std::floor((txPosition.x + range) / m_cellSize);
+    double minY = std::floor((txPosition.y - range) / m_cellSize);
+    double maxY = std::floor((txPosition.y + range) / m_cellSize);
+    if ((maxX - minX + 1) * (maxY - minY + 1) <= m_grid.size())
+    {
+        for (auto x = static_cast<int64_t>(minX); x <= static_cast<int64_t>(maxX); ++x)
+        {
+            for (auto y = static_cast<int64_t>(minY); y <= static_cast<int64_t>(maxY); ++y)
+            {
+                auto cellIt = m_grid.find(Cell(x, y));
+                if (cellIt == m_grid.end())
+                {
+                    continue;
+                }
+                for (auto mobility : cellIt->second)
+                {
+                    addIfInRange(mobility, m_entries.at(mobility).m_position);
+                }
+            }
+        }
+    }
+    else
+    {
+        for (const auto& [cell, mobilities] : m_grid)
+        {
+            if (cell.first < minX || cell.first > maxX || cell.second < minY ||
+                cell.second > maxY)
+            {
+                continue;
+            }
+            for (auto mobility : mobilities)
+            {
+                addIfInRange(mobility, m_entries.at(mobility).m_position);
+            }
+        }
+    }
+
+    for (auto mobility : m_moving)
+    {
+        addIfInRange(mobility, mobility->GetPosition());
+    }
+    NS_LOG_LOGIC(m_inRange.size() << " of " << m_entries.size() << " receivers within "
+                                  << range << " m");
+}
+
+void
+RangeSpectrumTransmitFilter::AddMobility(Ptr<MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << mobility);
+    Entry entry;
+    entry.m_mobility = mobility;
+    entry.m_position = mobility->GetPosition();
+    entry.m_moving = mobility->GetVelocity() != Vector(0, 0, 0);
+    Insert(entry);
+    m_entries.emplace(PeekPointer(mobility), entry);
+    mobility->TraceConnectWithoutContext(
+        "CourseChange",
+        MakeCallback(&RangeSpectrumTransmitFilter::CourseChanged, this));
+}
+
+void
+RangeSpectrumTransmitFilter::CourseChanged(Ptr<const MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << mobility);
+    auto it = m_entries.find(PeekPointer(mobility));
+    if (it == m_entries.end())
+    {
+        return;
+    }
+    Remove(it->second);
+    it->second.m_position = mobility->GetPosition();
+    it->second.m_moving = mobility->GetVelocity() != Vector(0, 0, 0);
+    Insert(it->second);
+    // the receivers in range must be searched again, even for the same transmission
+    m_txParams = nullptr;
+}
+
+void
+RangeSpectrumTransmitFilter::Insert(Entry& entry)
+{
+    auto mobility = PeekPointer(entry.m_mobility);
+    if (entry.m_moving)
+    {
+        m_moving.push_back(mobility);
+    }
+    else
+    {
+        entry.m_cell = GetCell(entry.m_position);
+        m_grid[entry.m_cell].push_back(mobility);
+    }
+}
+
+void
+RangeSpectrumTransmitFilter::Remove(const Entry& entry)
+{
+    auto mobility = PeekPointer(entry.m_mobility);
+    if (entry.m_moving)
+    {
+        m_moving.erase(std::find(m_moving.begin(), m_moving.end(), mobility));
+    }
+    else
+    {
+        auto cellIt = m_grid.find(entry.m_cell);
+        NS_ASSERT(cellIt != m_grid.end());
+        auto& mobilities = cellIt->second;
+        mobilities.erase(std::find(mobilities.begin(), mobilities.end(), mobility));
+        if (mobilities.empty())
+        {
+            m_grid.erase(cellIt);
+        }
+    }
+}
+
+void
+RangeSpectrumTransmitFilter::Clear()
+{
+    for (auto& [mobility, entry] : m_entries)
+    {
+        entry.m_mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&RangeSpectrumTransmitFilter::CourseChanged, this));
+    }
+    m_entries.clear();
+    m_grid.clear();
+    m_moving.clear();
+    m_inRange.clear();
+    m_txParams = nullptr;
+}
+
+RangeSpectrumTransmitFilter::Cell
+RangeSpectrumTransmitFilter::GetCell(const Vector& position) const
+{
+    return Cell(static_cast<int64_t>(std::floor(position.x / m_cellSize)),
+                static_cast<int64_t>(std::floor(position.y / m_cellSize)));
+}
+
+std::size_t
+RangeSpectrumTransmitFilter::CellHash::operator()(const Cell& cell) const
+{
+    return std::hash<int64_t>()(cell.first) ^
+           (std::hash<int64_t>()(cell.second) * 0x9e3779b97f4a7c15ULL);
+}
+
+} // namespace ns3
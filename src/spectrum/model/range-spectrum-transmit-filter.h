@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RANGE_SPECTRUM_TRANSMIT_FILTER_H
+#define RANGE_SPECTRUM_TRANSMIT_FILTER_H
+
+#include "spectrum-transmit-filter.h"
+
+#include <ns3/mobility-model.h>
+#include <ns3/nstime.h>
+#include <ns3/vector.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Transmit filter discarding the receivers out of range of the transmitter
+ *
+ * A receiver is out of range if it is farther from the transmitter than MaxRange, or if
+ * it is so far that, with a free-space propagation loss and a total gain of MaxGain dB,
+ * the signal would be received with less than MinRxPower dBm. MaxGain must cover
+ * everything that can make the received power larger than the free-space one: the
+ * antenna and beamforming gains, and a margin for the shadowing and for the models with
+ * less loss than the free space at short distances. Receivers without a mobility model
+ * are never filtered.
+ *
+ * The positions of the receivers are kept in a uniform grid over the (x, y) plane, with
+ * square cells of GridCellSize meters, updated when their mobility models notify a
+ * course change. For each transmission, the receivers in range are found once, from the
+ * cells that intersect the range: the cost of the filter grows with the number of
+ * receivers in range, not with the number of receivers of the channel. The receivers
+ * that are moving, i.e., whose velocity was not zero at their last course change, are
+ * not in the grid, and their distance is always checked.
+ *
+ * The receivers are discarded before the propagation loss and the channel matrix of
+ * their links are computed, and the random variables of those models are not drawn for
+ * them: enabling the filter changes the random streams of a simulation.
+ */
+class RangeSpectrumTransmitFilter : public SpectrumTransmitFilter
+{
+  public:
+    RangeSpectrumTransmitFilter();
+    ~RangeSpectrumTransmitFilter() override;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Get the range of a transmission
+     *
+     * \param params the parameters of the transmitted signal
+     * \return the distance (m) beyond which the receivers are filtered
+     */
+    double GetRange(Ptr<const SpectrumSignalParameters> params) const;
+
+  protected:
+    void DoDispose() override;
+    int64_t DoAssignStreams(int64_t stream) override;
+
+  private:
+    /**
+     * \brief Ignore the signal if the receiver is out of range of the transmitter
+     *
+     * \param params the parameters of the signals being received
+     * \param receiverPhy the SpectrumPhy of the receiver
+     * \return whether the signal being received should be ignored
+     */
+    bool DoFilter(Ptr<const SpectrumSignalParameters> params,
+                  Ptr<const SpectrumPhy> receiverPhy) override;
+
+    /// Index of a cell of the grid
+    using Cell = std::pair<int64_t, int64_t>;
+
+    /**
+     * \brief Hash of a cell of the grid
+     */
+    struct CellHash
+    {
+        /**
+         * \param cell the cell
+         * \return the hash of the cell
+         */
+        std::size_t operator()(const Cell& cell) const;
+    };
+
+    /**
+     * \brief A receiver mobility model in the index
+     */
+    struct Entry
+    {
+        Ptr<MobilityModel> m_mobility; //!< The mobility model
+        Vector m_position;             //!< Position at the last course change
+        bool m_moving{false};          //!< Whether it is moving, i.e., not in the grid
+        Cell m_cell;                   //!< Cell of the grid, if not moving
+    };
+
+    /**
+     * \brief Add a mobility model to the index, and follow its course changes
+     * \param mobility the mobility model
+     */
+    void AddMobility(Ptr<MobilityModel> mobility);
+
+    /**
+     * \brief Update the index with the new position and velocity of a mobility model
+     * \param mobility the mobility model
+     */
+    void CourseChanged(Ptr<const MobilityModel> mobility);
+
+    /**
+     * \brief Insert an entry in the grid, or in the moving receivers
+     * \param entry the entry
+     */
+    void Insert(Entry& entry);
+
+    /**
+     * \brief Remove an entry from the grid, or from the moving receivers
+     * \param entry the entry
+     */
+    void Remove(const Entry& entry);
+
+    /**
+     * \brief Find the receivers in range of a transmission
+     * \param params the parameters of the transmitted signal
+     */
+    void FindReceiversInRange(Ptr<const SpectrumSignalParameters> params);
+
+    /**
+     * \brief Disconnect from the course changes and clear the index
+     */
+    void Clear();
+
+    /**
+     * \param position a position
+     * \return the cell of the grid containing the position
+     */
+    Cell GetCell(const Vector& position) const;
+
+    double m_maxRange;      //!< Maximum distance (m) between transmitter and receiver
+    double m_minRxPowerDbm; //!< Minimum received power (dBm)
+    double m_maxGainDb;     //!< Maximum total gain (dB) on top of the free-space loss
+    double m_cellSize;      //!< Side (m) of the cells of the grid
+
+    std::unordered_map<const MobilityModel*, Entry> m_entries; //!< Receiver mobility models
+    std::unordered_map<Cell, std::vector<const MobilityModel*>, CellHash>
+        m_grid;                                     //!< Receivers not moving, per cell
+    std::vector<const MobilityModel*> m_moving;     //!< Receivers moving
+    Ptr<const SpectrumSignalParameters> m_txParams; //!< Transmission of m_inRange
+    Time m_txTime;                                  //!< Time of the search of m_inRange
+    std::unordered_set<const MobilityModel*> m_inRange; //!< Receivers in range of m_txParams
+};
+
+} // namespace ns3
+
+#endif /* RANGE_SPECTRUM_TRANSMIT_FILTER_H */
@@ -0,0 +1,579 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPECTRUM_VALUE_EXPRESSION_H
+#define SPECTRUM_VALUE_EXPRESSION_H
+
+#include "spectrum-value.h"
+
+#include <ns3/assert.h>
+
+#include <cmath>
+#include <type_traits>
+
+/**
+ * \file
+ * \ingroup spectrum
+ *
+ * Expression templates for the SpectrumValue arithmetic.
+ *
+ * The SpectrumValue operators return a new SpectrumValue at each step, so that
+ * \c (a - b + c) / d allocates and walks three temporaries. Wrapping the first
+ * operand with Lazy() builds instead an expression object, which is evaluated
+ * element by element, in a single pass and into the destination only, when it is
+ * assigned to a SpectrumValue or reduced with Sum() or Integral():
+ *
+ * \code
+ *   SpectrumValue sinr = (Lazy(a) - b + c) / d;
+ *   double power = Integral(Lazy(psd) * gain);
+ * \endcode
+ *
+ * Each element is computed with the same operations, in the same order, as the
+ * SpectrumValue operators, so the results are bit-identical. The expression only
+ * refers to its operands: it must be evaluated within the full-expression where it
+ * is built, and not stored (e.g., in an \c auto variable) beyond the lifetime of the
+ * SpectrumValues it uses.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Base of the expressions of SpectrumValues (CRTP)
+ *
+ * An expression E provides:
+ *   - \c double \c operator[](size_t i) \c const, the value of the element i
+ *   - \c const \c SpectrumValue* \c GetOperand() \c const, a SpectrumValue operand of
+ *     the expression, or nullptr if there is none, which gives the SpectrumModel and the
+ *     size of the result
+ *   - \c void \c CheckOperands(const SpectrumValue& ref) \c const, which asserts that all
+ *     the SpectrumValue operands use the SpectrumModel of ref
+ *
+ * \tparam E the type of the expression
+ */
+template <typename E>
+class SpectrumValueExpression
+{
+  public:
+    /**
+     * \return the expression as its actual type
+     */
+    const E& Derived() const
+    {
+        return static_cast<const E&>(*this);
+    }
+};
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief A SpectrumValue operand of an expression
+ */
+class SpectrumValueTerm : public SpectrumValueExpression<SpectrumValueTerm>
+{
+  public:
+    /**
+     * \param value the SpectrumValue, which must outlive the expression
+     */
+    explicit SpectrumValueTerm(const SpectrumValue& value)
+        : m_value(&value),
+          m_data(value.GetValues().data())
+    {
+    }
+
+    /**
+     * \param i the index of the element
+     * \return the value of the element
+     */
+    double operator[](size_t i) const
+    {
+        return m_data[i];
+    }
+
+    /**
+     * \return the SpectrumValue
+     */
+    const SpectrumValue* GetOperand() const
+    {
+        return m_value;
+    }
+
+    /**
+     * \param ref the SpectrumValue giving the SpectrumModel of the result
+     */
+    void CheckOperands(const SpectrumValue& ref) const
+    {
+        NS_ASSERT_MSG(m_value->GetSpectrumModelUid() == ref.GetSpectrumModelUid(),
+                      "SpectrumValue operands with different SpectrumModels");
+    }
+
+  private:
+    const SpectrumValue* m_value; //!< The SpectrumValue
+    const double* m_data;         //!< Its values
+};
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief A flat value operand of an expression
+ */
+class SpectrumValueScalar : public SpectrumValueExpression<SpectrumValueScalar>
+{
+  public:
+    /**
+     * \param s the flat value
+     */
+    explicit SpectrumValueScalar(double s)
+        : m_s(s)
+    {
+    }
+
+    /**
+     * \return the flat value, for any element
+     */
+    double operator[](size_t /* i */) const
+    {
+        return m_s;
+    }
+
+    /**
+     * \return nullptr, a flat value has no SpectrumModel
+     */
+    const SpectrumValue* GetOperand() const
+    {
+        return nullptr;
+    }
+
+    /**
+     * \brief Nothing to check for a flat value
+     */
+    void CheckOperands(const SpectrumValue& /* ref */) const
+    {
+    }
+
+  private:
+    double m_s; //!< The flat value
+};
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Element-wise binary operation between two expressions
+ *
+ * \tparam L the type of the left operand
+ * \tparam R the type of the right operand
+ * \tparam Op the operation, with a static \c double \c Apply(double, double)
+ */
+template <typename L, typename R, typename Op>
+class SpectrumValueBinaryExpression
+    : public SpectrumValueExpression<SpectrumValueBinaryExpression<L, R, Op>>
+{
+  public:
+    /**
+     * \param lhs the left operand
+     * \param rhs the right operand
+     */
+    SpectrumValueBinaryExpression(const L& lhs, const R& rhs)
+        : m_lhs(lhs),
+          m_rhs(rhs)
+    {
+    }
+
+    /**
+     * \param i the index of the element
+     * \return the value of the element
+     */
+    double operator[](size_t i) const
+    {
+        return Op::Apply(m_lhs[i], m_rhs[i]);
+    }
+
+    /**
+     * \return a SpectrumValue operand, the leftmost one
+     */
+    const SpectrumValue* GetOperand() const
+    {
+        const SpectrumValue* operand = m_lhs.GetOperand();
+        return operand ? operand : m_rhs.GetOperand();
+    }
+
+    /**
+     * \param ref the SpectrumValue giving the SpectrumModel of the result
+     */
+    void CheckOperands(const SpectrumValue& ref) const
+    {
+        m_lhs.CheckOperands(ref);
+        m_rhs.CheckOperands(ref);
+    }
+
+  private:
+    L m_lhs; //!< The left operand
+    R m_rhs; //!< The right operand
+};
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Element-wise function of an expression
+ *
+ * \tparam E the type of the argument
+ * \tparam Op the function, with a static \c double \c Apply(double)
+ */
+template <typename E, typename Op>
+class SpectrumValueUnaryExpression
+    : public SpectrumValueExpression<SpectrumValueUnaryExpression<E, Op>>
+{
+  public:
+    /**
+     * \param arg the argument
+     */
+    explicit SpectrumValueUnaryExpression(const E& arg)
+        : m_arg(arg)
+    {
+    }
+
+    /**
+     * \param i the index of the element
+     * \return the value of the element
+     */
+    double operator[](size_t i) const
+    {
+        return Op::Apply(m_arg[i]);
+    }
+
+    /**
+     * \return the SpectrumValue operand of the argument
+     */
+    const SpectrumValue* GetOperand() const
+    {
+        return m_arg.GetOperand();
+    }
+
+    /**
+     * \param ref the SpectrumValue giving the SpectrumModel of the result
+     */
+    void CheckOperands(const SpectrumValue& ref) const
+    {
+        m_arg.CheckOperands(ref);
+    }
+
+  private:
+    E m_arg; //!< The argument
+};
+
+namespace internal
+{
+
+/// Element-wise addition
+struct SpectrumValueAdd
+{
+    /**
+     * \param a left operand
+     * \param b right operand
+     * \return a + b
+     */
+    static double Apply(double a, double b)
+    {
+        return a + b;
+    }
+};
+
+/// Element-wise subtraction
+struct SpectrumValueSubtract
+{
+    /**
+     * \param a left operand
+     * \param b right operand
+     * \return a - b
+     */
+    static double Apply(double a, double b)
+    {
+        return a - b;
+    }
+};
+
+/// Element-wise multiplication
+struct SpectrumValueMultiply
+{
+    /**
+     * \param a left operand
+     * \param b right operand
+     * \return a * b
+     */
+    static double Apply(double a, double b)
+    {
+        return a * b;
+    }
+};
+
+/// Element-wise division
+struct SpectrumValueDivide
+{
+    /**
+     * \param a left operand
+     * \param b right operand
+     * \return a / b
+     */
+    static double Apply(double a, double b)
+    {
+        return a / b;
+    }
+};
+
+/// Element-wise logarithm in base 10
+struct SpectrumValueLog10
+{
+    /**
+     * \param a the argument
+     * \return log10(a)
+     */
+    static double Apply(double a)
+    {
+        return std::log10(a);
+    }
+};
+
+/// True if T is an expression of SpectrumValues
+template <typename T>
+constexpr bool IsSpectrumValueExpression = std::is_base_of_v<SpectrumValueExpression<T>, T>;
+
+/// True if T can be an operand of an expression of SpectrumValues
+template <typename T>
+constexpr bool IsSpectrumValueOperand = IsSpectrumValueExpression<T> ||
+                                        std::is_same_v<T, SpectrumValue> ||
+                                        std::is_arithmetic_v<T>;
+
+/**
+ * True if an operator between L and R builds an expression: one of them must already be
+ * an expression, so that the SpectrumValue operators are unchanged
+ */
+template <typename L, typename R>
+constexpr bool IsSpectrumValueExpressionOperator =
+    (IsSpectrumValueExpression<L> && IsSpectrumValueOperand<R>) ||
+    (IsSpectrumValueOperand<L> && IsSpectrumValueExpression<R>);
+
+/**
+ * \param e an expression
+ * \return the expression itself
+ */
+template <typename E>
+const E&
+AsSpectrumValueExpression(const SpectrumValueExpression<E>& e)
+{
+    return e.Derived();
+}
+
+/**
+ * \param v a SpectrumValue
+ * \return the SpectrumValue as an operand
+ */
+inline SpectrumValueTerm
+AsSpectrumValueExpression(const SpectrumValue& v)
+{
+    return SpectrumValueTerm(v);
+}
+
+/**
+ * \param s a flat value
+ * \return the flat value as an operand
+ */
+inline SpectrumValueScalar
+AsSpectrumValueExpression(double s)
+{
+    return SpectrumValueScalar(s);
+}
+
+/**
+ * \tparam Op the operation
+ * \param lhs the left operand
+ * \param rhs the right operand
+ * \return the expression lhs Op rhs
+ */
+template <typename Op, typename L, typename R>
+auto
+MakeSpectrumValueBinaryExpression(const L& lhs, const R& rhs)
+{
+    auto l = AsSpectrumValueExpression(lhs);
+    auto r = AsSpectrumValueExpression(rhs);
+    return SpectrumValueBinaryExpression<decltype(l), decltype(r), Op>(l, r);
+}
+
+} // namespace internal
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief Start an expression of SpectrumValues, evaluated without temporaries
+ * \param value the first operand, which must outlive the expression
+ * \return the operand as an expression
+ */
+inline SpectrumValueTerm
+Lazy(const SpectrumValue& value)
+{
+    return SpectrumValueTerm(value);
+}
+
+/**
+ * \ingroup spectrum
+ * \param lhs the left operand
+ * \param rhs the right operand
+ * \return the expression of the element-wise lhs + rhs
+ */
+template <typename L,
+          typename R,
+          typename = std::enable_if_t<internal::IsSpectrumValueExpressionOperator<L, R>>>
+auto
+operator+(const L& lhs, const R& rhs)
+{
+    return internal::MakeSpectrumValueBinaryExpression<internal::SpectrumValueAdd>(lhs, rhs);
+}
+
+/**
+ * \ingroup spectrum
+ * \param lhs the left operand
+ * \param rhs the right operand
+ * \return the expression of the element-wise lhs - rhs
+ */
+template <typename L,
+          typename R,
+          typename = std::enable_if_t<internal::IsSpectrumValueExpressionOperator<L, R>>>
+auto
+operator-(const L& lhs, const R& rhs)
+{
+    return internal::MakeSpectrumValueBinaryExpression<internal::SpectrumValueSubtract>(lhs, rhs);
+}
+
+/**
+ * \ingroup spectrum
+ * \param lhs the left operand
+ * \param rhs the right operand
+ * \return the expression of the element-wise lhs * rhs
+ */
+template <typename L,
+          typename R,
+          typename = std::enable_if_t<internal::IsSpectrumValueExpressionOperator<L, R>>>
+auto
+operator*(const L& lhs, const R& rhs)
+{
+    return internal::MakeSpectrumValueBinaryExpression<internal::SpectrumValueMultiply>(lhs, rhs);
+}
+
+/**
+ * \ingroup spectrum
+ * \param lhs the left operand
+ * \param rhs the right operand
+ * \return the expression of the element-wise lhs / rhs
+ */
+template <typename L,
+          typename R,
+          typename = std::enable_if_t<internal::IsSpectrumValueExpressionOperator<L, R>>>
+auto
+operator/(const L& lhs, const R& rhs)
+{
+    return internal::MakeSpectrumValueBinaryExpression<internal::SpectrumValueDivide>(lhs, rhs);
+}
+
+/**
+ * \ingroup spectrum
+ * \param arg the argument
+ * \return the expression of the element-wise logarithm in base 10 of arg
+ */
+template <typename E>
+SpectrumValueUnaryExpression<E, internal::SpectrumValueLog10>
+Log10(const SpectrumValueExpression<E>& arg)
+{
+    return SpectrumValueUnaryExpression<E, internal::SpectrumValueLog10>(arg.Derived());
+}
+
+/**
+ * \ingroup spectrum
+ * \param expr the expression
+ * \return the sum of all the values of the expression, added in the same order as
+ * Sum(const SpectrumValue&)
+ */
+template <typename E>
+double
+Sum(const SpectrumValueExpression<E>& expr)
+{
+    const E& e = expr.Derived();
+    const SpectrumValue* ref = e.GetOperand();
+    e.CheckOperands(*ref);
+    size_t n = ref->GetValues().size();
+    double s = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        s += e[i];
+    }
+    return s;
+}
+
+/**
+ * \ingroup spectrum
+ * \param expr the expression
+ * \return the value of the integral of the expression, added in the same order as
+ * Integral(const SpectrumValue&)
+ */
+template <typename E>
+double
+Integral(const SpectrumValueExpression<E>& expr)
+{
+    const E& e = expr.Derived();
+    const SpectrumValue* ref = e.GetOperand();
+    e.CheckOperands(*ref);
+    size_t n = ref->GetValues().size();
+    double s = 0;
+    auto bit = ref->ConstBandsBegin();
+    for (size_t i = 0; i < n; ++i, ++bit)
+    {
+        NS_ASSERT(bit != ref->ConstBandsEnd());
+        s += e[i] * (bit->fh - bit->fl);
+    }
+    NS_ASSERT(bit == ref->ConstBandsEnd());
+    return s;
+}
+
+template <typename E>
+SpectrumValue::SpectrumValue(const SpectrumValueExpression<E>& expr)
+{
+    *this = expr;
+}
+
+template <typename E>
+SpectrumValue&
+SpectrumValue::operator=(const SpectrumValueExpression<E>& expr)
+{
+    const E& e = expr.Derived();
+    const SpectrumValue* ref = e.GetOperand();
+    e.CheckOperands(*ref);
+    // if this SpectrumValue is an operand, it has already the size of the result and the
+    // element i is read before being written
+    Ptr<const SpectrumModel> model = ref->m_spectrumModel;
+    m_values.resize(ref->m_values.size());
+    double* out = m_values.data();
+    for (size_t i = 0; i < m_values.size(); ++i)
+    {
+        out[i] = e[i];
+    }
+    m_spectrumModel = model;
+    return *this;
+}
+
+} // namespace ns3
+
+#endif /* SPECTRUM_VALUE_EXPRESSION_H */
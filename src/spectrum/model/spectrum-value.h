@@ -34,6 +34,9 @@ namespace ns3
 /// Container for element values
 typedef std::vector<double> Values;
 
+template <typename E>
+class SpectrumValueExpression;
+
 /**
  * \ingroup spectrum
  *
@@ -81,6 +84,28 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
 
     SpectrumValue();
 
+    /**
+     * @brief Evaluate an expression of SpectrumValues in a single pass, without temporaries
+     *
+     * Defined in spectrum-value-expression.h, which must be included to build expressions.
+     *
+     * @param expr the expression
+     */
+    template <typename E>
+    SpectrumValue(const SpectrumValueExpression<E>& expr);
+
+    /**
+     * @brief Evaluate an expression of SpectrumValues in a single pass, without temporaries
+     *
+     * The values are overwritten in place: this SpectrumValue can be an operand of the
+     * expression.
+     *
+     * @param expr the expression
+     * @return a reference to this SpectrumValue
+     */
+    template <typename E>
+    SpectrumValue& operator=(const SpectrumValueExpression<E>& expr);
+
     /**
      * Access value at given frequency index
      *
@@ -30,11 +30,14 @@
 #include "ns3/phased-array-model.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 #include <ns3/simulator.h>
 
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <random>
+#include <tuple>
 
 namespace ns3
 {
@@ -53,6 +56,69 @@ static const double offSetAlpha[20] = {
     0.6797, -0.6797, 0.8844, -0.8844, 1.1481, -1.1481, 1.5195, -1.5195, 2.1551, -2.1551,
 };
 
+#if defined(__GNUC__)
+/**
+ * Block of doubles processed at once by AccumulateRay, mapped by the compiler to one SIMD
+ * register of the target, as the SpectrumValue kernels. Each lane matches the scalar
+ * operations within rounding: the compiler may contract them differently (e.g., into FMA).
+ */
+#if defined(__AVX__)
+typedef double SimdBlock __attribute__((vector_size(32)));
+#else
+typedef double SimdBlock __attribute__((vector_size(16)));
+#endif
+/// Doubles in a SimdBlock
+static constexpr size_t SIMD_LANES = sizeof(SimdBlock) / sizeof(double);
+#endif
+
+/**
+ * Add the contribution of a ray to the coefficients of a range of transmitter elements,
+ * h[s] += a * tx[s] as complex numbers, with the real and imaginary parts in separate
+ * arrays.
+ * \param hRe the real parts of the coefficients
+ * \param hIm the imaginary parts of the coefficients
+ * \param txRe the real parts of the transmitter steering phases of the ray
+ * \param txIm the imaginary parts of the transmitter steering phases of the ray
+ * \param aRe the real part of the ray term common to the elements
+ * \param aIm the imaginary part of the ray term common to the elements
+ * \param first the first element
+ * \param last the end of the range of elements
+ */
+static void
+AccumulateRay(double* hRe,
+              double* hIm,
+              const double* txRe,
+              const double* txIm,
+              double aRe,
+              double aIm,
+              size_t first,
+              size_t last)
+{
+    size_t s = first;
+#if defined(__GNUC__)
+    for (; s + SIMD_LANES <= last; s += SIMD_LANES)
+    {
+        SimdBlock re;
+        SimdBlock im;
+        SimdBlock tRe;
+        SimdBlock tIm;
+        std::memcpy(&re, hRe + s, sizeof(re));
+        std::memcpy(&im, hIm + s, sizeof(im));
+        std::memcpy(&tRe, txRe + s, sizeof(tRe));
+        std::memcpy(&tIm, txIm + s, sizeof(tIm));
+        re += aRe * tRe - aIm * tIm;
+        im += aRe * tIm + aIm * tRe;
+        std::memcpy(hRe + s, &re, sizeof(re));
+        std::memcpy(hIm + s, &im, sizeof(im));
+    }
+#endif
+    for (; s < last; ++s)
+    {
+        hRe[s] += aRe * txRe[s] - aIm * txIm[s];
+        hIm[s] += aRe * txIm[s] + aIm * txRe[s];
+    }
+}
+
 /**
  * The square root matrix for <em>RMa LOS</em>, which is generated using the
  * Cholesky decomposition according to table 7.5-6 Part 2 and follows the order
@@ -1100,8 +1166,8 @@ ThreeGppChannelModel::DoDispose()
     {
         m_channelConditionModel->Dispose();
     }
-    m_channelMatrixMap.clear();
-    m_channelParamsMap.clear();
+    m_channelMatrixMap.Clear();
+    m_channelParamsMap.Clear();
     m_channelConditionModel = nullptr;
 }
 
@@ -1167,6 +1233,59 @@ ThreeGppChannelModel::GetTypeId()
                           DoubleValue(0.0),
                           MakeDoubleAccessor(&ThreeGppChannelModel::m_vScatt),
                           MakeDoubleChecker<double>(0.0))
+            // attributes for the caches of the channels
+            .AddAttribute("CacheMaxEntries",
+                          "Maximum number of channel params, and of channel matrices, kept in "
+                          "memory. The least recently used ones are evicted and generated again "
+                          "if needed. 0 means no limit.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::SetCacheMaxEntries,
+                                               &ThreeGppChannelModel::GetCacheMaxEntries),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("CacheIdleTime",
+                          "Time after which the channel params and matrices that are not used "
+                          "are evicted from memory. 0 means that they are kept until they are "
+                          "replaced.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&ThreeGppChannelModel::SetCacheIdleTime,
+                                           &ThreeGppChannelModel::GetCacheIdleTime),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("ParamsCacheHits",
+                          "Number of lookups of the channel params that found them in memory",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::GetParamsCacheHits),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("ParamsCacheMisses",
+                          "Number of lookups of the channel params that did not find them",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::GetParamsCacheMisses),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("ParamsCacheEvictions",
+                          "Number of channel params evicted from memory",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::GetParamsCacheEvictions),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("MatrixCacheHits",
+                          "Number of lookups of the channel matrices that found them in memory",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::GetMatrixCacheHits),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("MatrixCacheMisses",
+                          "Number of lookups of the channel matrices that did not find them",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::GetMatrixCacheMisses),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("MatrixCacheEvictions",
+                          "Number of channel matrices evicted from memory",
+                          TypeId::ATTR_GET,
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::GetMatrixCacheEvictions),
+                          MakeUintegerChecker<uint64_t>())
 
         ;
     return tid;
@@ -2502,9 +2621,9 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
     Ptr<ChannelMatrix> channelMatrix;
     Ptr<ThreeGppChannelParams> channelParams;
 
-    if (m_channelParamsMap.find(channelParamsKey) != m_channelParamsMap.end())
+    if (auto cachedParams = m_channelParamsMap.Find(channelParamsKey))
     {
-        channelParams = m_channelParamsMap[channelParamsKey];
+        channelParams = *cachedParams;
         // check if it has to be updated
         updateParams = ChannelParamsNeedsUpdate(channelParams, condition);
     }
@@ -2529,16 +2648,18 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
         // Step 10: Draw initial phases
         channelParams = GenerateChannelParameters(condition, table3gpp, aMob, bMob);
         // store or replace the channel parameters
-        m_channelParamsMap[channelParamsKey] = channelParams;
+        m_channelParamsMap.Insert(channelParamsKey, channelParams);
     }
 
-    if (m_channelMatrixMap.find(channelMatrixKey) != m_channelMatrixMap.end())
+    if (auto cachedMatrix = m_channelMatrixMap.Find(channelMatrixKey))
     {
         // channel matrix present in the map
         NS_LOG_DEBUG("channel matrix present in the map");
-        channelMatrix = m_channelMatrixMap[channelMatrixKey];
+        channelMatrix = *cachedMatrix;
         updateMatrix = ChannelMatrixNeedsUpdate(channelParams, channelMatrix);
         updateMatrix |= AntennaSetupChanged(aAntenna, bAntenna, channelMatrix);
+        // the matrix was generated with channel params that were evicted since then
+        updateMatrix |= notFoundParams;
     }
     else
     {
@@ -2558,7 +2679,7 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
                                                // antennas at the moment of the channel generation
 
         // store or replace the channel matrix in the channel map
-        m_channelMatrixMap[channelMatrixKey] = channelMatrix;
+        m_channelMatrixMap.Insert(channelMatrixKey, channelMatrix);
     }
 
     return channelMatrix;
@@ -2573,9 +2694,9 @@ ThreeGppChannelModel::GetParams(Ptr<const MobilityModel> aMob, Ptr<const Mobilit
     uint64_t channelParamsKey =
         GetKey(aMob->GetObject<Node>()->GetId(), bMob->GetObject<Node>()->GetId());
 
-    if (m_channelParamsMap.find(channelParamsKey) != m_channelParamsMap.end())
+    if (auto channelParams = m_channelParamsMap.Peek(channelParamsKey))
     {
-        return m_channelParamsMap.find(channelParamsKey)->second;
+        return *channelParams;
     }
     else
     {
@@ -2584,6 +2705,83 @@ ThreeGppChannelModel::GetParams(Ptr<const MobilityModel> aMob, Ptr<const Mobilit
     }
 }
 
+void
+ThreeGppChannelModel::RemoveNode(uint32_t nodeId)
+{
+    NS_LOG_FUNCTION(this << nodeId);
+    auto hasNode = [nodeId](const auto& channel) {
+        return channel->m_nodeIds.first == nodeId || channel->m_nodeIds.second == nodeId;
+    };
+    size_t params = m_channelParamsMap.Erase(hasNode);
+    size_t matrices = m_channelMatrixMap.Erase(hasNode);
+    NS_LOG_DEBUG("Removed " << params << " channel params and " << matrices
+                            << " channel matrices of node " << nodeId);
+}
+
+void
+ThreeGppChannelModel::SetCacheMaxEntries(uint32_t maxEntries)
+{
+    NS_LOG_FUNCTION(this << maxEntries);
+    m_channelParamsMap.SetMaxSize(maxEntries);
+    m_channelMatrixMap.SetMaxSize(maxEntries);
+}
+
+uint32_t
+ThreeGppChannelModel::GetCacheMaxEntries() const
+{
+    return m_channelParamsMap.GetMaxSize();
+}
+
+void
+ThreeGppChannelModel::SetCacheIdleTime(Time idleTime)
+{
+    NS_LOG_FUNCTION(this << idleTime);
+    m_channelParamsMap.SetIdleTime(idleTime);
+    m_channelMatrixMap.SetIdleTime(idleTime);
+}
+
+Time
+ThreeGppChannelModel::GetCacheIdleTime() const
+{
+    return m_channelParamsMap.GetIdleTime();
+}
+
+uint64_t
+ThreeGppChannelModel::GetParamsCacheHits() const
+{
+    return m_channelParamsMap.GetHits();
+}
+
+uint64_t
+ThreeGppChannelModel::GetParamsCacheMisses() const
+{
+    return m_channelParamsMap.GetMisses();
+}
+
+uint64_t
+ThreeGppChannelModel::GetParamsCacheEvictions() const
+{
+    return m_channelParamsMap.GetEvictions();
+}
+
+uint64_t
+ThreeGppChannelModel::GetMatrixCacheHits() const
+{
+    return m_channelMatrixMap.GetHits();
+}
+
+uint64_t
+ThreeGppChannelModel::GetMatrixCacheMisses() const
+{
+    return m_channelMatrixMap.GetMisses();
+}
+
+uint64_t
+ThreeGppChannelModel::GetMatrixCacheEvictions() const
+{
+    return m_channelMatrixMap.GetEvictions();
+}
+
 Ptr<ThreeGppChannelModel::ThreeGppChannelParams>
 ThreeGppChannelModel::GenerateChannelParameters(const Ptr<const ChannelCondition> channelCondition,
                                                 const Ptr<const ParamsTable> table3gpp,
@@ -3255,35 +3453,27 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
     // check if channelParams structure is generated in direction s-to-u or u-to-s
     bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-    MatrixBasedChannelModel::Double2DVector rayAodRadian;
-    MatrixBasedChannelModel::Double2DVector rayAoaRadian;
-    MatrixBasedChannelModel::Double2DVector rayZodRadian;
-    MatrixBasedChannelModel::Double2DVector rayZoaRadian;
-
     // if channel params is generated in the same direction in which we
     // generate the channel matrix, angles and zenith od departure and arrival are ok,
     // just set them to corresponding variable that will be used for the generation
     // of channel matrix, otherwise we need to flip angles and zeniths of departure and arrival
-    if (isSameDirection)
-    {
-        rayAodRadian = channelParams->m_rayAodRadian;
-        rayAoaRadian = channelParams->m_rayAoaRadian;
-        rayZodRadian = channelParams->m_rayZodRadian;
-        rayZoaRadian = channelParams->m_rayZoaRadian;
-    }
-    else
-    {
-        rayAodRadian = channelParams->m_rayAoaRadian;
-        rayAoaRadian = channelParams->m_rayAodRadian;
-        rayZodRadian = channelParams->m_rayZoaRadian;
-        rayZoaRadian = channelParams->m_rayZodRadian;
-    }
+    const Double2DVector& rayAodRadian =
+        isSameDirection ? channelParams->m_rayAodRadian : channelParams->m_rayAoaRadian;
+    const Double2DVector& rayAoaRadian =
+        isSameDirection ? channelParams->m_rayAoaRadian : channelParams->m_rayAodRadian;
+    const Double2DVector& rayZodRadian =
+        isSameDirection ? channelParams->m_rayZodRadian : channelParams->m_rayZoaRadian;
+    const Double2DVector& rayZoaRadian =
+        isSameDirection ? channelParams->m_rayZoaRadian : channelParams->m_rayZodRadian;
 
     // Step 11: Generate channel coefficients for each cluster n and each receiver
     //  and transmitter element pair u,s.
     // where n is cluster index, u and s are receive and transmit antenna element.
     size_t uSize = uAntenna->GetNumElems();
     size_t sSize = sAntenna->GetNumElems();
+    const uint8_t numReducedCluster = channelParams->m_reducedClusterNumber;
+    const uint8_t raysPerCluster = table3gpp->m_raysPerCluster;
+    const size_t numRays = static_cast<size_t>(numReducedCluster) * raysPerCluster;
 
     // NOTE: Since each of the strongest 2 clusters are divided into 3 sub-clusters,
     // the total cluster will generally be numReducedCLuster + 4.
@@ -3322,66 +3512,72 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
     Angles sAngle(uMob->GetPosition(), sMob->GetPosition());
     Angles uAngle(sMob->GetPosition(), uMob->GetPosition());
 
-    Double2DVector sinCosA; // cached multiplications of sin and cos of the ZoA and AoA angles
-    Double2DVector sinSinA; // cached multiplications of sines of the ZoA and AoA angles
-    Double2DVector cosZoA;  // cached cos of the ZoA angle
-    Double2DVector sinCosD; // cached multiplications of sin and cos of the ZoD and AoD angles
-    Double2DVector sinSinD; // cached multiplications of the cosines of the ZoA and AoA angles
-    Double2DVector cosZoD;  // cached cos of the ZoD angle
-
-    // contains part of the ray expression, cached as independent from the u- and s-indexes,
-    // but calculate it for different polarization angles of s and u
-    std::map<std::pair<uint8_t, uint8_t>, Complex2DVector> raysPreComp;
-    for (size_t polSa = 0; polSa < sAntenna->GetNumPols(); ++polSa)
-    {
-        for (size_t polUa = 0; polUa < uAntenna->GetNumPols(); ++polUa)
+    // the element locations and polarizations, read once, and for each element the first
+    // one at the same location (the elements of the two polarizations of a dual-polarized
+    // array are co-located), whose steering phases are computed once
+    auto readElements = [](Ptr<const PhasedArrayModel> antenna,
+                           std::vector<Vector>& locs,
+                           std::vector<uint8_t>& pols,
+                           std::vector<size_t>& sameLoc) {
+        std::map<std::tuple<double, double, double>, size_t> firstAtLoc;
+        for (size_t index = 0; index < antenna->GetNumElems(); index++)
         {
-            raysPreComp[std::make_pair(polSa, polUa)] =
-                Complex2DVector(channelParams->m_reducedClusterNumber, table3gpp->m_raysPerCluster);
+            locs.push_back(antenna->GetElementLocation(index));
+            pols.push_back(antenna->GetElemPol(index));
+            auto key = std::make_tuple(locs.back().x, locs.back().y, locs.back().z);
+            sameLoc.push_back(firstAtLoc.emplace(key, index).first->second);
         }
-    }
+    };
+    std::vector<Vector> uLocs;
+    std::vector<uint8_t> uPols;
+    std::vector<size_t> uSameLoc;
+    readElements(uAntenna, uLocs, uPols, uSameLoc);
+    std::vector<Vector> sLocs;
+    std::vector<uint8_t> sPols;
+    std::vector<size_t> sSameLoc;
+    readElements(sAntenna, sLocs, sPols, sSameLoc);
+
+    // contains part of the ray expression, cached as independent from the u- and s-indexes,
+    // but calculate it for different polarization angles of s and u: the element
+    // [(polSa * numPolsU + polUa) * numRays + nIndex * raysPerCluster + mIndex]
+    const size_t numPolsU = uAntenna->GetNumPols();
+    const size_t numPolsS = sAntenna->GetNumPols();
+    std::vector<std::complex<double>> raysPreComp(numPolsS * numPolsU * numRays);
+
+    // steering phases of the rays at each element, exp(j 2 pi (r . loc)), as
+    // structure of arrays: the element [rayIndex * uSize + uIndex] for the receiver, and
+    // [rayIndex * sSize + sIndex] for the transmitter
+    std::vector<double> rxPhaseRe(numRays * uSize);
+    std::vector<double> rxPhaseIm(numRays * uSize);
+    std::vector<double> txPhaseRe(numRays * sSize);
+    std::vector<double> txPhaseIm(numRays * sSize);
 
-    // resize to appropriate dimensions
-    sinCosA.resize(channelParams->m_reducedClusterNumber);
-    sinSinA.resize(channelParams->m_reducedClusterNumber);
-    cosZoA.resize(channelParams->m_reducedClusterNumber);
-    sinCosD.resize(channelParams->m_reducedClusterNumber);
-    sinSinD.resize(channelParams->m_reducedClusterNumber);
-    cosZoD.resize(channelParams->m_reducedClusterNumber);
-    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
-    {
-        sinCosA[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinSinA[nIndex].resize(table3gpp->m_raysPerCluster);
-        cosZoA[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinCosD[nIndex].resize(table3gpp->m_raysPerCluster);
-        sinSinD[nIndex].resize(table3gpp->m_raysPerCluster);
-        cosZoD[nIndex].resize(table3gpp->m_raysPerCluster);
-    }
     // pre-compute the terms which are independent from uIndex and sIndex
-    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+    for (uint8_t nIndex = 0; nIndex < numReducedCluster; nIndex++)
     {
-        for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+        for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
         {
-            DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
+            const size_t rayIndex = nIndex * raysPerCluster + mIndex;
+            const DoubleVector& initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
             NS_ASSERT(4 <= initialPhase.size());
             double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
 
             // cache the component of the "rays" terms which depend on the random angle of arrivals
             // and departures and initial phases only
-            for (uint8_t polUa = 0; polUa < uAntenna->GetNumPols(); ++polUa)
+            for (uint8_t polUa = 0; polUa < numPolsU; ++polUa)
             {
                 auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna->GetElementFieldPattern(
                     Angles(channelParams->m_rayAoaRadian[nIndex][mIndex],
                            channelParams->m_rayZoaRadian[nIndex][mIndex]),
                     polUa);
-                for (uint8_t polSa = 0; polSa < sAntenna->GetNumPols(); ++polSa)
+                for (uint8_t polSa = 0; polSa < numPolsS; ++polSa)
                 {
                     auto [txFieldPatternPhi, txFieldPatternTheta] =
                         sAntenna->GetElementFieldPattern(
                             Angles(channelParams->m_rayAodRadian[nIndex][mIndex],
                                    channelParams->m_rayZodRadian[nIndex][mIndex]),
                             polSa);
-                    raysPreComp[std::make_pair(polSa, polUa)](nIndex, mIndex) =
+                    raysPreComp[(polSa * numPolsU + polUa) * numRays + rayIndex] =
                         std::complex<double>(cos(initialPhase[0]), sin(initialPhase[0])) *
                             rxFieldPatternTheta * txFieldPatternTheta +
                         std::complex<double>(cos(initialPhase[1]), sin(initialPhase[1])) *
@@ -3393,133 +3589,158 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
                 }
             }
 
-            // cache the component of the "rxPhaseDiff" terms which depend on the random angle of
-            // arrivals only
+            // the "rxPhaseDiff" terms, which depend on the random angle of arrivals and on
+            // the location of the receiver elements only
             double sinRayZoa = sin(rayZoaRadian[nIndex][mIndex]);
             double sinRayAoa = sin(rayAoaRadian[nIndex][mIndex]);
             double cosRayAoa = cos(rayAoaRadian[nIndex][mIndex]);
-            sinCosA[nIndex][mIndex] = sinRayZoa * cosRayAoa;
-            sinSinA[nIndex][mIndex] = sinRayZoa * sinRayAoa;
-            cosZoA[nIndex][mIndex] = cos(rayZoaRadian[nIndex][mIndex]);
+            double sinCosA = sinRayZoa * cosRayAoa;
+            double sinSinA = sinRayZoa * sinRayAoa;
+            double cosZoA = cos(rayZoaRadian[nIndex][mIndex]);
+            for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+            {
+                const size_t phaseIndex = rayIndex * uSize + uIndex;
+                if (uSameLoc[uIndex] != uIndex)
+                {
+                    rxPhaseRe[phaseIndex] = rxPhaseRe[rayIndex * uSize + uSameLoc[uIndex]];
+                    rxPhaseIm[phaseIndex] = rxPhaseIm[rayIndex * uSize + uSameLoc[uIndex]];
+                    continue;
+                }
+                // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
+                const Vector& uLoc = uLocs[uIndex];
+                double rxPhaseDiff =
+                    2 * M_PI * (sinCosA * uLoc.x + sinSinA * uLoc.y + cosZoA * uLoc.z);
+                rxPhaseRe[phaseIndex] = cos(rxPhaseDiff);
+                rxPhaseIm[phaseIndex] = sin(rxPhaseDiff);
+            }
 
-            // cache the component of the "txPhaseDiff" terms which depend on the random angle of
-            // departure only
+            // the "txPhaseDiff" terms, which depend on the random angle of departure and on
+            // the location of the transmitter elements only
             double sinRayZod = sin(rayZodRadian[nIndex][mIndex]);
             double sinRayAod = sin(rayAodRadian[nIndex][mIndex]);
             double cosRayAod = cos(rayAodRadian[nIndex][mIndex]);
-            sinCosD[nIndex][mIndex] = sinRayZod * cosRayAod;
-            sinSinD[nIndex][mIndex] = sinRayZod * sinRayAod;
-            cosZoD[nIndex][mIndex] = cos(rayZodRadian[nIndex][mIndex]);
+            double sinCosD = sinRayZod * cosRayAod;
+            double sinSinD = sinRayZod * sinRayAod;
+            double cosZoD = cos(rayZodRadian[nIndex][mIndex]);
+            for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+            {
+                const size_t phaseIndex = rayIndex * sSize + sIndex;
+                if (sSameLoc[sIndex] != sIndex)
+                {
+                    txPhaseRe[phaseIndex] = txPhaseRe[rayIndex * sSize + sSameLoc[sIndex]];
+                    txPhaseIm[phaseIndex] = txPhaseIm[rayIndex * sSize + sSameLoc[sIndex]];
+                    continue;
+                }
+                const Vector& sLoc = sLocs[sIndex];
+                double txPhaseDiff =
+                    2 * M_PI * (sinCosD * sLoc.x + sinSinD * sLoc.y + cosZoD * sLoc.z);
+                txPhaseRe[phaseIndex] = cos(txPhaseDiff);
+                txPhaseIm[phaseIndex] = sin(txPhaseDiff);
+            }
+        }
+    }
+
+    // the transmitter elements, grouped in runs of consecutive elements with the same
+    // polarization, as (first element, end of the run)
+    std::vector<std::pair<size_t, size_t>> sPolRuns;
+    for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+    {
+        if (sPolRuns.empty() || sPols[sIndex] != sPols[sPolRuns.back().first])
+        {
+            sPolRuns.emplace_back(sIndex, sIndex);
+        }
+        sPolRuns.back().second = sIndex + 1;
+    }
+
+    // sub-cluster of each ray of the strongest clusters (7.5-28), the others have only one
+    std::vector<uint8_t> subCluster(raysPerCluster);
+    for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+    {
+        switch (mIndex)
+        {
+        case 9:
+        case 10:
+        case 11:
+        case 12:
+        case 17:
+        case 18:
+            subCluster[mIndex] = 1;
+            break;
+        case 13:
+        case 14:
+        case 15:
+        case 16:
+            subCluster[mIndex] = 2;
+            break;
+        default: // case 1,2,3,4,5,6,7,8,19,20
+            subCluster[mIndex] = 0;
+            break;
         }
     }
 
-    // The following for loops computes the channel coefficients
+    // The following for loops computes the channel coefficients, for a receiver element at
+    // a time: the sums over the rays of all the transmitter elements are done together, in
+    // the inner loop over the transmitter elements, each one in the order of the rays
+    std::vector<double> raysRe(3 * sSize);
+    std::vector<double> raysIm(3 * sSize);
     // Keeps track of how many sub-clusters have been added up to now
     uint8_t numSubClustersAdded = 0;
-    for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+    for (uint8_t nIndex = 0; nIndex < numReducedCluster; nIndex++)
     {
+        // Compute the N-2 weakest cluster, assuming 0 slant angle and a
+        // polarization slant angle configured in the array (7.5-22), or the 3 sub-clusters
+        // of the 2 strongest ones (7.5-28)
+        bool isStrongest =
+            (nIndex == channelParams->m_cluster1st || nIndex == channelParams->m_cluster2nd);
+        double scale = sqrt(channelParams->m_clusterPower[nIndex] / raysPerCluster);
+
         for (size_t uIndex = 0; uIndex < uSize; uIndex++)
         {
-            Vector uLoc = uAntenna->GetElementLocation(uIndex);
+            std::fill(raysRe.begin(), raysRe.end(), 0.0);
+            std::fill(raysIm.begin(), raysIm.end(), 0.0);
 
-            for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+            for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
             {
-                Vector sLoc = sAntenna->GetElementLocation(sIndex);
-                // Compute the N-2 weakest cluster, assuming 0 slant angle and a
-                // polarization slant angle configured in the array (7.5-22)
-                if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
+                const size_t rayIndex = nIndex * raysPerCluster + mIndex;
+                const size_t sub = isStrongest ? subCluster[mIndex] : 0;
+                double* subRe = raysRe.data() + sub * sSize;
+                double* subIm = raysIm.data() + sub * sSize;
+                const double* txRe = txPhaseRe.data() + rayIndex * sSize;
+                const double* txIm = txPhaseIm.data() + rayIndex * sSize;
+                const double rxRe = rxPhaseRe[rayIndex * uSize + uIndex];
+                const double rxIm = rxPhaseIm[rayIndex * uSize + uIndex];
+
+                for (const auto& [first, last] : sPolRuns)
                 {
-                    std::complex<double> rays(0, 0);
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
-                    {
-                        // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                        double rxPhaseDiff =
-                            2 * M_PI *
-                            (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
-                             cosZoA[nIndex][mIndex] * uLoc.z);
-
-                        double txPhaseDiff =
-                            2 * M_PI *
-                            (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
-                             cosZoD[nIndex][mIndex] * sLoc.z);
-                        // NOTE Doppler is computed in the CalcBeamformingGain function and is
-                        // simplified to only account for the center angle of each cluster.
-                        rays += raysPreComp[std::make_pair(sAntenna->GetElemPol(sIndex),
-                                                           uAntenna->GetElemPol(uIndex))](nIndex,
-                                                                                          mIndex) *
-                                std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                                std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-                    }
-                    rays *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    hUsn(uIndex, sIndex, nIndex) = rays;
+                    // raysPreComp * rxPhase, as the complex product
+                    const std::complex<double> pre =
+                        raysPreComp[(sPols[first] * numPolsU + uPols[uIndex]) * numRays +
+                                    rayIndex];
+                    const double aRe = pre.real() * rxRe - pre.imag() * rxIm;
+                    const double aIm = pre.real() * rxIm + pre.imag() * rxRe;
+                    // NOTE Doppler is computed in the CalcBeamformingGain function and is
+                    // simplified to only account for the center angle of each cluster.
+                    AccumulateRay(subRe, subIm, txRe, txIm, aRe, aIm, first, last);
                 }
-                else //(7.5-28)
-                {
-                    std::complex<double> raysSub1(0, 0);
-                    std::complex<double> raysSub2(0, 0);
-                    std::complex<double> raysSub3(0, 0);
+            }
 
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
-                    {
-                        // ZML:Just remind me that the angle offsets for the 3 subclusters were not
-                        // generated correctly.
-                        double rxPhaseDiff =
-                            2 * M_PI *
-                            (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
-                             cosZoA[nIndex][mIndex] * uLoc.z);
-
-                        double txPhaseDiff =
-                            2 * M_PI *
-                            (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
-                             cosZoD[nIndex][mIndex] * sLoc.z);
-
-                        std::complex<double> raySub =
-                            raysPreComp[std::make_pair(sAntenna->GetElemPol(sIndex),
-                                                       uAntenna->GetElemPol(uIndex))](nIndex,
-                                                                                      mIndex) *
-                            std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                            std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-
-                        switch (mIndex)
-                        {
-                        case 9:
-                        case 10:
-                        case 11:
-                        case 12:
-                        case 17:
-                        case 18:
-                            raysSub2 += raySub;
-                            break;
-                        case 13:
-                        case 14:
-                        case 15:
-                        case 16:
-                            raysSub3 += raySub;
-                            break;
-                        default: // case 1,2,3,4,5,6,7,8,19,20
-                            raysSub1 += raySub;
-                            break;
-                        }
-                    }
-                    raysSub1 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub2 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub3 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    hUsn(uIndex, sIndex, nIndex) = raysSub1;
-                    hUsn(uIndex,
-                         sIndex,
-                         channelParams->m_reducedClusterNumber + numSubClustersAdded) = raysSub2;
-                    hUsn(uIndex,
-                         sIndex,
-                         channelParams->m_reducedClusterNumber + numSubClustersAdded + 1) =
-                        raysSub3;
+            for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+            {
+                hUsn(uIndex, sIndex, nIndex) =
+                    std::complex<double>(raysRe[sIndex], raysIm[sIndex]) * scale;
+                if (isStrongest)
+                {
+                    hUsn(uIndex, sIndex, numReducedCluster + numSubClustersAdded) =
+                        std::complex<double>(raysRe[sSize + sIndex], raysIm[sSize + sIndex]) *
+                        scale;
+                    hUsn(uIndex, sIndex, numReducedCluster + numSubClustersAdded + 1) =
+                        std::complex<double>(raysRe[2 * sSize + sIndex],
+                                             raysIm[2 * sSize + sIndex]) *
+                        scale;
                 }
             }
         }
-        if (nIndex == channelParams->m_cluster1st || nIndex == channelParams->m_cluster2nd)
+        if (isStrongest)
         {
             numSubClustersAdded += 2;
         }
@@ -3540,46 +3761,60 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
         const double sinSAngleAz = sin(sAngle.GetAzimuth());
         const double cosSAngleAz = cos(sAngle.GetAzimuth());
 
+        // the field patterns of the LOS ray depend on the polarization of the elements only
+        std::vector<std::pair<double, double>> rxFieldPatterns(numPolsU);
+        for (uint8_t polUa = 0; polUa < numPolsU; ++polUa)
+        {
+            rxFieldPatterns[polUa] = uAntenna->GetElementFieldPattern(
+                Angles(uAngle.GetAzimuth(), uAngle.GetInclination()),
+                polUa);
+        }
+        std::vector<std::pair<double, double>> txFieldPatterns(numPolsS);
+        for (uint8_t polSa = 0; polSa < numPolsS; ++polSa)
+        {
+            txFieldPatterns[polSa] = sAntenna->GetElementFieldPattern(
+                Angles(sAngle.GetAzimuth(), sAngle.GetInclination()),
+                polSa);
+        }
+        std::vector<std::complex<double>> txPhases(sSize);
+        for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+            const Vector& sLoc = sLocs[sIndex];
+            double txPhaseDiff =
+                2 * M_PI *
+                (sinSAngleIncl * cosSAngleAz * sLoc.x + sinSAngleIncl * sinSAngleAz * sLoc.y +
+                 cosSAngleIncl * sLoc.z);
+            txPhases[sIndex] = std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+        }
+
+        double kLinear = pow(10, channelParams->m_K_factor / 10.0);
+        const double nlosScale = sqrt(1.0 / (kLinear + 1));
+        // the LOS path should be attenuated if blockage is enabled.
+        const double losScale = sqrt(kLinear / (1 + kLinear));
+        const double losAttenuation = pow(10, channelParams->m_attenuation_dB[0] / 10.0);
+
         for (size_t uIndex = 0; uIndex < uSize; uIndex++)
         {
-            Vector uLoc = uAntenna->GetElementLocation(uIndex);
+            const Vector& uLoc = uLocs[uIndex];
             double rxPhaseDiff = 2 * M_PI *
                                  (sinUAngleIncl * cosUAngleAz * uLoc.x +
                                   sinUAngleIncl * sinUAngleAz * uLoc.y + cosUAngleIncl * uLoc.z);
+            const std::complex<double> rxPhase(cos(rxPhaseDiff), sin(rxPhaseDiff));
+            auto [rxFieldPatternPhi, rxFieldPatternTheta] = rxFieldPatterns[uPols[uIndex]];
 
             for (size_t sIndex = 0; sIndex < sSize; sIndex++)
             {
-                Vector sLoc = sAntenna->GetElementLocation(sIndex);
-                std::complex<double> ray(0, 0);
-                double txPhaseDiff =
-                    2 * M_PI *
-                    (sinSAngleIncl * cosSAngleAz * sLoc.x + sinSAngleIncl * sinSAngleAz * sLoc.y +
-                     cosSAngleIncl * sLoc.z);
+                auto [txFieldPatternPhi, txFieldPatternTheta] = txFieldPatterns[sPols[sIndex]];
 
-                auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna->GetElementFieldPattern(
-                    Angles(uAngle.GetAzimuth(), uAngle.GetInclination()),
-                    uAntenna->GetElemPol(uIndex));
-                auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna->GetElementFieldPattern(
-                    Angles(sAngle.GetAzimuth(), sAngle.GetInclination()),
-                    sAntenna->GetElemPol(sIndex));
-
-                ray = (rxFieldPatternTheta * txFieldPatternTheta -
-                       rxFieldPatternPhi * txFieldPatternPhi) *
-                      phaseDiffDueToDistance *
-                      std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                      std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-
-                double kLinear = pow(10, channelParams->m_K_factor / 10.0);
-                // the LOS path should be attenuated if blockage is enabled.
-                hUsn(uIndex, sIndex, 0) =
-                    sqrt(1.0 / (kLinear + 1)) * hUsn(uIndex, sIndex, 0) +
-                    sqrt(kLinear / (1 + kLinear)) * ray /
-                        pow(10,
-                            channelParams->m_attenuation_dB[0] / 10.0); //(7.5-30) for tau = tau1
+                std::complex<double> ray = (rxFieldPatternTheta * txFieldPatternTheta -
+                                            rxFieldPatternPhi * txFieldPatternPhi) *
+                                           phaseDiffDueToDistance * rxPhase * txPhases[sIndex];
+
+                hUsn(uIndex, sIndex, 0) = nlosScale * hUsn(uIndex, sIndex, 0) +
+                                          losScale * ray / losAttenuation; //(7.5-30) for tau = tau1
                 for (size_t nIndex = 1; nIndex < hUsn.GetNumPages(); nIndex++)
                 {
-                    hUsn(uIndex, sIndex, nIndex) *=
-                        sqrt(1.0 / (kLinear + 1)); //(7.5-30) for tau = tau2...tauN
+                    hUsn(uIndex, sIndex, nIndex) *= nlosScale; //(7.5-30) for tau = tau2...tauN
                 }
             }
         }
@@ -21,6 +21,7 @@
 #ifndef THREE_GPP_CHANNEL_H
 #define THREE_GPP_CHANNEL_H
 
+#include "channel-cache.h"
 #include "matrix-based-channel-model.h"
 
 #include "ns3/angles.h"
@@ -31,6 +32,8 @@
 #include <complex.h>
 #include <unordered_map>
 
+class ThreeGppChannelReferenceTest;
+
 namespace ns3
 {
 
@@ -47,6 +50,8 @@ class MobilityModel;
  */
 class ThreeGppChannelModel : public MatrixBasedChannelModel
 {
+    friend class ::ThreeGppChannelReferenceTest;
+
   public:
     /**
      * Constructor
@@ -129,6 +134,80 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
      */
     Ptr<const ChannelParams> GetParams(Ptr<const MobilityModel> aMob,
                                        Ptr<const MobilityModel> bMob) const override;
+
+    /**
+     * Removes the channel params of the pairs of nodes including a node, and the
+     * channel matrices between the antennas of those pairs.
+     *
+     * \param nodeId the ID of the node
+     */
+    void RemoveNode(uint32_t nodeId) override;
+
+    /**
+     * Sets the maximum number of entries of the caches of the channel params and of
+     * the channel matrices. When a cache is full, its least recently used entry is
+     * evicted.
+     *
+     * \param maxEntries the maximum number of entries of each cache, 0 for no limit
+     */
+    void SetCacheMaxEntries(uint32_t maxEntries);
+
+    /**
+     * Returns the maximum number of entries of the caches
+     * \return the maximum number of entries of each cache, 0 for no limit
+     */
+    uint32_t GetCacheMaxEntries() const;
+
+    /**
+     * Sets the time after which the cached channel params and matrices that are not
+     * used are evicted
+     *
+     * \param idleTime the idle time, 0 to keep them until they are replaced
+     */
+    void SetCacheIdleTime(Time idleTime);
+
+    /**
+     * Returns the time after which the cached channels that are not used are evicted
+     * \return the idle time, 0 if they are kept until they are replaced
+     */
+    Time GetCacheIdleTime() const;
+
+    /**
+     * Returns the number of lookups of the channel params that found them in the cache
+     * \return the number of hits of the cache of the channel params
+     */
+    uint64_t GetParamsCacheHits() const;
+
+    /**
+     * Returns the number of lookups of the channel params that did not find them
+     * \return the number of misses of the cache of the channel params
+     */
+    uint64_t GetParamsCacheMisses() const;
+
+    /**
+     * Returns the number of channel params evicted from the cache
+     * \return the number of evictions of the cache of the channel params
+     */
+    uint64_t GetParamsCacheEvictions() const;
+
+    /**
+     * Returns the number of lookups of the channel matrices that found them in the cache
+     * \return the number of hits of the cache of the channel matrices
+     */
+    uint64_t GetMatrixCacheHits() const;
+
+    /**
+     * Returns the number of lookups of the channel matrices that did not find them
+     * \return the number of misses of the cache of the channel matrices
+     */
+    uint64_t GetMatrixCacheMisses() const;
+
+    /**
+     * Returns the number of channel matrices evicted from the cache
+     * \return the number of evictions of the cache of the channel matrices
+     */
+    uint64_t GetMatrixCacheEvictions() const;
+
     /**
      * \brief Assign a fixed random variable stream number to the random variables
      * used by this model.
@@ -364,14 +443,14 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
                              Ptr<const PhasedArrayModel> bAntenna,
                              Ptr<const ChannelMatrix> channelMatrix);
 
-    std::unordered_map<uint64_t, Ptr<ChannelMatrix>>
-        m_channelMatrixMap; //!< map containing the channel realizations per pair of
+    ChannelCache<Ptr<ChannelMatrix>>
+        m_channelMatrixMap; //!< cache containing the channel realizations per pair of
                             //!< PhasedAntennaArray instances, the key of this map is reciprocal
                             //!< uniquely identifies a pair of PhasedAntennaArrays
-    std::unordered_map<uint64_t, Ptr<ThreeGppChannelParams>>
-        m_channelParamsMap; //!< map containing the common channel parameters per pair of nodes, the
-                            //!< key of this map is reciprocal and uniquely identifies a pair of
-                            //!< nodes
+    ChannelCache<Ptr<ThreeGppChannelParams>>
+        m_channelParamsMap; //!< cache containing the common channel parameters per pair of nodes,
+                            //!< the key of this map is reciprocal and uniquely identifies a pair
+                            //!< of nodes
     Time m_updatePeriod;    //!< the channel update period
     double m_frequency;     //!< the operating frequency
     std::string m_scenario; //!< the 3GPP scenario
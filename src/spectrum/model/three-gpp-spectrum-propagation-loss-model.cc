@@ -24,6 +24,7 @@
 #include "spectrum-signal-parameters.h"
 #include "three-gpp-channel-model.h"
 
+#include "ns3/abort.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/net-device.h"
@@ -31,7 +32,10 @@
 #include "ns3/pointer.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <cstring>
 #include <map>
 
 namespace ns3
@@ -41,6 +45,34 @@ NS_LOG_COMPONENT_DEFINE("ThreeGppSpectrumPropagationLossModel");
 
 NS_OBJECT_ENSURE_REGISTERED(ThreeGppSpectrumPropagationLossModel);
 
+/**
+ * Computes the key of a pair of beamforming vectors in the cache of the long term
+ * components, as a FNV-1a hash of their elements
+ * \param sW the beamforming vector of the s node
+ * \param uW the beamforming vector of the u node
+ * \return the key of the pair of beamforming vectors
+ */
+static uint64_t
+GetBeamPairKey(const PhasedArrayModel::ComplexVector& sW,
+               const PhasedArrayModel::ComplexVector& uW)
+{
+    uint64_t key = 0xcbf29ce484222325ULL;
+    auto add = [&key](uint64_t value) { key = (key ^ value) * 0x100000001b3ULL; };
+    for (const auto w : {&sW, &uW})
+    {
+        add(w->GetSize());
+        for (size_t i = 0; i < w->GetSize(); ++i)
+        {
+            double parts[2] = {w->GetValues()[i].real(), w->GetValues()[i].imag()};
+            uint64_t bits[2];
+            std::memcpy(bits, parts, sizeof(bits));
+            add(bits[0]);
+            add(bits[1]);
+        }
+    }
+    return key;
+}
+
 ThreeGppSpectrumPropagationLossModel::ThreeGppSpectrumPropagationLossModel()
 {
     NS_LOG_FUNCTION(this);
@@ -54,7 +86,7 @@ ThreeGppSpectrumPropagationLossModel::~ThreeGppSpectrumPropagationLossModel()
 void
 ThreeGppSpectrumPropagationLossModel::DoDispose()
 {
-    m_longTermMap.clear();
+    m_longTermMap.Clear();
     m_channelModel->Dispose();
     m_channelModel = nullptr;
 }
@@ -73,7 +105,58 @@ ThreeGppSpectrumPropagationLossModel::GetTypeId()
                 StringValue("ns3::ThreeGppChannelModel"),
                 MakePointerAccessor(&ThreeGppSpectrumPropagationLossModel::SetChannelModel,
                                     &ThreeGppSpectrumPropagationLossModel::GetChannelModel),
-                MakePointerChecker<MatrixBasedChannelModel>());
+                MakePointerChecker<MatrixBasedChannelModel>())
+            .AddAttribute("CacheMaxEntries",
+                          "Maximum number of long term components kept in memory. The least "
+                          "recently used ones are evicted and computed again if needed. 0 means "
+                          "no limit.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(
+                              &ThreeGppSpectrumPropagationLossModel::SetCacheMaxEntries,
+                              &ThreeGppSpectrumPropagationLossModel::GetCacheMaxEntries),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("CacheIdleTime",
+                          "Time after which the long term components that are not used are "
+                          "evicted from memory. 0 means that they are kept until they are "
+                          "replaced.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&ThreeGppSpectrumPropagationLossModel::SetCacheIdleTime,
+                                           &ThreeGppSpectrumPropagationLossModel::GetCacheIdleTime),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("MaxBeamPairs",
+                          "Maximum number of pairs of beamforming vectors whose long term "
+                          "components are kept for each pair of antenna arrays, until the "
+                          "channel is updated. Values larger than 1 avoid computing them again "
+                          "when the beams are swept over a codebook, e.g., by a beam search, "
+                          "or switched back.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(
+                              &ThreeGppSpectrumPropagationLossModel::SetMaxBeamPairs,
+                              &ThreeGppSpectrumPropagationLossModel::GetMaxBeamPairs),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute(
+                "LongTermCacheHits",
+                "Number of lookups of the long term components that found them in memory",
+                TypeId::ATTR_GET,
+                UintegerValue(0),
+                MakeUintegerAccessor(&ThreeGppSpectrumPropagationLossModel::GetLongTermCacheHits),
+                MakeUintegerChecker<uint64_t>())
+            .AddAttribute(
+                "LongTermCacheMisses",
+                "Number of lookups of the long term components that did not find them",
+                TypeId::ATTR_GET,
+                UintegerValue(0),
+                MakeUintegerAccessor(
+                    &ThreeGppSpectrumPropagationLossModel::GetLongTermCacheMisses),
+                MakeUintegerChecker<uint64_t>())
+            .AddAttribute(
+                "LongTermCacheEvictions",
+                "Number of long term components evicted from memory",
+                TypeId::ATTR_GET,
+                UintegerValue(0),
+                MakeUintegerAccessor(
+                    &ThreeGppSpectrumPropagationLossModel::GetLongTermCacheEvictions),
+                MakeUintegerChecker<uint64_t>());
     return tid;
 }
 
@@ -89,9 +172,86 @@ ThreeGppSpectrumPropagationLossModel::GetChannelModel() const
     return m_channelModel;
 }
 
+void
+ThreeGppSpectrumPropagationLossModel::RemoveNode(uint32_t nodeId)
+{
+    NS_LOG_FUNCTION(this << nodeId);
+    m_longTermMap.Erase([nodeId](Ptr<const LongTermBeams> longTerms) {
+        return longTerms->m_channel->m_nodeIds.first == nodeId ||
+               longTerms->m_channel->m_nodeIds.second == nodeId;
+    });
+    m_channelModel->RemoveNode(nodeId);
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::SetCacheMaxEntries(uint32_t maxEntries)
+{
+    NS_LOG_FUNCTION(this << maxEntries);
+    m_longTermMap.SetMaxSize(maxEntries);
+}
+
+uint32_t
+ThreeGppSpectrumPropagationLossModel::GetCacheMaxEntries() const
+{
+    return m_longTermMap.GetMaxSize();
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::SetCacheIdleTime(Time idleTime)
+{
+    NS_LOG_FUNCTION(this << idleTime);
+    m_longTermMap.SetIdleTime(idleTime);
+}
+
+Time
+ThreeGppSpectrumPropagationLossModel::GetCacheIdleTime() const
+{
+    return m_longTermMap.GetIdleTime();
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::SetMaxBeamPairs(uint32_t maxBeamPairs)
+{
+    NS_LOG_FUNCTION(this << maxBeamPairs);
+    NS_ABORT_MSG_IF(maxBeamPairs == 0, "At least one pair of beams must be kept");
+    m_maxBeamPairs = maxBeamPairs;
+}
+
+uint32_t
+ThreeGppSpectrumPropagationLossModel::GetMaxBeamPairs() const
+{
+    return m_maxBeamPairs;
+}
+
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheHits() const
+{
+    return m_longTermMap.GetHits();
+}
+
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheMisses() const
+{
+    return m_longTermMap.GetMisses();
+}
+
+uint64_t
+ThreeGppSpectrumPropagationLossModel::GetLongTermCacheEvictions() const
+{
+    return m_longTermMap.GetEvictions();
+}
+
 double
 ThreeGppSpectrumPropagationLossModel::GetFrequency() const
 {
+    // read the 3GPP channel model directly rather than through the attribute system, which
+    // copies the shared accessors and may not be used by several threads
+    const auto threeGppChannelModel =
+        dynamic_cast<const ThreeGppChannelModel*>(PeekPointer(m_channelModel));
+    if (threeGppChannelModel)
+    {
+        return threeGppChannelModel->GetFrequency();
+    }
     DoubleValue freq;
     m_channelModel->GetAttribute("Frequency", freq);
     return freq.Get();
@@ -220,12 +380,40 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
 {
     NS_LOG_FUNCTION(this);
     Ptr<SpectrumSignalParameters> rxParams = params->Copy();
+    ApplyBeamformingGain(rxParams,
+                         longTerm,
+                         channelMatrix,
+                         channelParams,
+                         sSpeed,
+                         uSpeed,
+                         numTxPorts,
+                         numRxPorts,
+                         isReverse,
+                         Simulator::Now().GetSeconds(),
+                         GetFrequency());
+    return rxParams;
+}
+
+void
+ThreeGppSpectrumPropagationLossModel::ApplyBeamformingGain(
+    Ptr<SpectrumSignalParameters> rxParams,
+    Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+    const Vector& sSpeed,
+    const Vector& uSpeed,
+    uint8_t numTxPorts,
+    uint8_t numRxPorts,
+    bool isReverse,
+    double slotTime,
+    double frequency) const
+{
+    NS_LOG_FUNCTION(this);
     size_t numCluster = channelMatrix->m_channel.GetNumPages();
     // compute the doppler term
     // NOTE the update of Doppler is simplified by only taking the center angle of
     // each cluster in to consideration.
-    double slotTime = Simulator::Now().GetSeconds();
-    double factor = 2 * M_PI * slotTime * GetFrequency() / 3e8;
+    double factor = 2 * M_PI * slotTime * frequency / 3e8;
     PhasedArrayModel::ComplexVector doppler(numCluster);
 
     // Make sure that all the structures that are passed to this function
@@ -311,31 +499,42 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     {
         NS_ASSERT_MSG(rxParams->psd->GetValuesN() == rxParams->spectrumChannelMatrix->GetNumPages(),
                       "RX PSD and the spectrum channel matrix should have the same number of RBs ");
+        const auto& chanSpct = *rxParams->spectrumChannelMatrix;
+        const auto& precMat = *rxParams->precodingMatrix;
+        NS_ASSERT_MSG(precMat.GetNumPages() == chanSpct.GetNumPages() &&
+                          precMat.GetNumRows() == chanSpct.GetNumCols(),
+                      "The precoding matrix does not match the spectrum channel matrix");
         // Calculate RX PSD from the spectrum channel matrix, H and
-        // the precoding matrix, P as:
+        // the precoding matrix, P as the trace of:
         // PSD = (H*P)^h * (H*P),
         // where the dimensions are:
         // H (rxPorts,txPorts,numRbs) x P (txPorts,txStreams, numRbs) =
         // HxP (rxPorts,txStreams, numRbs)
-        MatrixBasedChannelModel::Complex3DVector hP =
-            *rxParams->spectrumChannelMatrix * (*rxParams->precodingMatrix);
-        // (HxP)^h dimensions are (txStreams, rxPorts, numRbs)
-        MatrixBasedChannelModel::Complex3DVector hPHerm = hP.HermitianTranspose();
-
-        // Finally, (HxP)^h x (HxP) = PSD (txStreams, txStreams, numRbs)
-        MatrixBasedChannelModel::Complex3DVector psd = hPHerm * hP;
-        // Update rxParams->Psd
+        // The trace is the sum of the norms of the elements of HxP, so that neither HxP nor
+        // the product with its Hermitian transpose are stored.
+        auto numRxPorts = chanSpct.GetNumRows();
+        auto numTxPorts = chanSpct.GetNumCols();
+        auto numStreams = precMat.GetNumCols();
         for (uint32_t rbIdx = 0; rbIdx < rxParams->psd->GetValuesN(); ++rbIdx)
         {
-            (*rxParams->psd)[rbIdx] = 0.0;
-
-            for (size_t txStream = 0; txStream < psd.GetNumRows(); ++txStream)
+            const auto* h = chanSpct.GetPagePtr(rbIdx);
+            const auto* p = precMat.GetPagePtr(rbIdx);
+            double rbPsd = 0.0;
+            for (size_t txStream = 0; txStream < numStreams; ++txStream)
             {
-                (*rxParams->psd)[rbIdx] += std::real(psd(txStream, txStream, rbIdx));
+                for (size_t rxPort = 0; rxPort < numRxPorts; ++rxPort)
+                {
+                    std::complex<double> hp = 0.0;
+                    for (size_t txPort = 0; txPort < numTxPorts; ++txPort)
+                    {
+                        hp += h[rxPort + numRxPorts * txPort] * p[txPort + numTxPorts * txStream];
+                    }
+                    rbPsd += std::norm(hp);
+                }
             }
+            (*rxParams->psd)[rbIdx] = rbPsd;
         }
     }
-    return rxParams;
 }
 
 Ptr<MatrixBasedChannelModel::Complex3DVector>
@@ -344,7 +543,7 @@ ThreeGppSpectrumPropagationLossModel::GenSpectrumChannelMatrix(
     Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
     Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
-    PhasedArrayModel::ComplexVector doppler,
+    const PhasedArrayModel::ComplexVector& doppler,
     uint8_t numTxPorts,
     uint8_t numRxPorts,
     bool isReverse) const
@@ -352,8 +551,6 @@ ThreeGppSpectrumPropagationLossModel::GenSpectrumChannelMatrix(
     size_t numCluster = channelMatrix->m_channel.GetNumPages();
     auto numRb = inPsd->GetValuesN();
 
-    auto directionalLongTerm = isReverse ? longTerm->Transpose() : (*longTerm);
-
     Ptr<MatrixBasedChannelModel::Complex3DVector> chanSpct =
         Create<MatrixBasedChannelModel::Complex3DVector>(numRxPorts, numTxPorts, (uint16_t)numRb);
 
@@ -368,64 +565,101 @@ ThreeGppSpectrumPropagationLossModel::GenSpectrumChannelMatrix(
     {
         channelParams->m_cachedRbWidth = rbWidth;
         channelParams->m_cachedDelaySincos = ComplexMatrixArray(numRb, numCluster);
-        auto sbit = inPsd->ConstBandsBegin(); // band iterator
-        for (unsigned i = 0; i < numRb; i++)
-        {
-            double fsb = (*sbit).fc; // center frequency of the sub-band
-            for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
-            {
-                double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
-                channelParams->m_cachedDelaySincos(i, cIndex) =
-                    std::complex<double>(cos(delay), sin(delay));
-            }
-            sbit++;
-        }
-    }
-
-    // Compute the product between the doppler and the delay sincos
-    auto delaySincosCopy = channelParams->m_cachedDelaySincos;
-    for (size_t iRb = 0; iRb < inPsd->GetValuesN(); iRb++)
-    {
-        for (std::size_t cIndex = 0; cIndex < numCluster; cIndex++)
-        {
-            delaySincosCopy(iRb, cIndex) *= doppler[cIndex];
-        }
+        CalcDelaySincos(inPsd, channelParams, numCluster);
     }
+    const auto& delaySincos = channelParams->m_cachedDelaySincos;
 
     // If "params" (ChannelMatrix) and longTerm were computed for the reverse direction (e.g. this
     // is a DL transmission but params and longTerm were last updated during UL), then the elements
-    // in longTerm start from different offsets.
-
-    auto vit = inPsd->ValuesBegin(); // psd iterator
-    size_t iRb = 0;
-    // Compute the frequency-domain channel matrix
-    while (vit != inPsd->ValuesEnd())
+    // in longTerm start from different offsets, i.e., it is accessed transposed.
+
+    // Compute the frequency-domain channel matrix, one port pair at a time: the doppler is
+    // applied to the long term of each cluster, and the delay sincos of each cluster, which are
+    // contiguous over the RBs, are accumulated for all the RBs at once. The real and imaginary
+    // parts are accumulated separately, so that the loops over the RBs are vectorized.
+    std::vector<double> gainReal(numRb);
+    std::vector<double> gainImag(numRb);
+    for (auto rxPortIdx = 0; rxPortIdx < numRxPorts; rxPortIdx++)
     {
-        if ((*vit) != 0.00)
+        for (auto txPortIdx = 0; txPortIdx < numTxPorts; txPortIdx++)
         {
-            auto sqrtVit = sqrt(*vit);
-            for (auto rxPortIdx = 0; rxPortIdx < numRxPorts; rxPortIdx++)
+            std::fill(gainReal.begin(), gainReal.end(), 0.0);
+            std::fill(gainImag.begin(), gainImag.end(), 0.0);
+            for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
             {
-                for (auto txPortIdx = 0; txPortIdx < numTxPorts; txPortIdx++)
+                auto clusterGain = (isReverse ? (*longTerm)(txPortIdx, rxPortIdx, cIndex)
+                                              : (*longTerm)(rxPortIdx, txPortIdx, cIndex)) *
+                                   doppler[cIndex];
+                double gr = clusterGain.real();
+                double gi = clusterGain.imag();
+                const auto* sincos = delaySincos.GetPagePtr(0) + numRb * cIndex;
+                for (size_t iRb = 0; iRb < numRb; iRb++)
+                {
+                    double sr = sincos[iRb].real();
+                    double si = sincos[iRb].imag();
+                    gainReal[iRb] += gr * sr - gi * si;
+                    gainImag[iRb] += gr * si + gi * sr;
+                }
+            }
+            for (size_t iRb = 0; iRb < numRb; iRb++)
+            {
+                auto psd = (*inPsd)[iRb];
+                if (psd != 0.00)
                 {
-                    std::complex<double> subsbandGain(0.0, 0.0);
-                    for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
-                    {
-                        subsbandGain += directionalLongTerm(rxPortIdx, txPortIdx, cIndex) *
-                                        delaySincosCopy(iRb, cIndex);
-                    }
                     // Multiply with the square root of the input PSD so that the norm (absolute
                     // value squared) of chanSpct will be the output PSD
-                    chanSpct->Elem(rxPortIdx, txPortIdx, iRb) = sqrtVit * subsbandGain;
+                    auto sqrtVit = std::sqrt(psd);
+                    chanSpct->Elem(rxPortIdx, txPortIdx, iRb) =
+                        std::complex<double>(sqrtVit * gainReal[iRb], sqrtVit * gainImag[iRb]);
                 }
             }
         }
-        vit++;
-        iRb++;
     }
     return chanSpct;
 }
 
+void
+ThreeGppSpectrumPropagationLossModel::CalcDelaySincos(
+    Ptr<const SpectrumValue> inPsd,
+    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+    size_t numCluster)
+{
+    auto numRb = inPsd->GetValuesN();
+    auto& delaySincos = channelParams->m_cachedDelaySincos;
+
+    // The center frequencies of the RBs are usually evenly spaced: the sincos of each cluster
+    // are then a geometric progression over the RBs, computed by a complex multiplication per RB
+    // rather than a cos and a sin. They are computed exactly every DELAY_SINCOS_ANCHOR RBs, and
+    // wherever the spacing changes, so that the rounding errors do not accumulate.
+    std::vector<double> fsb; // center frequencies of the sub-bands
+    fsb.reserve(numRb);
+    for (auto sbit = inPsd->ConstBandsBegin(); sbit != inPsd->ConstBandsEnd(); sbit++)
+    {
+        fsb.push_back(sbit->fc);
+    }
+    double spacing = (numRb > 1) ? (fsb[1] - fsb[0]) : 0.0;
+
+    for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        double delay = channelParams->m_delay[cIndex];
+        auto step = std::polar(1.0, -2 * M_PI * spacing * delay);
+        auto* sincos = delaySincos.GetPagePtr(0) + numRb * cIndex;
+        for (size_t iRb = 0; iRb < numRb; iRb++)
+        {
+            if ((iRb % DELAY_SINCOS_ANCHOR != 0) &&
+                std::abs(fsb[iRb] - fsb[iRb - 1] - spacing) <= 1e-9 * std::abs(spacing))
+            {
+                sincos[iRb] = sincos[iRb - 1] * step;
+            }
+            else
+            {
+                double phase = -2 * M_PI * fsb[iRb] * delay;
+                sincos[iRb] = std::complex<double>(cos(phase), sin(phase));
+            }
+        }
+    }
+}
+
 Ptr<const MatrixBasedChannelModel::Complex3DVector>
 ThreeGppSpectrumPropagationLossModel::GetLongTerm(
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
@@ -455,48 +689,63 @@ ThreeGppSpectrumPropagationLossModel::GetLongTerm(
         uW = aPhasedArrayModel->GetBeamformingVector();
     }
 
-    bool update = false;   // indicates whether the long term has to be updated
-    bool notFound = false; // indicates if the long term has not been computed yet
-
     // compute the long term key, the key is unique for each tx-rx pair
     uint64_t longTermId =
         MatrixBasedChannelModel::GetKey(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId());
 
-    // look for the long term in the map and check if it is valid
-    if (m_longTermMap.find(longTermId) != m_longTermMap.end())
+    // look for the long terms of the tx-rx pair in the map
+    Ptr<LongTermBeams> longTerms;
+    if (auto cached = m_longTermMap.Find(longTermId))
     {
-        NS_LOG_DEBUG("found the long term component in the map");
-        longTerm = m_longTermMap[longTermId]->m_longTerm;
-
-        // check if the channel matrix has been updated
-        // or the s beam has been changed
-        // or the u beam has been changed
-        update = (m_longTermMap[longTermId]->m_channel->m_generatedTime !=
-                      channelMatrix->m_generatedTime ||
-                  m_longTermMap[longTermId]->m_sW != sW || m_longTermMap[longTermId]->m_uW != uW);
+        NS_LOG_DEBUG("found the long term components in the map");
+        longTerms = *cached;
+
+        // check if the channel matrix has been updated, possibly after an eviction: the
+        // long terms of all the pairs of beams are outdated
+        if (longTerms->m_channel != channelMatrix ||
+            longTerms->m_channel->m_generatedTime != channelMatrix->m_generatedTime)
+        {
+            longTerms->m_channel = channelMatrix;
+            longTerms->m_longTerms.Clear();
+        }
     }
     else
     {
-        NS_LOG_DEBUG("long term component NOT found");
-        notFound = true;
+        NS_LOG_DEBUG("long term components NOT found");
+        longTerms = Create<LongTermBeams>();
+        longTerms->m_channel = channelMatrix;
+        m_longTermMap.Insert(longTermId, longTerms);
+    }
+    if (longTerms->m_longTerms.GetMaxSize() != m_maxBeamPairs)
+    {
+        longTerms->m_longTerms.SetMaxSize(m_maxBeamPairs);
     }
 
-    if (update || notFound)
+    // look for the long term of the pair of beams; the beamforming vectors are compared
+    // as well, in case of a collision of the keys
+    uint64_t beamPairKey = GetBeamPairKey(sW, uW);
+    if (auto cached = longTerms->m_longTerms.Find(beamPairKey))
     {
-        NS_LOG_DEBUG("compute the long term");
-        // compute the long term component
-        longTerm = CalcLongTerm(channelMatrix, sAntenna, uAntenna);
-        Ptr<LongTerm> longTermItem = Create<LongTerm>();
-        longTermItem->m_longTerm = longTerm;
-        longTermItem->m_channel = channelMatrix;
-        longTermItem->m_sW = std::move(sW);
-        longTermItem->m_uW = std::move(uW);
-        // store the long term to reduce computation load
-        // only the small scale fading needs to be updated if the large scale parameters and antenna
-        // weights remain unchanged.
-        m_longTermMap[longTermId] = longTermItem;
+        if ((*cached)->m_sW == sW && (*cached)->m_uW == uW)
+        {
+            NS_LOG_DEBUG("found the long term component of the beams");
+            return (*cached)->m_longTerm;
+        }
     }
 
+    NS_LOG_DEBUG("compute the long term");
+    // compute the long term component
+    longTerm = CalcLongTerm(channelMatrix, sAntenna, uAntenna);
+    Ptr<LongTerm> longTermItem = Create<LongTerm>();
+    longTermItem->m_longTerm = longTerm;
+    longTermItem->m_channel = channelMatrix;
+    longTermItem->m_sW = std::move(sW);
+    longTermItem->m_uW = std::move(uW);
+    // store the long term to reduce computation load
+    // only the small scale fading needs to be updated if the large scale parameters and antenna
+    // weights remain unchanged.
+    longTerms->m_longTerms.Insert(beamPairKey, longTermItem);
+
     return longTerm;
 }
 
@@ -542,6 +791,61 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity(
                                isReverse);
 }
 
+Ptr<SpectrumSignalParameters>
+ThreeGppSpectrumPropagationLossModel::DoPrepareRxPowerSpectralDensity(
+    Ptr<const SpectrumSignalParameters> spectrumSignalParams,
+    Ptr<const MobilityModel> a,
+    Ptr<const MobilityModel> b,
+    Ptr<const PhasedArrayModel> aPhasedArrayModel,
+    Ptr<const PhasedArrayModel> bPhasedArrayModel,
+    DeferredCalculation& deferred) const
+{
+    NS_LOG_FUNCTION(this << spectrumSignalParams << a << b << aPhasedArrayModel
+                         << bPhasedArrayModel);
+    NS_ASSERT_MSG(aPhasedArrayModel && bPhasedArrayModel, "Antenna not found");
+
+    // same as DoCalcRxPowerSpectralDensity, up to the beamforming gain
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix =
+        m_channelModel->GetChannel(a, b, aPhasedArrayModel, bPhasedArrayModel);
+    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams =
+        m_channelModel->GetParams(a, b);
+    Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm =
+        GetLongTerm(channelMatrix, aPhasedArrayModel, bPhasedArrayModel);
+    auto isReverse =
+        channelMatrix->IsReverse(aPhasedArrayModel->GetId(), bPhasedArrayModel->GetId());
+
+    Ptr<SpectrumSignalParameters> rxParams = spectrumSignalParams->Copy();
+    // the channel matrix of the TX parameters, if any, may be shared with other receivers:
+    // release it here rather than in the deferred calculation, which overwrites it
+    rxParams->spectrumChannelMatrix = nullptr;
+
+    deferred = [this,
+                rxParams,
+                longTerm,
+                channelMatrix,
+                channelParams,
+                sSpeed = a->GetVelocity(),
+                uSpeed = b->GetVelocity(),
+                numTxPorts = aPhasedArrayModel->GetNumPorts(),
+                numRxPorts = bPhasedArrayModel->GetNumPorts(),
+                isReverse,
+                slotTime = Simulator::Now().GetSeconds(),
+                frequency = GetFrequency()]() {
+        ApplyBeamformingGain(rxParams,
+                             longTerm,
+                             channelMatrix,
+                             channelParams,
+                             sSpeed,
+                             uSpeed,
+                             numTxPorts,
+                             numRxPorts,
+                             isReverse,
+                             slotTime,
+                             frequency);
+    };
+    return rxParams;
+}
+
 int64_t
 ThreeGppSpectrumPropagationLossModel::DoAssignStreams(int64_t stream)
 {
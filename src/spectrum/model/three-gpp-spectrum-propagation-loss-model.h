@@ -21,6 +21,7 @@
 #ifndef THREE_GPP_SPECTRUM_PROPAGATION_LOSS_H
 #define THREE_GPP_SPECTRUM_PROPAGATION_LOSS_H
 
+#include "channel-cache.h"
 #include "matrix-based-channel-model.h"
 #include "phased-array-spectrum-propagation-loss-model.h"
 
@@ -31,7 +32,9 @@
 #include <unordered_map>
 
 class ThreeGppCalcLongTermMultiPortTest;
+class ThreeGppLongTermBeamCacheTest;
 class ThreeGppMimoPolarizationTest;
+class ThreeGppSpectrumChannelMatrixTest;
 
 namespace ns3
 {
@@ -55,7 +58,9 @@ class NetDevice;
 class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagationLossModel
 {
     friend class ::ThreeGppCalcLongTermMultiPortTest;
+    friend class ::ThreeGppLongTermBeamCacheTest;
     friend class ::ThreeGppMimoPolarizationTest;
+    friend class ::ThreeGppSpectrumChannelMatrixTest;
 
   public:
     /**
@@ -104,6 +109,73 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
      */
     void GetChannelModelAttribute(const std::string& name, AttributeValue& value) const;
 
+    /**
+     * Removes the long term components of the channels of a node, and the channels of
+     * the node in the associated MatrixBasedChannelModel instance
+     * \param nodeId the ID of the node
+     */
+    void RemoveNode(uint32_t nodeId);
+
+    /**
+     * Sets the maximum number of long term components kept in the cache. When the cache
+     * is full, its least recently used entry is evicted.
+     * \param maxEntries the maximum number of entries, 0 for no limit
+     */
+    void SetCacheMaxEntries(uint32_t maxEntries);
+
+    /**
+     * Returns the maximum number of long term components kept in the cache
+     * \return the maximum number of entries, 0 for no limit
+     */
+    uint32_t GetCacheMaxEntries() const;
+
+    /**
+     * Sets the time after which the cached long term components that are not used are
+     * evicted
+     * \param idleTime the idle time, 0 to keep them until they are replaced
+     */
+    void SetCacheIdleTime(Time idleTime);
+
+    /**
+     * Returns the time after which the cached long term components that are not used
+     * are evicted
+     * \return the idle time, 0 if they are kept until they are replaced
+     */
+    Time GetCacheIdleTime() const;
+
+    /**
+     * Sets the maximum number of pairs of beamforming vectors whose long term components
+     * are kept for each pair of antenna arrays. When the maximum is reached, the long
+     * term component of the least recently used pair of beamforming vectors is evicted.
+     * \param maxBeamPairs the maximum number of pairs of beamforming vectors, at least 1
+     */
+    void SetMaxBeamPairs(uint32_t maxBeamPairs);
+
+    /**
+     * Returns the maximum number of pairs of beamforming vectors whose long term
+     * components are kept for each pair of antenna arrays
+     * \return the maximum number of pairs of beamforming vectors
+     */
+    uint32_t GetMaxBeamPairs() const;
+
+    /**
+     * Returns the number of lookups of the long term components that found them
+     * \return the number of hits of the cache of the long term components
+     */
+    uint64_t GetLongTermCacheHits() const;
+
+    /**
+     * Returns the number of lookups of the long term components that did not find them
+     * \return the number of misses of the cache of the long term components
+     */
+    uint64_t GetLongTermCacheMisses() const;
+
+    /**
+     * Returns the number of long term components evicted from the cache
+     * \return the number of evictions of the cache of the long term components
+     */
+    uint64_t GetLongTermCacheEvictions() const;
+
     /**
      * \brief Computes the received PSD.
      *
@@ -116,7 +188,10 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
      * the propagation delay.
      * To reduce the computational load, the long term component associated with
      * a certain channel is cached and recomputed only when the channel realization
-     * is updated, or when the beamforming vectors change.
+     * is updated, or when the beamforming vectors change. The long term components
+     * of up to MaxBeamPairs pairs of beamforming vectors are kept per channel, so
+     * that a beam sweep over a codebook, or a switch back to a previous beam, does not
+     * recompute them.
      *
      * \param spectrumSignalParams spectrum signal tx parameters
      * \param a first node mobility model
@@ -133,6 +208,29 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
         Ptr<const PhasedArrayModel> bPhasedArrayModel) const override;
 
   protected:
+    /**
+     * \brief Splits DoCalcRxPowerSpectralDensity in two parts.
+     *
+     * Retrieves the channel matrix and the long term component, and copies the
+     * parameters; the deferred calculation applies the Doppler and the beamforming gain,
+     * i.e., computes the spectrum channel matrix and the received PSD.
+     *
+     * \param spectrumSignalParams spectrum signal tx parameters
+     * \param a first node mobility model
+     * \param b second node mobility model
+     * \param aPhasedArrayModel the antenna array of the first node
+     * \param bPhasedArrayModel the antenna array of the second node
+     * \param deferred the calculation of the beamforming gain
+     * \return the parameters that will hold the received PSD
+     */
+    Ptr<SpectrumSignalParameters> DoPrepareRxPowerSpectralDensity(
+        Ptr<const SpectrumSignalParameters> spectrumSignalParams,
+        Ptr<const MobilityModel> a,
+        Ptr<const MobilityModel> b,
+        Ptr<const PhasedArrayModel> aPhasedArrayModel,
+        Ptr<const PhasedArrayModel> bPhasedArrayModel,
+        DeferredCalculation& deferred) const override;
+
     /**
      * Data structure that stores the long term component for a tx-rx pair
      */
@@ -148,6 +246,18 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
             m_uW; //!< the beamforming vector for the node u used to compute the long term
     };
 
+    /**
+     * Data structure that stores the long term components of a tx-rx pair computed with
+     * the same channel matrix, for the pairs of beamforming vectors in use
+     */
+    struct LongTermBeams : public SimpleRefCount<LongTermBeams>
+    {
+        Ptr<const MatrixBasedChannelModel::ChannelMatrix>
+            m_channel; //!< pointer to the channel matrix used to compute the long terms
+        ChannelCache<Ptr<const LongTerm>>
+            m_longTerms; //!< the long terms, per hash of the pair of beamforming vectors
+    };
+
     /**
      * Computes the frequency-domain channel matrix with the dimensions numRxPorts*numTxPorts*numRBs
      * \param inPsd the input PSD
@@ -165,11 +275,26 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
         Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
         Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
         Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
-        PhasedArrayModel::ComplexVector doppler,
+        const PhasedArrayModel::ComplexVector& doppler,
         uint8_t numTxPorts,
         uint8_t numRxPorts,
         bool isReverse) const;
 
+    /**
+     * Computes the delay sincos of each RB and cluster, exp(-j*2*pi*fc*delay), in the
+     * cache of the channel parameters, which must already have the dimensions
+     * numRBs * numCluster
+     * \param inPsd the input PSD, with the center frequencies of the RBs
+     * \param channelParams the channel parameters, including delays
+     * \param numCluster the number of clusters
+     */
+    static void CalcDelaySincos(Ptr<const SpectrumValue> inPsd,
+                                Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                                size_t numCluster);
+
+    /// Number of RBs after which the delay sincos are computed exactly rather than by recurrence
+    static constexpr size_t DELAY_SINCOS_ANCHOR = 32;
+
     /**
      * Get the operating frequency
      * \return the operating frequency in Hz
@@ -177,8 +302,9 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
     double GetFrequency() const;
 
     /**
-     * Looks for the long term component in m_longTermMap. If found, checks
-     * whether it has to be updated. If not found or if it has to be updated,
+     * Looks for the long term components of the tx-rx pair in m_longTermMap, and
+     * drops them if the channel matrix has been updated. Then, looks for the long
+     * term component of the pair of beamforming vectors in use. If not found,
      * calls the method CalcLongTerm to compute it.
      * \param channelMatrix the channel matrix
      * \param aPhasedArrayModel the antenna array of the tx device
@@ -244,10 +370,43 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
         uint8_t numRxPorts,
         bool isReverse) const;
 
+    /**
+     * \brief Computes the beamforming gain and applies it to a copy of the TX parameters
+     *
+     * Does not depend on the state of the simulation, so that it can be called
+     * concurrently for different pairs of nodes.
+     *
+     * \param rxParams copy of the TX parameters, where the spectrum channel matrix and the
+     *        RX PSD are set
+     * \param longTerm the long term component
+     * \param channelMatrix the channel matrix structure
+     * \param channelParams the channel params structure
+     * \param sSpeed the speed of the first node
+     * \param uSpeed the speed of the second node
+     * \param numTxPorts the number of the ports of the first node
+     * \param numRxPorts the number of the porst of the second node
+     * \param isReverse indicator that tells whether the channel matrix is reverse
+     * \param slotTime the time (s) at which the Doppler is computed
+     * \param frequency the center frequency (Hz) of the channel
+     */
+    void ApplyBeamformingGain(Ptr<SpectrumSignalParameters> rxParams,
+                              Ptr<const MatrixBasedChannelModel::Complex3DVector> longTerm,
+                              Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
+                              Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                              const Vector& sSpeed,
+                              const Vector& uSpeed,
+                              uint8_t numTxPorts,
+                              uint8_t numRxPorts,
+                              bool isReverse,
+                              double slotTime,
+                              double frequency) const;
+
     int64_t DoAssignStreams(int64_t stream) override;
 
-    mutable std::unordered_map<uint64_t, Ptr<const LongTerm>>
-        m_longTermMap;                           //!< map containing the long term components
+    mutable ChannelCache<Ptr<LongTermBeams>>
+        m_longTermMap;                           //!< cache containing the long term components
+    uint32_t m_maxBeamPairs{1};                  //!< the maximum number of pairs of beams per
+                                                 //!< tx-rx pair in m_longTermMap
     Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
 };
 } // namespace ns3
@@ -0,0 +1,388 @@
+/*
+ * Copyright (c) 2024 Seoul National University (SNU)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/constant-velocity-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/net-device.h>
+#include <ns3/range-spectrum-transmit-filter.h>
+#include <ns3/simulator.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/test.h>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup spectrum-tests
+ * RangeSpectrumTransmitFilter test suite
+ */
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief SpectrumPhy recording the receptions
+ */
+class RangeFilterTestPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * Constructor
+     * \param rxSpectrumModel the spectrum model of the receptions
+     */
+    RangeFilterTestPhy(Ptr<const SpectrumModel> rxSpectrumModel)
+        : m_rxSpectrumModel(rxSpectrumModel)
+    {
+    }
+
+    void SetDevice(Ptr<NetDevice> d) override
+    {
+    }
+
+    Ptr<NetDevice> GetDevice() const override
+    {
+        return nullptr;
+    }
+
+    void SetMobility(Ptr<MobilityModel> m) override
+    {
+        m_mobility = m;
+    }
+
+    Ptr<MobilityModel> GetMobility() const override
+    {
+        return m_mobility;
+    }
+
+    void SetChannel(Ptr<SpectrumChannel> c) override
+    {
+    }
+
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override
+    {
+        return m_rxSpectrumModel;
+    }
+
+    Ptr<Object> GetAntenna() const override
+    {
+        return nullptr;
+    }
+
+    void StartRx(Ptr<SpectrumSignalParameters> params) override
+    {
+        ++m_receptions;
+    }
+
+    uint32_t m_receptions{0}; //!< Number of receptions
+
+  private:
+    Ptr<const SpectrumModel> m_rxSpectrumModel; //!< the spectrum model of the receptions
+    Ptr<MobilityModel> m_mobility;              //!< the mobility model
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Check that a MultiModelSpectrumChannel with a RangeSpectrumTransmitFilter passes
+ * a transmission to the receivers in range, and only to them, for static receivers,
+ * moving receivers, and receivers moved from a cell of the grid to another one.
+ */
+class RangeSpectrumTransmitFilterTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param maxRange the MaxRange attribute of the filter
+     * \param minRxPowerDbm the MinRxPower attribute of the filter
+     * \param cellSize the GridCellSize attribute of the filter
+     */
+    RangeSpectrumTransmitFilterTestCase(double maxRange, double minRxPowerDbm, double cellSize);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Build the name of the test case
+     * \param maxRange the MaxRange attribute of the filter
+     * \param minRxPowerDbm the MinRxPower attribute of the filter
+     * \param cellSize the GridCellSize attribute of the filter
+     * \return the name of the test case
+     */
+    static std::string Name(double maxRange, double minRxPowerDbm, double cellSize);
+
+    /**
+     * Transmit a signal from a position and check the receivers reached
+     * \param position the position of the transmitter
+     */
+    void Transmit(Vector position);
+
+    /**
+     * Check the receivers reached by the last transmission
+     */
+    void CheckReceptions();
+
+    double m_maxRange;      //!< MaxRange of the filter
+    double m_minRxPowerDbm; //!< MinRxPower of the filter
+    double m_cellSize;      //!< GridCellSize of the filter
+
+    Ptr<MultiModelSpectrumChannel> m_channel;      //!< The channel
+    Ptr<RangeSpectrumTransmitFilter> m_filter;     //!< The filter
+    Ptr<SpectrumModel> m_model;                    //!< The spectrum model
+    Ptr<RangeFilterTestPhy> m_txPhy;               //!< The transmitter
+    std::vector<Ptr<RangeFilterTestPhy>> m_rxPhys; //!< The receivers
+    std::vector<uint32_t> m_expectedReceptions;    //!< Expected receptions per receiver
+};
+
+RangeSpectrumTransmitFilterTestCase::RangeSpectrumTransmitFilterTestCase(double maxRange,
+                                                                         double minRxPowerDbm,
+                                                                         double cellSize)
+    : TestCase(Name(maxRange, minRxPowerDbm, cellSize)),
+      m_maxRange(maxRange),
+      m_minRxPowerDbm(minRxPowerDbm),
+      m_cellSize(cellSize)
+{
+}
+
+std::string
+RangeSpectrumTransmitFilterTestCase::Name(double maxRange, double minRxPowerDbm, double cellSize)
+{
+    std::ostringstream oss;
+    oss << "RangeSpectrumTransmitFilter with MaxRange " << maxRange << " m, MinRxPower "
+        << minRxPowerDbm << " dBm, cells of " << cellSize << " m";
+    return oss.str();
+}
+
+void
+RangeSpectrumTransmitFilterTestCase::Transmit(Vector position)
+{
+    m_txPhy->GetMobility()->SetPosition(position);
+    auto params = Create<SpectrumSignalParameters>();
+    params->txPhy = m_txPhy;
+    params->psd = Create<SpectrumValue>(m_model);
+    *params->psd = 1e-3 / 180e3; // 0 dBm per band
+    params->duration = MilliSeconds(1);
+
+    double range = m_filter->GetRange(params);
+    for (std::size_t i = 0; i < m_rxPhys.size(); ++i)
+    {
+        auto mobility = m_rxPhys[i]->GetMobility();
+        if (!mobility || CalculateDistance(mobility->GetPosition(), position) <= range)
+        {
+            ++m_expectedReceptions[i];
+        }
+    }
+    m_channel->StartTx(params);
+    // after the receptions of all the transmissions starting now
+    Simulator::Schedule(NanoSeconds(1),
+                        &RangeSpectrumTransmitFilterTestCase::CheckReceptions,
+                        this);
+}
+
+void
+RangeSpectrumTransmitFilterTestCase::CheckReceptions()
+{
+    for (std::size_t i = 0; i < m_rxPhys.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_rxPhys[i]->m_receptions,
+                              m_expectedReceptions[i],
+                              "Wrong number of receptions of receiver " << i << " at "
+                                                                        << Simulator::Now());
+    }
+}
+
+void
+RangeSpectrumTransmitFilterTestCase::DoRun()
+{
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < 10; ++i)
+    {
+        freqs.push_back(3.5e9 + 180e3 * i);
+    }
+    m_model = Create<SpectrumModel>(freqs);
+
+    m_channel = CreateObject<MultiModelSpectrumChannel>();
+    m_filter = CreateObject<RangeSpectrumTransmitFilter>();
+    m_filter->SetAttribute("MaxRange", DoubleValue(m_maxRange));
+    m_filter->SetAttribute("MinRxPower", DoubleValue(m_minRxPowerDbm));
+    m_filter->SetAttribute("MaxGain", DoubleValue(10.0));
+    m_filter->SetAttribute("GridCellSize", DoubleValue(m_cellSize));
+    m_channel->AddSpectrumTransmitFilter(m_filter);
+
+    m_txPhy = CreateObject<RangeFilterTestPhy>(m_model);
+    m_txPhy->SetMobility(CreateObject<ConstantPositionMobilityModel>());
+
+    // static receivers spread over 3 km x 3 km, some moving ones, and one without mobility
+    std::vector<Ptr<MobilityModel>> staticMobilities;
+    for (uint32_t i = 0; i < 300; ++i)
+    {
+        auto phy = CreateObject<RangeFilterTestPhy>(m_model);
+        Ptr<MobilityModel> mobility;
+        Vector position(1500 * std::sin(1.7 * i + 0.3), 1500 * std::cos(2.9 * i), 1.5);
+        if (i % 10 == 0)
+        {
+            auto moving = CreateObject<ConstantVelocityMobilityModel>();
+            moving->SetPosition(position);
+            moving->SetVelocity(Vector(30 * std::cos(i), 30 * std::sin(i), 0));
+            mobility = moving;
+        }
+        else
+        {
+            mobility = CreateObject<ConstantPositionMobilityModel>();
+            mobility->SetPosition(position);
+            staticMobilities.push_back(mobility);
+        }
+        phy->SetMobility(mobility);
+        m_rxPhys.push_back(phy);
+        m_channel->AddRx(phy);
+    }
+    m_rxPhys.push_back(CreateObject<RangeFilterTestPhy>(m_model));
+    m_channel->AddRx(m_rxPhys.back());
+    m_expectedReceptions.assign(m_rxPhys.size(), 0);
+
+    for (uint32_t t = 0; t < 20; ++t)
+    {
+        Vector position(1000 * std::sin(0.9 * t), 1000 * std::cos(1.3 * t), 25);
+        Simulator::Schedule(Seconds(0.5 * t + 0.1),
+                            &RangeSpectrumTransmitFilterTestCase::Transmit,
+                            this,
+                            position);
+        // two transmissions at the same time, from different positions
+        Simulator::Schedule(Seconds(0.5 * t + 0.1),
+                            &RangeSpectrumTransmitFilterTestCase::Transmit,
+                            this,
+                            Vector(-position.y, position.x, 10));
+    }
+    // move static receivers to other cells, and to the middle of the area
+    for (std::size_t i = 0; i < staticMobilities.size(); i += 7)
+    {
+        auto mobility = staticMobilities[i];
+        Simulator::Schedule(Seconds(3.3), [mobility, i]() {
+            mobility->SetPosition(Vector(10.0 * (i % 11), 7.0 * (i % 13), 1.5));
+        });
+    }
+    Simulator::Stop(Seconds(11));
+    Simulator::Run();
+
+    uint32_t reached = 0;
+    uint32_t filtered = 0;
+    for (std::size_t i = 0; i + 1 < m_rxPhys.size(); ++i)
+    {
+        reached += m_expectedReceptions[i];
+        filtered += 40 - m_expectedReceptions[i];
+    }
+    NS_TEST_ASSERT_MSG_GT(reached, 0, "No receptions: the test does not check anything");
+    NS_TEST_ASSERT_MSG_GT(filtered, 0, "No receiver filtered: the test does not check anything");
+    NS_TEST_ASSERT_MSG_EQ(m_rxPhys.back()->m_receptions, 40, "A receiver without mobility must "
+                                                             "receive all the transmissions");
+
+    Simulator::Destroy();
+    m_channel = nullptr;
+    m_filter = nullptr;
+    m_txPhy = nullptr;
+    m_rxPhys.clear();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Check the range of RangeSpectrumTransmitFilter for a minimum received power: at
+ * that distance, the free-space received power with MaxGain is MinRxPower.
+ */
+class RangeSpectrumTransmitFilterRangeTestCase : public TestCase
+{
+  public:
+    RangeSpectrumTransmitFilterRangeTestCase()
+        : TestCase("RangeSpectrumTransmitFilter range for a minimum received power")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+RangeSpectrumTransmitFilterRangeTestCase::DoRun()
+{
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < 100; ++i)
+    {
+        freqs.push_back(28e9 + 120e3 * i);
+    }
+    auto model = Create<SpectrumModel>(freqs);
+    auto params = Create<SpectrumSignalParameters>();
+    params->psd = Create<SpectrumValue>(model);
+    *params->psd = 1.0 / (100 * 120e3); // 30 dBm
+
+    auto filter = CreateObject<RangeSpectrumTransmitFilter>();
+    filter->SetAttribute("MinRxPower", DoubleValue(-100.0));
+    filter->SetAttribute("MaxGain", DoubleValue(20.0));
+    double range = filter->GetRange(params);
+    double fsplDb = 20 * std::log10(4 * M_PI * range * freqs.front() / 299792458.0);
+    NS_TEST_ASSERT_MSG_EQ_TOL(30 + 20 - fsplDb, -100, 1e-9, "Wrong range");
+
+    // the range is given by the lowest frequency, whatever the order of the bands
+    Bands bands;
+    for (auto fc = freqs.rbegin(); fc != freqs.rend(); ++fc)
+    {
+        BandInfo band;
+        band.fl = *fc - 60e3;
+        band.fc = *fc;
+        band.fh = *fc + 60e3;
+        bands.push_back(band);
+    }
+    auto reversedParams = Create<SpectrumSignalParameters>();
+    reversedParams->psd = Create<SpectrumValue>(Create<SpectrumModel>(bands));
+    *reversedParams->psd = 1.0 / (100 * 120e3);
+    NS_TEST_ASSERT_MSG_EQ_TOL(filter->GetRange(reversedParams),
+                              range,
+                              range * 1e-12,
+                              "Range not given by the lowest frequency");
+
+    filter->SetAttribute("MaxRange", DoubleValue(100.0));
+    NS_TEST_ASSERT_MSG_EQ(filter->GetRange(params), 100.0, "MaxRange must limit the range");
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief RangeSpectrumTransmitFilter test suite
+ */
+class RangeSpectrumTransmitFilterTestSuite : public TestSuite
+{
+  public:
+    RangeSpectrumTransmitFilterTestSuite()
+        : TestSuite("range-spectrum-transmit-filter", Type::UNIT)
+    {
+        AddTestCase(new RangeSpectrumTransmitFilterRangeTestCase, Duration::QUICK);
+        // the range is smaller, then of the order, then larger than the cells
+        AddTestCase(new RangeSpectrumTransmitFilterTestCase(400, -1e9, 50), Duration::QUICK);
+        AddTestCase(new RangeSpectrumTransmitFilterTestCase(400, -1e9, 250), Duration::QUICK);
+        AddTestCase(new RangeSpectrumTransmitFilterTestCase(1e9, -77, 250), Duration::QUICK);
+        AddTestCase(new RangeSpectrumTransmitFilterTestCase(800, -1e9, 100), Duration::QUICK);
+    }
+};
+
+/// Static variable for test initialization
+static RangeSpectrumTransmitFilterTestSuite g_rangeSpectrumTransmitFilterTestSuite;
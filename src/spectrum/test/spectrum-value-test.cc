@@ -22,6 +22,7 @@
 #include <ns3/log.h>
 #include <ns3/object.h>
 #include <ns3/spectrum-converter.h>
+#include <ns3/spectrum-value-expression.h>
 #include <ns3/spectrum-value.h>
 #include <ns3/test.h>
 
@@ -93,6 +94,77 @@ SpectrumValueTestCase::DoRun()
     NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL(m_a, m_b, TOLERANCE, "");
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Spectrum Value expression templates Test
+ *
+ * Checks that the expressions built with Lazy() give exactly the same values as the
+ * SpectrumValue operators, including the in-place evaluation and the reductions. The
+ * number of bands is not a multiple of the SIMD block, so that the remainder of the
+ * element-wise kernels is covered too.
+ */
+class SpectrumValueExpressionTestCase : public TestCase
+{
+  public:
+    SpectrumValueExpressionTestCase();
+    void DoRun() override;
+};
+
+SpectrumValueExpressionTestCase::SpectrumValueExpressionTestCase()
+    : TestCase("SpectrumValue expressions evaluated without temporaries")
+{
+}
+
+void
+SpectrumValueExpressionTestCase::DoRun()
+{
+    std::vector<double> freqs;
+    for (int i = 1; i <= 37; i++)
+    {
+        freqs.push_back(1e9 + 1e5 * i * i);
+    }
+    Ptr<SpectrumModel> f = Create<SpectrumModel>(freqs);
+
+    SpectrumValue a(f);
+    SpectrumValue b(f);
+    SpectrumValue c(f);
+    SpectrumValue d(f);
+    for (size_t i = 0; i < freqs.size(); i++)
+    {
+        a[i] = (1.5 + std::sin(0.7 * i)) * 1e-13;
+        b[i] = (1.2 + std::cos(1.3 * i)) * 3e-14;
+        c[i] = 1e-15 / (1 + i);
+        d[i] = 2e-14 + std::sin(0.1 * i) * 1e-14;
+    }
+
+    SpectrumValue expected = (a - b + c) / d;
+    SpectrumValue res = (Lazy(a) - b + c) / d;
+    NS_TEST_ASSERT_MSG_EQ(res.GetSpectrumModelUid(), f->GetUid(), "Wrong SpectrumModel");
+    for (size_t i = 0; i < freqs.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(res[i], expected[i], "(a - b + c) / d differs at " << i);
+    }
+
+    expected = 10 * Log10(2.0 * a * b / (c + 1e-16));
+    res = 10 * Log10(2.0 * Lazy(a) * b / (Lazy(c) + 1e-16));
+    for (size_t i = 0; i < freqs.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(res[i], expected[i], "10 log10(2ab / (c + n)) differs at " << i);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(Sum(Lazy(a) * b), Sum(a * b), "Sum differs");
+    NS_TEST_ASSERT_MSG_EQ(Integral(Lazy(c) + d), Integral(c + d), "Integral differs");
+
+    // in place, with the destination as an operand
+    expected = a * b - d;
+    a = Lazy(a) * b - d;
+    for (size_t i = 0; i < freqs.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(a[i], expected[i], "a = a * b - d differs at " << i);
+    }
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -276,6 +348,8 @@ SpectrumValueTestSuite::SpectrumValueTestSuite()
     tv1rs3 = v1 >> 3;
     AddTestCase(new SpectrumValueTestCase(tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"),
                 TestCase::Duration::QUICK);
+
+    AddTestCase(new SpectrumValueExpressionTestCase, TestCase::Duration::QUICK);
 }
 
 /**
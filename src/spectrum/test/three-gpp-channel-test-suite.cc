@@ -17,6 +17,7 @@
 
 #include "ns3/abort.h"
 #include "ns3/angles.h"
+#include "ns3/boolean.h"
 #include "ns3/channel-condition-model.h"
 #include "ns3/config.h"
 #include "ns3/constant-position-mobility-model.h"
@@ -24,11 +25,14 @@
 #include "ns3/ism-spectrum-value-helper.h"
 #include "ns3/isotropic-antenna-model.h"
 #include "ns3/log.h"
+#include "ns3/multi-model-spectrum-channel.h"
 #include "ns3/node-container.h"
 #include "ns3/pointer.h"
+#include "ns3/propagation-delay-model.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/simple-net-device.h"
 #include "ns3/simulator.h"
+#include "ns3/spectrum-phy.h"
 #include "ns3/spectrum-signal-parameters.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
@@ -38,6 +42,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/uniform-planar-array.h"
 
+#include <functional>
 #include <valarray>
 
 using namespace ns3;
@@ -496,6 +501,211 @@ ThreeGppChannelMatrixUpdateTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the channel coefficients computed by ThreeGppChannelModel::GetNewChannel.
+ * The coefficients of each receiver element, transmitter element and cluster must match,
+ * within rounding, the ones computed with a plain loop over the rays (7.5-22) and
+ * (7.5-28), for arrays whose number of elements is not a multiple of the SIMD block.
+ */
+class ThreeGppChannelReferenceTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * \param txColumns the number of columns of the transmitter array, with one row
+     * \param rxColumns the number of columns of the receiver array, with one row
+     * \param isDualPolarized whether the arrays are dual-polarized
+     */
+    ThreeGppChannelReferenceTest(uint32_t txColumns, uint32_t rxColumns, bool isDualPolarized);
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+
+    uint32_t m_txColumns;   //!< number of columns of the transmitter array
+    uint32_t m_rxColumns;   //!< number of columns of the receiver array
+    bool m_isDualPolarized; //!< whether the arrays are dual-polarized
+};
+
+ThreeGppChannelReferenceTest::ThreeGppChannelReferenceTest(uint32_t txColumns,
+                                                           uint32_t rxColumns,
+                                                           bool isDualPolarized)
+    : TestCase("Check the channel coefficients against a reference computation, " +
+               std::to_string(txColumns) + "x" + std::to_string(rxColumns) +
+               (isDualPolarized ? " dual-polarized" : " single-polarized")),
+      m_txColumns(txColumns),
+      m_rxColumns(rxColumns),
+      m_isDualPolarized(isDualPolarized)
+{
+}
+
+void
+ThreeGppChannelReferenceTest::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    // NLOS only, so that all the coefficients come from the clusters
+    Ptr<ChannelConditionModel> channelConditionModel =
+        CreateObject<NeverLosChannelConditionModel>();
+    Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Frequency", DoubleValue(28.0e9));
+    channelModel->SetAttribute("Scenario", StringValue("UMa"));
+    channelModel->SetAttribute("ChannelConditionModel", PointerValue(channelConditionModel));
+    channelModel->AssignStreams(1);
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    Ptr<MobilityModel> txMob = CreateObject<ConstantPositionMobilityModel>();
+    txMob->SetPosition(Vector(0.0, 0.0, 25.0));
+    Ptr<MobilityModel> rxMob = CreateObject<ConstantPositionMobilityModel>();
+    rxMob->SetPosition(Vector(80.0, 30.0, 1.5));
+    nodes.Get(0)->AggregateObject(txMob);
+    nodes.Get(1)->AggregateObject(rxMob);
+
+    auto createArray = [this](uint32_t columns, double bearing) {
+        return CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumColumns",
+            UintegerValue(columns),
+            "NumRows",
+            UintegerValue(1),
+            "AntennaElement",
+            PointerValue(CreateObject<ThreeGppAntennaModel>()),
+            "BearingAngle",
+            DoubleValue(bearing),
+            "PolSlantAngle",
+            DoubleValue(m_isDualPolarized ? M_PI / 4 : 0.0),
+            "IsDualPolarized",
+            BooleanValue(m_isDualPolarized));
+    };
+    Ptr<PhasedArrayModel> txAntenna = createArray(m_txColumns, 0.0);
+    Ptr<PhasedArrayModel> rxAntenna = createArray(m_rxColumns, M_PI);
+
+    // s is the transmitter and u the receiver, as in TR 38.901
+    Ptr<MobilityModel> sMob = txMob;
+    Ptr<MobilityModel> uMob = rxMob;
+    Ptr<PhasedArrayModel> sAntenna = txAntenna;
+    Ptr<PhasedArrayModel> uAntenna = rxAntenna;
+
+    auto channel = channelModel->GetChannel(sMob, uMob, sAntenna, uAntenna);
+    auto params = DynamicCast<const ThreeGppChannelModel::ThreeGppChannelParams>(
+        channelModel->GetParams(sMob, uMob));
+    NS_TEST_ASSERT_MSG_NE(params, nullptr, "The channel parameters are missing");
+    auto table = channelModel->GetThreeGppTable(
+        sMob,
+        uMob,
+        channelConditionModel->GetChannelCondition(sMob, uMob));
+    NS_TEST_ASSERT_MSG_EQ(params->m_losCondition,
+                          ChannelCondition::NLOS,
+                          "The channel must be NLOS");
+
+    bool isSameDirection = (params->m_nodeIds == channel->m_nodeIds);
+    const auto& rayAod = isSameDirection ? params->m_rayAodRadian : params->m_rayAoaRadian;
+    const auto& rayAoa = isSameDirection ? params->m_rayAoaRadian : params->m_rayAodRadian;
+    const auto& rayZod = isSameDirection ? params->m_rayZodRadian : params->m_rayZoaRadian;
+    const auto& rayZoa = isSameDirection ? params->m_rayZoaRadian : params->m_rayZodRadian;
+
+    const size_t uSize = uAntenna->GetNumElems();
+    const size_t sSize = sAntenna->GetNumElems();
+    const uint8_t numReducedCluster = params->m_reducedClusterNumber;
+    const uint8_t raysPerCluster = table->m_raysPerCluster;
+    const size_t numOverallCluster =
+        numReducedCluster + (params->m_cluster1st != params->m_cluster2nd ? 4 : 2);
+    NS_TEST_ASSERT_MSG_EQ(channel->m_channel.GetNumRows(), uSize, "Wrong number of rows");
+    NS_TEST_ASSERT_MSG_EQ(channel->m_channel.GetNumCols(), sSize, "Wrong number of columns");
+    NS_TEST_ASSERT_MSG_EQ(channel->m_channel.GetNumPages(),
+                          numOverallCluster,
+                          "Wrong number of clusters");
+
+    for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+    {
+        const Vector uLoc = uAntenna->GetElementLocation(uIndex);
+        const uint8_t uPol = uAntenna->GetElemPol(uIndex);
+        for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+            const Vector sLoc = sAntenna->GetElementLocation(sIndex);
+            const uint8_t sPol = sAntenna->GetElemPol(sIndex);
+            std::vector<std::complex<double>> expected(numOverallCluster, 0.0);
+            uint8_t numSubClustersAdded = 0;
+            for (uint8_t nIndex = 0; nIndex < numReducedCluster; nIndex++)
+            {
+                bool isStrongest =
+                    (nIndex == params->m_cluster1st || nIndex == params->m_cluster2nd);
+                double scale = std::sqrt(params->m_clusterPower[nIndex] / raysPerCluster);
+                for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+                {
+                    const auto& initialPhase = params->m_clusterPhase[nIndex][mIndex];
+                    double k = params->m_crossPolarizationPowerRatios[nIndex][mIndex];
+                    auto [rxPhi, rxTheta] = uAntenna->GetElementFieldPattern(
+                        Angles(params->m_rayAoaRadian[nIndex][mIndex],
+                               params->m_rayZoaRadian[nIndex][mIndex]),
+                        uPol);
+                    auto [txPhi, txTheta] = sAntenna->GetElementFieldPattern(
+                        Angles(params->m_rayAodRadian[nIndex][mIndex],
+                               params->m_rayZodRadian[nIndex][mIndex]),
+                        sPol);
+                    std::complex<double> ray =
+                        std::polar(1.0, initialPhase[0]) * rxTheta * txTheta +
+                        std::polar(1.0, initialPhase[1]) * std::sqrt(1.0 / k) * rxTheta *
+                            txPhi +
+                        std::polar(1.0, initialPhase[2]) * std::sqrt(1.0 / k) * rxPhi *
+                            txTheta +
+                        std::polar(1.0, initialPhase[3]) * rxPhi * txPhi;
+
+                    double aoa = rayAoa[nIndex][mIndex];
+                    double zoa = rayZoa[nIndex][mIndex];
+                    double aod = rayAod[nIndex][mIndex];
+                    double zod = rayZod[nIndex][mIndex];
+                    double rxPhaseDiff =
+                        2 * M_PI *
+                        (std::sin(zoa) * std::cos(aoa) * uLoc.x +
+                         std::sin(zoa) * std::sin(aoa) * uLoc.y + std::cos(zoa) * uLoc.z);
+                    double txPhaseDiff =
+                        2 * M_PI *
+                        (std::sin(zod) * std::cos(aod) * sLoc.x +
+                         std::sin(zod) * std::sin(aod) * sLoc.y + std::cos(zod) * sLoc.z);
+                    ray *= std::polar(1.0, rxPhaseDiff) * std::polar(1.0, txPhaseDiff);
+
+                    // sub-clusters of the strongest clusters (7.5-28)
+                    size_t cIndex = nIndex;
+                    if (isStrongest)
+                    {
+                        if ((mIndex >= 9 && mIndex <= 12) || mIndex == 17 || mIndex == 18)
+                        {
+                            cIndex = numReducedCluster + numSubClustersAdded;
+                        }
+                        else if (mIndex >= 13 && mIndex <= 16)
+                        {
+                            cIndex = numReducedCluster + numSubClustersAdded + 1;
+                        }
+                    }
+                    expected[cIndex] += ray * scale;
+                }
+                if (isStrongest)
+                {
+                    numSubClustersAdded += 2;
+                }
+            }
+
+            for (size_t cIndex = 0; cIndex < numOverallCluster; cIndex++)
+            {
+                std::complex<double> actual = channel->m_channel(uIndex, sIndex, cIndex);
+                NS_TEST_ASSERT_MSG_EQ_TOL(std::abs(actual - expected[cIndex]),
+                                          0.0,
+                                          1e-9 * std::max(1.0, std::abs(expected[cIndex])),
+                                          "Wrong coefficient of u=" << uIndex
+                                              << " s=" << sIndex << " n=" << cIndex);
+            }
+        }
+    }
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -1441,11 +1651,728 @@ ThreeGppMimoPolarizationTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * SpectrumPhy with a phased array that records the signals it receives
+ */
+class ThreeGppParallelRxTestPhy : public SpectrumPhy
+{
+  public:
+    /**
+     * Constructor
+     * \param rxSpectrumModel the spectrum model of the receptions
+     * \param antenna the antenna array
+     */
+    ThreeGppParallelRxTestPhy(Ptr<const SpectrumModel> rxSpectrumModel,
+                              Ptr<PhasedArrayModel> antenna)
+        : m_rxSpectrumModel(rxSpectrumModel),
+          m_antenna(antenna)
+    {
+    }
+
+    void SetDevice(Ptr<NetDevice> d) override
+    {
+        m_device = d;
+    }
+
+    Ptr<NetDevice> GetDevice() const override
+    {
+        return m_device;
+    }
+
+    void SetMobility(Ptr<MobilityModel> m) override
+    {
+        m_mobility = m;
+    }
+
+    Ptr<MobilityModel> GetMobility() const override
+    {
+        return m_mobility;
+    }
+
+    void SetChannel(Ptr<SpectrumChannel> c) override
+    {
+    }
+
+    Ptr<const SpectrumModel> GetRxSpectrumModel() const override
+    {
+        return m_rxSpectrumModel;
+    }
+
+    Ptr<Object> GetAntenna() const override
+    {
+        return m_antenna;
+    }
+
+    void StartRx(Ptr<SpectrumSignalParameters> params) override
+    {
+        m_rxCallback(params);
+    }
+
+    std::function<void(Ptr<SpectrumSignalParameters>)> m_rxCallback; //!< Called at each reception
+
+  private:
+    Ptr<const SpectrumModel> m_rxSpectrumModel; //!< the spectrum model of the receptions
+    Ptr<PhasedArrayModel> m_antenna;            //!< the antenna array
+    Ptr<NetDevice> m_device;                    //!< the device
+    Ptr<MobilityModel> m_mobility;              //!< the mobility model
+};
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the MultiModelSpectrumChannel with RxThreads: a gNB-like node transmits
+ * to receivers at different distances, some of them with the same propagation delay and
+ * one node with two receivers, before and after an update of the channel matrices.
+ * The order, the times, the received PSDs and the spectrum channel matrices of the
+ * receptions must be exactly the same with and without threads.
+ */
+class ThreeGppParallelRxTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ThreeGppParallelRxTest();
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+
+    /**
+     * A reception recorded by a receiver
+     */
+    struct Reception
+    {
+        uint32_t m_phy;                                                //!< index of the receiver
+        Time m_time;                                                   //!< time of the reception
+        std::vector<double> m_psd;                                     //!< received PSD
+        Ptr<const MatrixBasedChannelModel::Complex3DVector> m_channel; //!< channel matrix
+    };
+
+    /**
+     * Run the scenario
+     * \param rxThreads the value of the RxThreads attribute of the channel
+     * \return the receptions, in their order
+     */
+    std::vector<Reception> RunScenario(uint32_t rxThreads);
+};
+
+ThreeGppParallelRxTest::ThreeGppParallelRxTest()
+    : TestCase("Check that the RX PSDs computed in parallel match the serial ones")
+{
+}
+
+std::vector<ThreeGppParallelRxTest::Reception>
+ThreeGppParallelRxTest::RunScenario(uint32_t rxThreads)
+{
+    Config::SetDefault("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue(MilliSeconds(100)));
+
+    Ptr<ThreeGppSpectrumPropagationLossModel> lossModel =
+        CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    lossModel->SetChannelModelAttribute("Frequency", DoubleValue(2.4e9));
+    lossModel->SetChannelModelAttribute("Scenario", StringValue("UMa"));
+    lossModel->SetChannelModelAttribute(
+        "ChannelConditionModel",
+        PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+    DynamicCast<ThreeGppChannelModel>(lossModel->GetChannelModel())->AssignStreams(1);
+
+    Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel>();
+    channel->SetAttribute("RxThreads", UintegerValue(rxThreads));
+    channel->AddPhasedArraySpectrumPropagationLossModel(lossModel);
+    channel->SetPropagationDelayModel(CreateObject<ConstantSpeedPropagationDelayModel>());
+
+    SpectrumValue5MhzFactory sf;
+    Ptr<SpectrumValue> txPsd = sf.CreateTxPowerSpectralDensity(0.1, 1);
+
+    // node 0 transmits; nodes 1 to 8 are on a circle, the others farther; node 1 has
+    // two receivers
+    const uint32_t numNodes = 12;
+    NodeContainer nodes;
+    nodes.Create(numNodes);
+    std::vector<Ptr<ThreeGppParallelRxTestPhy>> phys;
+    std::vector<Reception> receptions;
+    for (uint32_t i = 0; i < numNodes; ++i)
+    {
+        Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice>();
+        nodes.Get(i)->AddDevice(dev);
+        dev->SetNode(nodes.Get(i));
+        Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+        double radius = i <= 8 ? 100.0 : 100.0 + 37.0 * i;
+        mob->SetPosition(Vector(radius * std::cos(0.7 * i), radius * std::sin(0.7 * i), 1.5));
+        if (i == 0)
+        {
+            mob->SetPosition(Vector(0.0, 0.0, 25.0));
+        }
+        nodes.Get(i)->AggregateObject(mob);
+
+        for (uint32_t j = 0; j < (i == 1 ? 2 : 1); ++j)
+        {
+            Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+                "NumColumns",
+                UintegerValue(i == 0 ? 4 : 2),
+                "NumRows",
+                UintegerValue(i == 0 ? 4 : 2),
+                "AntennaElement",
+                PointerValue(CreateObject<IsotropicAntennaModel>()));
+            auto phy = Create<ThreeGppParallelRxTestPhy>(txPsd->GetSpectrumModel(), antenna);
+            phy->SetDevice(dev);
+            phy->SetMobility(mob);
+            uint32_t index = phys.size();
+            phy->m_rxCallback = [&receptions, index](Ptr<SpectrumSignalParameters> params) {
+                receptions.push_back({index,
+                                      Simulator::Now(),
+                                      std::vector<double>(params->psd->ConstValuesBegin(),
+                                                          params->psd->ConstValuesEnd()),
+                                      params->spectrumChannelMatrix});
+            };
+            channel->AddRx(phy);
+            phys.push_back(phy);
+        }
+    }
+
+    // point the beams of the receivers to the transmitter, and the one of the transmitter
+    // to node 3
+    auto position = [&nodes](uint32_t i) {
+        return nodes.Get(i)->GetObject<MobilityModel>()->GetPosition();
+    };
+    for (uint32_t p = 1; p < phys.size(); ++p)
+    {
+        auto antenna = DynamicCast<PhasedArrayModel>(phys[p]->GetAntenna());
+        auto node = phys[p]->GetDevice()->GetNode()->GetId();
+        antenna->SetBeamformingVector(
+            antenna->GetBeamformingVector(Angles(position(0), position(node))));
+    }
+    auto txAntenna = DynamicCast<PhasedArrayModel>(phys[0]->GetAntenna());
+    txAntenna->SetBeamformingVector(
+        txAntenna->GetBeamformingVector(Angles(position(3), position(0))));
+
+    for (auto time : {MilliSeconds(1), MilliSeconds(2), MilliSeconds(150)})
+    {
+        Simulator::Schedule(time, [&phys, &channel, txPsd]() {
+            Ptr<SpectrumSignalParameters> txParams = Create<SpectrumSignalParameters>();
+            txParams->psd = txPsd->Copy();
+            txParams->txPhy = phys[0];
+            txParams->duration = MicroSeconds(100);
+            channel->StartTx(txParams);
+        });
+    }
+    Simulator::Run();
+    Simulator::Destroy();
+    return receptions;
+}
+
+void
+ThreeGppParallelRxTest::DoRun()
+{
+    auto serial = RunScenario(0);
+    auto parallel = RunScenario(4);
+
+    NS_TEST_ASSERT_MSG_EQ(serial.size(), 3 * 12, "Wrong number of receptions");
+    NS_TEST_ASSERT_MSG_EQ(parallel.size(), serial.size(), "Wrong number of receptions");
+    for (std::size_t i = 0; i < serial.size(); ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(parallel[i].m_phy, serial[i].m_phy, "Different order");
+        NS_TEST_ASSERT_MSG_EQ(parallel[i].m_time, serial[i].m_time, "Different time");
+        NS_TEST_ASSERT_MSG_EQ((parallel[i].m_psd == serial[i].m_psd), true, "Different PSD");
+        NS_TEST_ASSERT_MSG_EQ((*parallel[i].m_channel == *serial[i].m_channel),
+                              true,
+                              "Different spectrum channel matrix");
+    }
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the long term components kept per pair of beamforming vectors by the
+ * ThreeGppSpectrumPropagationLossModel, with at most 2 pairs. The TX node switches
+ * between 3 beams, and the test checks whether the long terms are computed again or
+ * found in the cache, and that they are computed again after an update of the channel.
+ */
+class ThreeGppLongTermBeamCacheTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ThreeGppLongTermBeamCacheTest();
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+};
+
+ThreeGppLongTermBeamCacheTest::ThreeGppLongTermBeamCacheTest()
+    : TestCase("Check the long term components kept per pair of beamforming vectors")
+{
+}
+
+void
+ThreeGppLongTermBeamCacheTest::DoRun()
+{
+    auto lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    lossModel->SetChannelModelAttribute("Frequency", DoubleValue(2.4e9));
+    lossModel->SetChannelModelAttribute("Scenario", StringValue("UMa"));
+    lossModel->SetChannelModelAttribute(
+        "ChannelConditionModel",
+        PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+    lossModel->SetAttribute("MaxBeamPairs", UintegerValue(2));
+    auto channelModel = lossModel->GetChannelModel();
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    std::vector<Ptr<MobilityModel>> mobilities;
+    std::vector<Ptr<PhasedArrayModel>> antennas;
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector(50.0 * i, 0.0, i == 0 ? 25.0 : 1.5));
+        nodes.Get(i)->AggregateObject(mobility);
+        mobilities.push_back(mobility);
+        antennas.push_back(CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumColumns",
+            UintegerValue(4),
+            "NumRows",
+            UintegerValue(2),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>())));
+    }
+    antennas[1]->SetBeamformingVector(antennas[1]->GetBeamformingVector(
+        Angles(mobilities[0]->GetPosition(), mobilities[1]->GetPosition())));
+    std::vector<PhasedArrayModel::ComplexVector> beams;
+    for (double azimuth : {0.0, M_PI / 4, -M_PI / 4})
+    {
+        beams.push_back(antennas[0]->GetBeamformingVector(Angles(azimuth, M_PI / 2)));
+    }
+
+    auto channel = channelModel->GetChannel(mobilities[0], mobilities[1], antennas[0], antennas[1]);
+    auto getLongTerm = [&](uint32_t beam) {
+        antennas[0]->SetBeamformingVector(beams[beam]);
+        return lossModel->GetLongTerm(channel, antennas[0], antennas[1]);
+    };
+
+    auto longTerm0 = getLongTerm(0);
+    NS_TEST_ASSERT_MSG_EQ(getLongTerm(0), longTerm0, "The long term is computed again");
+    auto longTerm1 = getLongTerm(1);
+    NS_TEST_ASSERT_MSG_NE(longTerm1, longTerm0, "The long term of a new beam is not computed");
+    NS_TEST_ASSERT_MSG_EQ(getLongTerm(0),
+                          longTerm0,
+                          "The long term of the previous beam is not kept");
+
+    // a third beam evicts the least recently used one
+    getLongTerm(2);
+    NS_TEST_ASSERT_MSG_EQ(getLongTerm(0), longTerm0, "The most recently used beam is evicted");
+    NS_TEST_ASSERT_MSG_NE(getLongTerm(1), longTerm1, "The least recently used beam is kept");
+
+    // a new channel matrix makes the long terms of all the beams outdated
+    channelModel->RemoveNode(nodes.Get(1)->GetId());
+    channel = channelModel->GetChannel(mobilities[0], mobilities[1], antennas[0], antennas[1]);
+    NS_TEST_ASSERT_MSG_NE(getLongTerm(0), longTerm0, "The long term of the old channel is used");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the caches of the ThreeGppChannelModel and of the
+ * ThreeGppSpectrumPropagationLossModel classes, with at most 2 entries and an idle
+ * time of 100 ms. A node computes the received PSDs of 3 other nodes in turn, so that
+ * the least recently used channels are evicted, then again after more than 100 ms,
+ * so that the idle channels are evicted, and finally removes one of the nodes. It
+ * checks the counters of the caches and whether the channel params are kept.
+ */
+class ThreeGppChannelCacheTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ThreeGppChannelCacheTest();
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+
+    /**
+     * Compute the PSD received by a node
+     * \param node the index of the receiving node
+     */
+    void CalcRxPsd(uint32_t node);
+
+    /**
+     * Check the counters of the caches, which are the same for the three caches
+     * \param hits the expected number of hits
+     * \param misses the expected number of misses
+     * \param evictions the expected number of evictions
+     * \param step the step of the test, for the messages
+     */
+    void CheckCounters(uint64_t hits, uint64_t misses, uint64_t evictions, std::string step);
+
+    /**
+     * Get the channel params between the first node and another node, if cached
+     * \param node the index of the other node
+     * \return the channel params, or nullptr
+     */
+    Ptr<const MatrixBasedChannelModel::ChannelParams> GetParams(uint32_t node) const;
+
+    Ptr<ThreeGppSpectrumPropagationLossModel> m_lossModel; //!< the loss model
+    Ptr<ThreeGppChannelModel> m_channelModel;               //!< the channel model
+    std::vector<Ptr<MobilityModel>> m_mobilities;           //!< the mobility models of the nodes
+    std::vector<Ptr<PhasedArrayModel>> m_antennas;          //!< the antennas of the nodes
+    Ptr<SpectrumSignalParameters> m_txParams;               //!< the transmitted signal
+};
+
+ThreeGppChannelCacheTest::ThreeGppChannelCacheTest()
+    : TestCase("Check the eviction of the cached channel params, matrices and long terms")
+{
+}
+
+void
+ThreeGppChannelCacheTest::CalcRxPsd(uint32_t node)
+{
+    m_lossModel->DoCalcRxPowerSpectralDensity(m_txParams,
+                                              m_mobilities[0],
+                                              m_mobilities[node],
+                                              m_antennas[0],
+                                              m_antennas[node]);
+}
+
+void
+ThreeGppChannelCacheTest::CheckCounters(uint64_t hits,
+                                        uint64_t misses,
+                                        uint64_t evictions,
+                                        std::string step)
+{
+    NS_TEST_ASSERT_MSG_EQ(m_channelModel->GetParamsCacheHits(), hits, step << ": params hits");
+    NS_TEST_ASSERT_MSG_EQ(m_channelModel->GetParamsCacheMisses(),
+                          misses,
+                          step << ": params misses");
+    NS_TEST_ASSERT_MSG_EQ(m_channelModel->GetParamsCacheEvictions(),
+                          evictions,
+                          step << ": params evictions");
+    NS_TEST_ASSERT_MSG_EQ(m_channelModel->GetMatrixCacheHits(), hits, step << ": matrix hits");
+    NS_TEST_ASSERT_MSG_EQ(m_channelModel->GetMatrixCacheMisses(),
+                          misses,
+                          step << ": matrix misses");
+    NS_TEST_ASSERT_MSG_EQ(m_channelModel->GetMatrixCacheEvictions(),
+                          evictions,
+                          step << ": matrix evictions");
+
+    UintegerValue value;
+    m_lossModel->GetAttribute("LongTermCacheHits", value);
+    NS_TEST_ASSERT_MSG_EQ(value.Get(), hits, step << ": long term hits");
+    m_lossModel->GetAttribute("LongTermCacheMisses", value);
+    NS_TEST_ASSERT_MSG_EQ(value.Get(), misses, step << ": long term misses");
+    m_lossModel->GetAttribute("LongTermCacheEvictions", value);
+    NS_TEST_ASSERT_MSG_EQ(value.Get(), evictions, step << ": long term evictions");
+}
+
+Ptr<const MatrixBasedChannelModel::ChannelParams>
+ThreeGppChannelCacheTest::GetParams(uint32_t node) const
+{
+    return m_channelModel->GetParams(m_mobilities[0], m_mobilities[node]);
+}
+
+void
+ThreeGppChannelCacheTest::DoRun()
+{
+    m_lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    m_lossModel->SetChannelModelAttribute("Frequency", DoubleValue(2.4e9));
+    m_lossModel->SetChannelModelAttribute("Scenario", StringValue("UMa"));
+    m_lossModel->SetChannelModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(0)));
+    m_lossModel->SetChannelModelAttribute(
+        "ChannelConditionModel",
+        PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+    m_lossModel->SetChannelModelAttribute("CacheMaxEntries", UintegerValue(2));
+    m_lossModel->SetChannelModelAttribute("CacheIdleTime", TimeValue(MilliSeconds(100)));
+    m_lossModel->SetAttribute("CacheMaxEntries", UintegerValue(2));
+    m_lossModel->SetAttribute("CacheIdleTime", TimeValue(MilliSeconds(100)));
+    m_channelModel = DynamicCast<ThreeGppChannelModel>(m_lossModel->GetChannelModel());
+
+    NodeContainer nodes;
+    nodes.Create(4);
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector(20.0 * i, 10.0 * i, i == 0 ? 25.0 : 1.5));
+        nodes.Get(i)->AggregateObject(mobility);
+        m_mobilities.push_back(mobility);
+        m_antennas.push_back(CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumColumns",
+            UintegerValue(2),
+            "NumRows",
+            UintegerValue(2),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>())));
+    }
+    for (uint32_t i = 1; i < nodes.GetN(); ++i)
+    {
+        m_antennas[i]->SetBeamformingVector(m_antennas[i]->GetBeamformingVector(
+            Angles(m_mobilities[0]->GetPosition(), m_mobilities[i]->GetPosition())));
+    }
+    m_antennas[0]->SetBeamformingVector(m_antennas[0]->GetBeamformingVector(
+        Angles(m_mobilities[1]->GetPosition(), m_mobilities[0]->GetPosition())));
+
+    SpectrumValue5MhzFactory sf;
+    m_txParams = Create<SpectrumSignalParameters>();
+    m_txParams->psd = sf.CreateTxPowerSpectralDensity(0.1, 1);
+
+    // 1) fill the caches, then evict the least recently used channel
+    CalcRxPsd(1);
+    CalcRxPsd(2);
+    CalcRxPsd(1);
+    CheckCounters(1, 2, 0, "Filling the caches");
+    auto params1 = GetParams(1);
+    CalcRxPsd(3);
+    CheckCounters(1, 3, 1, "Adding a third channel");
+    NS_TEST_ASSERT_MSG_EQ(GetParams(2), nullptr, "The least recently used channel is kept");
+    NS_TEST_ASSERT_MSG_EQ(GetParams(1), params1, "The most recently used channel is evicted");
+    CalcRxPsd(1);
+    CheckCounters(2, 3, 1, "Using the first channel again");
+
+    // 2) keep using the first channel, then let it expire
+    Simulator::Schedule(MilliSeconds(50), [this, params1]() {
+        CalcRxPsd(1);
+        CheckCounters(3, 3, 1, "Before the idle time");
+        NS_TEST_ASSERT_MSG_EQ(GetParams(1), params1, "The channel is not kept");
+    });
+    Simulator::Schedule(MilliSeconds(200), [this, params1]() {
+        CalcRxPsd(2);
+        CheckCounters(3, 4, 3, "After the idle time");
+        NS_TEST_ASSERT_MSG_EQ(GetParams(1), nullptr, "The idle channel is not evicted");
+        NS_TEST_ASSERT_MSG_EQ((GetParams(2) != nullptr), true, "The new channel is not cached");
+
+        // 3) remove the second node
+        m_lossModel->RemoveNode(m_mobilities[2]->GetObject<Node>()->GetId());
+        CheckCounters(3, 4, 4, "After the removal of a node");
+        NS_TEST_ASSERT_MSG_EQ(GetParams(2), nullptr, "The channel of the node is not removed");
+        CalcRxPsd(2);
+        CheckCounters(3, 5, 4, "After the removal of a node");
+    });
+
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup spectrum-tests
  *
  * Test suite for the ThreeGppChannelModel class
  */
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the frequency-domain channel matrix and the received PSD of the
+ * ThreeGppSpectrumPropagationLossModel. The channel matrix of each RB, computed with
+ * the delay sincos obtained by recurrence over the RBs, must be the same as when
+ * computed from scratch with a complex exponential per cluster and RB, in both
+ * directions of the channel, with evenly and unevenly spaced RBs. The PSD received
+ * with a precoding matrix must be the trace of (HP)^h * (HP).
+ */
+class ThreeGppSpectrumChannelMatrixTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ThreeGppSpectrumChannelMatrixTest();
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+
+    /**
+     * Check the channel matrix of a direction of the channel against the one computed
+     * from scratch
+     * \param psd the input PSD
+     * \param txIndex the index of the transmitting node
+     * \param rxIndex the index of the receiving node
+     * \param msg the context of the check
+     */
+    void CheckChannelMatrix(Ptr<SpectrumValue> psd,
+                            uint32_t txIndex,
+                            uint32_t rxIndex,
+                            std::string msg);
+
+    Ptr<ThreeGppSpectrumPropagationLossModel> m_lossModel; //!< the loss model
+    std::vector<Ptr<MobilityModel>> m_mobilities;           //!< the mobility models of the nodes
+    std::vector<Ptr<PhasedArrayModel>> m_antennas;          //!< the antennas of the nodes
+};
+
+ThreeGppSpectrumChannelMatrixTest::ThreeGppSpectrumChannelMatrixTest()
+    : TestCase("Check the frequency-domain channel matrix and the received PSD")
+{
+}
+
+void
+ThreeGppSpectrumChannelMatrixTest::CheckChannelMatrix(Ptr<SpectrumValue> psd,
+                                                      uint32_t txIndex,
+                                                      uint32_t rxIndex,
+                                                      std::string msg)
+{
+    auto txAntenna = m_antennas[txIndex];
+    auto rxAntenna = m_antennas[rxIndex];
+    auto channelModel = m_lossModel->GetChannelModel();
+    auto channel = channelModel->GetChannel(m_mobilities[txIndex],
+                                            m_mobilities[rxIndex],
+                                            txAntenna,
+                                            rxAntenna);
+    auto channelParams = channelModel->GetParams(m_mobilities[txIndex], m_mobilities[rxIndex]);
+    auto longTerm = m_lossModel->GetLongTerm(channel, txAntenna, rxAntenna);
+    auto isReverse = channel->IsReverse(txAntenna->GetId(), rxAntenna->GetId());
+    auto numCluster = channel->m_channel.GetNumPages();
+    auto numTxPorts = txAntenna->GetNumPorts();
+    auto numRxPorts = rxAntenna->GetNumPorts();
+    PhasedArrayModel::ComplexVector doppler(numCluster);
+    for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        doppler[cIndex] = std::polar(1.0, 0.1 * cIndex);
+    }
+
+    auto chanSpct = m_lossModel->GenSpectrumChannelMatrix(psd,
+                                                          longTerm,
+                                                          channel,
+                                                          channelParams,
+                                                          doppler,
+                                                          numTxPorts,
+                                                          numRxPorts,
+                                                          isReverse);
+    NS_TEST_ASSERT_MSG_EQ(chanSpct->GetNumRows(), numRxPorts, msg << ": wrong number of rows");
+    NS_TEST_ASSERT_MSG_EQ(chanSpct->GetNumCols(), numTxPorts, msg << ": wrong number of columns");
+    NS_TEST_ASSERT_MSG_EQ(chanSpct->GetNumPages(),
+                          psd->GetValuesN(),
+                          msg << ": wrong number of RBs");
+
+    auto band = psd->ConstBandsBegin();
+    for (size_t iRb = 0; iRb < psd->GetValuesN(); iRb++, band++)
+    {
+        for (size_t rxPort = 0; rxPort < numRxPorts; rxPort++)
+        {
+            for (size_t txPort = 0; txPort < numTxPorts; txPort++)
+            {
+                std::complex<double> expected = 0.0;
+                double tolerance = 0.0;
+                for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+                {
+                    auto clusterLongTerm = isReverse ? (*longTerm)(txPort, rxPort, cIndex)
+                                                     : (*longTerm)(rxPort, txPort, cIndex);
+                    double delay = -2 * M_PI * band->fc * channelParams->m_delay[cIndex];
+                    expected += clusterLongTerm * std::polar(1.0, delay) * doppler[cIndex];
+                    tolerance += 1e-9 * std::abs(clusterLongTerm);
+                }
+                expected *= std::sqrt((*psd)[iRb]);
+                tolerance *= std::sqrt((*psd)[iRb]);
+                NS_TEST_ASSERT_MSG_LT_OR_EQ(std::abs((*chanSpct)(rxPort, txPort, iRb) - expected),
+                                            tolerance,
+                                            msg << ": wrong channel of RB " << iRb << " port "
+                                                << rxPort << "," << txPort);
+            }
+        }
+    }
+
+    // the PSD received with a precoding matrix is the trace of (HP)^h * (HP)
+    auto rxParams = Create<SpectrumSignalParameters>();
+    rxParams->psd = psd->Copy();
+    auto precodingMatrix =
+        Create<MatrixBasedChannelModel::Complex3DVector>(numTxPorts, 2, psd->GetValuesN());
+    for (size_t i = 0; i < precodingMatrix->GetSize(); i++)
+    {
+        (*precodingMatrix)(i % numTxPorts, (i / numTxPorts) % 2, i / (2 * numTxPorts)) =
+            std::polar(0.5, 0.3 * i);
+    }
+    rxParams->precodingMatrix = precodingMatrix;
+    m_lossModel->ApplyBeamformingGain(rxParams,
+                                      longTerm,
+                                      channel,
+                                      channelParams,
+                                      Vector(0, 0, 0),
+                                      Vector(0, 0, 0),
+                                      numTxPorts,
+                                      numRxPorts,
+                                      isReverse,
+                                      0.0,
+                                      28e9);
+    auto hP = *rxParams->spectrumChannelMatrix * (*rxParams->precodingMatrix);
+    auto expectedPsd = hP.HermitianTranspose() * hP;
+    for (size_t iRb = 0; iRb < psd->GetValuesN(); iRb++)
+    {
+        double expected = std::real(expectedPsd(0, 0, iRb) + expectedPsd(1, 1, iRb));
+        NS_TEST_ASSERT_MSG_EQ_TOL((*rxParams->psd)[iRb],
+                                  expected,
+                                  1e-9 * expected,
+                                  msg << ": wrong precoded PSD of RB " << iRb);
+    }
+}
+
+void
+ThreeGppSpectrumChannelMatrixTest::DoRun()
+{
+    m_lossModel = CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    m_lossModel->SetChannelModelAttribute("Frequency", DoubleValue(28e9));
+    m_lossModel->SetChannelModelAttribute("Scenario", StringValue("UMa"));
+    m_lossModel->SetChannelModelAttribute(
+        "ChannelConditionModel",
+        PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+
+    // a gNB with 4 ports and a UE with 2 ports, so that the directions are not symmetric
+    NodeContainer nodes;
+    nodes.Create(2);
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector(100.0 * i, 20.0 * i, i == 0 ? 25.0 : 1.5));
+        nodes.Get(i)->AggregateObject(mobility);
+        m_mobilities.push_back(mobility);
+        m_antennas.push_back(CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumColumns",
+            UintegerValue(4),
+            "NumRows",
+            UintegerValue(2),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>()),
+            "NumHorizontalPorts",
+            UintegerValue(i == 0 ? 4 : 2)));
+    }
+    for (uint32_t i = 0; i < nodes.GetN(); ++i)
+    {
+        m_antennas[i]->SetBeamformingVector(m_antennas[i]->GetBeamformingVector(
+            Angles(m_mobilities[1 - i]->GetPosition(), m_mobilities[i]->GetPosition())));
+    }
+
+    // 100 evenly spaced RBs, with an RB without power, and the same RBs unevenly spaced
+    std::vector<double> evenFrequencies;
+    std::vector<double> unevenFrequencies;
+    for (uint32_t rb = 0; rb < 100; ++rb)
+    {
+        evenFrequencies.push_back(28e9 + rb * 1.44e6);
+        unevenFrequencies.push_back(28e9 + rb * 1.44e6 + (rb % 3) * 0.1e6);
+    }
+    for (const auto& frequencies : {evenFrequencies, unevenFrequencies})
+    {
+        bool isEven = (frequencies == evenFrequencies);
+        auto psd = Create<SpectrumValue>(Create<SpectrumModel>(frequencies));
+        for (size_t rb = 0; rb < psd->GetValuesN(); ++rb)
+        {
+            (*psd)[rb] = (rb == 10) ? 0.0 : 1e-9 * (1 + rb % 4);
+        }
+        std::string spacing = isEven ? "evenly spaced RBs" : "unevenly spaced RBs";
+        CheckChannelMatrix(psd, 0, 1, "Direct channel, " + spacing);
+        CheckChannelMatrix(psd, 1, 0, "Reverse channel, " + spacing);
+    }
+
+    Simulator::Destroy();
+}
+
 class ThreeGppChannelTestSuite : public TestSuite
 {
   public:
@@ -1467,6 +2394,9 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite()
     AddTestCase(new ThreeGppChannelMatrixUpdateTest(2, 2, 1, 1), TestCase::Duration::QUICK);
     AddTestCase(new ThreeGppChannelMatrixUpdateTest(2, 4, 2, 2), TestCase::Duration::QUICK);
     AddTestCase(new ThreeGppChannelMatrixUpdateTest(2, 2, 2, 2), TestCase::Duration::QUICK);
+    AddTestCase(new ThreeGppChannelReferenceTest(5, 3, false), TestCase::Duration::QUICK);
+    AddTestCase(new ThreeGppChannelReferenceTest(3, 1, true), TestCase::Duration::QUICK);
+    AddTestCase(new ThreeGppChannelReferenceTest(7, 2, true), TestCase::Duration::QUICK);
     AddTestCase(new ThreeGppAntennaSetupChangedTest(), TestCase::Duration::QUICK);
     AddTestCase(new ThreeGppSpectrumPropagationLossModelTest(4, 4, 1, 1),
                 TestCase::Duration::QUICK);
@@ -1477,6 +2407,10 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite()
     AddTestCase(new ThreeGppSpectrumPropagationLossModelTest(4, 2, 2, 1),
                 TestCase::Duration::QUICK);
     AddTestCase(new ThreeGppCalcLongTermMultiPortTest(), TestCase::Duration::QUICK);
+    AddTestCase(new ThreeGppParallelRxTest(), TestCase::Duration::QUICK);
+    AddTestCase(new ThreeGppChannelCacheTest(), TestCase::Duration::QUICK);
+    AddTestCase(new ThreeGppLongTermBeamCacheTest(), TestCase::Duration::QUICK);
+    AddTestCase(new ThreeGppSpectrumChannelMatrixTest(), TestCase::Duration::QUICK);
 
     /**
      *  The TX and RX antennas are configured face-to-face.